@@ -0,0 +1,188 @@
+#include "finance_driver.h"
+
+#include <google/protobuf/util/time_util.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+using namespace wallet;
+using google::protobuf::util::TimeUtil;
+
+namespace {
+
+    constexpr int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+    // Document numbers of a run start at seed * DOCUMENTS_PER_SEED
+    constexpr uint64_t DOCUMENTS_PER_SEED = 1'000'000'000;
+
+    template < typename Response, typename Invoke >
+    ECallResult invoke(std::chrono::milliseconds deadline, Invoke && invoke) {
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + deadline);
+
+        Response response;
+        const grpc::Status status = invoke(&context, &response);
+        if (!status.ok()) {
+            return ECallResult::RPC_FAILED;
+        }
+        return response.has_error() ? ECallResult::ERROR_RESPONSE : ECallResult::OK;
+    }
+
+    int64_t uniform(std::mt19937_64 & random, int64_t from, int64_t to) {
+        return std::uniform_int_distribution< int64_t >(from, to)(random);
+    }
+
+    /**
+     * @brief Generator of the calling thread, every thread gets its own sequence
+     */
+    std::mt19937_64 & threadRandom(std::atomic< uint64_t > & nextSeed) {
+        thread_local std::mt19937_64 random(nextSeed.fetch_add(1, std::memory_order_relaxed));
+        return random;
+    }
+
+} // unnamed namespace
+
+QRPayloadGenerator::QRPayloadGenerator(std::size_t poolSize, uint64_t seed)
+  : nextDocument_((seed % 1000 + 1) * DOCUMENTS_PER_SEED) {
+    std::mt19937_64 random(seed);
+    pool_.reserve(poolSize);
+    for (std::size_t i = 0; i < poolSize; ++i) {
+        pool_.push_back(make(nextDocument_++, random));
+    }
+}
+
+std::string QRPayloadGenerator::next(std::mt19937_64 & random) {
+    if (!pool_.empty()) {
+        return pool_[static_cast< std::size_t >(uniform(random, 0, static_cast< int64_t >(pool_.size()) - 1))];
+    }
+    return make(nextDocument_.fetch_add(1, std::memory_order_relaxed), random);
+}
+
+std::string QRPayloadGenerator::make(uint64_t documentNumber, std::mt19937_64 & random) const {
+    std::array< char, 160 > buffer{};
+    std::snprintf(buffer.data(), buffer.size(), "t=2024%02lld%02lldT%02lld%02lld&s=%lld.%02lld&fn=92840001002872%02lld&i=%llu&fp=%lld&n=1",
+                  static_cast< long long >(uniform(random, 1, 12)), static_cast< long long >(uniform(random, 1, 28)),
+                  static_cast< long long >(uniform(random, 8, 22)), static_cast< long long >(uniform(random, 0, 59)),
+                  static_cast< long long >(uniform(random, 1, 9'999)), static_cast< long long >(uniform(random, 0, 99)),
+                  static_cast< long long >(uniform(random, 0, 99)),
+                  static_cast< unsigned long long >(documentNumber),
+                  static_cast< long long >(uniform(random, 1'000'000'000, 4'294'967'295)));
+    return buffer.data();
+}
+
+FinanceDriver::FinanceDriver(std::vector< std::unique_ptr< FinanceService::Stub > > stubs, std::vector< std::string > tokens, Settings settings)
+  : settings_(std::move(settings))
+  , stubs_(std::move(stubs))
+  , tokens_(std::move(tokens))
+  , qrPayloads_(settings_.qrPool, settings_.seed)
+  , nextSeed_(settings_.seed) {
+    if (stubs_.empty() || tokens_.empty()) {
+        throw std::invalid_argument("FinanceDriver needs at least one stub and one token");
+    }
+}
+
+std::vector< std::string > FinanceDriver::acquireTokens(FinanceService::Stub & stub, std::size_t count, const Settings & settings) {
+    std::vector< std::string > tokens;
+    tokens.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        AuthRequest request;
+        request.set_device_id(settings.devicePrefix + std::to_string(i));
+        request.set_device_name("Load generator");
+
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + settings.deadline);
+        AuthResponse response;
+        const auto status = stub.Authenticate(&context, request, &response);
+        if (!status.ok()) {
+            throw std::runtime_error("Authenticate failed: " + status.error_message());
+        }
+        if (response.has_error()) {
+            throw std::runtime_error("Authenticate failed: " + response.error().message());
+        }
+        tokens.push_back(response.token());
+    }
+    return tokens;
+}
+
+ECallResult FinanceDriver::call(ERpc rpc, std::size_t worker) {
+    auto & stub = *stubs_[worker % stubs_.size()];
+    auto & random = threadRandom(nextSeed_);
+    const auto tokenIndex = static_cast< std::size_t >(uniform(random, 0, static_cast< int64_t >(tokens_.size()) - 1));
+    const auto & token = tokens_[tokenIndex];
+    const auto now = TimeUtil::GetCurrentTime();
+
+    switch (rpc) {
+    case ERpc::AUTHENTICATE: {
+        AuthRequest request;
+        request.set_device_id(settings_.devicePrefix + std::to_string(tokenIndex));
+        return invoke< AuthResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.Authenticate(context, request, response);
+        });
+    }
+    case ERpc::PROCESS_QR_CODE: {
+        QRCodeRequest request;
+        request.mutable_auth()->set_token(token);
+        request.set_qr_code_content(qrPayloads_.next(random));
+        request.set_create_transaction(uniform(random, 0, 1) == 1);
+        return invoke< ReceiptDetailsResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.ProcessQRCode(context, request, response);
+        });
+    }
+    case ERpc::GET_RECEIPTS: {
+        GetReceiptsRequest request;
+        request.mutable_auth()->set_token(token);
+        request.set_limit(20);
+        return invoke< ReceiptsResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.GetReceipts(context, request, response);
+        });
+    }
+    case ERpc::GET_TRANSACTIONS: {
+        GetTransactionsRequest request;
+        request.mutable_auth()->set_token(token);
+        request.set_limit(50);
+        // A quarter of the lists is filtered by type, like the income/expense tabs of the app
+        if (uniform(random, 0, 3) == 0) {
+            request.set_type(static_cast< int32_t >(uniform(random, 0, 1)));
+        }
+        return invoke< TransactionsResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.GetTransactions(context, request, response);
+        });
+    }
+    case ERpc::CREATE_TRANSACTION: {
+        CreateTransactionRequest request;
+        request.mutable_auth()->set_token(token);
+        auto * transaction = request.mutable_transaction();
+        transaction->set_type(static_cast< int32_t >(uniform(random, 0, 1)));
+        transaction->set_amount(static_cast< int32_t >(uniform(random, 100, 1'000'000)));
+        *transaction->mutable_timestamp() = now - TimeUtil::SecondsToDuration(uniform(random, 0, 365 * SECONDS_PER_DAY));
+        transaction->set_comment("Load generator");
+        return invoke< CreateTransactionResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.CreateTransaction(context, request, response);
+        });
+    }
+    case ERpc::GET_STATISTICS: {
+        GetStatisticsRequest request;
+        request.mutable_auth()->set_token(token);
+        *request.mutable_from_date() = now - TimeUtil::SecondsToDuration(30 * SECONDS_PER_DAY);
+        *request.mutable_to_date() = now;
+        return invoke< StatisticsResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.GetStatistics(context, request, response);
+        });
+    }
+    case ERpc::GET_CATEGORIES: {
+        GetCategoriesRequest request;
+        request.mutable_auth()->set_token(token);
+        return invoke< CategoriesResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.GetCategories(context, request, response);
+        });
+    }
+    case ERpc::GET_CHARACTERS: {
+        GetCharactersRequest request;
+        request.mutable_auth()->set_token(token);
+        return invoke< CharactersResponse >(settings_.deadline, [&](auto * context, auto * response) {
+            return stub.GetCharacters(context, request, response);
+        });
+    }
+    }
+    return ECallResult::RPC_FAILED;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <backend/loadgen/load_generator.h>
+#include <proto/wallet/service.grpc.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wallet {
+
+    /**
+     * @brief Synthetic receipt QR codes in the format of fiscal receipts
+     *
+     * Without a pool every payload names a new receipt, so the server inserts it and queues
+     * an OFD request. With a pool the payloads repeat, which models users rescanning
+     * receipts and exercises the duplicate path.
+     */
+    class QRPayloadGenerator final {
+    public:
+        /**
+         * @param poolSize Number of distinct receipts, zero for an unlimited number
+         * @param seed Seed of the fiscal document numbers, runs with different seeds do not collide
+         */
+        QRPayloadGenerator(std::size_t poolSize, uint64_t seed);
+
+        /**
+         * @brief Returns the next payload, thread-safe
+         */
+        std::string next(std::mt19937_64 & random);
+
+    private:
+        std::string make(uint64_t documentNumber, std::mt19937_64 & random) const;
+
+    private:
+        std::vector< std::string > pool_;
+        std::atomic< uint64_t > nextDocument_;
+    };
+
+    /**
+     * @brief Issues FinanceService requests with synthetic data for the load generator
+     */
+    class FinanceDriver final {
+    public:
+        struct Settings {
+            std::chrono::milliseconds deadline{ 5'000 }; /**< Deadline of every call */
+            std::string devicePrefix = "loadgen-device-"; /**< Device ids of the token pool are the prefix and an index */
+            std::size_t qrPool = 0;                      /**< See QRPayloadGenerator */
+            uint64_t seed = 0;
+        };
+
+    public:
+        /**
+         * @param stubs Stubs of separate channels, the workers are spread over them
+         * @param tokens Pool of user tokens, every request is made on behalf of a random one
+         * @throws std::invalid_argument if there are no stubs or tokens
+         */
+        FinanceDriver(std::vector< std::unique_ptr< FinanceService::Stub > > stubs, std::vector< std::string > tokens, Settings settings);
+
+        /**
+         * @brief Authenticates count devices and returns their tokens
+         *
+         * New devices are registered, so the first run against an empty database also creates the users.
+         *
+         * @throws std::runtime_error if a device cannot be authenticated
+         */
+        static std::vector< std::string > acquireTokens(FinanceService::Stub & stub, std::size_t count, const Settings & settings);
+
+        /**
+         * @brief Sends one request of the RPC, thread-safe
+         */
+        ECallResult call(ERpc rpc, std::size_t worker);
+
+    private:
+        const Settings settings_;
+        const std::vector< std::unique_ptr< FinanceService::Stub > > stubs_;
+        const std::vector< std::string > tokens_;
+        QRPayloadGenerator qrPayloads_;
+        std::atomic< uint64_t > nextSeed_;
+    };
+
+} // namespace wallet
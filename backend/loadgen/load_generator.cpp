@@ -0,0 +1,277 @@
+#include "load_generator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace wallet;
+
+namespace {
+
+    constexpr std::array< std::pair< ERpc, std::string_view >, 8 > RPC_NAMES = { {
+     { ERpc::AUTHENTICATE, "Authenticate" },
+     { ERpc::PROCESS_QR_CODE, "ProcessQRCode" },
+     { ERpc::GET_RECEIPTS, "GetReceipts" },
+     { ERpc::GET_TRANSACTIONS, "GetTransactions" },
+     { ERpc::CREATE_TRANSACTION, "CreateTransaction" },
+     { ERpc::GET_STATISTICS, "GetStatistics" },
+     { ERpc::GET_CATEGORIES, "GetCategories" },
+     { ERpc::GET_CHARACTERS, "GetCharacters" },
+    } };
+
+    /**
+     * @brief Counters and latencies of one RPC shared by all workers
+     */
+    struct RpcRecorder {
+        std::atomic< uint64_t > ok{ 0 };
+        std::atomic< uint64_t > errorResponses{ 0 };
+        std::atomic< uint64_t > failed{ 0 };
+        cxx::Histogram latency;
+
+        void record(ECallResult result, std::chrono::nanoseconds elapsed) {
+            switch (result) {
+            case ECallResult::OK:
+                ok.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case ECallResult::ERROR_RESPONSE:
+                errorResponses.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case ECallResult::RPC_FAILED:
+                failed.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            latency.record(elapsed);
+        }
+    };
+
+    double toMilliseconds(uint64_t microseconds) {
+        return static_cast< double >(microseconds) / 1000.0;
+    }
+
+    void appendRow(std::string & out, std::string_view name, const RpcStats & stats, double seconds) {
+        std::array< char, 256 > line{};
+        const auto rps = seconds > 0.0 ? static_cast< double >(stats.count()) / seconds : 0.0;
+        std::snprintf(line.data(), line.size(), "%-20.*s %10llu %10.1f %8llu %8llu %9.2f %9.2f %9.2f %9.2f\n",
+                      static_cast< int >(name.size()), name.data(),
+                      static_cast< unsigned long long >(stats.count()), rps,
+                      static_cast< unsigned long long >(stats.errorResponses), static_cast< unsigned long long >(stats.failed),
+                      toMilliseconds(stats.latency.quantile(0.5)), toMilliseconds(stats.latency.quantile(0.99)),
+                      toMilliseconds(stats.latency.quantile(0.999)), toMilliseconds(stats.latency.max()));
+        out += line.data();
+    }
+
+} // unnamed namespace
+
+std::string_view wallet::rpcName(ERpc rpc) noexcept {
+    for (const auto & [value, name]: RPC_NAMES) {
+        if (value == rpc) {
+            return name;
+        }
+    }
+    return "Unknown";
+}
+
+std::optional< ERpc > wallet::parseRpc(std::string_view name) noexcept {
+    for (const auto & [value, rpcName]: RPC_NAMES) {
+        if (rpcName == name) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+RequestMix::RequestMix()
+  : RequestMix(Weights{
+     { ERpc::GET_TRANSACTIONS, 35 },
+     { ERpc::GET_STATISTICS, 15 },
+     { ERpc::GET_RECEIPTS, 10 },
+     { ERpc::PROCESS_QR_CODE, 15 },
+     { ERpc::CREATE_TRANSACTION, 10 },
+     { ERpc::GET_CATEGORIES, 10 },
+     { ERpc::GET_CHARACTERS, 5 },
+    }) {
+}
+
+RequestMix::RequestMix(Weights weights)
+  : weights_(std::move(weights)) {
+    std::erase_if(weights_, [](const auto & weight) {
+        return weight.second == 0;
+    });
+    if (weights_.empty()) {
+        throw std::invalid_argument("Request mix has no RPCs");
+    }
+
+    uint64_t sum = 0;
+    cumulative_.reserve(weights_.size());
+    for (const auto & [rpc, weight]: weights_) {
+        sum += weight;
+        cumulative_.push_back(sum);
+    }
+}
+
+std::optional< RequestMix > RequestMix::parse(std::string_view spec) {
+    Weights weights;
+    while (!spec.empty()) {
+        const auto comma = spec.find(',');
+        const auto entry = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+
+        const auto separator = entry.find('=');
+        if (separator == std::string_view::npos) {
+            return std::nullopt;
+        }
+        const auto rpc = parseRpc(entry.substr(0, separator));
+        const auto value = entry.substr(separator + 1);
+        uint32_t weight = 0;
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), weight);
+        if (!rpc.has_value() || ec != std::errc() || ptr != value.data() + value.size()) {
+            return std::nullopt;
+        }
+        weights.emplace_back(*rpc, weight);
+    }
+
+    const bool hasPositive = std::any_of(weights.begin(), weights.end(), [](const auto & weight) {
+        return weight.second > 0;
+    });
+    if (!hasPositive) {
+        return std::nullopt;
+    }
+    return RequestMix(std::move(weights));
+}
+
+ERpc RequestMix::pick(std::mt19937_64 & random) const {
+    const auto value = std::uniform_int_distribution< uint64_t >(0, cumulative_.back() - 1)(random);
+    const auto it = std::upper_bound(cumulative_.begin(), cumulative_.end(), value);
+    return weights_[static_cast< std::size_t >(it - cumulative_.begin())].first;
+}
+
+const RequestMix::Weights & RequestMix::weights() const noexcept {
+    return weights_;
+}
+
+uint64_t RpcStats::count() const noexcept {
+    return ok + errorResponses + failed;
+}
+
+RpcStats LoadReport::total() const {
+    RpcStats result;
+    for (const auto & [rpc, stats]: rpcs) {
+        result.ok += stats.ok;
+        result.errorResponses += stats.errorResponses;
+        result.failed += stats.failed;
+        result.latency.merge(stats.latency);
+    }
+    return result;
+}
+
+double LoadReport::achievedQps() const {
+    const double seconds = std::chrono::duration< double >(elapsed).count();
+    return seconds > 0.0 ? static_cast< double >(total().count()) / seconds : 0.0;
+}
+
+std::string LoadReport::format() const {
+    const double seconds = std::chrono::duration< double >(elapsed).count();
+
+    std::string out;
+    std::array< char, 128 > window{};
+    if (targetQps > 0.0) {
+        std::snprintf(window.data(), window.size(), "Window %.1f s, open loop, target %.1f QPS, achieved %.1f QPS\n", seconds, targetQps, achievedQps());
+    } else {
+        std::snprintf(window.data(), window.size(), "Window %.1f s, closed loop, achieved %.1f QPS\n", seconds, achievedQps());
+    }
+    out += window.data();
+    out += "RPC                       Count        RPS   Errors   Failed    p50 ms    p99 ms   p999 ms    max ms\n";
+    for (const auto & [rpc, stats]: rpcs) {
+        appendRow(out, rpcName(rpc), stats, seconds);
+    }
+    appendRow(out, "Total", total(), seconds);
+    return out;
+}
+
+LoadGenerator::LoadGenerator(Settings settings)
+  : settings_(std::move(settings)) {
+    if (settings_.concurrency == 0) {
+        throw std::invalid_argument("Concurrency must be positive");
+    }
+}
+
+LoadReport LoadGenerator::run(const Call & call) const {
+    std::map< ERpc, std::unique_ptr< RpcRecorder > > recorders;
+    for (const auto & [rpc, weight]: settings_.mix.weights()) {
+        recorders.try_emplace(rpc, std::make_unique< RpcRecorder >());
+    }
+
+    const bool openLoop = settings_.qps > 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    const auto measureFrom = start + settings_.warmup;
+    const auto end = measureFrom + settings_.duration;
+    std::atomic< uint64_t > nextTicket{ 0 };
+    // Nanoseconds from measureFrom, late completions stretch the window so RPS is the achieved rate
+    std::atomic< int64_t > lastCompletion{ 0 };
+
+    const auto worker = [&](std::size_t index) {
+        std::seed_seq seed{ settings_.seed, static_cast< uint64_t >(index) };
+        std::mt19937_64 random(seed);
+
+        while (true) {
+            std::chrono::steady_clock::time_point scheduled;
+            if (openLoop) {
+                // The schedule is shared: a worker that is late takes the oldest unsent request
+                const auto ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+                scheduled = start + std::chrono::nanoseconds(static_cast< int64_t >(static_cast< double >(ticket) * 1e9 / settings_.qps));
+                if (scheduled >= end) {
+                    break;
+                }
+                std::this_thread::sleep_until(scheduled);
+            } else {
+                scheduled = std::chrono::steady_clock::now();
+                if (scheduled >= end) {
+                    break;
+                }
+            }
+
+            const auto rpc = settings_.mix.pick(random);
+            ECallResult result = ECallResult::RPC_FAILED;
+            try {
+                result = call(rpc, index);
+            } catch (const std::exception &) {
+            }
+
+            if (scheduled >= measureFrom) {
+                const auto completed = std::chrono::steady_clock::now();
+                recorders.at(rpc)->record(result, completed - scheduled);
+
+                const int64_t offset = std::chrono::duration_cast< std::chrono::nanoseconds >(completed - measureFrom).count();
+                auto last = lastCompletion.load(std::memory_order_relaxed);
+                while (last < offset && !lastCompletion.compare_exchange_weak(last, offset, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    threads.reserve(settings_.concurrency);
+    for (std::size_t index = 0; index < settings_.concurrency; ++index) {
+        threads.emplace_back(worker, index);
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+
+    LoadReport report;
+    report.elapsed = std::chrono::nanoseconds(lastCompletion.load());
+    report.targetQps = settings_.qps;
+    for (const auto & [rpc, recorder]: recorders) {
+        auto & stats = report.rpcs[rpc];
+        stats.ok = recorder->ok.load();
+        stats.errorResponses = recorder->errorResponses.load();
+        stats.failed = recorder->failed.load();
+        stats.latency = recorder->latency.snapshot();
+    }
+    return report;
+}
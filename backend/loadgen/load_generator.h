@@ -0,0 +1,169 @@
+#pragma once
+
+#include <utils/metrics/registry/histogram.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace wallet {
+
+    /**
+     * @brief RPCs of FinanceService the load generator can issue
+     */
+    enum class ERpc {
+        AUTHENTICATE,
+        PROCESS_QR_CODE,
+        GET_RECEIPTS,
+        GET_TRANSACTIONS,
+        CREATE_TRANSACTION,
+        GET_STATISTICS,
+        GET_CATEGORIES,
+        GET_CHARACTERS
+    };
+
+    /**
+     * @brief Method name of the RPC as in service.proto
+     */
+    std::string_view rpcName(ERpc rpc) noexcept;
+
+    /**
+     * @brief Finds the RPC by its method name
+     */
+    std::optional< ERpc > parseRpc(std::string_view name) noexcept;
+
+    /**
+     * @brief Weighted choice of the next RPC
+     */
+    class RequestMix final {
+    public:
+        using Weights = std::vector< std::pair< ERpc, uint32_t > >;
+
+    public:
+        /**
+         * @brief Read-heavy mix of a mobile client: lists and statistics dominate, every sixth request scans a receipt
+         */
+        RequestMix();
+
+        /**
+         * @param weights RPCs with positive weights
+         * @throws std::invalid_argument if there are no positive weights
+         */
+        explicit RequestMix(Weights weights);
+
+        /**
+         * @brief Parses "GetTransactions=40,ProcessQRCode=10,..."
+         * @return Mix or empty if a name is unknown or a weight is not a number
+         */
+        static std::optional< RequestMix > parse(std::string_view spec);
+
+        /**
+         * @brief Picks an RPC with probability proportional to its weight
+         */
+        ERpc pick(std::mt19937_64 & random) const;
+
+        const Weights & weights() const noexcept;
+
+    private:
+        Weights weights_;
+        std::vector< uint64_t > cumulative_;
+    };
+
+    /**
+     * @brief Outcome of one request
+     */
+    enum class ECallResult {
+        OK,             /**< Successful response */
+        ERROR_RESPONSE, /**< The service answered with ErrorInfo */
+        RPC_FAILED      /**< Non-OK gRPC status, e.g. deadline exceeded or unavailable */
+    };
+
+    /**
+     * @brief Results of one RPC over the measured window
+     */
+    struct RpcStats {
+        uint64_t ok = 0;
+        uint64_t errorResponses = 0;
+        uint64_t failed = 0;
+        cxx::Histogram::Snapshot latency; /**< Microseconds */
+
+        uint64_t count() const noexcept;
+    };
+
+    /**
+     * @brief Results of a load run
+     */
+    struct LoadReport {
+        std::chrono::nanoseconds elapsed{ 0 }; /**< From the start of the measured window to the last measured completion */
+        double targetQps = 0.0;                /**< Zero for a closed-loop run */
+        std::map< ERpc, RpcStats > rpcs;
+
+        /**
+         * @brief Stats of all RPCs together
+         */
+        RpcStats total() const;
+
+        /**
+         * @brief Completed calls per second, below targetQps once the server saturates
+         */
+        double achievedQps() const;
+
+        /**
+         * @brief Renders a table with throughput and p50/p99/p999/max latency per RPC
+         */
+        std::string format() const;
+    };
+
+    /**
+     * @brief Drives a call function with a request mix and measures the latency of every call
+     *
+     * Each of the concurrency workers has one request in flight. In the closed-loop mode
+     * (qps = 0) a worker sends the next request as soon as the previous one returns, which
+     * finds the maximum throughput.
+     *
+     * In the open-loop mode requests are scheduled at fixed intervals of 1 / qps regardless of
+     * how fast the server answers, and latency is measured from the scheduled start rather
+     * than from the moment a worker got to send the request. So when the server stalls, the
+     * requests that should have been sent meanwhile are charged with the waiting time instead
+     * of being silently omitted from the statistics (coordinated omission). If the workers
+     * cannot keep up with the schedule, the report shows it as growing latency.
+     */
+    class LoadGenerator final {
+    public:
+        /**
+         * @brief Sends one request of the RPC on behalf of the worker
+         *
+         * Called concurrently from all workers, worker is in [0, concurrency).
+         */
+        using Call = std::function< ECallResult(ERpc rpc, std::size_t worker) >;
+
+        struct Settings {
+            std::size_t concurrency = 16;
+            double qps = 0.0; /**< Target request rate, zero for a closed loop */
+            std::chrono::milliseconds duration{ 30'000 };
+            std::chrono::milliseconds warmup{ 0 }; /**< Requests scheduled during the warmup are not recorded */
+            RequestMix mix;
+            uint64_t seed = 0;
+        };
+
+    public:
+        explicit LoadGenerator(Settings settings);
+
+        /**
+         * @brief Runs the load for warmup + duration and blocks until the last request returns
+         */
+        LoadReport run(const Call & call) const;
+
+    private:
+        const Settings settings_;
+    };
+
+} // namespace wallet
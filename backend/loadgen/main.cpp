@@ -0,0 +1,207 @@
+#include <backend/loadgen/finance_driver.h>
+#include <backend/loadgen/load_generator.h>
+#include <backend/service/service.h>
+#include <backend/service/sqlite/sqlite_profile.h>
+
+#include <grpcpp/create_channel.h>
+#include <grpcpp/server_builder.h>
+#include <spdlog/sinks/stdout_sinks.h>
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+    /**
+     * @brief Command line options of the load generator
+     */
+    struct LoadOptions {
+        std::string target = "localhost:50051"; /**< Address of a running server */
+        std::string sqlitePath;                 /**< Runs the service in-process over this database instead */
+        std::size_t channels = 1;               /**< Separate connections, each has its own HTTP/2 stream limit */
+        std::size_t tokens = 16;                /**< Simulated users */
+        std::chrono::milliseconds deadline{ 5'000 };
+        wallet::LoadGenerator::Settings load;
+        wallet::FinanceDriver::Settings driver;
+    };
+
+    template < typename T >
+    std::optional< T > parseNumber(std::string_view value) {
+        T result{};
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc() || ptr != value.data() + value.size()) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Sets a numeric option
+     * @return False if the value is not a number or is below the minimum
+     */
+    template < typename T >
+    bool setNumber(std::string_view value, T minimum, T & target) {
+        const auto number = parseNumber< T >(value);
+        if (!number.has_value() || *number < minimum) {
+            return false;
+        }
+        target = *number;
+        return true;
+    }
+
+    bool setMilliseconds(std::string_view value, int64_t minimum, std::chrono::milliseconds & target) {
+        int64_t milliseconds = 0;
+        if (!setNumber(value, minimum, milliseconds)) {
+            return false;
+        }
+        target = std::chrono::milliseconds(milliseconds);
+        return true;
+    }
+
+    /**
+     * @brief Parses --target=HOST:PORT, --sqlite=PATH, --concurrency=N, --qps=N, --duration-ms=N, --warmup-ms=N,
+     * --deadline-ms=N, --mix=NAME=WEIGHT,..., --tokens=N, --token-prefix=S, --qr-pool=N, --channels=N and --seed=N
+     * @return Parsed options or empty on invalid arguments
+     */
+    std::optional< LoadOptions > parseOptions(int argc, char ** argv) {
+        LoadOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg(argv[i]);
+            const auto separator = arg.find('=');
+            const auto name = arg.substr(0, separator);
+            const auto value = separator == std::string_view::npos ? std::string_view() : arg.substr(separator + 1);
+
+            bool valid = !value.empty();
+            if (name == "--target") {
+                options.target = value;
+            } else if (name == "--sqlite") {
+                options.sqlitePath = value;
+            } else if (name == "--token-prefix") {
+                options.driver.devicePrefix = value;
+            } else if (name == "--mix") {
+                auto mix = wallet::RequestMix::parse(value);
+                valid = mix.has_value();
+                if (valid) {
+                    options.load.mix = std::move(*mix);
+                }
+            } else if (name == "--concurrency") {
+                valid = setNumber< std::size_t >(value, 1, options.load.concurrency);
+            } else if (name == "--qps") {
+                valid = setNumber(value, 0.0, options.load.qps);
+            } else if (name == "--duration-ms") {
+                valid = setMilliseconds(value, 1, options.load.duration);
+            } else if (name == "--warmup-ms") {
+                valid = setMilliseconds(value, 0, options.load.warmup);
+            } else if (name == "--deadline-ms") {
+                valid = setMilliseconds(value, 1, options.deadline);
+            } else if (name == "--tokens") {
+                valid = setNumber< std::size_t >(value, 1, options.tokens);
+            } else if (name == "--qr-pool") {
+                valid = setNumber< std::size_t >(value, 0, options.driver.qrPool);
+            } else if (name == "--channels") {
+                valid = setNumber< std::size_t >(value, 1, options.channels);
+            } else if (name == "--seed") {
+                valid = setNumber< uint64_t >(value, 0, options.load.seed);
+            } else {
+                valid = false;
+            }
+
+            if (!valid) {
+                SPDLOG_ERROR("Invalid argument: {}", arg);
+                return std::nullopt;
+            }
+        }
+        options.driver.deadline = options.deadline;
+        options.driver.seed = options.load.seed;
+        return options;
+    }
+
+    /**
+     * @brief Service over a SQLite database served in-process, without sockets
+     */
+    struct EmbeddedServer {
+        std::shared_ptr< cxx::SQLiteDatabase > db;
+        std::shared_ptr< wallet::FinanceServiceImpl > service;
+        std::unique_ptr< grpc::Server > server;
+    };
+
+    std::unique_ptr< EmbeddedServer > startEmbeddedServer(const std::string & path, std::size_t concurrency) {
+        auto embedded = std::make_unique< EmbeddedServer >();
+        // Every worker has one request in flight, each holding at most one connection
+        cxx::SQLiteDatabase::Settings settings;
+        settings.poolSize = concurrency;
+        embedded->db = wallet::openSqliteDatabase(path, std::move(settings));
+        embedded->service = std::make_shared< wallet::FinanceServiceImpl >(embedded->db);
+
+        grpc::ServerBuilder builder;
+        builder.RegisterService(embedded->service.get());
+        embedded->server = builder.BuildAndStart();
+        return embedded;
+    }
+
+    std::shared_ptr< grpc::Channel > createChannel(const LoadOptions & options, EmbeddedServer * embedded, std::size_t index) {
+        grpc::ChannelArguments arguments;
+        // Without a distinct argument gRPC shares one subchannel between all channels to the same target
+        arguments.SetInt("wallet.loadgen.channel", static_cast< int >(index));
+        if (embedded != nullptr) {
+            return embedded->server->InProcessChannel(arguments);
+        }
+        return grpc::CreateCustomChannel(options.target, grpc::InsecureChannelCredentials(), arguments);
+    }
+
+} // unnamed namespace
+
+int main(int argc, char ** argv) {
+    auto logger = spdlog::stdout_logger_mt("loadgen");
+    logger->set_level(spdlog::level::info);
+    spdlog::set_default_logger(std::move(logger));
+
+    // Отключаем xDS клиент
+    setenv("GRPC_XDS_BOOTSTRAP", "{}", 1);
+
+    const auto options = parseOptions(argc, argv);
+    if (!options.has_value()) {
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::unique_ptr< EmbeddedServer > embedded;
+        if (!options->sqlitePath.empty()) {
+            embedded = startEmbeddedServer(options->sqlitePath, options->load.concurrency);
+            SPDLOG_INFO("Serving {} in-process", options->sqlitePath);
+        }
+
+        std::vector< std::unique_ptr< wallet::FinanceService::Stub > > stubs;
+        for (std::size_t i = 0; i < options->channels; ++i) {
+            stubs.push_back(wallet::FinanceService::NewStub(createChannel(*options, embedded.get(), i)));
+        }
+
+        auto tokens = wallet::FinanceDriver::acquireTokens(*stubs.front(), options->tokens, options->driver);
+        SPDLOG_INFO("Authenticated {} devices", tokens.size());
+
+        wallet::FinanceDriver driver(std::move(stubs), std::move(tokens), options->driver);
+        const wallet::LoadGenerator generator(options->load);
+        SPDLOG_INFO("Running {} workers for {} ms after {} ms of warmup", options->load.concurrency, options->load.duration.count(), options->load.warmup.count());
+
+        const auto report = generator.run([&driver](wallet::ERpc rpc, std::size_t worker) {
+            return driver.call(rpc, worker);
+        });
+        std::fputs(report.format().c_str(), stdout);
+
+        if (embedded) {
+            embedded->server->Shutdown();
+        }
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Load run failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
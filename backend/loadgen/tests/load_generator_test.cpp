@@ -0,0 +1,141 @@
+#include <backend/loadgen/finance_driver.h>
+#include <backend/loadgen/load_generator.h>
+#include <backend/receipt/data/qr/qr.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace wallet;
+using namespace std::chrono_literals;
+
+TEST(RequestMixTest, ParsesWeights) {
+    const auto mix = RequestMix::parse("GetTransactions=3,ProcessQRCode=1,GetCategories=0");
+
+    ASSERT_TRUE(mix.has_value());
+    const RequestMix::Weights expected = { { ERpc::GET_TRANSACTIONS, 3 }, { ERpc::PROCESS_QR_CODE, 1 } };
+    EXPECT_EQ(mix->weights(), expected);
+}
+
+TEST(RequestMixTest, RejectsInvalidSpec) {
+    EXPECT_FALSE(RequestMix::parse("").has_value());
+    EXPECT_FALSE(RequestMix::parse("GetTransactions").has_value());
+    EXPECT_FALSE(RequestMix::parse("GetTransactions=x").has_value());
+    EXPECT_FALSE(RequestMix::parse("Unknown=1").has_value());
+    EXPECT_FALSE(RequestMix::parse("GetTransactions=0").has_value());
+    EXPECT_THROW(RequestMix(RequestMix::Weights{}), std::invalid_argument);
+}
+
+TEST(RequestMixTest, PicksProportionallyToWeights) {
+    const RequestMix mix({ { ERpc::GET_TRANSACTIONS, 3 }, { ERpc::GET_RECEIPTS, 1 } });
+    std::mt19937_64 random(42);
+
+    int transactions = 0;
+    constexpr int PICKS = 40'000;
+    for (int i = 0; i < PICKS; ++i) {
+        if (mix.pick(random) == ERpc::GET_TRANSACTIONS) {
+            ++transactions;
+        }
+    }
+    EXPECT_NEAR(static_cast< double >(transactions) / PICKS, 0.75, 0.02);
+}
+
+TEST(LoadGeneratorTest, ClosedLoopCountsResults) {
+    LoadGenerator::Settings settings;
+    settings.concurrency = 4;
+    settings.duration = 100ms;
+    settings.mix = RequestMix({ { ERpc::GET_CATEGORIES, 1 }, { ERpc::GET_CHARACTERS, 1 } });
+
+    std::atomic< uint64_t > calls{ 0 };
+    const auto report = LoadGenerator(settings).run([&calls](ERpc rpc, std::size_t worker) {
+        EXPECT_LT(worker, 4u);
+        ++calls;
+        std::this_thread::sleep_for(1ms);
+        if (rpc == ERpc::GET_CHARACTERS) {
+            throw std::runtime_error("Transport error");
+        }
+        return ECallResult::ERROR_RESPONSE;
+    });
+
+    const auto total = report.total();
+    EXPECT_EQ(total.count(), calls.load());
+    EXPECT_GT(total.count(), 0u);
+    EXPECT_EQ(total.ok, 0u);
+    EXPECT_EQ(report.rpcs.at(ERpc::GET_CATEGORIES).errorResponses, report.rpcs.at(ERpc::GET_CATEGORIES).count());
+    EXPECT_EQ(report.rpcs.at(ERpc::GET_CHARACTERS).failed, report.rpcs.at(ERpc::GET_CHARACTERS).count());
+    EXPECT_NE(report.format().find("GetCategories"), std::string::npos);
+}
+
+TEST(LoadGeneratorTest, OpenLoopChargesQueueingDelay) {
+    // The server needs 20 ms per request but 100 requests per second are scheduled, so every
+    // request waits for the previous ones; a closed loop would report 20 ms for all of them
+    LoadGenerator::Settings settings;
+    settings.concurrency = 1;
+    settings.qps = 100.0;
+    settings.duration = 400ms;
+    settings.mix = RequestMix({ { ERpc::GET_CATEGORIES, 1 } });
+
+    const auto report = LoadGenerator(settings).run([](ERpc, std::size_t) {
+        std::this_thread::sleep_for(20ms);
+        return ECallResult::OK;
+    });
+
+    const auto & stats = report.rpcs.at(ERpc::GET_CATEGORIES);
+    EXPECT_GE(stats.ok, 30u);
+    EXPECT_LE(stats.ok, 40u);
+    EXPECT_GT(stats.latency.max(), 200'000u);
+    EXPECT_GT(stats.latency.quantile(0.5), 100'000u);
+
+    // The server completes 50 requests per second whatever rate is offered
+    EXPECT_EQ(report.targetQps, 100.0);
+    EXPECT_GT(report.elapsed, 600ms);
+    EXPECT_LT(report.achievedQps(), 60.0);
+    EXPECT_NE(report.format().find("target 100.0 QPS"), std::string::npos);
+}
+
+TEST(LoadGeneratorTest, SkipsWarmup) {
+    LoadGenerator::Settings settings;
+    settings.concurrency = 1;
+    settings.qps = 100.0;
+    settings.warmup = 200ms;
+    settings.duration = 100ms;
+    settings.mix = RequestMix({ { ERpc::GET_CATEGORIES, 1 } });
+
+    std::atomic< uint64_t > calls{ 0 };
+    const auto report = LoadGenerator(settings).run([&calls](ERpc, std::size_t) {
+        ++calls;
+        return ECallResult::OK;
+    });
+
+    EXPECT_EQ(calls.load(), 30u);
+    EXPECT_EQ(report.total().count(), 10u);
+}
+
+TEST(QRPayloadGeneratorTest, GeneratesUniqueValidCodes) {
+    QRPayloadGenerator generator(0, 7);
+    std::mt19937_64 random(1);
+
+    std::set< uint64_t > documents;
+    for (int i = 0; i < 1000; ++i) {
+        const auto payload = generator.next(random);
+        ASSERT_TRUE(isValidQRData(payload)) << payload;
+        documents.insert(parseQRFields(payload).i);
+    }
+    EXPECT_EQ(documents.size(), 1000u);
+}
+
+TEST(QRPayloadGeneratorTest, RepeatsPooledCodes) {
+    QRPayloadGenerator generator(5, 7);
+    std::mt19937_64 random(1);
+
+    std::set< std::string > payloads;
+    for (int i = 0; i < 1000; ++i) {
+        payloads.insert(generator.next(random));
+    }
+    EXPECT_EQ(payloads.size(), 5u);
+}
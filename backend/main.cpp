@@ -1,42 +1,263 @@
+#include <backend/receipt/enrichment/enrichment_service.h>
+#include <backend/receipt/ofd/cached/cached_ofd.h>
+#include <backend/receipt/ofd/http/http_ofd.h>
+#include <backend/service/async/async_service.h>
+#include <backend/service/metrics/rpc_metrics_interceptor.h>
 #include <backend/service/service.h>
+#include <backend/service/sqlite/sqlite_profile.h>
 #include <utils/database/postgres/psql_database.h>
+#include <utils/executor/thread_pool/thread_pool.h>
+#include <utils/http/client/curl_multi/curl_multi_http_client.h>
+#include <utils/metrics/http/metrics_http_server.h>
 
+#include <grpcpp/resource_quota.h>
 #include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 using grpc::Server;
 using grpc::ServerBuilder;
 
-void runServer() {
+namespace {
+
+    /**
+     * @brief Server threading mode
+     */
+    enum class EServerMode {
+        SYNC, /**< Blocking handlers on the gRPC thread pool */
+        ASYNC /**< Callback handlers, blocking work on a dedicated database executor */
+    };
+
+    /**
+     * @brief Command line options of the server
+     */
+    struct ServerOptions {
+        EServerMode mode = EServerMode::SYNC;
+        std::size_t grpcThreads = std::max< std::size_t >(2, std::thread::hardware_concurrency()); /**< Max gRPC threads */
+        std::size_t dbThreads = std::max< std::size_t >(4, std::thread::hardware_concurrency() * 2); /**< Database executor threads */
+        std::size_t dbQueueSize = 1024;                                                             /**< Pending requests before rejecting */
+        std::size_t exportThreads = 2;                                                              /**< Export executor threads */
+        std::size_t exportQueueSize = 16;                                                           /**< Pending exports before rejecting */
+        std::size_t ofdWorkers = 4;                                                                 /**< Concurrent OFD requests of the enrichment */
+        std::size_t metricsPort = 50052;                                                            /**< Local port of the Prometheus endpoint */
+        std::string sqlitePath;                                                                     /**< Embedded single-node mode over this SQLite database */
+    };
+
+    std::optional< std::size_t > parseSize(std::string_view value) {
+        std::size_t result = 0;
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc() || ptr != value.data() + value.size() || result == 0) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Parses --mode=sync|async, --grpc-threads=N, --db-threads=N, --db-queue=N, --export-threads=N,
+     * --export-queue=N, --ofd-workers=N, --metrics-port=N
+     * and --sqlite=PATH
+     *
+     * --sqlite=:memory: is only accepted in sync mode: the in-memory database has a single
+     * connection, so every request waits for the previous one and an export holds it for the
+     * whole stream.
+     * @return Parsed options or empty on invalid arguments
+     */
+    std::optional< ServerOptions > parseOptions(int argc, char ** argv) {
+        ServerOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg(argv[i]);
+            const auto separator = arg.find('=');
+            const auto name = arg.substr(0, separator);
+            const auto value = separator == std::string_view::npos ? std::string_view() : arg.substr(separator + 1);
+
+            if (name == "--mode" && (value == "sync" || value == "async")) {
+                options.mode = value == "sync" ? EServerMode::SYNC : EServerMode::ASYNC;
+                continue;
+            }
+            if (name == "--sqlite" && !value.empty()) {
+                options.sqlitePath = value;
+                continue;
+            }
+
+            std::size_t * target = nullptr;
+            if (name == "--grpc-threads") {
+                target = &options.grpcThreads;
+            } else if (name == "--db-threads") {
+                target = &options.dbThreads;
+            } else if (name == "--db-queue") {
+                target = &options.dbQueueSize;
+            } else if (name == "--export-threads") {
+                target = &options.exportThreads;
+            } else if (name == "--export-queue") {
+                target = &options.exportQueueSize;
+            } else if (name == "--ofd-workers") {
+                target = &options.ofdWorkers;
+            } else if (name == "--metrics-port") {
+                target = &options.metricsPort;
+            }
+
+            const auto size = parseSize(value);
+            if (target == nullptr || !size.has_value()) {
+                SPDLOG_ERROR("Invalid argument: {}", arg);
+                return std::nullopt;
+            }
+            *target = *size;
+        }
+        if (options.sqlitePath == ":memory:" && options.mode != EServerMode::SYNC) {
+            SPDLOG_ERROR("--sqlite=:memory: has a single connection and requires --mode=sync");
+            return std::nullopt;
+        }
+        return options;
+    }
+
+    /**
+     * @brief Connections the service needs to never wait for one
+     *
+     * In async mode every executor and export thread holds at most one connection,
+     * in sync mode every gRPC thread does.
+     */
+    std::size_t serviceConnections(const ServerOptions & options) {
+        return options.mode == EServerMode::ASYNC ? options.dbThreads + options.exportThreads : std::max(options.grpcThreads, options.dbThreads);
+    }
+
+    /**
+     * @brief Connects to the PostgreSQL server and exports the pool gauges
+     */
+    std::shared_ptr< cxx::PsqlDatabase > connectPostgres(const ServerOptions & options, cxx::MetricsRegistry & metrics) {
+        const cxx::PsqlDatabase::ConnectionInfo connectionInfo{
+         .dbname = "wallet",
+         .user = "admin",
+         .password = "adminadmin",
+         .host = "10.129.0.5",
+         .port = "5432",
+        };
+        // The enrichment workers take connections of their own
+        const cxx::PsqlDatabase::PoolSettings poolSettings{
+         .minSize = 2,
+         .maxSize = serviceConnections(options) + options.ofdWorkers,
+        };
+
+        auto db = std::make_shared< cxx::PsqlDatabase >();
+        db->connect(connectionInfo, poolSettings);
+
+        if (const auto pool = db->pool(); pool) {
+            metrics.callback("db_pool_connections", "Open database connections", { { "state", "open" } }, [pool]() {
+                return static_cast< double >(pool->size());
+            });
+            metrics.callback("db_pool_connections", "Open database connections", { { "state", "idle" } }, [pool]() {
+                return static_cast< double >(pool->idleCount());
+            });
+            metrics.callback("db_pool_waiting", "Transactions waiting for a database connection", {}, [pool]() {
+                return static_cast< double >(pool->waitingCount());
+            });
+        }
+        return db;
+    }
+
+} // unnamed namespace
+
+void runServer(const ServerOptions & options) {
     const std::string serverAddress("0.0.0.0:50051");
 
-    SPDLOG_INFO("Run server");
+    SPDLOG_INFO("Run server in {} mode", options.mode == EServerMode::SYNC ? "sync" : "async");
+
+    auto & metrics = cxx::MetricsRegistry::global();
+
+    std::shared_ptr< cxx::IDatabase > db;
+    std::shared_ptr< cxx::PsqlDatabase > postgres;
+    if (!options.sqlitePath.empty()) {
+        // The enrichment is not available with SQLite, the requests are the only users of the pool
+        cxx::SQLiteDatabase::Settings settings;
+        settings.poolSize = serviceConnections(options);
+        db = wallet::openSqliteDatabase(options.sqlitePath, std::move(settings));
+        SPDLOG_INFO("Serving SQLite database {}", options.sqlitePath);
+        if (options.sqlitePath == ":memory:") {
+            SPDLOG_WARN("In-memory SQLite database has a single connection, requests are served one at a time");
+        }
+    } else {
+        postgres = connectPostgres(options, metrics);
+        db = postgres;
+    }
+
+    auto service = std::make_shared< wallet::FinanceServiceImpl >(db);
+
+    // Receipt data is fetched from the OFD in the background, only when the API token is provided.
+    // The enrichment queue relies on PostgreSQL row locks, the embedded mode serves scanned receipts without it
+    std::unique_ptr< wallet::ReceiptEnrichmentService > enrichment;
+    const char * ofdToken = std::getenv("OFD_TOKEN");
+    if (!postgres) {
+        SPDLOG_WARN("Receipt enrichment is not available with SQLite");
+    } else if (ofdToken != nullptr) {
+        auto httpClient = std::make_shared< cxx::CurlMultiHttpClient >(cxx::CurlMultiHttpClient::Settings{});
+        auto httpOfd = std::make_shared< wallet::HttpOFD >(std::move(httpClient), wallet::HttpOFD::Settings{ .token = ofdToken });
+        auto ofd = std::make_shared< wallet::CachedOFD >(std::move(httpOfd), postgres, wallet::CachedOFD::Settings{});
 
-    auto db = std::make_unique< cxx::PsqlDatabase >();
-    db->connect(cxx::PsqlDatabase::ConnectionInfo{
-     .dbname = "wallet",
-     .user = "admin",
-     .password = "adminadmin",
-     .host = "10.129.0.5",
-     .port = "5432",
-    });
+        wallet::ReceiptEnrichmentService::Settings enrichmentSettings;
+        enrichmentSettings.concurrency = options.ofdWorkers;
+        enrichment = std::make_unique< wallet::ReceiptEnrichmentService >(postgres, std::move(ofd), enrichmentSettings);
+        enrichment->start();
+    } else {
+        SPDLOG_WARN("OFD_TOKEN is not set, receipt enrichment is disabled");
+    }
 
-    wallet::FinanceServiceImpl service(std::move(db));
+    grpc::ResourceQuota quota("wallet_server");
+    quota.SetMaxThreads(static_cast< int >(options.grpcThreads));
 
     ServerBuilder builder;
+    builder.SetResourceQuota(quota);
     builder.AddListeningPort(serverAddress, grpc::InsecureServerCredentials());
-    builder.RegisterService(&service);
+
+    std::vector< std::unique_ptr< grpc::experimental::ServerInterceptorFactoryInterface > > interceptors;
+    interceptors.push_back(std::make_unique< wallet::RpcMetricsInterceptorFactory >(metrics));
+    builder.experimental().SetInterceptorCreators(std::move(interceptors));
+
+    std::shared_ptr< cxx::ThreadPool > executor;
+    std::shared_ptr< cxx::ThreadPool > exportExecutor;
+    std::unique_ptr< wallet::AsyncFinanceService > asyncService;
+    if (options.mode == EServerMode::ASYNC) {
+        executor = std::make_shared< cxx::ThreadPool >(options.dbThreads, options.dbQueueSize);
+        metrics.callback("wallet_executor_queue_size", "Requests waiting for a database executor thread", {}, [executor]() {
+            return static_cast< double >(executor->queueSize());
+        });
+        exportExecutor = std::make_shared< cxx::ThreadPool >(options.exportThreads, options.exportQueueSize);
+        metrics.callback("wallet_export_queue_size", "Exports waiting for an export executor thread", {}, [exportExecutor]() {
+            return static_cast< double >(exportExecutor->queueSize());
+        });
+        asyncService = std::make_unique< wallet::AsyncFinanceService >(service, executor, exportExecutor);
+        builder.RegisterService(asyncService.get());
+    } else {
+        builder.RegisterService(service.get());
+    }
 
     std::unique_ptr< Server > server(builder.BuildAndStart());
     SPDLOG_INFO("Server listening on {}", serverAddress);
 
+    const cxx::MetricsHttpServer metricsServer(metrics, static_cast< int >(options.metricsPort));
+    SPDLOG_INFO("Metrics available on http://127.0.0.1:{}/metrics", metricsServer.port());
+
     server->Wait();
+
+    if (enrichment) {
+        enrichment->stop();
+    }
+    if (executor) {
+        executor->shutdown();
+    }
+    if (exportExecutor) {
+        exportExecutor->shutdown();
+    }
 }
 
-int main(int, char **) {
+int main(int argc, char ** argv) {
     // Init logger
     auto logger = spdlog::stdout_logger_mt("sdlmain");
 #ifndef NDEBUG
@@ -48,6 +269,11 @@ int main(int, char **) {
 
     // Отключаем xDS клиент
     setenv("GRPC_XDS_BOOTSTRAP", "{}", 1);
-    runServer();
+
+    const auto options = parseOptions(argc, argv);
+    if (!options.has_value()) {
+        return EXIT_FAILURE;
+    }
+    runServer(*options);
     return 0;
 }
@@ -0,0 +1,54 @@
+#include <backend/receipt/data/items/items.h>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <string>
+
+namespace {
+
+    const nlohmann::json ITEM_JSON = nlohmann::json::parse(R"(
+{
+    "nds": 1,
+    "sum": 26699,
+    "name": "PAP.Бум.туал.3сл белая 12рул",
+    "price": 26699,
+    "quantity": 1,
+    "paymentType": 4,
+    "productType": 1,
+    "itemsQuantityMeasure": 0
+})");
+
+    nlohmann::json readOFDItems() {
+        std::ifstream file(OFD_OUT_JSON_PATH);
+        return nlohmann::json::parse(file)["data"]["json"]["items"];
+    }
+
+    void BM_ParseItemFromJson(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(wallet::parseItemFromJson(ITEM_JSON));
+        }
+    }
+    BENCHMARK(BM_ParseItemFromJson);
+
+    void BM_ParseReceiptItemsFromJson(benchmark::State & state) {
+        const auto items = readOFDItems();
+        for (auto _: state) {
+            for (const auto & item: items) {
+                benchmark::DoNotOptimize(wallet::parseItemFromJson(item));
+            }
+        }
+        state.SetItemsProcessed(static_cast< int64_t >(state.iterations() * items.size()));
+    }
+    BENCHMARK(BM_ParseReceiptItemsFromJson);
+
+    void BM_NormalizeItemName(benchmark::State & state) {
+        const std::string name = "  GL.VIL.Нектар\tмультифрукт   0,95л  ";
+        for (auto _: state) {
+            benchmark::DoNotOptimize(wallet::normalizeItemName(name));
+        }
+    }
+    BENCHMARK(BM_NormalizeItemName);
+
+} // unnamed namespace
@@ -1,49 +1,44 @@
 #include "items.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <utils/string/doublespaces/doublespaces.h>
 #include <utils/string/trim.h>
 
 #include <nlohmann/json.hpp>
 
-namespace {
+using namespace wallet;
 
-    wallet::ReceiptItem::ENDSType getNDSType(int ndsInt) {
-        using namespace wallet;
-        return ReceiptItem::ENDSType_IsValid(ndsInt)
-              ? static_cast< ReceiptItem::ENDSType >(ndsInt)
-              : ReceiptItem::NDS_UNKNOWN;
-    }
-
-    wallet::ReceiptItem::EPaymentType getPaymentType(int paymentTypeInt) {
-        using namespace wallet;
-        return ReceiptItem::EPaymentType_IsValid(paymentTypeInt)
-              ? static_cast< ReceiptItem::EPaymentType >(paymentTypeInt)
-              : ReceiptItem::PAYMENT_TYPE_UNKNOWN;
-    }
+auto wallet::normalizeItemName(std::string name) -> std::string {
+    cxx::trim(name);
+    std::replace(name.begin(), name.end(), '\t', ' ');
+    cxx::removeDoubleSpaces(name);
+    return name;
+}
 
-    wallet::ReceiptItem::EProductType getProductType(int productTypeInt) {
-        using namespace wallet;
-        return ReceiptItem::EProductType_IsValid(productTypeInt)
-              ? static_cast< ReceiptItem::EProductType >(productTypeInt)
-              : ReceiptItem::PRODUCT_TYPE_UNKNOWN;
-    }
+auto wallet::getNDSType(int ndsInt) -> ReceiptItem::ENDSType {
+    return ReceiptItem::ENDSType_IsValid(ndsInt)
+          ? static_cast< ReceiptItem::ENDSType >(ndsInt)
+          : ReceiptItem::NDS_UNKNOWN;
+}
 
-    wallet::ReceiptItem::EMeasurementUnit getMeasurementUnit(int measurementUnitInt) {
-        using namespace wallet;
-        return ReceiptItem::EMeasurementUnit_IsValid(measurementUnitInt)
-              ? static_cast< ReceiptItem::EMeasurementUnit >(measurementUnitInt)
-              : ReceiptItem::MEASUREMENT_UNIT_PIECE; // piece by default
-    }
+auto wallet::getPaymentType(int paymentTypeInt) -> ReceiptItem::EPaymentType {
+    return ReceiptItem::EPaymentType_IsValid(paymentTypeInt)
+          ? static_cast< ReceiptItem::EPaymentType >(paymentTypeInt)
+          : ReceiptItem::PAYMENT_TYPE_UNKNOWN;
+}
 
-    std::string convertString(std::string s) {
-        cxx::trim(s);
-        std::replace(s.begin(), s.end(), '\t', ' ');
-        cxx::removeDoubleSpaces(s);
-        return s;
-    }
+auto wallet::getProductType(int productTypeInt) -> ReceiptItem::EProductType {
+    return ReceiptItem::EProductType_IsValid(productTypeInt)
+          ? static_cast< ReceiptItem::EProductType >(productTypeInt)
+          : ReceiptItem::PRODUCT_TYPE_UNKNOWN;
+}
 
-} // unnamed namespace
+auto wallet::getMeasurementUnit(int measurementUnitInt) -> ReceiptItem::EMeasurementUnit {
+    return ReceiptItem::EMeasurementUnit_IsValid(measurementUnitInt)
+          ? static_cast< ReceiptItem::EMeasurementUnit >(measurementUnitInt)
+          : ReceiptItem::MEASUREMENT_UNIT_PIECE; // piece by default
+}
 
 auto wallet::parseItemFromJson(const json & data) -> ReceiptItem {
     if (!data.is_object()) {
@@ -52,7 +47,7 @@ auto wallet::parseItemFromJson(const json & data) -> ReceiptItem {
 
     ReceiptItem item;
 
-    item.set_name(convertString(data["name"].get< std::string >()));
+    item.set_name(normalizeItemName(data["name"].get< std::string >()));
     item.set_price(data["price"].get< double >());
     item.set_quantity(data["quantity"].get< double >());
     item.set_sum(data["sum"].get< double >());
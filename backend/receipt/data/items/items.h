@@ -4,8 +4,23 @@
 
 #include <nlohmann/json_fwd.hpp>
 
+#include <string>
+
 using namespace nlohmann;
 
 namespace wallet {
     auto parseItemFromJson(const json & data) -> ReceiptItem;
+
+    /**
+     * @brief Normalizes an item name: trims it, replaces tabs and collapses repeated spaces
+     */
+    auto normalizeItemName(std::string name) -> std::string;
+
+    /**
+     * @brief Converters of OFD codes, unknown codes map to the default value of the enum
+     */
+    auto getNDSType(int ndsInt) -> ReceiptItem::ENDSType;
+    auto getPaymentType(int paymentTypeInt) -> ReceiptItem::EPaymentType;
+    auto getProductType(int productTypeInt) -> ReceiptItem::EProductType;
+    auto getMeasurementUnit(int measurementUnitInt) -> ReceiptItem::EMeasurementUnit;
 } // namespace wallet
@@ -0,0 +1,95 @@
+#include <backend/receipt/data/qr/qr.h>
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const std::string QR_CODE = "t=20200727T1747&s=432.00&fn=9284000100287274&i=28889&fp=3906849540&n=1";
+
+    // The previous std::regex based implementation, kept for comparison
+    namespace legacy {
+
+        bool isValidQRData(const std::string & data) {
+            std::regex fiscalQRRegex(
+             "t=\\d{8}T\\d{4}&"
+             "s=\\d+\\.?\\d*&"
+             "fn=\\d+&"
+             "i=\\d+&"
+             "fp=\\d+&"
+             "n=\\d+");
+
+            return std::regex_match(data, fiscalQRRegex);
+        }
+
+        wallet::Receipt parseQRDataFromString(const std::string & data) {
+            std::map< std::string, std::string > params;
+            std::regex paramRegex("([^=&]+)=([^=&]+)");
+            auto paramBegin = std::sregex_iterator(data.begin(), data.end(), paramRegex);
+            auto paramEnd = std::sregex_iterator();
+
+            for (auto i = paramBegin; i != paramEnd; ++i) {
+                std::smatch match = *i;
+                params[match[1].str()] = match[2].str();
+            }
+
+            const std::vector< std::string > requiredFields = { "t", "s", "fn", "i", "fp", "n" };
+            for (const auto & field: requiredFields) {
+                if (params.find(field) == params.end()) {
+                    throw std::runtime_error("Missing fields: " + field);
+                }
+            }
+
+            wallet::Receipt receipt;
+            receipt.set_t(params["t"]);
+            receipt.set_s(std::stod(params["s"]));
+            receipt.set_fn(std::stoull(params["fn"]));
+            receipt.set_i(std::stoull(params["i"]));
+            receipt.set_fp(std::stoull(params["fp"]));
+            receipt.set_n(std::stoi(params["n"]));
+            return receipt;
+        }
+
+    } // namespace legacy
+
+    void BM_IsValidQRData(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(wallet::isValidQRData(QR_CODE));
+        }
+    }
+    BENCHMARK(BM_IsValidQRData);
+
+    void BM_IsValidQRDataRegex(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(legacy::isValidQRData(QR_CODE));
+        }
+    }
+    BENCHMARK(BM_IsValidQRDataRegex);
+
+    void BM_ParseQRFields(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(wallet::parseQRFields(QR_CODE));
+        }
+    }
+    BENCHMARK(BM_ParseQRFields);
+
+    void BM_ParseQRDataFromString(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(wallet::parseQRDataFromString(QR_CODE));
+        }
+    }
+    BENCHMARK(BM_ParseQRDataFromString);
+
+    void BM_ParseQRDataFromStringRegex(benchmark::State & state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(legacy::parseQRDataFromString(QR_CODE));
+        }
+    }
+    BENCHMARK(BM_ParseQRDataFromStringRegex);
+
+} // unnamed namespace
@@ -1,74 +1,184 @@
 #include "qr.h"
 
-#include <regex>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <string>
 
-bool wallet::isValidQRData(const std::string & data) {
+namespace {
+
+    /**
+     * @brief Required fields in the order they are reported when missing
+     */
+    enum EField {
+        T,
+        S,
+        FN,
+        I,
+        FP,
+        N,
+        FIELDS_COUNT
+    };
+
+    constexpr std::array< std::string_view, FIELDS_COUNT > FIELD_NAMES = { "t", "s", "fn", "i", "fp", "n" };
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool isSeparator(char c) {
+        return c == '=' || c == '&';
+    }
+
+    /**
+     * @brief Consumes a literal prefix
+     */
+    bool consume(std::string_view & data, std::string_view prefix) {
+        if (!data.starts_with(prefix)) {
+            return false;
+        }
+        data.remove_prefix(prefix.size());
+        return true;
+    }
+
+    /**
+     * @brief Consumes digits, exactly count of them if count is not zero, otherwise at least one
+     */
+    bool consumeDigits(std::string_view & data, std::size_t count = 0) {
+        std::size_t length = 0;
+        while (length < data.size() && isDigit(data[length]) && (count == 0 || length < count)) {
+            ++length;
+        }
+        if (length == 0 || (count != 0 && length != count)) {
+            return false;
+        }
+        data.remove_prefix(length);
+        return true;
+    }
+
+    /**
+     * @brief Consumes an amount: digits, optionally followed by a dot and more digits
+     */
+    bool consumeAmount(std::string_view & data) {
+        if (!consumeDigits(data)) {
+            return false;
+        }
+        if (consume(data, ".") && !data.empty() && isDigit(data.front())) {
+            consumeDigits(data);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Parses the leading number of a value, trailing characters are ignored
+     */
+    template < typename T >
+    bool parseNumber(std::string_view value, T & result) {
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        return ec == std::errc();
+    }
+
+} // unnamed namespace
+
+bool wallet::isValidQRData(std::string_view data) {
     // Проверяем общий формат фискального QR-кода
-    std::regex fiscalQRRegex(
-     "t=\\d{8}T\\d{4}&" // Дата и время (t)
-     "s=\\d+\\.?\\d*&"  // Сумма (s)
-     "fn=\\d+&"         // Номер фискального накопителя (fn)
-     "i=\\d+&"          // Номер фискального документа (i)
-     "fp=\\d+&"         // Фискальный признак (fp)
-     "n=\\d+"           // Тип документа (n)
-    );
-
-    return std::regex_match(data, fiscalQRRegex);
+    return consume(data, "t=") && consumeDigits(data, 8) && consume(data, "T") && consumeDigits(data, 4) // Дата и время (t)
+        && consume(data, "&s=") && consumeAmount(data)                                                   // Сумма (s)
+        && consume(data, "&fn=") && consumeDigits(data)                                                  // Номер фискального накопителя (fn)
+        && consume(data, "&i=") && consumeDigits(data)                                                   // Номер фискального документа (i)
+        && consume(data, "&fp=") && consumeDigits(data)                                                  // Фискальный признак (fp)
+        && consume(data, "&n=") && consumeDigits(data)                                                   // Тип документа (n)
+        && data.empty();
 }
 
-wallet::Receipt wallet::parseQRDataFromString(const std::string & data) {
-    // Парсим параметры QR-кода
-    std::map< std::string, std::string > params;
-    std::regex paramRegex("([^=&]+)=([^=&]+)");
-    auto paramBegin = std::sregex_iterator(data.begin(), data.end(), paramRegex);
-    auto paramEnd = std::sregex_iterator();
+wallet::QRFields wallet::parseQRFields(std::string_view data) {
+    // Парсим параметры QR-кода: пары key=value, где key и value не содержат '=' и '&'
+    std::array< std::string_view, FIELDS_COUNT > values{};
+    std::array< bool, FIELDS_COUNT > found{};
 
-    for (auto i = paramBegin; i != paramEnd; ++i) {
-        std::smatch match = *i;
-        params[match[1].str()] = match[2].str();
-    }
+    std::size_t pos = 0;
+    while (pos < data.size()) {
+        if (isSeparator(data[pos])) {
+            ++pos;
+            continue;
+        }
 
-    // Проверяем наличие всех необходимых полей
-    const std::vector< std::string > requiredFields = { "t", "s", "fn", "i", "fp", "n" };
-    std::vector< std::string > missingFields;
+        const std::size_t keyEnd = data.find_first_of("=&", pos);
+        if (keyEnd == std::string_view::npos) {
+            break;
+        }
+        if (data[keyEnd] == '&' || keyEnd + 1 == data.size() || isSeparator(data[keyEnd + 1])) {
+            pos = keyEnd + 1;
+            continue;
+        }
 
-    for (const auto & field: requiredFields) {
-        if (params.find(field) == params.end()) {
-            missingFields.push_back(field);
+        std::size_t valueEnd = data.find_first_of("=&", keyEnd + 1);
+        if (valueEnd == std::string_view::npos) {
+            valueEnd = data.size();
         }
+
+        const auto key = data.substr(pos, keyEnd - pos);
+        for (std::size_t field = 0; field < FIELDS_COUNT; ++field) {
+            if (key == FIELD_NAMES[field]) {
+                values[field] = data.substr(keyEnd + 1, valueEnd - keyEnd - 1);
+                found[field] = true;
+                break;
+            }
+        }
+        pos = valueEnd;
     }
 
-    if (!missingFields.empty()) {
-        std::string details = "Missing fields: ";
-        for (size_t i = 0; i < missingFields.size(); ++i) {
-            details += missingFields[i];
-            if (i < missingFields.size() - 1) {
-                details += ", ";
+    // Проверяем наличие всех необходимых полей
+    std::string missingFields;
+    for (std::size_t field = 0; field < FIELDS_COUNT; ++field) {
+        if (!found[field]) {
+            if (!missingFields.empty()) {
+                missingFields += ", ";
             }
+            missingFields += FIELD_NAMES[field];
         }
-        throw std::runtime_error(details);
     }
+    if (!missingFields.empty()) {
+        throw std::runtime_error("Missing fields: " + missingFields);
+    }
+
+    QRFields fields;
+    fields.t = values[T];
 
     // Проверка суммы
-    double amount = std::stod(params["s"]);
-    if (amount < 0) {
-        throw std::runtime_error("Invalid amount (s): " + params["s"]);
+    if (!parseNumber(values[S], fields.s) || fields.s < 0) {
+        throw std::runtime_error("Invalid amount (s): " + std::string(values[S]));
     }
 
     // Проверка типа документа
-    int docType = std::stoi(params["n"]);
-    if (docType < 1 || docType > 4) {
-        throw std::runtime_error("Invalid document type (n): " + params["n"]);
+    if (!parseNumber(values[N], fields.n) || fields.n < 1 || fields.n > 4) {
+        throw std::runtime_error("Invalid document type (n): " + std::string(values[N]));
+    }
+
+    if (!parseNumber(values[FN], fields.fn)) {
+        throw std::runtime_error("Invalid fiscal drive number (fn): " + std::string(values[FN]));
     }
+    if (!parseNumber(values[I], fields.i)) {
+        throw std::runtime_error("Invalid fiscal document number (i): " + std::string(values[I]));
+    }
+    if (!parseNumber(values[FP], fields.fp)) {
+        throw std::runtime_error("Invalid fiscal sign (fp): " + std::string(values[FP]));
+    }
+
+    return fields;
+}
+
+wallet::Receipt wallet::parseQRDataFromString(std::string_view data) {
+    const auto fields = parseQRFields(data);
 
     Receipt receipt;
 
-    receipt.set_t(params["t"]);
-    receipt.set_s(amount);
-    receipt.set_fn(std::stoull(params["fn"]));
-    receipt.set_i(std::stoull(params["i"]));
-    receipt.set_fp(std::stoull(params["fp"]));
-    receipt.set_n(docType);
+    receipt.set_t(std::string(fields.t));
+    receipt.set_s(fields.s);
+    receipt.set_fn(fields.fn);
+    receipt.set_i(fields.i);
+    receipt.set_fp(fields.fp);
+    receipt.set_n(fields.n);
 
     return receipt;
 }
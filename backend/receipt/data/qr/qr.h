@@ -2,9 +2,44 @@
 
 #include <proto/wallet/receipt/receipt.pb.h>
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 
 namespace wallet {
-    bool isValidQRData(const std::string & data);
-    Receipt parseQRDataFromString(const std::string & data);
+
+    /**
+     * @brief Fields of a fiscal receipt QR code
+     *
+     * The date view points into the parsed string and is valid while the string is alive.
+     */
+    struct QRFields {
+        std::string_view t; /**< Date and time (yyyyMMddTHHmm[ss]) */
+        double s = 0.0;     /**< Amount */
+        uint64_t fn = 0;    /**< Fiscal drive number */
+        uint64_t i = 0;     /**< Fiscal document number */
+        uint64_t fp = 0;    /**< Fiscal sign */
+        int32_t n = 0;      /**< Document type */
+    };
+
+    /**
+     * @brief Checks that the data is a fiscal QR code in the canonical form
+     *
+     * Accepts exactly "t=<8 digits>T<4 digits>&s=<digits>[.<digits>]&fn=<digits>&i=<digits>&fp=<digits>&n=<digits>".
+     */
+    bool isValidQRData(std::string_view data);
+
+    /**
+     * @brief Parses the key=value pairs of a fiscal QR code without allocating memory
+     *
+     * Pairs may go in any order, unknown keys are ignored, a repeated key overrides the previous value.
+     * @throws std::runtime_error if required fields are missing or have invalid values
+     */
+    QRFields parseQRFields(std::string_view data);
+
+    /**
+     * @brief Parses a fiscal QR code into a receipt
+     * @throws std::runtime_error if required fields are missing or have invalid values
+     */
+    Receipt parseQRDataFromString(std::string_view data);
+
 } // namespace wallet
@@ -0,0 +1,81 @@
+#include <backend/receipt/data/qr/qr.h>
+
+#include <gtest/gtest.h>
+
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace wallet;
+
+namespace {
+
+    void expectError(const std::string & data, const std::string & message) {
+        try {
+            parseQRDataFromString(data);
+            FAIL() << "Expected an error for " << data;
+        } catch (const std::runtime_error & e) {
+            EXPECT_EQ(e.what(), message);
+        }
+    }
+
+} // unnamed namespace
+
+TEST(QRTest, ParsesCanonicalCode) {
+    const auto receipt = parseQRDataFromString("t=20200727T174700&s=432.00&fn=9284000100287274&i=28889&fp=3906849540&n=1");
+
+    EXPECT_EQ(receipt.t(), "20200727T174700");
+    EXPECT_DOUBLE_EQ(receipt.s(), 432.0);
+    EXPECT_EQ(receipt.fn(), 9284000100287274ULL);
+    EXPECT_EQ(receipt.i(), 28889);
+    EXPECT_EQ(receipt.fp(), 3906849540ULL);
+    EXPECT_EQ(receipt.n(), 1);
+}
+
+TEST(QRTest, ParsesPairsInAnyOrder) {
+    const auto fields = parseQRFields("n=2&fp=3&unknown=x&i=2&fn=1&s=10.5&t=20240101T1200&s=11.25");
+
+    EXPECT_EQ(fields.t, "20240101T1200");
+    EXPECT_DOUBLE_EQ(fields.s, 11.25);
+    EXPECT_EQ(fields.fn, 1);
+    EXPECT_EQ(fields.i, 2);
+    EXPECT_EQ(fields.fp, 3);
+    EXPECT_EQ(fields.n, 2);
+}
+
+TEST(QRTest, ReportsMissingFields) {
+    expectError("t=20200727T1747&fn=1&i=2&n=1", "Missing fields: s, fp");
+    expectError("", "Missing fields: t, s, fn, i, fp, n");
+    // Empty values and malformed pairs are not recognized
+    expectError("t=&s==1&fn=1&i=2&fp=3&n=1", "Missing fields: t, s");
+}
+
+TEST(QRTest, ValidatesValues) {
+    expectError("t=1&s=-1&fn=1&i=2&fp=3&n=1", "Invalid amount (s): -1");
+    expectError("t=1&s=1&fn=1&i=2&fp=3&n=5", "Invalid document type (n): 5");
+    expectError("t=1&s=1&fn=1&i=2&fp=3&n=0", "Invalid document type (n): 0");
+    expectError("t=1&s=abc&fn=1&i=2&fp=3&n=1", "Invalid amount (s): abc");
+}
+
+TEST(QRTest, ValidationMatchesFormat) {
+    const std::regex fiscalQRRegex("t=\\d{8}T\\d{4}&s=\\d+\\.?\\d*&fn=\\d+&i=\\d+&fp=\\d+&n=\\d+");
+
+    const std::vector< std::string > inputs = {
+        "t=20200727T1747&s=432.00&fn=9284000100287274&i=28889&fp=3906849540&n=1",
+        "t=20200727T1747&s=432&fn=1&i=2&fp=3&n=1",
+        "t=20200727T1747&s=432.&fn=1&i=2&fp=3&n=1",
+        "t=20200727T174700&s=432.00&fn=1&i=2&fp=3&n=1",
+        "t=2020072T1747&s=1&fn=1&i=2&fp=3&n=1",
+        "t=20200727T1747&s=.5&fn=1&i=2&fp=3&n=1",
+        "t=20200727T1747&s=1.2.3&fn=1&i=2&fp=3&n=1",
+        "t=20200727T1747&s=1&fn=1&i=2&fp=3&n=",
+        "t=20200727T1747&s=1&fn=1&i=2&fp=3&n=1&",
+        "s=1&t=20200727T1747&fn=1&i=2&fp=3&n=1",
+        "",
+    };
+
+    for (const auto & input: inputs) {
+        EXPECT_EQ(isValidQRData(input), std::regex_match(input, fiscalQRRegex)) << input;
+    }
+}
@@ -1,9 +1,36 @@
 #include "receipt_database.h"
+
+#include <cmath>
 #include <stdexcept>
 
 using namespace wallet;
 using namespace cxx;
 
+namespace {
+
+    const std::string INSERT_RECEIPT_DATA_NAME = "receipt_database_insert_receipt_data";
+    const std::string INSERT_RECEIPT_DATA_SQL =
+     "INSERT INTO receipt_data (receipt_id, request_id, retailer_name, retailer_place, retailer_inn, retailer_address) "
+     "VALUES ($1, $2, $3, $4, $5, $6) RETURNING id";
+
+    const std::vector< std::string > RECEIPT_ITEMS_COLUMNS = {
+        "receipt_data_id",
+        "name",
+        "price",
+        "quantity",
+        "amount",
+        "nds_type",
+        "payment_type",
+        "product_type",
+        "measurement_unit",
+    };
+
+    std::optional< std::string > optionalString(bool has, const std::string & value) {
+        return has ? std::optional< std::string >(value) : std::nullopt;
+    }
+
+} // unnamed namespace
+
 bool ReceiptDatabase::Config::isValid() const noexcept {
     return !tableName.empty();
 }
@@ -33,5 +60,58 @@ void ReceiptDatabase::insertReceiptData(const std::string & qrCode) {
     database_->makeTransaction()->insert(config_.tableName, { "qrdata" }, { qrCode });
 }
 
-void ReceiptDatabase::insertReceiptData(const ReceiptData & receipt) {
+std::optional< int32_t > ReceiptDatabase::insertReceiptData(int64_t receiptId, const ReceiptData & receiptData) {
+    auto transaction = database_->makeTransaction();
+    const auto receiptDataId = insertReceiptData(*transaction, receiptId, std::nullopt, receiptData);
+    if (!receiptDataId.has_value()) {
+        transaction->abort();
+        return std::nullopt;
+    }
+    transaction->commit();
+    return receiptDataId;
+}
+
+std::optional< int32_t > ReceiptDatabase::insertReceiptData(
+ ITransaction & transaction,
+ int64_t receiptId,
+ std::optional< int32_t > requestId,
+ const ReceiptData & receiptData) {
+    if (!transaction.prepare(INSERT_RECEIPT_DATA_NAME, INSERT_RECEIPT_DATA_SQL)) {
+        return std::nullopt;
+    }
+
+    const auto & retailer = receiptData.retailer();
+    const auto dataResultOpt = transaction.execPrepared(
+     INSERT_RECEIPT_DATA_NAME,
+     receiptId,
+     requestId,
+     optionalString(retailer.has_name(), retailer.name()),
+     optionalString(retailer.has_place(), retailer.place()),
+     optionalString(retailer.has_inn(), retailer.inn()),
+     optionalString(retailer.has_address(), retailer.address()));
+    if (!dataResultOpt.has_value() || dataResultOpt->empty()) {
+        return std::nullopt;
+    }
+    const auto receiptDataId = dataResultOpt.value()[0][0].as< int32_t >();
+
+    std::vector< std::vector< SqlParam > > rows;
+    rows.reserve(receiptData.items_size());
+    for (const auto & item: receiptData.items()) {
+        rows.push_back({
+         int64_t{ receiptDataId },
+         item.name(),
+         static_cast< int64_t >(std::llround(item.price())),
+         item.quantity(),
+         static_cast< int64_t >(std::llround(item.sum())),
+         static_cast< int64_t >(item.nds_type()),
+         static_cast< int64_t >(item.payment_type()),
+         static_cast< int64_t >(item.product_type()),
+         static_cast< int64_t >(item.measurement_unit()),
+        });
+    }
+    if (!rows.empty() && !transaction.insertBulk("receipt_items", RECEIPT_ITEMS_COLUMNS, rows)) {
+        return std::nullopt;
+    }
+
+    return receiptDataId;
 }
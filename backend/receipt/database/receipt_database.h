@@ -3,7 +3,9 @@
 #include <proto/wallet/receipt/receipt.pb.h>
 #include <utils/database/interface/i_database.h>
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace wallet {
@@ -26,7 +28,33 @@ namespace wallet {
 
         void insertReceipt(const std::string & token, const Receipt & receipt);
         void insertReceiptData(const std::string & qrCode);
-        void insertReceiptData(const std::string & token, const ReceiptData & receipt);
+
+        /**
+         * @brief Stores retailer data and all items of a receipt in one transaction
+         *
+         * @param receiptId Id of the receipt in receipts table
+         * @param receiptData Receipt data received from the OFD
+         * @return Id of the receipt_data row or empty on failure
+         */
+        std::optional< int32_t > insertReceiptData(int64_t receiptId, const ReceiptData & receiptData);
+
+        /**
+         * @brief Stores retailer data and all items of a receipt inside an open transaction
+         *
+         * Items are written with a single ITransaction::insertBulk call, so a receipt
+         * costs two statements regardless of the number of items.
+         *
+         * @param transaction Open transaction, not committed or aborted here
+         * @param receiptId Id of the receipt in receipts table
+         * @param requestId Id of the receipt request the data was fetched for, if any
+         * @param receiptData Receipt data received from the OFD
+         * @return Id of the receipt_data row or empty on failure
+         */
+        static std::optional< int32_t > insertReceiptData(
+         cxx::ITransaction & transaction,
+         int64_t receiptId,
+         std::optional< int32_t > requestId,
+         const ReceiptData & receiptData);
 
         // auto getReceipt
 
@@ -0,0 +1,86 @@
+#include <backend/receipt/database/receipt_database.h>
+#include <utils/database/mock/mock_database.h>
+#include <utils/database/mock/mock_transaction.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+using namespace cxx;
+using namespace wallet;
+using namespace testing;
+
+namespace {
+
+    ReceiptData makeData(int items) {
+        ReceiptData data;
+        data.mutable_retailer()->set_name("Shop");
+        for (int i = 0; i < items; ++i) {
+            auto * item = data.add_items();
+            item->set_name("Item " + std::to_string(i));
+            item->set_price(99.6);
+            item->set_quantity(1.5);
+            item->set_sum(149.4);
+            item->set_nds_type(ReceiptItem_ENDSType_NDS_20);
+        }
+        return data;
+    }
+
+    class ReceiptDatabaseTest: public ::Test {
+    public:
+        void SetUp() override {
+            ON_CALL(*mockDb_, makeTransaction).WillByDefault(Return(mockTransaction_));
+            ON_CALL(*mockTransaction_, prepare).WillByDefault(Return(true));
+            ON_CALL(*mockTransaction_, execPreparedParams).WillByDefault([](const std::string &, const std::vector< SqlParam > &) {
+                QueryResult result(1);
+                result.addInt(7);
+                return result;
+            });
+        }
+
+    protected:
+        const std::shared_ptr< MockDatabase > mockDb_ = std::make_shared< NiceMock< MockDatabase > >();
+        const std::shared_ptr< MockTransaction > mockTransaction_ = std::make_shared< NiceMock< MockTransaction > >();
+        ReceiptDatabase database_{ ReceiptDatabase::Config{ .tableName = "receipt_data" }, mockDb_ };
+    };
+
+    TEST_F(ReceiptDatabaseTest, ItemsAreWrittenWithOneBulkInsert) {
+        EXPECT_CALL(*mockTransaction_, execPreparedParams)
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params.at(0), SqlParam(int64_t{ 42 }));
+             EXPECT_EQ(params.at(1), SqlParam());
+             EXPECT_EQ(params.at(2), SqlParam(std::string("Shop")));
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, insertBulk(StrEq("receipt_items"), _, _))
+         .WillOnce([](const std::string &, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) {
+             EXPECT_EQ(rows.size(), 200);
+             for (const auto & row: rows) {
+                 EXPECT_EQ(row.size(), colNames.size());
+             }
+             EXPECT_EQ(rows.at(199).at(0), SqlParam(int64_t{ 7 }));
+             EXPECT_EQ(rows.at(199).at(1), SqlParam(std::string("Item 199")));
+             EXPECT_EQ(rows.at(199).at(2), SqlParam(int64_t{ 100 }));
+             EXPECT_EQ(rows.at(199).at(3), SqlParam(1.5));
+             EXPECT_EQ(rows.at(199).at(4), SqlParam(int64_t{ 149 }));
+             EXPECT_EQ(rows.at(199).at(5), SqlParam(int64_t{ ReceiptItem_ENDSType_NDS_20 }));
+             return true;
+         });
+        EXPECT_CALL(*mockTransaction_, executeQuery).Times(0);
+        EXPECT_CALL(*mockTransaction_, commit).Times(1);
+
+        EXPECT_EQ(database_.insertReceiptData(42, makeData(200)), 7);
+    }
+
+    TEST_F(ReceiptDatabaseTest, FailedBulkInsertAbortsTransaction) {
+        EXPECT_CALL(*mockTransaction_, insertBulk).WillOnce(Return(false));
+        EXPECT_CALL(*mockTransaction_, abort).Times(1);
+        EXPECT_CALL(*mockTransaction_, commit).Times(0);
+
+        EXPECT_FALSE(database_.insertReceiptData(42, makeData(3)).has_value());
+    }
+
+} // unnamed namespace
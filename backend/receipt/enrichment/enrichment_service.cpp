@@ -0,0 +1,278 @@
+#include "enrichment_service.h"
+
+#include <backend/receipt/database/receipt_database.h>
+
+#include <google/protobuf/util/json_util.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+using namespace wallet;
+
+namespace {
+
+    /**
+     * @brief Named SQL statement executed through the prepared statement cache
+     */
+    struct Statement {
+        std::string name;
+        std::string sql;
+    };
+
+    // Claimed requests are leased: they stay PROCESSING until done or until the lease expires
+    const Statement CLAIM_REQUESTS{
+        "enrichment_claim_requests",
+        "WITH claimed AS ("
+        "  UPDATE receipt_requests rr "
+        "  SET status = 1, attempts = rr.attempts + 1, next_attempt_at = NOW() + make_interval(secs => $2) "
+        "  WHERE rr.id IN ("
+        "    SELECT id FROM receipt_requests "
+        "    WHERE status IN (0, 1) AND next_attempt_at <= NOW() "
+        "    ORDER BY next_attempt_at "
+        "    LIMIT $1 "
+        "    FOR UPDATE SKIP LOCKED"
+        "  ) "
+        "  RETURNING rr.id, rr.receipt_id, rr.attempts"
+        ") "
+        "SELECT c.id, c.attempts, r.id, r.t, r.s, r.fn, r.i, r.fp, r.n "
+        "FROM claimed c JOIN receipts r ON r.id = c.receipt_id"
+    };
+
+    const Statement COMPLETE_REQUEST{
+        "enrichment_complete_request",
+        "UPDATE receipt_requests SET status = 2, ofd_data = $2::jsonb, last_error = NULL WHERE id = $1"
+    };
+
+    const Statement RETRY_REQUEST{
+        "enrichment_retry_request",
+        "UPDATE receipt_requests SET status = 0, next_attempt_at = NOW() + make_interval(secs => $2), last_error = $3 "
+        "WHERE id = $1"
+    };
+
+    const Statement FAIL_REQUEST{
+        "enrichment_fail_request",
+        "UPDATE receipt_requests SET status = 3, last_error = $2 WHERE id = $1"
+    };
+
+    template < typename... Args >
+    std::optional< cxx::QueryResult > execStatement(cxx::ITransaction & transaction, const Statement & statement, Args &&... args) {
+        if (!transaction.prepare(statement.name, statement.sql)) {
+            return std::nullopt;
+        }
+        return transaction.execPrepared(statement.name, std::forward< Args >(args)...);
+    }
+
+} // unnamed namespace
+
+ReceiptEnrichmentService::ReceiptEnrichmentService(std::shared_ptr< cxx::IDatabase > db, std::shared_ptr< OFDInterface > ofd, Settings settings)
+  : db_(std::move(db))
+  , ofd_(std::move(ofd))
+  , settings_(settings)
+  , workers_(std::max< std::size_t >(settings.concurrency, 1)) {
+}
+
+ReceiptEnrichmentService::~ReceiptEnrichmentService() {
+    stop();
+    workers_.shutdown();
+}
+
+void ReceiptEnrichmentService::start() {
+    std::lock_guard lock(mutex_);
+    if (!stopped_) {
+        return;
+    }
+    stopped_ = false;
+    poller_ = std::thread(&ReceiptEnrichmentService::run, this);
+}
+
+void ReceiptEnrichmentService::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    changed_.notify_all();
+
+    if (poller_.joinable()) {
+        poller_.join();
+    }
+
+    std::unique_lock lock(mutex_);
+    changed_.wait(lock, [this]() {
+        return inFlight_ == 0;
+    });
+}
+
+std::size_t ReceiptEnrichmentService::runOnce() {
+    const auto requests = claim(settings_.batchSize);
+
+    std::mutex doneMutex;
+    std::condition_variable doneChanged;
+    std::size_t done = 0;
+
+    for (const auto & request: requests) {
+        const bool submitted = workers_.submit([this, &request, &doneMutex, &doneChanged, &done]() {
+            process(request);
+            std::lock_guard lock(doneMutex);
+            ++done;
+            doneChanged.notify_one();
+        });
+        if (!submitted) {
+            process(request);
+            std::lock_guard lock(doneMutex);
+            ++done;
+        }
+    }
+
+    std::unique_lock lock(doneMutex);
+    doneChanged.wait(lock, [&done, &requests]() {
+        return done == requests.size();
+    });
+    return requests.size();
+}
+
+std::chrono::seconds ReceiptEnrichmentService::backoff(int32_t attempts) const {
+    auto delay = settings_.initialBackoff;
+    for (int32_t i = 1; i < attempts && delay < settings_.maxBackoff; ++i) {
+        delay *= 2;
+    }
+    return std::min(delay, settings_.maxBackoff);
+}
+
+void ReceiptEnrichmentService::run() {
+    SPDLOG_INFO("Receipt enrichment started, concurrency {}", settings_.concurrency);
+
+    const std::size_t concurrency = std::max< std::size_t >(settings_.concurrency, 1);
+    while (true) {
+        std::size_t free = 0;
+        {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [this, concurrency]() {
+                return stopped_ || inFlight_ < concurrency;
+            });
+            if (stopped_) {
+                break;
+            }
+            free = concurrency - inFlight_;
+        }
+
+        std::vector< ClaimedRequest > requests;
+        try {
+            requests = claim(std::min(free, settings_.batchSize));
+        } catch (const std::exception & e) {
+            SPDLOG_ERROR("Failed to claim receipt requests: {}", e.what());
+        }
+
+        if (requests.empty()) {
+            std::unique_lock lock(mutex_);
+            changed_.wait_for(lock, settings_.pollInterval, [this]() {
+                return stopped_;
+            });
+            continue;
+        }
+
+        for (auto & request: requests) {
+            {
+                std::lock_guard lock(mutex_);
+                ++inFlight_;
+            }
+            auto task = [this, request = std::move(request)]() {
+                process(request);
+                {
+                    std::lock_guard lock(mutex_);
+                    --inFlight_;
+                }
+                changed_.notify_all();
+            };
+            if (!workers_.submit(task)) {
+                task();
+            }
+        }
+    }
+
+    SPDLOG_INFO("Receipt enrichment stopped");
+}
+
+std::vector< ReceiptEnrichmentService::ClaimedRequest > ReceiptEnrichmentService::claim(std::size_t limit) {
+    std::vector< ClaimedRequest > requests;
+    if (limit == 0) {
+        return requests;
+    }
+
+    auto transaction = db_->makeTransaction();
+    auto resultOpt = execStatement(*transaction, CLAIM_REQUESTS, static_cast< int64_t >(limit), static_cast< int64_t >(settings_.leaseTime.count()));
+    if (!resultOpt.has_value()) {
+        transaction->abort();
+        return requests;
+    }
+
+    requests.reserve(resultOpt->size());
+    for (const auto & row: resultOpt.value()) {
+        auto & request = requests.emplace_back();
+        request.requestId = row[0].as< int32_t >();
+        request.attempts = row[1].as< int32_t >();
+        request.receipt.set_id(row[2].as< uint64_t >());
+        request.receipt.set_t(row[3].as< std::string >());
+        request.receipt.set_s(row[4].as< double >() / 100.0);
+        request.receipt.set_fn(row[5].as< uint64_t >());
+        request.receipt.set_i(row[6].as< uint64_t >());
+        request.receipt.set_fp(row[7].as< uint64_t >());
+        request.receipt.set_n(row[8].as< int32_t >());
+    }
+    transaction->commit();
+    return requests;
+}
+
+void ReceiptEnrichmentService::process(const ClaimedRequest & request) {
+    try {
+        const auto data = ofd_->getReceiptData(request.receipt);
+        if (data.items().empty() && !data.retailer().has_name()) {
+            fail(request, "OFD returned no receipt data");
+            return;
+        }
+        if (!store(request, data)) {
+            fail(request, "Failed to store receipt data");
+        }
+    } catch (const std::exception & e) {
+        fail(request, e.what());
+    }
+}
+
+bool ReceiptEnrichmentService::store(const ClaimedRequest & request, const ReceiptData & data) {
+    std::string ofdData;
+    if (!google::protobuf::util::MessageToJsonString(data, &ofdData).ok()) {
+        ofdData = "{}";
+    }
+
+    auto transaction = db_->makeTransaction();
+    if (!ReceiptDatabase::insertReceiptData(*transaction, static_cast< int64_t >(request.receipt.id()), request.requestId, data).has_value()) {
+        transaction->abort();
+        return false;
+    }
+
+    if (!execStatement(*transaction, COMPLETE_REQUEST, request.requestId, ofdData).has_value()) {
+        transaction->abort();
+        return false;
+    }
+
+    transaction->commit();
+    SPDLOG_DEBUG("Receipt {} enriched with {} items", request.receipt.id(), data.items_size());
+    return true;
+}
+
+void ReceiptEnrichmentService::fail(const ClaimedRequest & request, const std::string & error) {
+    try {
+        auto transaction = db_->makeTransaction();
+        if (request.attempts >= settings_.maxAttempts) {
+            SPDLOG_ERROR("Receipt request {} failed after {} attempts: {}", request.requestId, request.attempts, error);
+            execStatement(*transaction, FAIL_REQUEST, request.requestId, error);
+        } else {
+            const auto delay = backoff(request.attempts);
+            SPDLOG_WARN("Receipt request {} attempt {} failed, retry in {}s: {}", request.requestId, request.attempts, delay.count(), error);
+            execStatement(*transaction, RETRY_REQUEST, request.requestId, static_cast< int64_t >(delay.count()), error);
+        }
+        transaction->commit();
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Failed to update receipt request {}: {}", request.requestId, e.what());
+    }
+}
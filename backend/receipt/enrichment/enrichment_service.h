@@ -0,0 +1,146 @@
+#pragma once
+
+#include <backend/receipt/ofd/interface/i_ofd.h>
+#include <utils/database/interface/i_database.h>
+#include <utils/executor/thread_pool/thread_pool.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wallet {
+
+    /**
+     * @class ReceiptEnrichmentService
+     * @brief Background pipeline filling receipt_data and receipt_items from the OFD
+     *
+     * ProcessQRCode only registers a pending row in receipt_requests. The service polls the table,
+     * claims due requests in batches with SELECT ... FOR UPDATE SKIP LOCKED, so several backend
+     * instances can drain the same table, and fetches the receipts from the OFD on a bounded worker
+     * pool. Retailer data and all items of a receipt are stored in one transaction together with
+     * the request status.
+     *
+     * A claimed request is leased for Settings::leaseTime: if the process dies while the request is
+     * in flight, the request becomes due again after the lease expires. Failed requests are retried
+     * with exponential backoff until Settings::maxAttempts is reached.
+     */
+    class ReceiptEnrichmentService final {
+    public:
+        /**
+         * @brief Status of a row in receipt_requests
+         */
+        enum class ERequestStatus : int32_t {
+            PENDING = 0,    /**< Waiting for the next attempt */
+            PROCESSING = 1, /**< Claimed by a worker */
+            DONE = 2,       /**< Receipt data stored */
+            FAILED = 3      /**< Gave up after Settings::maxAttempts */
+        };
+
+        /**
+         * @brief Pipeline parameters
+         */
+        struct Settings {
+            std::size_t concurrency = 4;                         /**< Max OFD requests in flight */
+            std::size_t batchSize = 16;                          /**< Max requests claimed at once */
+            std::chrono::milliseconds pollInterval{ 1000 };      /**< Idle time between polls of an empty queue */
+            std::chrono::seconds leaseTime{ 300 };               /**< Time before an unfinished claim is retried */
+            int32_t maxAttempts = 5;                             /**< Attempts before a request is marked as failed */
+            std::chrono::seconds initialBackoff{ 30 };           /**< Delay before the first retry */
+            std::chrono::seconds maxBackoff{ 3600 };             /**< Upper bound of the retry delay */
+        };
+
+        /**
+         * @brief Request claimed for processing
+         */
+        struct ClaimedRequest {
+            int32_t requestId = 0;
+            int32_t attempts = 0;
+            Receipt receipt;
+        };
+
+    public:
+        /**
+         * @brief Constructor for ReceiptEnrichmentService
+         * @param db Database with the receipt tables
+         * @param ofd OFD client, must be safe to call from several threads
+         * @param settings Pipeline parameters
+         */
+        ReceiptEnrichmentService(std::shared_ptr< cxx::IDatabase > db, std::shared_ptr< OFDInterface > ofd, Settings settings);
+
+        /**
+         * @brief Stops the pipeline and waits for the requests in flight
+         */
+        ~ReceiptEnrichmentService();
+
+        ReceiptEnrichmentService(const ReceiptEnrichmentService &) = delete;
+        ReceiptEnrichmentService & operator=(const ReceiptEnrichmentService &) = delete;
+
+        /**
+         * @brief Starts the polling thread
+         */
+        void start();
+
+        /**
+         * @brief Stops polling and waits for the requests in flight
+         */
+        void stop();
+
+        /**
+         * @brief Claims one batch and processes it synchronously on the worker pool
+         * @return Number of processed requests
+         */
+        std::size_t runOnce();
+
+        /**
+         * @brief Delay before the next attempt of a request that failed the given number of times
+         */
+        std::chrono::seconds backoff(int32_t attempts) const;
+
+    private:
+        /**
+         * @brief Polling loop, keeps at most Settings::concurrency requests in flight
+         */
+        void run();
+
+        /**
+         * @brief Claims up to limit due requests
+         */
+        std::vector< ClaimedRequest > claim(std::size_t limit);
+
+        /**
+         * @brief Fetches a receipt from the OFD and stores the result
+         */
+        void process(const ClaimedRequest & request);
+
+        /**
+         * @brief Stores the receipt data and marks the request as done
+         * @return True if the transaction succeeded
+         */
+        bool store(const ClaimedRequest & request, const ReceiptData & data);
+
+        /**
+         * @brief Schedules a retry or marks the request as failed
+         */
+        void fail(const ClaimedRequest & request, const std::string & error);
+
+    private:
+        const std::shared_ptr< cxx::IDatabase > db_;
+        const std::shared_ptr< OFDInterface > ofd_;
+        const Settings settings_;
+
+        cxx::ThreadPool workers_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::size_t inFlight_ = 0;
+        bool stopped_ = true;
+        std::thread poller_;
+    };
+
+} // namespace wallet
@@ -0,0 +1,170 @@
+#include <backend/receipt/enrichment/enrichment_service.h>
+#include <backend/receipt/ofd/mock/mock_ofd.h>
+#include <backend/receipt/ofd/null/null_ofd.h>
+#include <utils/database/mock/mock_database.h>
+#include <utils/database/mock/mock_transaction.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace cxx;
+using namespace wallet;
+using namespace testing;
+
+namespace {
+
+    QueryResult makeClaimResult(int32_t requestId, int32_t attempts) {
+        QueryResult result(9);
+        result.addInt(requestId);
+        result.addInt(attempts);
+        result.addInt(42);
+        result.addText("20200727T174700");
+        result.addInt(43200);
+        result.addInt(9284000100287274);
+        result.addInt(28889);
+        result.addInt(3906849540);
+        result.addInt(1);
+        return result;
+    }
+
+    class ReceiptEnrichmentServiceTest: public ::Test {
+    public:
+        void SetUp() override {
+            EXPECT_CALL(*mockDb_, makeTransaction)
+             .WillRepeatedly([this]() {
+                 return mockTransaction_;
+             });
+            ON_CALL(*mockTransaction_, prepare).WillByDefault(Return(true));
+        }
+
+    protected:
+        std::unique_ptr< ReceiptEnrichmentService > makeService(std::shared_ptr< OFDInterface > ofd) {
+            ReceiptEnrichmentService::Settings settings;
+            settings.concurrency = 2;
+            return std::make_unique< ReceiptEnrichmentService >(mockDb_, std::move(ofd), settings);
+        }
+
+        void expectClaim(int32_t requestId, int32_t attempts) {
+            EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_claim_requests"), _))
+             .WillOnce([requestId, attempts](const std::string &, const std::vector< SqlParam > & params) {
+                 EXPECT_EQ(params.size(), 2);
+                 return makeClaimResult(requestId, attempts);
+             });
+        }
+
+    protected:
+        const std::shared_ptr< MockDatabase > mockDb_ = std::make_shared< NiceMock< MockDatabase > >();
+        const std::shared_ptr< MockTransaction > mockTransaction_ = std::make_shared< NiceMock< MockTransaction > >();
+        const std::shared_ptr< MockOFD > mockOfd_ = std::make_shared< MockOFD >();
+    };
+
+    TEST_F(ReceiptEnrichmentServiceTest, StoresReceiptDataAndCompletesRequest) {
+        expectClaim(5, 1);
+
+        EXPECT_CALL(*mockOfd_, getReceiptData)
+         .WillOnce([](const Receipt & receipt) {
+             EXPECT_EQ(receipt.id(), 42);
+             EXPECT_EQ(receipt.t(), "20200727T174700");
+             EXPECT_DOUBLE_EQ(receipt.s(), 432.0);
+             EXPECT_EQ(receipt.fn(), 9284000100287274);
+
+             ReceiptData data;
+             data.mutable_retailer()->set_name("Shop");
+             auto * milk = data.add_items();
+             milk->set_name("Milk 'Fresh'");
+             milk->set_price(8999);
+             milk->set_quantity(2);
+             milk->set_sum(17998);
+             auto * bread = data.add_items();
+             bread->set_name("Bread");
+             bread->set_price(4500);
+             bread->set_quantity(1);
+             bread->set_sum(4500);
+             return data;
+         });
+
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("receipt_database_insert_receipt_data"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params.at(0), SqlParam(int64_t{ 42 }));
+             EXPECT_EQ(params.at(1), SqlParam(int64_t{ 5 }));
+             EXPECT_EQ(params.at(2), SqlParam(std::string("Shop")));
+             EXPECT_EQ(params.at(3), SqlParam());
+             QueryResult result(1);
+             result.addInt(11);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, insertBulk(StrEq("receipt_items"), _, _))
+         .WillOnce([](const std::string &, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) {
+             EXPECT_EQ(colNames.size(), 9);
+             EXPECT_EQ(rows.size(), 2);
+             EXPECT_EQ(rows.at(0).at(0), SqlParam(int64_t{ 11 }));
+             EXPECT_EQ(rows.at(0).at(1), SqlParam(std::string("Milk 'Fresh'")));
+             EXPECT_EQ(rows.at(0).at(2), SqlParam(int64_t{ 8999 }));
+             EXPECT_EQ(rows.at(0).at(3), SqlParam(2.0));
+             EXPECT_EQ(rows.at(0).at(4), SqlParam(int64_t{ 17998 }));
+             EXPECT_EQ(rows.at(1).at(1), SqlParam(std::string("Bread")));
+             return true;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_complete_request"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params.at(0), SqlParam(int64_t{ 5 }));
+             EXPECT_THAT(std::get< std::string >(params.at(1)), HasSubstr("Shop"));
+             return QueryResult();
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_retry_request"), _)).Times(0);
+        EXPECT_CALL(*mockTransaction_, abort).Times(0);
+
+        EXPECT_EQ(makeService(mockOfd_)->runOnce(), 1);
+    }
+
+    TEST_F(ReceiptEnrichmentServiceTest, FailedRequestIsRetriedWithBackoff) {
+        expectClaim(5, 2);
+
+        EXPECT_CALL(*mockOfd_, getReceiptData).WillOnce(Throw(std::runtime_error("timeout")));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_retry_request"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params, (std::vector< SqlParam >{ int64_t{ 5 }, int64_t{ 60 }, std::string("timeout") }));
+             return QueryResult();
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("receipt_database_insert_receipt_data"), _)).Times(0);
+
+        EXPECT_EQ(makeService(mockOfd_)->runOnce(), 1);
+    }
+
+    TEST_F(ReceiptEnrichmentServiceTest, EmptyOFDAnswerIsRetried) {
+        expectClaim(5, 1);
+
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_retry_request"), _))
+         .WillOnce(Return(QueryResult()));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_complete_request"), _)).Times(0);
+
+        EXPECT_EQ(makeService(std::make_shared< NullOFD >())->runOnce(), 1);
+    }
+
+    TEST_F(ReceiptEnrichmentServiceTest, RequestFailsAfterMaxAttempts) {
+        expectClaim(5, 5);
+
+        EXPECT_CALL(*mockOfd_, getReceiptData).WillOnce(Throw(std::runtime_error("bad receipt")));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_fail_request"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params, (std::vector< SqlParam >{ int64_t{ 5 }, std::string("bad receipt") }));
+             return QueryResult();
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("enrichment_retry_request"), _)).Times(0);
+
+        EXPECT_EQ(makeService(mockOfd_)->runOnce(), 1);
+    }
+
+    TEST_F(ReceiptEnrichmentServiceTest, BackoffIsExponentialAndBounded) {
+        const auto service = makeService(mockOfd_);
+
+        EXPECT_EQ(service->backoff(1), std::chrono::seconds(30));
+        EXPECT_EQ(service->backoff(2), std::chrono::seconds(60));
+        EXPECT_EQ(service->backoff(3), std::chrono::seconds(120));
+        EXPECT_EQ(service->backoff(100), std::chrono::seconds(3600));
+    }
+
+} // unnamed namespace
@@ -0,0 +1,137 @@
+#include "cached_ofd.h"
+
+#include <google/protobuf/util/json_util.h>
+#include <spdlog/spdlog.h>
+
+#include <exception>
+#include <functional>
+
+using namespace wallet;
+
+namespace {
+
+    const std::string SELECT_OFD_DATA_NAME = "cached_ofd_select_ofd_data";
+    const std::string SELECT_OFD_DATA = "SELECT rr.ofd_data::text "
+                                        "FROM receipts r "
+                                        "JOIN receipt_requests rr ON rr.receipt_id = r.id "
+                                        "WHERE r.fn = $1 AND r.i = $2 AND r.fp = $3 AND rr.status = 2 AND rr.ofd_data IS NOT NULL "
+                                        "ORDER BY rr.id DESC "
+                                        "LIMIT 1";
+
+    bool isEmpty(const ReceiptData & data) {
+        return data.items().empty() && !data.retailer().has_name();
+    }
+
+    ReceiptData withReceipt(ReceiptData data, const Receipt & receipt) {
+        data.mutable_receipt()->CopyFrom(receipt);
+        return data;
+    }
+
+} // unnamed namespace
+
+std::size_t CachedOFD::FiscalKeyHash::operator()(const FiscalKey & key) const noexcept {
+    std::size_t hash = std::hash< uint64_t >{}(key.fn);
+    hash ^= std::hash< uint64_t >{}(key.i) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= std::hash< uint64_t >{}(key.fp) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+CachedOFD::CachedOFD(std::shared_ptr< OFDInterface > upstream, std::shared_ptr< cxx::IDatabase > db, Settings settings)
+  : upstream_(std::move(upstream))
+  , db_(std::move(db))
+  , memory_(settings.capacity) {
+}
+
+auto CachedOFD::getReceiptData(const Receipt & receipt) -> ReceiptData {
+    const FiscalKey key{ .fn = receipt.fn(), .i = receipt.i(), .fp = receipt.fp() };
+
+    std::promise< ReceiptData > promise;
+    {
+        std::unique_lock lock(mutex_);
+        if (const auto * cached = memory_.find(key); cached != nullptr) {
+            ++memoryHits_;
+            return withReceipt(*cached, receipt);
+        }
+
+        if (const auto it = inFlight_.find(key); it != inFlight_.end()) {
+            auto future = it->second;
+            lock.unlock();
+            ++coalesced_;
+            return withReceipt(future.get(), receipt);
+        }
+
+        inFlight_.emplace(key, promise.get_future().share());
+    }
+
+    try {
+        auto data = fetch(receipt);
+        {
+            std::lock_guard lock(mutex_);
+            if (!isEmpty(data)) {
+                memory_.insert(key, data);
+            }
+            inFlight_.erase(key);
+        }
+        promise.set_value(data);
+        return withReceipt(std::move(data), receipt);
+    } catch (...) {
+        {
+            std::lock_guard lock(mutex_);
+            inFlight_.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+}
+
+auto CachedOFD::stats() const -> Stats {
+    return {
+        .memoryHits = memoryHits_.load(),
+        .persistentHits = persistentHits_.load(),
+        .misses = misses_.load(),
+        .coalesced = coalesced_.load(),
+    };
+}
+
+ReceiptData CachedOFD::fetch(const Receipt & receipt) {
+    if (auto stored = loadPersistent(receipt); stored.has_value()) {
+        ++persistentHits_;
+        return std::move(stored.value());
+    }
+
+    ++misses_;
+    return upstream_->getReceiptData(receipt);
+}
+
+std::optional< ReceiptData > CachedOFD::loadPersistent(const Receipt & receipt) {
+    if (!db_) {
+        return std::nullopt;
+    }
+
+    try {
+        auto transaction = db_->makeTransaction();
+        if (!transaction->prepare(SELECT_OFD_DATA_NAME, SELECT_OFD_DATA)) {
+            return std::nullopt;
+        }
+        const auto resultOpt = transaction->execPrepared(
+         SELECT_OFD_DATA_NAME,
+         static_cast< int64_t >(receipt.fn()),
+         static_cast< int64_t >(receipt.i()),
+         static_cast< int64_t >(receipt.fp()));
+        transaction->commit();
+        if (!resultOpt.has_value() || resultOpt->empty() || resultOpt.value()[0][0].isNull()) {
+            return std::nullopt;
+        }
+
+        ReceiptData data;
+        google::protobuf::util::JsonParseOptions options;
+        options.ignore_unknown_fields = true;
+        if (!google::protobuf::util::JsonStringToMessage(resultOpt.value()[0][0].asString(), &data, options).ok() || isEmpty(data)) {
+            return std::nullopt;
+        }
+        return data;
+    } catch (const std::exception & e) {
+        SPDLOG_WARN("Failed to read stored OFD data: {}", e.what());
+        return std::nullopt;
+    }
+}
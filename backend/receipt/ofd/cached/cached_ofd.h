@@ -0,0 +1,109 @@
+#pragma once
+
+#include <backend/receipt/ofd/interface/i_ofd.h>
+#include <utils/cache/lru/lru_cache.h>
+#include <utils/database/interface/i_database.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace wallet {
+
+    /**
+     * @class CachedOFD
+     * @brief Caching decorator of an OFD client
+     *
+     * A receipt is identified by its fiscal key (fn, i, fp), the same receipt scanned by
+     * several users or scanned again is fetched from the OFD only once. Lookups go through:
+     * - an in-memory LRU tier;
+     * - a persistent tier: ofd_data of completed receipt_requests, written by the enrichment
+     *   pipeline, so answers survive restarts and are shared between backend instances;
+     * - the upstream OFD.
+     *
+     * Concurrent misses for the same key are coalesced: one caller queries the lower tiers,
+     * the others wait for its result. Empty answers and errors are not cached.
+     */
+    class CachedOFD final: public OFDInterface {
+    public:
+        /**
+         * @brief Cache parameters
+         */
+        struct Settings {
+            std::size_t capacity = 4096; /**< Receipts kept in memory */
+        };
+
+        /**
+         * @brief Lookup counters
+         */
+        struct Stats {
+            uint64_t memoryHits = 0;     /**< Served from the in-memory tier */
+            uint64_t persistentHits = 0; /**< Served from the database */
+            uint64_t misses = 0;         /**< Fetched from the upstream OFD */
+            uint64_t coalesced = 0;      /**< Waited for a concurrent lookup of the same receipt */
+        };
+
+    public:
+        /**
+         * @brief Constructor for CachedOFD
+         * @param upstream OFD client queried on a miss
+         * @param db Database with receipt_requests, nullptr disables the persistent tier
+         * @param settings Cache parameters
+         */
+        CachedOFD(std::shared_ptr< OFDInterface > upstream, std::shared_ptr< cxx::IDatabase > db, Settings settings);
+
+        ~CachedOFD() override = default;
+
+        auto getReceiptData(const Receipt & receipt) -> ReceiptData override;
+
+        /**
+         * @brief Snapshot of the lookup counters
+         */
+        Stats stats() const;
+
+    private:
+        /**
+         * @brief Fiscal key of a receipt
+         */
+        struct FiscalKey {
+            uint64_t fn = 0;
+            uint64_t i = 0;
+            uint64_t fp = 0;
+
+            bool operator==(const FiscalKey &) const = default;
+        };
+
+        struct FiscalKeyHash {
+            std::size_t operator()(const FiscalKey & key) const noexcept;
+        };
+
+        /**
+         * @brief Queries the persistent tier and then the upstream OFD
+         */
+        ReceiptData fetch(const Receipt & receipt);
+
+        /**
+         * @brief Reads the stored OFD answer of a receipt from the database
+         */
+        std::optional< ReceiptData > loadPersistent(const Receipt & receipt);
+
+    private:
+        const std::shared_ptr< OFDInterface > upstream_;
+        const std::shared_ptr< cxx::IDatabase > db_;
+
+        std::mutex mutex_;
+        cxx::LruCache< FiscalKey, ReceiptData, FiscalKeyHash > memory_;
+        std::unordered_map< FiscalKey, std::shared_future< ReceiptData >, FiscalKeyHash > inFlight_;
+
+        std::atomic< uint64_t > memoryHits_ = 0;
+        std::atomic< uint64_t > persistentHits_ = 0;
+        std::atomic< uint64_t > misses_ = 0;
+        std::atomic< uint64_t > coalesced_ = 0;
+    };
+
+} // namespace wallet
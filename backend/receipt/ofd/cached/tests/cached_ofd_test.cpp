@@ -0,0 +1,137 @@
+#include <backend/receipt/ofd/cached/cached_ofd.h>
+#include <backend/receipt/ofd/mock/mock_ofd.h>
+#include <utils/database/mock/mock_database.h>
+#include <utils/database/mock/mock_transaction.h>
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace cxx;
+using namespace wallet;
+using namespace testing;
+
+namespace {
+
+    Receipt makeReceipt(uint64_t id, uint64_t fn = 9284000100287274) {
+        Receipt receipt;
+        receipt.set_id(id);
+        receipt.set_fn(fn);
+        receipt.set_i(28889);
+        receipt.set_fp(3906849540);
+        return receipt;
+    }
+
+    ReceiptData makeData(const std::string & retailer) {
+        ReceiptData data;
+        data.mutable_retailer()->set_name(retailer);
+        data.add_items()->set_name("Milk");
+        return data;
+    }
+
+    class CachedOFDTest: public ::Test {
+    protected:
+        const std::shared_ptr< MockOFD > upstream_ = std::make_shared< MockOFD >();
+    };
+
+    TEST_F(CachedOFDTest, RepeatedLookupIsServedFromMemory) {
+        CachedOFD ofd(upstream_, nullptr, CachedOFD::Settings{});
+
+        EXPECT_CALL(*upstream_, getReceiptData).WillOnce(Return(makeData("Shop")));
+
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1)).retailer().name(), "Shop");
+        const auto second = ofd.getReceiptData(makeReceipt(2));
+        EXPECT_EQ(second.retailer().name(), "Shop");
+        EXPECT_EQ(second.receipt().id(), 2);
+
+        const auto stats = ofd.stats();
+        EXPECT_EQ(stats.misses, 1);
+        EXPECT_EQ(stats.memoryHits, 1);
+    }
+
+    TEST_F(CachedOFDTest, DifferentFiscalKeysAreFetchedSeparately) {
+        CachedOFD ofd(upstream_, nullptr, CachedOFD::Settings{});
+
+        EXPECT_CALL(*upstream_, getReceiptData)
+         .WillOnce(Return(makeData("First")))
+         .WillOnce(Return(makeData("Second")));
+
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1, 1)).retailer().name(), "First");
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(2, 2)).retailer().name(), "Second");
+        EXPECT_EQ(ofd.stats().misses, 2);
+    }
+
+    TEST_F(CachedOFDTest, StoredAnswerIsServedFromDatabase) {
+        const auto db = std::make_shared< NiceMock< MockDatabase > >();
+        const auto transaction = std::make_shared< NiceMock< MockTransaction > >();
+        EXPECT_CALL(*db, makeTransaction).WillRepeatedly(Return(transaction));
+        ON_CALL(*transaction, prepare).WillByDefault(Return(true));
+        EXPECT_CALL(*transaction, execPreparedParams)
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params, (std::vector< SqlParam >{ int64_t{ 9284000100287274 }, int64_t{ 28889 }, int64_t{ 3906849540 } }));
+             QueryResult result(1);
+             result.addText(R"({"retailer": {"name": "Stored"}, "items": [{"name": "Bread"}]})");
+             return result;
+         });
+        EXPECT_CALL(*upstream_, getReceiptData).Times(0);
+
+        CachedOFD ofd(upstream_, db, CachedOFD::Settings{});
+
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1)).items(0).name(), "Bread");
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1)).retailer().name(), "Stored");
+
+        const auto stats = ofd.stats();
+        EXPECT_EQ(stats.persistentHits, 1);
+        EXPECT_EQ(stats.memoryHits, 1);
+        EXPECT_EQ(stats.misses, 0);
+    }
+
+    TEST_F(CachedOFDTest, ConcurrentMissesAreCoalesced) {
+        CachedOFD ofd(upstream_, nullptr, CachedOFD::Settings{});
+
+        std::promise< void > release;
+        auto released = release.get_future().share();
+        EXPECT_CALL(*upstream_, getReceiptData)
+         .WillOnce([released](const Receipt &) {
+             released.wait();
+             return makeData("Shop");
+         });
+
+        constexpr int THREADS = 4;
+        std::vector< std::future< ReceiptData > > results;
+        for (int i = 0; i < THREADS; ++i) {
+            results.push_back(std::async(std::launch::async, [&ofd, i]() {
+                return ofd.getReceiptData(makeReceipt(i));
+            }));
+        }
+
+        while (ofd.stats().coalesced != THREADS - 1) {
+            std::this_thread::yield();
+        }
+        release.set_value();
+
+        for (auto & result: results) {
+            EXPECT_EQ(result.get().retailer().name(), "Shop");
+        }
+        EXPECT_EQ(ofd.stats().misses, 1);
+    }
+
+    TEST_F(CachedOFDTest, ErrorsAndEmptyAnswersAreNotCached) {
+        CachedOFD ofd(upstream_, nullptr, CachedOFD::Settings{});
+
+        EXPECT_CALL(*upstream_, getReceiptData)
+         .WillOnce(Throw(std::runtime_error("timeout")))
+         .WillOnce(Return(ReceiptData()))
+         .WillOnce(Return(makeData("Shop")));
+
+        EXPECT_THROW(ofd.getReceiptData(makeReceipt(1)), std::runtime_error);
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1)).items_size(), 0);
+        EXPECT_EQ(ofd.getReceiptData(makeReceipt(1)).retailer().name(), "Shop");
+        EXPECT_EQ(ofd.stats().misses, 3);
+    }
+
+} // unnamed namespace
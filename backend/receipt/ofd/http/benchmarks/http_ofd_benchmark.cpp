@@ -0,0 +1,70 @@
+#include <backend/receipt/ofd/http/http_ofd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace cxx;
+using namespace wallet;
+
+namespace {
+
+    std::string readOFDOut() {
+        std::ifstream file(OFD_OUT_JSON_PATH);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    /**
+     * @brief Answers every request with the recorded OFD response, so only HttpOFD itself is measured
+     */
+    class RecordedHttpClient final: public IHttpClient {
+    public:
+        explicit RecordedHttpClient(std::string body)
+          : body_(std::move(body)) {
+        }
+
+        Response get(const std::string & /*url*/, Headers /*headers*/) override {
+            return Response{ 200, body_, {} };
+        }
+
+        Response post(const std::string & /*url*/, const std::string & /*body*/, Headers /*headers*/) override {
+            return Response{ 200, body_, {} };
+        }
+
+        Response put(const std::string & /*url*/, const std::string & /*body*/, Headers /*headers*/) override {
+            return Response{ 200, body_, {} };
+        }
+
+        Response del(const std::string & /*url*/, Headers /*headers*/) override {
+            return Response{ 200, body_, {} };
+        }
+
+    private:
+        const std::string body_;
+    };
+
+    void BM_HttpOFDGetReceiptData(benchmark::State & state) {
+        const auto body = readOFDOut();
+        HttpOFD ofd(std::make_shared< RecordedHttpClient >(body), HttpOFD::Settings{ .token = "token" });
+
+        Receipt receipt;
+        receipt.set_t("20200727T1747");
+        receipt.set_s(432.0);
+        receipt.set_fn(9284000100287274);
+        receipt.set_i(28889);
+        receipt.set_fp(3906849540);
+        receipt.set_n(1);
+
+        for (auto _: state) {
+            benchmark::DoNotOptimize(ofd.getReceiptData(receipt));
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_HttpOFDGetReceiptData);
+
+} // unnamed namespace
@@ -1,10 +1,7 @@
 #include "http_ofd.h"
 
-#include <backend/receipt/data/items/items.h>
+#include <backend/receipt/ofd/parser/ofd_parser.h>
 
-#include <utils/string/trim.h>
-
-#include <nlohmann/json.hpp>
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
 #include <spdlog/spdlog.h>
 
@@ -13,7 +10,6 @@
 
 using namespace cxx;
 using namespace wallet;
-using namespace nlohmann;
 
 namespace {
 
@@ -36,33 +32,18 @@ auto HttpOFD::getReceiptData(const Receipt & receipt) -> ReceiptData {
 
     SPDLOG_DEBUG("New data from OFD {}", response.body);
 
-    auto responseJson = json::parse(response.body);
-    const auto & data = responseJson["data"];
-
     ReceiptData receiptData;
     receiptData.mutable_receipt()->CopyFrom(receipt);
-    if (!data.contains("json")) {
-        if (data.is_string()) {
-            SPDLOG_ERROR("Failed to get receipt data from OFD. Message: {}", data.dump());
+
+    const auto result = parseOFDResponse(response.body, receiptData);
+    if (!result.found) {
+        if (!result.message.empty()) {
+            SPDLOG_ERROR("Failed to get receipt data from OFD. Message: {}", result.message);
         } else {
             SPDLOG_ERROR("Failed to get receipt data from OFD. Data is not string");
         }
-        return receiptData;
     }
 
-    const auto & jsonData = data["json"];
-
-    for (const auto & itemJson: jsonData["items"]) {
-        ReceiptItem item = parseItemFromJson(itemJson);
-        receiptData.add_items()->Swap(&item);
-    }
-
-    auto * retailerInfo = receiptData.mutable_retailer();
-    retailerInfo->set_name(cxx::trimCopy(jsonData["user"].get< std::string >()));
-    retailerInfo->set_place(cxx::trimCopy(jsonData["retailPlace"].get< std::string >()));
-    retailerInfo->set_inn(cxx::trimCopy(jsonData["userInn"].get< std::string >()));
-    retailerInfo->set_address(cxx::trimCopy(jsonData["retailPlaceAddress"].get< std::string >()));
-
     return receiptData;
 }
 
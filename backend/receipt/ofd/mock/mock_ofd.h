@@ -9,6 +9,7 @@ using namespace testing;
 namespace wallet {
 
     class MockOFD final: public OFDInterface {
+    public:
         MOCK_METHOD(ReceiptData, getReceiptData, (const Receipt &), (override));
     };
 
@@ -0,0 +1,74 @@
+#include <backend/receipt/data/items/items.h>
+#include <backend/receipt/ofd/parser/ofd_parser.h>
+#include <utils/string/trim.h>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    std::string readOFDOut() {
+        std::ifstream file(OFD_OUT_JSON_PATH);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    // Response of a large supermarket receipt: the items of docs/ofd/ofd_out.json repeated
+    std::string makeLargeResponse(int copies) {
+        auto responseJson = nlohmann::json::parse(readOFDOut());
+        auto & items = responseJson["data"]["json"]["items"];
+        const auto original = items;
+        for (int i = 1; i < copies; ++i) {
+            for (const auto & item: original) {
+                items.push_back(item);
+            }
+        }
+        return responseJson.dump();
+    }
+
+    // The previous DOM based implementation of HttpOFD, kept for comparison
+    wallet::ReceiptData parseWithDom(const std::string & body) {
+        auto responseJson = nlohmann::json::parse(body);
+        const auto & jsonData = responseJson["data"]["json"];
+
+        wallet::ReceiptData receiptData;
+        for (const auto & itemJson: jsonData["items"]) {
+            wallet::ReceiptItem item = wallet::parseItemFromJson(itemJson);
+            receiptData.add_items()->Swap(&item);
+        }
+        auto * retailer = receiptData.mutable_retailer();
+        retailer->set_name(cxx::trimCopy(jsonData["user"].get< std::string >()));
+        retailer->set_place(cxx::trimCopy(jsonData["retailPlace"].get< std::string >()));
+        retailer->set_inn(cxx::trimCopy(jsonData["userInn"].get< std::string >()));
+        retailer->set_address(cxx::trimCopy(jsonData["retailPlaceAddress"].get< std::string >()));
+        return receiptData;
+    }
+
+    void BM_ParseDom(benchmark::State & state) {
+        const auto body = state.range(0) == 1 ? readOFDOut() : makeLargeResponse(static_cast< int >(state.range(0)));
+        for (auto _: state) {
+            auto receiptData = parseWithDom(body);
+            benchmark::DoNotOptimize(receiptData);
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_ParseDom)->Arg(1)->Arg(50);
+
+    void BM_ParseSax(benchmark::State & state) {
+        const auto body = state.range(0) == 1 ? readOFDOut() : makeLargeResponse(static_cast< int >(state.range(0)));
+        for (auto _: state) {
+            wallet::ReceiptData receiptData;
+            auto result = wallet::parseOFDResponse(body, receiptData);
+            benchmark::DoNotOptimize(receiptData);
+            benchmark::DoNotOptimize(result);
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * body.size()));
+    }
+    BENCHMARK(BM_ParseSax)->Arg(1)->Arg(50);
+
+} // unnamed namespace
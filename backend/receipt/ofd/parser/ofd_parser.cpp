@@ -0,0 +1,320 @@
+#include "ofd_parser.h"
+
+#include <backend/receipt/data/items/items.h>
+#include <utils/string/trim.h>
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace wallet;
+
+namespace {
+
+    /**
+     * @brief Container the parser is currently in
+     */
+    enum class EScope {
+        ROOT,     /**< Outside of the response */
+        RESPONSE, /**< Top level object */
+        DATA,     /**< "data" object */
+        RECEIPT,  /**< "data.json" object */
+        ITEMS,    /**< "data.json.items" array */
+        ITEM      /**< Element of "items" */
+    };
+
+    /**
+     * @brief Known key whose value is expected next
+     */
+    enum class EField {
+        NONE,
+        DATA,
+        JSON,
+        USER,
+        RETAIL_PLACE,
+        USER_INN,
+        RETAIL_PLACE_ADDRESS,
+        ITEMS,
+        NAME,
+        PRICE,
+        QUANTITY,
+        SUM,
+        NDS,
+        PAYMENT_TYPE,
+        PRODUCT_TYPE,
+        QUANTITY_MEASURE
+    };
+
+    EField fieldOf(EScope scope, std::string_view key) {
+        switch (scope) {
+        case EScope::RESPONSE:
+            return key == "data" ? EField::DATA : EField::NONE;
+        case EScope::DATA:
+            return key == "json" ? EField::JSON : EField::NONE;
+        case EScope::RECEIPT:
+            if (key == "items") {
+                return EField::ITEMS;
+            } else if (key == "user") {
+                return EField::USER;
+            } else if (key == "retailPlace") {
+                return EField::RETAIL_PLACE;
+            } else if (key == "userInn") {
+                return EField::USER_INN;
+            } else if (key == "retailPlaceAddress") {
+                return EField::RETAIL_PLACE_ADDRESS;
+            }
+            return EField::NONE;
+        case EScope::ITEM:
+            if (key == "name") {
+                return EField::NAME;
+            } else if (key == "price") {
+                return EField::PRICE;
+            } else if (key == "quantity") {
+                return EField::QUANTITY;
+            } else if (key == "sum") {
+                return EField::SUM;
+            } else if (key == "nds") {
+                return EField::NDS;
+            } else if (key == "paymentType") {
+                return EField::PAYMENT_TYPE;
+            } else if (key == "productType") {
+                return EField::PRODUCT_TYPE;
+            } else if (key == "itemsQuantityMeasure") {
+                return EField::QUANTITY_MEASURE;
+            }
+            return EField::NONE;
+        default:
+            return EField::NONE;
+        }
+    }
+
+    /**
+     * @brief SAX handler filling ReceiptData
+     *
+     * Subtrees that are not needed are skipped by counting their nesting depth.
+     */
+    class OFDResponseHandler final: public nlohmann::json_sax< nlohmann::json > {
+    public:
+        explicit OFDResponseHandler(ReceiptData & receiptData)
+          : receiptData_(receiptData) {
+        }
+
+        OFDParseResult & result() {
+            return result_;
+        }
+
+        const std::string & error() const {
+            return error_;
+        }
+
+        bool null() override {
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool boolean(bool /*value*/) override {
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool number_integer(number_integer_t value) override {
+            return number(static_cast< double >(value));
+        }
+
+        bool number_unsigned(number_unsigned_t value) override {
+            return number(static_cast< double >(value));
+        }
+
+        bool number_float(number_float_t value, const string_t & /*text*/) override {
+            return number(value);
+        }
+
+        bool string(string_t & value) override {
+            if (skipDepth_ == 0) {
+                stringValue(value);
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool binary(binary_t & /*value*/) override {
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool start_object(std::size_t /*elements*/) override {
+            if (skipDepth_ > 0) {
+                ++skipDepth_;
+                return true;
+            }
+
+            if (scope_ == EScope::ROOT) {
+                scope_ = EScope::RESPONSE;
+            } else if (scope_ == EScope::RESPONSE && field_ == EField::DATA) {
+                scope_ = EScope::DATA;
+            } else if (scope_ == EScope::DATA && field_ == EField::JSON) {
+                scope_ = EScope::RECEIPT;
+                result_.found = true;
+            } else if (scope_ == EScope::ITEMS) {
+                scope_ = EScope::ITEM;
+                item_ = receiptData_.add_items();
+            } else {
+                skipDepth_ = 1;
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool end_object() override {
+            if (skipDepth_ > 0) {
+                --skipDepth_;
+                return true;
+            }
+
+            switch (scope_) {
+            case EScope::RESPONSE:
+                scope_ = EScope::ROOT;
+                break;
+            case EScope::DATA:
+                scope_ = EScope::RESPONSE;
+                break;
+            case EScope::RECEIPT:
+                scope_ = EScope::DATA;
+                break;
+            case EScope::ITEM:
+                item_->set_name(normalizeItemName(std::move(*item_->mutable_name())));
+                item_ = nullptr;
+                scope_ = EScope::ITEMS;
+                break;
+            default:
+                break;
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool start_array(std::size_t /*elements*/) override {
+            if (skipDepth_ > 0) {
+                ++skipDepth_;
+            } else if (scope_ == EScope::RECEIPT && field_ == EField::ITEMS) {
+                scope_ = EScope::ITEMS;
+            } else {
+                skipDepth_ = 1;
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool end_array() override {
+            if (skipDepth_ > 0) {
+                --skipDepth_;
+            } else if (scope_ == EScope::ITEMS) {
+                scope_ = EScope::RECEIPT;
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        bool key(string_t & value) override {
+            if (skipDepth_ == 0) {
+                field_ = fieldOf(scope_, value);
+            }
+            return true;
+        }
+
+        bool parse_error(std::size_t /*position*/, const std::string & /*lastToken*/, const nlohmann::detail::exception & e) override {
+            error_ = e.what();
+            return false;
+        }
+
+    private:
+        bool number(double value) {
+            if (skipDepth_ == 0 && scope_ == EScope::ITEM) {
+                const auto code = static_cast< int >(value);
+                switch (field_) {
+                case EField::PRICE:
+                    item_->set_price(value);
+                    break;
+                case EField::QUANTITY:
+                    item_->set_quantity(value);
+                    break;
+                case EField::SUM:
+                    item_->set_sum(value);
+                    break;
+                case EField::NDS:
+                    item_->set_nds_type(getNDSType(code));
+                    break;
+                case EField::PAYMENT_TYPE:
+                    item_->set_payment_type(getPaymentType(code));
+                    break;
+                case EField::PRODUCT_TYPE:
+                    item_->set_product_type(getProductType(code));
+                    break;
+                case EField::QUANTITY_MEASURE:
+                    item_->set_measurement_unit(getMeasurementUnit(code));
+                    break;
+                default:
+                    break;
+                }
+            }
+            field_ = EField::NONE;
+            return true;
+        }
+
+        void stringValue(string_t & value) {
+            if (scope_ == EScope::RESPONSE && field_ == EField::DATA) {
+                result_.message = std::move(value);
+                return;
+            }
+            if (scope_ == EScope::ITEM && field_ == EField::NAME) {
+                *item_->mutable_name() = std::move(value);
+                return;
+            }
+            if (scope_ != EScope::RECEIPT) {
+                return;
+            }
+
+            auto * retailer = receiptData_.mutable_retailer();
+            std::string * target = nullptr;
+            switch (field_) {
+            case EField::USER:
+                target = retailer->mutable_name();
+                break;
+            case EField::RETAIL_PLACE:
+                target = retailer->mutable_place();
+                break;
+            case EField::USER_INN:
+                target = retailer->mutable_inn();
+                break;
+            case EField::RETAIL_PLACE_ADDRESS:
+                target = retailer->mutable_address();
+                break;
+            default:
+                return;
+            }
+            *target = std::move(value);
+            cxx::trim(*target);
+        }
+
+    private:
+        ReceiptData & receiptData_;
+        OFDParseResult result_;
+        std::string error_;
+
+        EScope scope_ = EScope::ROOT;
+        EField field_ = EField::NONE;
+        std::size_t skipDepth_ = 0;
+        ReceiptItem * item_ = nullptr;
+    };
+
+} // unnamed namespace
+
+auto wallet::parseOFDResponse(std::string_view body, ReceiptData & receiptData) -> OFDParseResult {
+    OFDResponseHandler handler(receiptData);
+    if (!nlohmann::json::sax_parse(body.begin(), body.end(), &handler)) {
+        throw std::runtime_error("Bad OFD response: " + handler.error());
+    }
+    return std::move(handler.result());
+}
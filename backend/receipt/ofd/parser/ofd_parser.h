@@ -0,0 +1,33 @@
+#pragma once
+
+#include <proto/wallet/receipt/receipt.pb.h>
+
+#include <string>
+#include <string_view>
+
+namespace wallet {
+
+    /**
+     * @brief Outcome of parsing an OFD response
+     */
+    struct OFDParseResult {
+        bool found = false;  /**< The response contains the receipt */
+        std::string message; /**< Message of the OFD when the receipt is missing */
+    };
+
+    /**
+     * @brief Parses a proverkacheka.com response directly into ReceiptData
+     *
+     * The body is read in one streaming pass with the nlohmann SAX interface, no DOM is built.
+     * Only data.json.items and the retailer fields are materialized: values of other keys,
+     * including nested objects with raw fiscal data, are skipped while tokenizing, and item
+     * names are moved from the tokenizer buffer into the message.
+     *
+     * @param body Response body
+     * @param receiptData Receives items and retailer information
+     * @return Whether the receipt was found, or the OFD message otherwise
+     * @throw std::runtime_error If the body is not valid JSON
+     */
+    auto parseOFDResponse(std::string_view body, ReceiptData & receiptData) -> OFDParseResult;
+
+} // namespace wallet
@@ -0,0 +1,126 @@
+#include <backend/receipt/data/items/items.h>
+#include <backend/receipt/ofd/parser/ofd_parser.h>
+#include <utils/string/trim.h>
+
+#include <google/protobuf/util/message_differencer.h>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace wallet;
+using namespace testing;
+
+namespace {
+
+    std::string readOFDOut() {
+        std::ifstream file(OFD_OUT_JSON_PATH);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    // Reference result built from the DOM, the way HttpOFD used to parse the response
+    ReceiptData parseWithDom(const std::string & body) {
+        const auto responseJson = nlohmann::json::parse(body);
+        const auto & jsonData = responseJson["data"]["json"];
+
+        ReceiptData receiptData;
+        for (const auto & itemJson: jsonData["items"]) {
+            ReceiptItem item = parseItemFromJson(itemJson);
+            receiptData.add_items()->Swap(&item);
+        }
+        auto * retailer = receiptData.mutable_retailer();
+        retailer->set_name(cxx::trimCopy(jsonData["user"].get< std::string >()));
+        retailer->set_place(cxx::trimCopy(jsonData["retailPlace"].get< std::string >()));
+        retailer->set_inn(cxx::trimCopy(jsonData["userInn"].get< std::string >()));
+        retailer->set_address(cxx::trimCopy(jsonData["retailPlaceAddress"].get< std::string >()));
+        return receiptData;
+    }
+
+} // unnamed namespace
+
+TEST(OFDParserTest, ParsesOFDResponse) {
+    const auto body = readOFDOut();
+    ASSERT_FALSE(body.empty());
+
+    ReceiptData receiptData;
+    const auto result = parseOFDResponse(body, receiptData);
+
+    EXPECT_TRUE(result.found);
+    ASSERT_EQ(receiptData.items_size(), 9);
+    EXPECT_EQ(receiptData.items(0).name(), "PAP.Бум.туал.3сл белая 12рул");
+    EXPECT_EQ(receiptData.items(4).quantity(), 6);
+    EXPECT_EQ(receiptData.items(4).sum(), 47994);
+    EXPECT_EQ(receiptData.items(2).product_type(), ReceiptItem::PRODUCT_TYPE_UNKNOWN);
+    EXPECT_EQ(receiptData.retailer().name(), "ООО \"Агроторг\"");
+    EXPECT_EQ(receiptData.retailer().place(), "Q539 7050-Пятерочка");
+    EXPECT_EQ(receiptData.retailer().inn(), "7825706086");
+}
+
+TEST(OFDParserTest, MatchesDomParser) {
+    const auto body = readOFDOut();
+
+    ReceiptData receiptData;
+    parseOFDResponse(body, receiptData);
+
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(receiptData, parseWithDom(body)));
+}
+
+TEST(OFDParserTest, SkipsUnusedSubtrees) {
+    const std::string body = R"({
+        "code": 1,
+        "data": {
+            "html": { "items": [ { "name": "from html" } ] },
+            "json": {
+                "user": "  Shop  ",
+                "properties": [ [ 1, 2 ], { "items": [ { "name": "nested" } ] } ],
+                "items": [
+                    {
+                        "name": " Milk\t 1L  ",
+                        "price": 8999,
+                        "quantity": 0.5,
+                        "sum": 4500,
+                        "nds": 99,
+                        "productCodeNew": { "gs1m": { "name": "code", "sum": 1 } },
+                        "itemsQuantityMeasure": 41
+                    },
+                    42
+                ]
+            }
+        },
+        "request": { "qrraw": "t=20200727T174700" }
+    })";
+
+    ReceiptData receiptData;
+    const auto result = parseOFDResponse(body, receiptData);
+
+    EXPECT_TRUE(result.found);
+    ASSERT_EQ(receiptData.items_size(), 1);
+    EXPECT_EQ(receiptData.items(0).name(), "Milk 1L");
+    EXPECT_EQ(receiptData.items(0).price(), 8999);
+    EXPECT_EQ(receiptData.items(0).quantity(), 0.5);
+    EXPECT_EQ(receiptData.items(0).sum(), 4500);
+    EXPECT_EQ(receiptData.items(0).nds_type(), ReceiptItem::NDS_UNKNOWN);
+    EXPECT_EQ(receiptData.items(0).measurement_unit(), ReceiptItem::MEASUREMENT_UNIT_LITER);
+    EXPECT_EQ(receiptData.retailer().name(), "Shop");
+    EXPECT_FALSE(receiptData.retailer().has_place());
+}
+
+TEST(OFDParserTest, ReceiptNotFound) {
+    ReceiptData receiptData;
+    const auto result = parseOFDResponse(R"({"code": 0, "data": "Чек не найден"})", receiptData);
+
+    EXPECT_FALSE(result.found);
+    EXPECT_EQ(result.message, "Чек не найден");
+    EXPECT_EQ(receiptData.items_size(), 0);
+}
+
+TEST(OFDParserTest, InvalidJson) {
+    ReceiptData receiptData;
+    EXPECT_THROW(parseOFDResponse(R"({"data": {"json": {"items": [)", receiptData), std::runtime_error);
+    EXPECT_THROW(parseOFDResponse("", receiptData), std::runtime_error);
+}
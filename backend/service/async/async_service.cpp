@@ -0,0 +1,291 @@
+#include "async_service.h"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace wallet;
+
+namespace {
+
+    /**
+     * @brief Streaming call of ProcessQRCodes, deletes itself when gRPC is done with it
+     */
+    class QRCodeBatchReactor final: public grpc::ServerBidiReactor< QRCodeBatchRequest, QRCodeBatchResponse > {
+    public:
+        QRCodeBatchReactor(grpc::CallbackServerContext * context, std::shared_ptr< FinanceServiceImpl > impl, std::shared_ptr< cxx::ThreadPool > executor)
+          : context_(context)
+          , impl_(std::move(impl))
+          , executor_(std::move(executor)) {
+            StartRead(&request_);
+        }
+
+        void OnReadDone(bool ok) override {
+            if (ok) {
+                if (requests_.size() == FinanceServiceImpl::MAX_QR_BATCH_SIZE) {
+                    Finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Too many receipts in one batch"));
+                    return;
+                }
+                requests_.push_back(std::move(request_));
+                request_.Clear();
+                StartRead(&request_);
+                return;
+            }
+            if (context_->IsCancelled()) {
+                Finish(grpc::Status::CANCELLED);
+                return;
+            }
+
+            // The client closed its side, the reactor stays alive until Finish() so the task may use it
+            const bool accepted = executor_->submit([this]() {
+                responses_ = impl_->processQRCodeBatch(requests_);
+                requests_.clear();
+                writeNext();
+            });
+            if (!accepted) {
+                SPDLOG_WARN("Database executor is saturated, rejecting request");
+                Finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Server is overloaded"));
+            }
+        }
+
+        void OnWriteDone(bool ok) override {
+            if (!ok) {
+                Finish(grpc::Status::CANCELLED);
+                return;
+            }
+            ++written_;
+            writeNext();
+        }
+
+        void OnDone() override {
+            delete this;
+        }
+
+    private:
+        void writeNext() {
+            if (written_ < responses_.size()) {
+                StartWrite(&responses_[written_]);
+            } else {
+                Finish(grpc::Status::OK);
+            }
+        }
+
+    private:
+        grpc::CallbackServerContext * context_;
+        std::shared_ptr< FinanceServiceImpl > impl_;
+        std::shared_ptr< cxx::ThreadPool > executor_;
+
+        QRCodeBatchRequest request_;
+        std::vector< QRCodeBatchRequest > requests_;
+        std::vector< QRCodeBatchResponse > responses_;
+        std::size_t written_ = 0;
+    };
+
+    /**
+     * @brief Server-streaming export, deletes itself when gRPC is done with it
+     *
+     * The export runs on an export executor thread and reads the next rows only after gRPC took
+     * the previous chunk, so a slow client holds one chunk in memory and one export thread.
+     * A write that does not complete within the write timeout cancels the call, which bounds
+     * how long a stalled client keeps the thread and its database cursor.
+     */
+    template < typename Chunk >
+    class ExportReactor final: public grpc::ServerWriteReactor< Chunk > {
+    public:
+        using Export = bool (FinanceServiceImpl::*)(const ExportRequest &, const FinanceServiceImpl::ChunkWriter< Chunk > &);
+
+        ExportReactor(grpc::CallbackServerContext * context, const ExportRequest * request, std::shared_ptr< FinanceServiceImpl > impl, const std::shared_ptr< cxx::ThreadPool > & executor, std::chrono::milliseconds writeTimeout, Export run)
+          : context_(context)
+          , writeTimeout_(writeTimeout) {
+            const bool accepted = executor->submit([this, request, impl = std::move(impl), run]() {
+                const bool delivered = ((*impl).*run)(*request, [this](const Chunk & chunk) {
+                    return write(chunk);
+                });
+                this->Finish(delivered ? grpc::Status::OK : grpc::Status::CANCELLED);
+            });
+            if (!accepted) {
+                SPDLOG_WARN("Export executor is saturated, rejecting request");
+                this->Finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Server is overloaded"));
+            }
+        }
+
+        void OnWriteDone(bool ok) override {
+            std::lock_guard lock(mutex_);
+            pending_ = false;
+            ok_ = ok;
+            written_.notify_one();
+        }
+
+        void OnCancel() override {
+            std::lock_guard lock(mutex_);
+            cancelled_ = true;
+        }
+
+        void OnDone() override {
+            delete this;
+        }
+
+    private:
+        /**
+         * @brief Starts a write and blocks the export thread until it completes
+         *
+         * The call is cancelled when the client does not take the chunk within the write timeout.
+         */
+        bool write(const Chunk & chunk) {
+            std::unique_lock lock(mutex_);
+            if (cancelled_) {
+                return false;
+            }
+            // The export reuses its chunk, gRPC needs the message until OnWriteDone()
+            chunk_ = chunk;
+            pending_ = true;
+            lock.unlock();
+
+            this->StartWrite(&chunk_);
+
+            lock.lock();
+            const auto completed = [this]() {
+                return !pending_;
+            };
+            if (!written_.wait_for(lock, writeTimeout_, completed)) {
+                SPDLOG_WARN("Export client did not receive a chunk in {} ms, cancelling the call", writeTimeout_.count());
+                context_->TryCancel();
+            }
+            // A pending write is completed with ok == false when the call is cancelled
+            written_.wait(lock, completed);
+            return ok_;
+        }
+
+    private:
+        grpc::CallbackServerContext * context_;
+        std::chrono::milliseconds writeTimeout_;
+
+        std::mutex mutex_;
+        std::condition_variable written_;
+        Chunk chunk_;
+        bool pending_ = false;
+        bool ok_ = true;
+        bool cancelled_ = false;
+    };
+
+} // unnamed namespace
+
+AsyncFinanceService::AsyncFinanceService(std::shared_ptr< FinanceServiceImpl > impl, std::shared_ptr< cxx::ThreadPool > executor, std::shared_ptr< cxx::ThreadPool > exportExecutor, std::chrono::milliseconds exportWriteTimeout)
+  : impl_(std::move(impl))
+  , executor_(std::move(executor))
+  , exportExecutor_(std::move(exportExecutor))
+  , exportWriteTimeout_(exportWriteTimeout) {
+}
+
+template < typename Request, typename Response >
+grpc::ServerUnaryReactor * AsyncFinanceService::dispatch(grpc::CallbackServerContext * context, const Request * request, Response * response, Handler< Request, Response > handler) {
+    auto * reactor = context->DefaultReactor();
+
+    const bool accepted = executor_->submit([this, context, request, response, reactor, handler]() {
+        if (context->IsCancelled()) {
+            reactor->Finish(grpc::Status::CANCELLED);
+            return;
+        }
+
+        // FinanceServiceImpl handlers do not use the server context
+        grpc::ServerContext syncContext;
+        reactor->Finish(((*impl_).*handler)(&syncContext, request, response));
+    });
+
+    if (!accepted) {
+        SPDLOG_WARN("Database executor is saturated, rejecting request");
+        reactor->Finish(grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Server is overloaded"));
+    }
+    return reactor;
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::Authenticate(grpc::CallbackServerContext * context, const AuthRequest * request, AuthResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::Authenticate);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::ProcessQRCode(grpc::CallbackServerContext * context, const QRCodeRequest * request, ReceiptDetailsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::ProcessQRCode);
+}
+
+grpc::ServerBidiReactor< QRCodeBatchRequest, QRCodeBatchResponse > * AsyncFinanceService::ProcessQRCodes(grpc::CallbackServerContext * context) {
+    return new QRCodeBatchReactor(context, impl_, executor_);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetReceipts(grpc::CallbackServerContext * context, const GetReceiptsRequest * request, ReceiptsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetReceipts);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetReceiptDetails(grpc::CallbackServerContext * context, const GetReceiptDetailsRequest * request, ReceiptDetailsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetReceiptDetails);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::CreateTransaction(grpc::CallbackServerContext * context, const CreateTransactionRequest * request, CreateTransactionResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::CreateTransaction);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::UpdateTransaction(grpc::CallbackServerContext * context, const UpdateTransactionRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::UpdateTransaction);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::DeleteTransaction(grpc::CallbackServerContext * context, const DeleteTransactionRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::DeleteTransaction);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetTransactions(grpc::CallbackServerContext * context, const GetTransactionsRequest * request, TransactionsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetTransactions);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetTransactionDetails(grpc::CallbackServerContext * context, const GetTransactionDetailsRequest * request, TransactionDetailsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetTransactionDetails);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::CreateSplit(grpc::CallbackServerContext * context, const CreateSplitRequest * request, CreateSplitResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::CreateSplit);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::UpdateSplit(grpc::CallbackServerContext * context, const UpdateSplitRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::UpdateSplit);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::DeleteSplit(grpc::CallbackServerContext * context, const DeleteSplitRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::DeleteSplit);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetCharacters(grpc::CallbackServerContext * context, const GetCharactersRequest * request, CharactersResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetCharacters);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::ManageCharacter(grpc::CallbackServerContext * context, const ManageCharacterRequest * request, ManageCharacterResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::ManageCharacter);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::DeleteCharacter(grpc::CallbackServerContext * context, const ManageCharacterRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::DeleteCharacter);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetCategories(grpc::CallbackServerContext * context, const GetCategoriesRequest * request, CategoriesResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetCategories);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::ManageCategory(grpc::CallbackServerContext * context, const ManageCategoryRequest * request, ManageCategoryResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::ManageCategory);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::DeleteCategory(grpc::CallbackServerContext * context, const ManageCategoryRequest * request, Response * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::DeleteCategory);
+}
+
+grpc::ServerUnaryReactor * AsyncFinanceService::GetStatistics(grpc::CallbackServerContext * context, const GetStatisticsRequest * request, StatisticsResponse * response) {
+    return dispatch(context, request, response, &FinanceServiceImpl::GetStatistics);
+}
+
+grpc::ServerWriteReactor< TransactionsChunk > * AsyncFinanceService::ExportTransactions(grpc::CallbackServerContext * context, const ExportRequest * request) {
+    return new ExportReactor< TransactionsChunk >(context, request, impl_, exportExecutor_, exportWriteTimeout_, &FinanceServiceImpl::exportTransactions);
+}
+
+grpc::ServerWriteReactor< ReceiptsChunk > * AsyncFinanceService::ExportReceipts(grpc::CallbackServerContext * context, const ExportRequest * request) {
+    return new ExportReactor< ReceiptsChunk >(context, request, impl_, exportExecutor_, exportWriteTimeout_, &FinanceServiceImpl::exportReceipts);
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <backend/service/service.h>
+#include <proto/wallet/service.grpc.pb.h>
+#include <utils/executor/thread_pool/thread_pool.h>
+
+#include <chrono>
+#include <memory>
+
+namespace wallet {
+
+    /**
+     * @class AsyncFinanceService
+     * @brief Callback API front end of FinanceServiceImpl
+     *
+     * gRPC invokes the callback handlers on its network threads. Every handler only
+     * enqueues the request to the database executor and returns a reactor, the blocking
+     * FinanceServiceImpl handler then runs on an executor thread and finishes the reactor.
+     * Network threads therefore never wait for the database, and the number of requests
+     * served concurrently is bounded by the executor size instead of the gRPC thread count.
+     *
+     * Requests are rejected with RESOURCE_EXHAUSTED when the executor queue is full and
+     * with CANCELLED when the client gave up before the request was picked up.
+     *
+     * Exports stream for as long as the client keeps reading, so they run on a separate
+     * export executor and never occupy the threads serving unary requests. A chunk the client
+     * does not take within the export write timeout cancels the export.
+     *
+     * Both executors must be shut down before the service is destroyed.
+     */
+    class AsyncFinanceService final: public FinanceService::CallbackService {
+    public:
+        /**
+         * @brief Default time a client has to receive one export chunk
+         */
+        static constexpr std::chrono::milliseconds DEFAULT_EXPORT_WRITE_TIMEOUT { 30'000 };
+
+        /**
+         * @brief Constructor for AsyncFinanceService
+         * @param impl Synchronous service implementation executing the requests
+         * @param executor Executor running the blocking handlers
+         * @param exportExecutor Executor running the streaming exports
+         * @param exportWriteTimeout Time a client has to receive one export chunk
+         */
+        AsyncFinanceService(std::shared_ptr< FinanceServiceImpl > impl, std::shared_ptr< cxx::ThreadPool > executor, std::shared_ptr< cxx::ThreadPool > exportExecutor, std::chrono::milliseconds exportWriteTimeout = DEFAULT_EXPORT_WRITE_TIMEOUT);
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::Authenticate
+         */
+        grpc::ServerUnaryReactor * Authenticate(grpc::CallbackServerContext * context, const AuthRequest * request, AuthResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ProcessQRCode
+         */
+        grpc::ServerUnaryReactor * ProcessQRCode(grpc::CallbackServerContext * context, const QRCodeRequest * request, ReceiptDetailsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ProcessQRCodes
+         *
+         * The reactor collects the requests on network threads, runs the batch on the executor
+         * once the client closes its side and streams the results back one write at a time.
+         */
+        grpc::ServerBidiReactor< QRCodeBatchRequest, QRCodeBatchResponse > * ProcessQRCodes(grpc::CallbackServerContext * context) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetReceipts
+         */
+        grpc::ServerUnaryReactor * GetReceipts(grpc::CallbackServerContext * context, const GetReceiptsRequest * request, ReceiptsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetReceiptDetails
+         */
+        grpc::ServerUnaryReactor * GetReceiptDetails(grpc::CallbackServerContext * context, const GetReceiptDetailsRequest * request, ReceiptDetailsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::CreateTransaction
+         */
+        grpc::ServerUnaryReactor * CreateTransaction(grpc::CallbackServerContext * context, const CreateTransactionRequest * request, CreateTransactionResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::UpdateTransaction
+         */
+        grpc::ServerUnaryReactor * UpdateTransaction(grpc::CallbackServerContext * context, const UpdateTransactionRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::DeleteTransaction
+         */
+        grpc::ServerUnaryReactor * DeleteTransaction(grpc::CallbackServerContext * context, const DeleteTransactionRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetTransactions
+         */
+        grpc::ServerUnaryReactor * GetTransactions(grpc::CallbackServerContext * context, const GetTransactionsRequest * request, TransactionsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetTransactionDetails
+         */
+        grpc::ServerUnaryReactor * GetTransactionDetails(grpc::CallbackServerContext * context, const GetTransactionDetailsRequest * request, TransactionDetailsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::CreateSplit
+         */
+        grpc::ServerUnaryReactor * CreateSplit(grpc::CallbackServerContext * context, const CreateSplitRequest * request, CreateSplitResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::UpdateSplit
+         */
+        grpc::ServerUnaryReactor * UpdateSplit(grpc::CallbackServerContext * context, const UpdateSplitRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::DeleteSplit
+         */
+        grpc::ServerUnaryReactor * DeleteSplit(grpc::CallbackServerContext * context, const DeleteSplitRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetCharacters
+         */
+        grpc::ServerUnaryReactor * GetCharacters(grpc::CallbackServerContext * context, const GetCharactersRequest * request, CharactersResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ManageCharacter
+         */
+        grpc::ServerUnaryReactor * ManageCharacter(grpc::CallbackServerContext * context, const ManageCharacterRequest * request, ManageCharacterResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::DeleteCharacter
+         */
+        grpc::ServerUnaryReactor * DeleteCharacter(grpc::CallbackServerContext * context, const ManageCharacterRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetCategories
+         */
+        grpc::ServerUnaryReactor * GetCategories(grpc::CallbackServerContext * context, const GetCategoriesRequest * request, CategoriesResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ManageCategory
+         */
+        grpc::ServerUnaryReactor * ManageCategory(grpc::CallbackServerContext * context, const ManageCategoryRequest * request, ManageCategoryResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::DeleteCategory
+         */
+        grpc::ServerUnaryReactor * DeleteCategory(grpc::CallbackServerContext * context, const ManageCategoryRequest * request, Response * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::GetStatistics
+         */
+        grpc::ServerUnaryReactor * GetStatistics(grpc::CallbackServerContext * context, const GetStatisticsRequest * request, StatisticsResponse * response) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ExportTransactions
+         *
+         * The export runs on the export executor and waits for every chunk to be sent before reading
+         * the next rows, so the export thread is held until the client received everything or
+         * a chunk was not received within the write timeout.
+         */
+        grpc::ServerWriteReactor< TransactionsChunk > * ExportTransactions(grpc::CallbackServerContext * context, const ExportRequest * request) override;
+
+        /**
+         * @brief Asynchronous counterpart of FinanceServiceImpl::ExportReceipts
+         */
+        grpc::ServerWriteReactor< ReceiptsChunk > * ExportReceipts(grpc::CallbackServerContext * context, const ExportRequest * request) override;
+
+    private:
+        /**
+         * @brief Pointer to a synchronous FinanceServiceImpl handler
+         */
+        template < typename Request, typename Response >
+        using Handler = grpc::Status (FinanceServiceImpl::*)(grpc::ServerContext *, const Request *, Response *);
+
+        /**
+         * @brief Runs a synchronous handler on the executor and finishes the call with its status
+         * @param context The callback server context
+         * @param request The request message
+         * @param response The response message
+         * @param handler Synchronous handler to execute
+         * @return Reactor finished when the handler completes
+         */
+        template < typename Request, typename Response >
+        grpc::ServerUnaryReactor * dispatch(grpc::CallbackServerContext * context, const Request * request, Response * response, Handler< Request, Response > handler);
+
+    private:
+        /**
+         * @brief Synchronous service implementation
+         */
+        std::shared_ptr< FinanceServiceImpl > impl_;
+
+        /**
+         * @brief Executor for blocking database work
+         */
+        std::shared_ptr< cxx::ThreadPool > executor_;
+
+        /**
+         * @brief Executor for streaming exports
+         */
+        std::shared_ptr< cxx::ThreadPool > exportExecutor_;
+
+        /**
+         * @brief Time a client has to receive one export chunk
+         */
+        std::chrono::milliseconds exportWriteTimeout_;
+    };
+
+} // namespace wallet
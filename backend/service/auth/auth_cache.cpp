@@ -0,0 +1,101 @@
+#include "auth_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace wallet;
+
+AuthCache::Shard::Shard(std::size_t capacity)
+  : entries(capacity) {
+}
+
+AuthCache::AuthCache()
+  : AuthCache(Settings{}) {
+}
+
+AuthCache::AuthCache(Settings settings)
+  : settings_(settings) {
+    if (settings_.capacity == 0) {
+        return;
+    }
+
+    const std::size_t shardCount = std::max< std::size_t >(1, std::min(settings_.shards, settings_.capacity));
+    const std::size_t shardCapacity = (settings_.capacity + shardCount - 1) / shardCount;
+
+    shards_.reserve(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        shards_.push_back(std::make_unique< Shard >(shardCapacity));
+    }
+}
+
+AuthCache::EStatus AuthCache::find(const std::string & token, int32_t & userId) {
+    if (shards_.empty()) {
+        return EStatus::MISS;
+    }
+
+    auto & shard = shardFor(token);
+    std::lock_guard lock(shard.mutex);
+
+    auto * entry = shard.entries.find(token);
+    if (entry == nullptr) {
+        return EStatus::MISS;
+    }
+    if (entry->expiresAt <= Clock::now()) {
+        shard.entries.erase(token);
+        return EStatus::MISS;
+    }
+    if (!entry->userId.has_value()) {
+        return EStatus::REJECTED;
+    }
+
+    userId = *entry->userId;
+    return EStatus::AUTHENTICATED;
+}
+
+void AuthCache::storeUser(const std::string & token, int32_t userId) {
+    store(token, userId, settings_.ttl);
+}
+
+void AuthCache::storeRejected(const std::string & token) {
+    store(token, std::nullopt, settings_.negativeTtl);
+}
+
+void AuthCache::invalidate(const std::string & token) {
+    if (shards_.empty()) {
+        return;
+    }
+
+    auto & shard = shardFor(token);
+    std::lock_guard lock(shard.mutex);
+    shard.entries.erase(token);
+}
+
+void AuthCache::clear() {
+    for (auto & shard: shards_) {
+        std::lock_guard lock(shard->mutex);
+        shard->entries.clear();
+    }
+}
+
+std::size_t AuthCache::size() const {
+    std::size_t total = 0;
+    for (const auto & shard: shards_) {
+        std::lock_guard lock(shard->mutex);
+        total += shard->entries.size();
+    }
+    return total;
+}
+
+AuthCache::Shard & AuthCache::shardFor(const std::string & token) const {
+    return *shards_[std::hash< std::string >{}(token) % shards_.size()];
+}
+
+void AuthCache::store(const std::string & token, std::optional< int32_t > userId, std::chrono::milliseconds ttl) {
+    if (shards_.empty() || ttl <= std::chrono::milliseconds::zero()) {
+        return;
+    }
+
+    auto & shard = shardFor(token);
+    std::lock_guard lock(shard.mutex);
+    shard.entries.insert(token, Entry{ userId, Clock::now() + ttl });
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <utils/cache/lru/lru_cache.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace wallet {
+
+    /**
+     * @brief In-process cache of token to user ID resolutions
+     *
+     * Tokens are distributed between independent shards by hash, each shard is an LRU cache
+     * guarded by its own mutex, so concurrent handlers rarely contend on the same lock.
+     * Successful lookups are kept for Settings::ttl, unknown tokens are remembered for
+     * Settings::negativeTtl to absorb repeated requests with a bad token.
+     *
+     * Entries must be invalidated when a token is (re)assigned, otherwise a stale negative
+     * entry may reject a valid token until it expires.
+     */
+    class AuthCache final {
+    public:
+        /**
+         * @brief Cache sizing and expiration parameters
+         */
+        struct Settings {
+            std::size_t capacity = 65'536;                  /**< Total number of cached tokens, zero disables the cache */
+            std::size_t shards = 16;                        /**< Number of independently locked shards */
+            std::chrono::milliseconds ttl{ 60'000 };        /**< Lifetime of a resolved token */
+            std::chrono::milliseconds negativeTtl{ 5000 };  /**< Lifetime of a rejected token, zero disables negative caching */
+        };
+
+        /**
+         * @brief Result of a cache lookup
+         */
+        enum class EStatus {
+            MISS,          /**< Token is unknown to the cache, the database must be queried */
+            AUTHENTICATED, /**< Token belongs to a user */
+            REJECTED       /**< Token was recently looked up and does not belong to any user */
+        };
+
+    public:
+        /**
+         * @brief Constructs an empty cache with default settings
+         */
+        AuthCache();
+
+        /**
+         * @brief Constructs an empty cache
+         * @param settings Cache parameters
+         */
+        explicit AuthCache(Settings settings);
+
+        AuthCache(const AuthCache &) = delete;
+        AuthCache & operator=(const AuthCache &) = delete;
+
+        /**
+         * @brief Looks up a token
+         * @param token The authentication token
+         * @param userId Output parameter set to the user ID when the token is authenticated
+         * @return Lookup status, expired entries are reported as a miss
+         */
+        EStatus find(const std::string & token, int32_t & userId);
+
+        /**
+         * @brief Remembers that the token belongs to the user
+         * @param token The authentication token
+         * @param userId ID of the token owner
+         */
+        void storeUser(const std::string & token, int32_t userId);
+
+        /**
+         * @brief Remembers that the token does not belong to any user
+         * @param token The authentication token
+         */
+        void storeRejected(const std::string & token);
+
+        /**
+         * @brief Drops the cached resolution of a token
+         * @param token The authentication token
+         */
+        void invalidate(const std::string & token);
+
+        /**
+         * @brief Drops all cached resolutions
+         */
+        void clear();
+
+        /**
+         * @brief Number of cached tokens, including expired entries not yet evicted
+         */
+        std::size_t size() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Cached resolution, userId is empty for rejected tokens
+         */
+        struct Entry {
+            std::optional< int32_t > userId;
+            Clock::time_point expiresAt;
+        };
+
+        /**
+         * @brief Independently locked part of the cache
+         */
+        struct Shard {
+            explicit Shard(std::size_t capacity);
+
+            mutable std::mutex mutex;
+            cxx::LruCache< std::string, Entry > entries;
+        };
+
+        Shard & shardFor(const std::string & token) const;
+
+        void store(const std::string & token, std::optional< int32_t > userId, std::chrono::milliseconds ttl);
+
+    private:
+        const Settings settings_;
+        std::vector< std::unique_ptr< Shard > > shards_;
+    };
+
+} // namespace wallet
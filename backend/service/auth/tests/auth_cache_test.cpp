@@ -0,0 +1,92 @@
+#include <backend/service/auth/auth_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wallet;
+using namespace std::chrono_literals;
+
+TEST(AuthCacheTest, StoresUsersAndRejectedTokens) {
+    AuthCache cache;
+
+    int32_t userId = 0;
+    EXPECT_EQ(cache.find("token", userId), AuthCache::EStatus::MISS);
+
+    cache.storeUser("token", 42);
+    EXPECT_EQ(cache.find("token", userId), AuthCache::EStatus::AUTHENTICATED);
+    EXPECT_EQ(userId, 42);
+
+    cache.storeRejected("bad");
+    EXPECT_EQ(cache.find("bad", userId), AuthCache::EStatus::REJECTED);
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(AuthCacheTest, EntriesExpire) {
+    AuthCache cache({ .ttl = 20ms, .negativeTtl = 0ms });
+
+    cache.storeUser("token", 1);
+    cache.storeRejected("bad");
+
+    int32_t userId = 0;
+    EXPECT_EQ(cache.find("token", userId), AuthCache::EStatus::AUTHENTICATED);
+    // Negative caching is disabled
+    EXPECT_EQ(cache.find("bad", userId), AuthCache::EStatus::MISS);
+
+    std::this_thread::sleep_for(40ms);
+    EXPECT_EQ(cache.find("token", userId), AuthCache::EStatus::MISS);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(AuthCacheTest, Invalidation) {
+    AuthCache cache;
+    cache.storeRejected("token");
+    cache.storeUser("other", 2);
+
+    cache.invalidate("token");
+    int32_t userId = 0;
+    EXPECT_EQ(cache.find("token", userId), AuthCache::EStatus::MISS);
+    EXPECT_EQ(cache.find("other", userId), AuthCache::EStatus::AUTHENTICATED);
+
+    cache.clear();
+    EXPECT_EQ(cache.find("other", userId), AuthCache::EStatus::MISS);
+}
+
+TEST(AuthCacheTest, CapacityIsBounded) {
+    AuthCache cache({ .capacity = 8, .shards = 4 });
+    for (int32_t i = 0; i < 100; ++i) {
+        cache.storeUser("token_" + std::to_string(i), i);
+    }
+    EXPECT_LE(cache.size(), 8);
+
+    AuthCache disabled({ .capacity = 0 });
+    disabled.storeUser("token", 1);
+    int32_t userId = 0;
+    EXPECT_EQ(disabled.find("token", userId), AuthCache::EStatus::MISS);
+}
+
+TEST(AuthCacheTest, ConcurrentAccess) {
+    AuthCache cache({ .capacity = 1024 });
+
+    std::vector< std::thread > threads;
+    for (int32_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int32_t i = 0; i < 1000; ++i) {
+                const auto token = "token_" + std::to_string((t * 1000 + i) % 256);
+                int32_t userId = 0;
+                if (cache.find(token, userId) == AuthCache::EStatus::MISS) {
+                    cache.storeUser(token, (t * 1000 + i) % 256);
+                } else {
+                    EXPECT_EQ(token, "token_" + std::to_string(userId));
+                }
+            }
+        });
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(cache.size(), 256);
+}
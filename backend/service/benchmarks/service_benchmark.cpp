@@ -0,0 +1,401 @@
+#include <backend/service/service.h>
+#include <backend/service/sqlite/sqlite_profile.h>
+#include <utils/database/sqlite/sqlite_database.h>
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/util/time_util.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cxx;
+using namespace wallet;
+using google::protobuf::util::TimeUtil;
+
+namespace {
+
+    const std::string TOKEN = "benchmark_token";
+    const std::string DEVICE_ID = "benchmark_device";
+
+    constexpr int RECEIPTS = 200;
+    constexpr int ITEMS_PER_RECEIPT = 10;
+    constexpr int TRANSACTIONS = 2'000;
+    constexpr int CATEGORIES = 20;
+    constexpr int CHARACTERS = 5;
+
+    std::string sequence(int count) {
+        return "WITH RECURSIVE seq(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM seq WHERE n < " + std::to_string(count) + ") ";
+    }
+
+    // One user with a year of history: receipts with items, transactions and splits, the triggers fill the daily rollups
+    std::vector< std::string > seedStatements() {
+        return {
+            "INSERT INTO users (id, token) VALUES (1, '" + TOKEN + "')",
+            "INSERT INTO users_data (user_id, device_id, device_name) VALUES (1, '" + DEVICE_ID + "', 'Benchmark')",
+            sequence(CATEGORIES) + "INSERT INTO categories (id, name) SELECT n, 'Категория ' || n FROM seq",
+            sequence(CHARACTERS) + "INSERT INTO user_characters (id, user_id, name) SELECT n, 1, 'Персонаж ' || n FROM seq",
+            sequence(RECEIPTS) + "INSERT INTO receipts (id, t, s, fn, i, fp, n) "
+                                 "SELECT n, '20240101T1200', n * 1000, 9284000100287274, n, 3906849540 + n, 1 FROM seq",
+            "INSERT INTO user_receipts (user_id, receipt_id) SELECT 1, id FROM receipts",
+            "INSERT INTO receipt_data (id, receipt_id, retailer_name, retailer_place, retailer_inn, retailer_address) "
+            "SELECT id, id, 'ООО \"Агроторг\"', 'Пятерочка', '7825706086', 'Санкт-Петербург' FROM receipts",
+            sequence(ITEMS_PER_RECEIPT) + "INSERT INTO receipt_items (receipt_data_id, name, price, quantity, amount, nds_type, "
+                                          "payment_type, product_type, measurement_unit) "
+                                          "SELECT rd.id, 'Товар ' || seq.n, 9999, 1, 9999, 1, 4, 1, 0 FROM receipt_data rd, seq",
+            sequence(TRANSACTIONS) + "INSERT INTO transactions (id, user_id, timestamp, type, amount, category_id, receipt_id, comment) "
+                                     "SELECT n, 1, datetime('2024-01-01', '+' || (n % 365) || ' days', '+' || n || ' seconds'), "
+                                     "n % 4 = 0, 100 + n, 1 + n % " + std::to_string(CATEGORIES) + ", "
+                                     "CASE WHEN n <= " + std::to_string(RECEIPTS) + " THEN n END, 'Транзакция ' || n FROM seq",
+            "INSERT INTO transaction_splits (transaction_id, character_id, amount) "
+            "SELECT id, 1 + id % " + std::to_string(CHARACTERS) + ", amount / 2 FROM transactions WHERE id % 4 = 1",
+        };
+    }
+
+    /**
+     * @brief Service over an in-memory SQLite database of the embedded mode seeded for a single user
+     */
+    class ServiceFixture: public benchmark::Fixture {
+    public:
+        void SetUp(const benchmark::State & /*state*/) override {
+            db_ = openSqliteDatabase(":memory:");
+            execute(seedStatements());
+            service_ = std::make_unique< FinanceServiceImpl >(db_);
+        }
+
+        void TearDown(const benchmark::State & /*state*/) override {
+            service_.reset();
+            db_.reset();
+        }
+
+    protected:
+        void execute(const std::vector< std::string > & statements) {
+            auto transaction = db_->makeTransaction();
+            for (const auto & statement: statements) {
+                if (!transaction->executeQuery(statement).has_value()) {
+                    throw std::runtime_error("Failed to seed the database: " + statement);
+                }
+            }
+            transaction->commit();
+        }
+
+        /**
+         * @brief Inserts a row outside of the measured time and returns its id
+         */
+        int32_t insertRow(benchmark::State & state, const std::string & query) {
+            state.PauseTiming();
+            auto result = db_->makeTransaction()->executeQuery(query + " RETURNING id");
+            state.ResumeTiming();
+            if (!result.has_value() || result->empty()) {
+                state.SkipWithError("Failed to insert a row");
+                return 0;
+            }
+            return (*result)[0][0].as< int32_t >();
+        }
+
+        template < typename Request >
+        static Request authorized() {
+            Request request;
+            request.mutable_auth()->set_token(TOKEN);
+            return request;
+        }
+
+        /**
+         * @brief Stops the benchmark on an error response, e.g. SQL the backend does not support
+         */
+        template < typename Response >
+        static bool succeeded(benchmark::State & state, const Response & response) {
+            if (!response.has_error()) {
+                return true;
+            }
+            const auto message = response.error().message() + (response.error().has_details() ? ": " + response.error().details() : "");
+            state.SkipWithError(message.c_str());
+            return false;
+        }
+
+    protected:
+        std::shared_ptr< SQLiteDatabase > db_;
+        std::unique_ptr< FinanceServiceImpl > service_;
+    };
+
+    BENCHMARK_F(ServiceFixture, Authenticate)(benchmark::State & state) {
+        AuthRequest request;
+        request.set_device_id(DEVICE_ID);
+        for (auto _: state) {
+            grpc::ServerContext context;
+            AuthResponse response;
+            service_->Authenticate(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, ProcessQRCode)(benchmark::State & state) {
+        auto request = authorized< QRCodeRequest >();
+        request.set_create_transaction(true);
+        int64_t documentNumber = RECEIPTS;
+        for (auto _: state) {
+            request.set_qr_code_content("t=20240301T1200&s=432.00&fn=9284000100287274&i=" + std::to_string(++documentNumber) + "&fp=3906849540&n=1");
+            grpc::ServerContext context;
+            ReceiptDetailsResponse response;
+            service_->ProcessQRCode(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, GetReceipts)(benchmark::State & state) {
+        auto request = authorized< GetReceiptsRequest >();
+        request.set_limit(50);
+        for (auto _: state) {
+            grpc::ServerContext context;
+            ReceiptsResponse response;
+            service_->GetReceipts(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, GetReceiptDetails)(benchmark::State & state) {
+        auto request = authorized< GetReceiptDetailsRequest >();
+        request.set_receipt_id(RECEIPTS / 2);
+        for (auto _: state) {
+            grpc::ServerContext context;
+            ReceiptDetailsResponse response;
+            service_->GetReceiptDetails(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, CreateTransaction)(benchmark::State & state) {
+        auto request = authorized< CreateTransactionRequest >();
+        auto * transaction = request.mutable_transaction();
+        transaction->set_type(1);
+        transaction->set_amount(43200);
+        *transaction->mutable_timestamp() = TimeUtil::SecondsToTimestamp(1'717'200'000);
+        transaction->set_category_id(1);
+        transaction->set_comment("Обед");
+        for (auto _: state) {
+            grpc::ServerContext context;
+            CreateTransactionResponse response;
+            service_->CreateTransaction(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, UpdateTransaction)(benchmark::State & state) {
+        auto request = authorized< UpdateTransactionRequest >();
+        auto * transaction = request.mutable_transaction();
+        transaction->set_id(TRANSACTIONS / 2);
+        transaction->set_type(1);
+        *transaction->mutable_timestamp() = TimeUtil::SecondsToTimestamp(1'717'200'000);
+        transaction->set_category_id(2);
+        int32_t amount = 0;
+        for (auto _: state) {
+            transaction->set_amount(++amount);
+            grpc::ServerContext context;
+            Response response;
+            service_->UpdateTransaction(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, DeleteTransaction)(benchmark::State & state) {
+        auto request = authorized< DeleteTransactionRequest >();
+        for (auto _: state) {
+            request.set_transaction_id(insertRow(state, "INSERT INTO transactions (user_id, timestamp, type, amount) VALUES (1, '2024-06-01 12:00:00', 1, 100)"));
+            grpc::ServerContext context;
+            Response response;
+            service_->DeleteTransaction(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_DEFINE_F(ServiceFixture, GetTransactions)(benchmark::State & state) {
+        auto request = authorized< GetTransactionsRequest >();
+        request.set_limit(static_cast< int32_t >(state.range(0)));
+        for (auto _: state) {
+            grpc::ServerContext context;
+            TransactionsResponse response;
+            service_->GetTransactions(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+            if (response.transactions().transactions().empty()) {
+                state.SkipWithError("No transactions returned");
+                break;
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK_REGISTER_F(ServiceFixture, GetTransactions)->Arg(20)->Arg(200);
+
+    BENCHMARK_F(ServiceFixture, GetTransactionDetails)(benchmark::State & state) {
+        auto request = authorized< GetTransactionDetailsRequest >();
+        // Linked to a receipt and split between characters
+        request.set_transaction_id(1);
+        for (auto _: state) {
+            grpc::ServerContext context;
+            TransactionDetailsResponse response;
+            service_->GetTransactionDetails(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, CreateSplit)(benchmark::State & state) {
+        auto request = authorized< CreateSplitRequest >();
+        auto * split = request.mutable_split();
+        split->set_character_id(1);
+        split->set_amount(50);
+        for (auto _: state) {
+            split->set_transaction_id(insertRow(state, "INSERT INTO transactions (user_id, timestamp, type, amount) VALUES (1, '2024-06-01 12:00:00', 1, 100)"));
+            grpc::ServerContext context;
+            CreateSplitResponse response;
+            service_->CreateSplit(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, UpdateSplit)(benchmark::State & state) {
+        auto request = authorized< UpdateSplitRequest >();
+        auto * split = request.mutable_split();
+        split->set_id(1);
+        int32_t amount = 0;
+        for (auto _: state) {
+            split->set_amount(++amount);
+            grpc::ServerContext context;
+            Response response;
+            service_->UpdateSplit(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, DeleteSplit)(benchmark::State & state) {
+        auto request = authorized< DeleteSplitRequest >();
+        for (auto _: state) {
+            request.set_split_id(insertRow(state, "INSERT INTO transaction_splits (transaction_id, character_id, amount) "
+                                                  "SELECT MAX(id), 1, 50 FROM transactions"));
+            grpc::ServerContext context;
+            Response response;
+            service_->DeleteSplit(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, GetCharacters)(benchmark::State & state) {
+        const auto request = authorized< GetCharactersRequest >();
+        for (auto _: state) {
+            grpc::ServerContext context;
+            CharactersResponse response;
+            service_->GetCharacters(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, ManageCharacter)(benchmark::State & state) {
+        auto request = authorized< ManageCharacterRequest >();
+        int64_t counter = 0;
+        for (auto _: state) {
+            request.set_name("Новый персонаж " + std::to_string(++counter));
+            grpc::ServerContext context;
+            ManageCharacterResponse response;
+            service_->ManageCharacter(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, DeleteCharacter)(benchmark::State & state) {
+        auto request = authorized< ManageCharacterRequest >();
+        int64_t counter = 0;
+        for (auto _: state) {
+            request.set_id(insertRow(state, "INSERT INTO user_characters (user_id, name) VALUES (1, 'Удаляемый " + std::to_string(++counter) + "')"));
+            grpc::ServerContext context;
+            Response response;
+            service_->DeleteCharacter(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, GetCategories)(benchmark::State & state) {
+        const auto request = authorized< GetCategoriesRequest >();
+        for (auto _: state) {
+            grpc::ServerContext context;
+            CategoriesResponse response;
+            service_->GetCategories(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, ManageCategory)(benchmark::State & state) {
+        auto request = authorized< ManageCategoryRequest >();
+        int64_t counter = 0;
+        for (auto _: state) {
+            request.set_name("Новая категория " + std::to_string(++counter));
+            grpc::ServerContext context;
+            ManageCategoryResponse response;
+            service_->ManageCategory(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, DeleteCategory)(benchmark::State & state) {
+        auto request = authorized< ManageCategoryRequest >();
+        int64_t counter = 0;
+        for (auto _: state) {
+            request.set_id(insertRow(state, "INSERT INTO categories (name) VALUES ('Удаляемая " + std::to_string(++counter) + "')"));
+            grpc::ServerContext context;
+            Response response;
+            service_->DeleteCategory(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+        }
+    }
+
+    BENCHMARK_F(ServiceFixture, GetStatistics)(benchmark::State & state) {
+        const auto request = authorized< GetStatisticsRequest >();
+        for (auto _: state) {
+            grpc::ServerContext context;
+            StatisticsResponse response;
+            service_->GetStatistics(&context, &request, &response);
+            if (!succeeded(state, response)) {
+                break;
+            }
+            if (response.statistics().chart_data().daily().empty()) {
+                state.SkipWithError("No statistics returned");
+                break;
+            }
+        }
+    }
+
+} // unnamed namespace
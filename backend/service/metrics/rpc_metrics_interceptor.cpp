@@ -0,0 +1,129 @@
+#include "rpc_metrics_interceptor.h"
+
+#include <google/protobuf/descriptor.h>
+
+using namespace wallet;
+
+using grpc::experimental::InterceptionHookPoints;
+
+RpcMethodMetrics::RpcMethodMetrics(cxx::MetricsRegistry & registry, std::string method)
+  : registry_(registry)
+  , method_(std::move(method))
+  , duration_(registry.histogram("wallet_rpc_duration_seconds", "RPC latency by method", { { "method", method_ } }))
+  , inFlight_(registry.gauge("wallet_rpc_in_flight", "RPCs being processed")) {
+}
+
+cxx::Histogram & RpcMethodMetrics::duration() noexcept {
+    return duration_;
+}
+
+cxx::Gauge & RpcMethodMetrics::inFlight() noexcept {
+    return inFlight_;
+}
+
+cxx::Counter & RpcMethodMetrics::error(ErrorInfo::ErrorCode code) {
+    if (static_cast< std::size_t >(code) >= errors_.size()) {
+        // Codes unknown to this build are not cached
+        return registry_.counter("wallet_rpc_errors_total", "RPC errors by method and error code", { { "method", method_ }, { "code", std::to_string(code) } });
+    }
+    return errorCounter(errors_[code], ErrorInfo::ErrorCode_Name(code));
+}
+
+cxx::Counter & RpcMethodMetrics::error(grpc::StatusCode code) {
+    const auto index = static_cast< std::size_t >(code);
+    if (index >= statusErrors_.size()) {
+        return registry_.counter("wallet_rpc_errors_total", "RPC errors by method and error code", { { "method", method_ }, { "code", "GRPC_" + std::to_string(index) } });
+    }
+    return errorCounter(statusErrors_[index], "GRPC_" + std::to_string(index));
+}
+
+cxx::Counter & RpcMethodMetrics::errorCounter(std::atomic< cxx::Counter * > & slot, const std::string & code) {
+    auto * counter = slot.load(std::memory_order_acquire);
+    if (!counter) {
+        // Concurrent first errors get the same series from the registry
+        counter = &registry_.counter("wallet_rpc_errors_total", "RPC errors by method and error code", { { "method", method_ }, { "code", code } });
+        slot.store(counter, std::memory_order_release);
+    }
+    return *counter;
+}
+
+RpcMetricsInterceptor::RpcMetricsInterceptor(RpcMethodMetrics & metrics)
+  : metrics_(metrics)
+  , start_(std::chrono::steady_clock::now()) {
+    metrics_.inFlight().add(1);
+}
+
+RpcMetricsInterceptor::~RpcMetricsInterceptor() {
+    metrics_.inFlight().add(-1);
+}
+
+void RpcMetricsInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods * methods) {
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_MESSAGE)) {
+        // All responses of the service are generated protobuf messages
+        if (const auto * message = static_cast< const google::protobuf::Message * >(methods->GetSendMessage()); message != nullptr) {
+            errorCode_ = responseErrorCode(*message);
+        }
+    }
+    if (methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+        record(methods->GetSendStatus());
+    }
+    methods->Proceed();
+}
+
+void RpcMetricsInterceptor::record(const grpc::Status & status) {
+    metrics_.duration().record(std::chrono::steady_clock::now() - start_);
+
+    if (errorCode_.has_value()) {
+        metrics_.error(*errorCode_).inc();
+    }
+    if (!status.ok()) {
+        metrics_.error(status.error_code()).inc();
+    }
+}
+
+RpcMetricsInterceptorFactory::RpcMetricsInterceptorFactory(cxx::MetricsRegistry & registry)
+  : registry_(registry) {
+    const auto * service = google::protobuf::DescriptorPool::generated_pool()->FindServiceByName("wallet.FinanceService");
+    for (int i = 0; service != nullptr && i < service->method_count(); ++i) {
+        const std::string name(service->method(i)->name());
+        services_.emplace("/" + std::string(service->full_name()) + "/" + name, std::make_unique< RpcMethodMetrics >(registry_, name));
+    }
+}
+
+grpc::experimental::Interceptor * RpcMetricsInterceptorFactory::CreateServerInterceptor(grpc::experimental::ServerRpcInfo * info) {
+    return new RpcMetricsInterceptor(methodMetrics(info->method() != nullptr ? info->method() : ""));
+}
+
+RpcMethodMetrics & RpcMetricsInterceptorFactory::methodMetrics(std::string_view fullName) {
+    if (const auto it = services_.find(fullName); it != services_.end()) {
+        return *it->second;
+    }
+
+    std::lock_guard lock(mutex_);
+    auto it = otherMethods_.find(fullName);
+    if (it == otherMethods_.end()) {
+        it = otherMethods_.emplace(std::string(fullName), std::make_unique< RpcMethodMetrics >(registry_, rpcMethodName(fullName))).first;
+    }
+    return *it->second;
+}
+
+std::string wallet::rpcMethodName(std::string_view fullName) {
+    const auto separator = fullName.rfind('/');
+    return std::string(separator == std::string_view::npos ? fullName : fullName.substr(separator + 1));
+}
+
+std::optional< ErrorInfo::ErrorCode > wallet::responseErrorCode(const google::protobuf::Message & response) {
+    const auto * field = response.GetDescriptor()->FindFieldByName("error");
+    if (field == nullptr || field->is_repeated() || field->message_type() != ErrorInfo::descriptor()) {
+        return std::nullopt;
+    }
+
+    const auto * reflection = response.GetReflection();
+    if (!reflection->HasField(response, field)) {
+        return std::nullopt;
+    }
+
+    const auto & error = reflection->GetMessage(response, field);
+    const auto * codeField = ErrorInfo::descriptor()->FindFieldByNumber(ErrorInfo::kCodeFieldNumber);
+    return static_cast< ErrorInfo::ErrorCode >(error.GetReflection()->GetEnumValue(error, codeField));
+}
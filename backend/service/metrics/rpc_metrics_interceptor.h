@@ -0,0 +1,158 @@
+#pragma once
+
+#include <proto/wallet/service.pb.h>
+#include <utils/metrics/registry/metrics_registry.h>
+
+#include <grpcpp/support/server_interceptor.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace wallet {
+
+    /**
+     * @class RpcMethodMetrics
+     * @brief Series of one method, looked up in the registry once and shared by its calls
+     *
+     * Recording only touches the cached metrics. Error counters are created on the first
+     * error with their code, so codes that never occur have no series.
+     */
+    class RpcMethodMetrics final {
+    public:
+        /**
+         * @param registry Registry to record into
+         * @param method Short method name used as the label
+         */
+        RpcMethodMetrics(cxx::MetricsRegistry & registry, std::string method);
+
+        RpcMethodMetrics(const RpcMethodMetrics &) = delete;
+        RpcMethodMetrics & operator=(const RpcMethodMetrics &) = delete;
+
+        cxx::Histogram & duration() noexcept;
+        cxx::Gauge & inFlight() noexcept;
+
+        /**
+         * @brief Counter of responses carrying the error code
+         */
+        cxx::Counter & error(ErrorInfo::ErrorCode code);
+
+        /**
+         * @brief Counter of calls finished with the non-OK status code
+         */
+        cxx::Counter & error(grpc::StatusCode code);
+
+    private:
+        cxx::Counter & errorCounter(std::atomic< cxx::Counter * > & slot, const std::string & code);
+
+    private:
+        // gRPC status codes are 0 to UNAUTHENTICATED
+        static constexpr std::size_t STATUS_CODES = grpc::StatusCode::UNAUTHENTICATED + 1;
+
+    private:
+        cxx::MetricsRegistry & registry_;
+        const std::string method_;
+        cxx::Histogram & duration_;
+        cxx::Gauge & inFlight_;
+        std::array< std::atomic< cxx::Counter * >, ErrorInfo::ErrorCode_ARRAYSIZE > errors_{};
+        std::array< std::atomic< cxx::Counter * >, STATUS_CODES > statusErrors_{};
+    };
+
+    /**
+     * @class RpcMetricsInterceptor
+     * @brief Records metrics of a single call, see RpcMetricsInterceptorFactory
+     */
+    class RpcMetricsInterceptor final: public grpc::experimental::Interceptor {
+    public:
+        /**
+         * @param metrics Series of the called method, must outlive the interceptor
+         */
+        explicit RpcMetricsInterceptor(RpcMethodMetrics & metrics);
+
+        ~RpcMetricsInterceptor() override;
+
+        void Intercept(grpc::experimental::InterceptorBatchMethods * methods) override;
+
+    private:
+        void record(const grpc::Status & status);
+
+    private:
+        RpcMethodMetrics & metrics_;
+        const std::chrono::steady_clock::time_point start_;
+        std::optional< ErrorInfo::ErrorCode > errorCode_;
+    };
+
+    /**
+     * @class RpcMetricsInterceptorFactory
+     * @brief Creates server interceptors recording per-method RPC metrics
+     *
+     * Every call is measured from its creation to sending the status:
+     * - wallet_rpc_duration_seconds{method} - latency histogram;
+     * - wallet_rpc_errors_total{method, code} - responses carrying ErrorInfo, by ErrorInfo::ErrorCode,
+     *   and calls finished with a non-OK gRPC status, by "GRPC_" + status code;
+     * - wallet_rpc_in_flight - calls being processed.
+     *
+     * Works for both the sync and the callback service, the interceptor runs on the thread
+     * that handles the call. The series of every FinanceService method are resolved when the
+     * factory is created, a call only looks up its method in an immutable map; other methods
+     * are added under a lock on their first call.
+     */
+    class RpcMetricsInterceptorFactory final: public grpc::experimental::ServerInterceptorFactoryInterface {
+    public:
+        /**
+         * @param registry Registry to record into, must outlive the server
+         */
+        explicit RpcMetricsInterceptorFactory(cxx::MetricsRegistry & registry = cxx::MetricsRegistry::global());
+
+        grpc::experimental::Interceptor * CreateServerInterceptor(grpc::experimental::ServerRpcInfo * info) override;
+
+    private:
+        RpcMethodMetrics & methodMetrics(std::string_view fullName);
+
+    private:
+        /**
+         * @brief Allows lookups by std::string_view
+         */
+        struct NameHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view name) const noexcept {
+                return std::hash< std::string_view >{}(name);
+            }
+        };
+
+        using Methods = std::unordered_map< std::string, std::unique_ptr< RpcMethodMetrics >, NameHash, std::equal_to<> >;
+
+    private:
+        cxx::MetricsRegistry & registry_;
+
+        /**
+         * @brief Methods of FinanceService by full name, never changed after construction
+         */
+        Methods services_;
+
+        std::mutex mutex_;
+        Methods otherMethods_;
+    };
+
+    /**
+     * @brief Short method name from the full gRPC name, "/wallet.FinanceService/GetReceipts" -> "GetReceipts"
+     */
+    std::string rpcMethodName(std::string_view fullName);
+
+    /**
+     * @brief Error code of a response whose set "error" field is ErrorInfo
+     *
+     * @param response Response message
+     * @return Error code or empty if the response is not an error
+     */
+    std::optional< ErrorInfo::ErrorCode > responseErrorCode(const google::protobuf::Message & response);
+
+} // namespace wallet
@@ -0,0 +1,140 @@
+#include <backend/service/metrics/rpc_metrics_interceptor.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <string>
+
+using namespace wallet;
+using grpc::experimental::InterceptionHookPoints;
+
+namespace {
+
+    /**
+     * @brief Batch of a server call with the given hook points, everything else is unused
+     */
+    class FakeBatchMethods final: public grpc::experimental::InterceptorBatchMethods {
+    public:
+        FakeBatchMethods(std::set< InterceptionHookPoints > points, const void * message = nullptr, grpc::Status status = grpc::Status::OK)
+          : points_(std::move(points))
+          , message_(message)
+          , status_(std::move(status)) {
+        }
+
+        bool QueryInterceptionHookPoint(InterceptionHookPoints type) override {
+            return points_.contains(type);
+        }
+        void Proceed() override {
+            ++proceeded;
+        }
+        void Hijack() override {
+        }
+        grpc::ByteBuffer * GetSerializedSendMessage() override {
+            return nullptr;
+        }
+        const void * GetSendMessage() override {
+            return message_;
+        }
+        void ModifySendMessage(const void *) override {
+        }
+        bool GetSendMessageStatus() override {
+            return true;
+        }
+        std::multimap< std::string, std::string > * GetSendInitialMetadata() override {
+            return nullptr;
+        }
+        grpc::Status GetSendStatus() override {
+            return status_;
+        }
+        void ModifySendStatus(const grpc::Status &) override {
+        }
+        std::multimap< std::string, std::string > * GetSendTrailingMetadata() override {
+            return nullptr;
+        }
+        void * GetRecvMessage() override {
+            return nullptr;
+        }
+        std::multimap< grpc::string_ref, grpc::string_ref > * GetRecvInitialMetadata() override {
+            return nullptr;
+        }
+        grpc::Status * GetRecvStatus() override {
+            return nullptr;
+        }
+        std::multimap< grpc::string_ref, grpc::string_ref > * GetRecvTrailingMetadata() override {
+            return nullptr;
+        }
+        std::unique_ptr< grpc::ChannelInterface > GetInterceptedChannel() override {
+            return nullptr;
+        }
+        void FailHijackedRecvMessage() override {
+        }
+        void FailHijackedSendMessage() override {
+        }
+
+    public:
+        int proceeded = 0;
+
+    private:
+        const std::set< InterceptionHookPoints > points_;
+        const void * message_;
+        const grpc::Status status_;
+    };
+
+    ReceiptsResponse makeError(ErrorInfo::ErrorCode code) {
+        ReceiptsResponse response;
+        response.mutable_error()->set_code(code);
+        return response;
+    }
+
+} // unnamed namespace
+
+TEST(RpcMetricsInterceptorTest, MethodNameIsShortened) {
+    EXPECT_EQ(rpcMethodName("/wallet.FinanceService/ProcessQRCode"), "ProcessQRCode");
+    EXPECT_EQ(rpcMethodName("Plain"), "Plain");
+}
+
+TEST(RpcMetricsInterceptorTest, ErrorCodeIsReadFromResponse) {
+    EXPECT_EQ(responseErrorCode(makeError(ErrorInfo::NOT_FOUND)), ErrorInfo::NOT_FOUND);
+    EXPECT_EQ(responseErrorCode(makeError(ErrorInfo::UNKNOWN_ERROR)), ErrorInfo::UNKNOWN_ERROR);
+    EXPECT_FALSE(responseErrorCode(ReceiptsResponse()).has_value());
+    EXPECT_FALSE(responseErrorCode(ErrorInfo()).has_value());
+}
+
+TEST(RpcMetricsInterceptorTest, RecordsLatencyErrorsAndInFlight) {
+    cxx::MetricsRegistry registry;
+    const auto & inFlight = registry.gauge("wallet_rpc_in_flight", "");
+    RpcMethodMetrics metrics(registry, "GetReceipts");
+
+    {
+        RpcMetricsInterceptor interceptor(metrics);
+        EXPECT_EQ(inFlight.value(), 1);
+
+        const auto response = makeError(ErrorInfo::UNAUTHORIZED);
+        FakeBatchMethods send({ InterceptionHookPoints::PRE_SEND_MESSAGE }, &response);
+        interceptor.Intercept(&send);
+        FakeBatchMethods finish({ InterceptionHookPoints::PRE_SEND_STATUS });
+        interceptor.Intercept(&finish);
+        EXPECT_EQ(send.proceeded + finish.proceeded, 2);
+    }
+    {
+        RpcMetricsInterceptor interceptor(metrics);
+        FakeBatchMethods finish({ InterceptionHookPoints::PRE_SEND_STATUS }, nullptr, grpc::Status(grpc::StatusCode::UNAVAILABLE, "busy"));
+        interceptor.Intercept(&finish);
+    }
+
+    EXPECT_EQ(inFlight.value(), 0);
+    EXPECT_EQ(registry.histogram("wallet_rpc_duration_seconds", "", { { "method", "GetReceipts" } }).snapshot().count(), 2);
+    EXPECT_EQ(registry.counter("wallet_rpc_errors_total", "", { { "method", "GetReceipts" }, { "code", "UNAUTHORIZED" } }).value(), 1);
+    EXPECT_EQ(registry.counter("wallet_rpc_errors_total", "", { { "method", "GetReceipts" }, { "code", "GRPC_14" } }).value(), 1);
+}
+
+TEST(RpcMetricsInterceptorTest, ErrorSeriesAppearOnFirstError) {
+    cxx::MetricsRegistry registry;
+    RpcMethodMetrics metrics(registry, "GetReceipts");
+    EXPECT_EQ(registry.renderPrometheus().find("wallet_rpc_errors_total{"), std::string::npos);
+
+    EXPECT_EQ(&metrics.error(ErrorInfo::NOT_FOUND), &metrics.error(ErrorInfo::NOT_FOUND));
+    EXPECT_EQ(&metrics.error(ErrorInfo::NOT_FOUND), &registry.counter("wallet_rpc_errors_total", "", { { "method", "GetReceipts" }, { "code", "NOT_FOUND" } }));
+    EXPECT_EQ(&metrics.error(grpc::StatusCode::INTERNAL), &registry.counter("wallet_rpc_errors_total", "", { { "method", "GetReceipts" }, { "code", "GRPC_13" } }));
+}
@@ -5,15 +5,22 @@
 
 #include <backend/receipt/data/qr/qr.h>
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <functional>
 #include <iomanip>
+#include <optional>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 using namespace wallet;
 using google::protobuf::Timestamp;
-using google::protobuf::util::TimeUtil;
 
 namespace {
 
@@ -46,55 +53,493 @@ namespace {
         return protoTimestamp;
     }
 
-    template < class... Ts >
-    struct Overloaded: Ts... {
-        using Ts::operator()...;
+    /**
+     * @brief Formats a timestamp as UTC 'YYYY-MM-DD HH:MM:SS[.ffffff]'
+     *
+     * Both databases parse this form, and SQLite, which keeps timestamps as text,
+     * orders such strings the same way as the time points.
+     */
+    std::string toSqlTimestamp(const Timestamp & timestamp) {
+        const auto seconds = static_cast< time_t >(timestamp.seconds());
+        struct tm tm = {};
+        gmtime_r(&seconds, &tm);
+
+        char buffer[64];
+        const std::size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        const int32_t microseconds = timestamp.nanos() / 1000;
+        if (microseconds > 0) {
+            std::snprintf(buffer + length, sizeof(buffer) - length, ".%06d", microseconds);
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Named SQL statement executed through the prepared statement cache
+     *
+     * Statements that need PostgreSQL casts carry a separate SQLite text.
+     */
+    struct Statement {
+        std::string name;
+        std::string sql;
+        std::string sqliteSql = {};
+
+        const std::string & text(cxx::ESqlDialect dialect) const {
+            return dialect == cxx::ESqlDialect::SQLITE && !sqliteSql.empty() ? sqliteSql : sql;
+        }
+    };
+
+    const Statement FIND_USER_BY_TOKEN{
+        "find_user_by_token",
+        "SELECT id FROM users WHERE token = $1"
+    };
+
+    // Optional filters are passed as NULL, so every request shares one plan.
+    // The first row always carries the totals; page columns are NULL when the page is empty.
+    const Statement SELECT_TRANSACTIONS{
+        "select_transactions",
+        "WITH filtered AS ("
+        "  SELECT t.id, t.timestamp, t.type, t.amount, t.category_id, t.receipt_id, t.comment "
+        "  FROM transactions t "
+        "  WHERE t.user_id = $1 "
+        "  AND ($2::timestamp IS NULL OR t.timestamp >= $2::timestamp) "
+        "  AND ($3::timestamp IS NULL OR t.timestamp <= $3::timestamp) "
+        "  AND ($4::integer IS NULL OR t.type = $4::integer) "
+        "  AND ($5::integer IS NULL OR t.category_id = $5::integer)"
+        "), totals AS ("
+        "  SELECT COUNT(*) AS total_count, "
+        "  COALESCE(SUM(amount) FILTER (WHERE type = 0), 0) AS total_income, "
+        "  COALESCE(SUM(amount) FILTER (WHERE type = 1), 0) AS total_expense "
+        "  FROM filtered"
+        "), page AS ("
+        "  SELECT f.* FROM filtered f "
+        "  WHERE $6::timestamp IS NULL OR (f.timestamp, f.id) < ($6::timestamp, $7::integer) "
+        "  ORDER BY f.timestamp DESC, f.id DESC "
+        "  LIMIT $8 OFFSET $9"
+        "), split AS ("
+        "  SELECT DISTINCT ts.transaction_id FROM transaction_splits ts "
+        "  WHERE ts.transaction_id IN (SELECT id FROM page)"
+        ") "
+        "SELECT tot.total_count, tot.total_income, tot.total_expense, "
+        "p.id, p.timestamp, p.type, p.amount, p.category_id, c.name, p.receipt_id, p.comment, "
+        "s.transaction_id IS NOT NULL "
+        "FROM totals tot "
+        "LEFT JOIN page p ON TRUE "
+        "LEFT JOIN categories c ON c.id = p.category_id "
+        "LEFT JOIN split s ON s.transaction_id = p.id "
+        "ORDER BY p.timestamp DESC, p.id DESC",
+        "WITH filtered AS ("
+        "  SELECT t.id, t.timestamp, t.type, t.amount, t.category_id, t.receipt_id, t.comment "
+        "  FROM transactions t "
+        "  WHERE t.user_id = $1 "
+        "  AND ($2 IS NULL OR t.timestamp >= $2) "
+        "  AND ($3 IS NULL OR t.timestamp <= $3) "
+        "  AND ($4 IS NULL OR t.type = $4) "
+        "  AND ($5 IS NULL OR t.category_id = $5)"
+        "), totals AS ("
+        "  SELECT COUNT(*) AS total_count, "
+        "  COALESCE(SUM(amount) FILTER (WHERE type = 0), 0) AS total_income, "
+        "  COALESCE(SUM(amount) FILTER (WHERE type = 1), 0) AS total_expense "
+        "  FROM filtered"
+        "), page AS ("
+        "  SELECT f.* FROM filtered f "
+        "  WHERE $6 IS NULL OR (f.timestamp, f.id) < ($6, $7) "
+        "  ORDER BY f.timestamp DESC, f.id DESC "
+        "  LIMIT $8 OFFSET $9"
+        "), split AS ("
+        "  SELECT DISTINCT ts.transaction_id FROM transaction_splits ts "
+        "  WHERE ts.transaction_id IN (SELECT id FROM page)"
+        ") "
+        "SELECT tot.total_count, tot.total_income, tot.total_expense, "
+        "p.id, p.timestamp, p.type, p.amount, p.category_id, c.name, p.receipt_id, p.comment, "
+        "s.transaction_id IS NOT NULL "
+        "FROM totals tot "
+        "LEFT JOIN page p ON TRUE "
+        "LEFT JOIN categories c ON c.id = p.category_id "
+        "LEFT JOIN split s ON s.transaction_id = p.id "
+        "ORDER BY p.timestamp DESC, p.id DESC"
+    };
+
+    // Statistics are read from the daily rollups maintained by triggers, the range is applied by whole days
+    const Statement SELECT_DAILY_STATS{
+        "select_daily_stats",
+        "SELECT s.day, s.type, s.category_id, COALESCE(c.name, 'Без категории'), "
+        "s.transactions_count, s.total_amount "
+        "FROM user_daily_stats s "
+        "LEFT JOIN categories c ON c.id = s.category_id "
+        "WHERE s.user_id = $1 "
+        "AND ($2::timestamp IS NULL OR s.day >= $2::timestamp::date) "
+        "AND ($3::timestamp IS NULL OR s.day <= $3::timestamp::date) "
+        "AND s.transactions_count > 0 "
+        "ORDER BY s.day",
+        "SELECT s.day, s.type, s.category_id, COALESCE(c.name, 'Без категории'), "
+        "s.transactions_count, s.total_amount "
+        "FROM user_daily_stats s "
+        "LEFT JOIN categories c ON c.id = s.category_id "
+        "WHERE s.user_id = $1 "
+        "AND ($2 IS NULL OR s.day >= date($2)) "
+        "AND ($3 IS NULL OR s.day <= date($3)) "
+        "AND s.transactions_count > 0 "
+        "ORDER BY s.day"
+    };
+
+    const Statement SELECT_CHARACTER_STATS{
+        "select_character_stats",
+        "SELECT s.character_id, uc.name, SUM(s.splits_count), SUM(s.total_amount) AS total_amount "
+        "FROM user_daily_character_stats s "
+        "JOIN user_characters uc ON uc.id = s.character_id "
+        "WHERE s.user_id = $1 AND s.type = 1 "
+        "AND ($2::timestamp IS NULL OR s.day >= $2::timestamp::date) "
+        "AND ($3::timestamp IS NULL OR s.day <= $3::timestamp::date) "
+        "GROUP BY s.character_id, uc.name "
+        "HAVING SUM(s.splits_count) > 0 "
+        "ORDER BY total_amount DESC",
+        "SELECT s.character_id, uc.name, SUM(s.splits_count), SUM(s.total_amount) AS total_amount "
+        "FROM user_daily_character_stats s "
+        "JOIN user_characters uc ON uc.id = s.character_id "
+        "WHERE s.user_id = $1 AND s.type = 1 "
+        "AND ($2 IS NULL OR s.day >= date($2)) "
+        "AND ($3 IS NULL OR s.day <= date($3)) "
+        "GROUP BY s.character_id, uc.name "
+        "HAVING SUM(s.splits_count) > 0 "
+        "ORDER BY total_amount DESC"
+    };
+
+    // Exports walk the whole history once, so splits are probed per row instead of collected up front
+    const Statement EXPORT_TRANSACTIONS{
+        "export_transactions",
+        "SELECT t.id, t.timestamp, t.type, t.amount, t.category_id, c.name, t.receipt_id, t.comment, "
+        "EXISTS(SELECT 1 FROM transaction_splits ts WHERE ts.transaction_id = t.id) "
+        "FROM transactions t "
+        "LEFT JOIN categories c ON c.id = t.category_id "
+        "WHERE t.user_id = $1 "
+        "AND ($2::timestamp IS NULL OR t.timestamp >= $2::timestamp) "
+        "AND ($3::timestamp IS NULL OR t.timestamp <= $3::timestamp) "
+        "ORDER BY t.timestamp DESC, t.id DESC",
+        "SELECT t.id, t.timestamp, t.type, t.amount, t.category_id, c.name, t.receipt_id, t.comment, "
+        "EXISTS(SELECT 1 FROM transaction_splits ts WHERE ts.transaction_id = t.id) "
+        "FROM transactions t "
+        "LEFT JOIN categories c ON c.id = t.category_id "
+        "WHERE t.user_id = $1 "
+        "AND ($2 IS NULL OR t.timestamp >= $2) "
+        "AND ($3 IS NULL OR t.timestamp <= $3) "
+        "ORDER BY t.timestamp DESC, t.id DESC"
+    };
+
+    const Statement EXPORT_RECEIPTS{
+        "export_receipts",
+        "SELECT r.id, r.t, r.s, r.n, rd.retailer_name, "
+        "(SELECT COUNT(*) FROM receipt_items ri WHERE ri.receipt_data_id = rd.id), "
+        "EXISTS(SELECT 1 FROM transactions t WHERE t.receipt_id = r.id) "
+        "FROM receipts r "
+        "JOIN user_receipts ur ON ur.receipt_id = r.id "
+        "LEFT JOIN receipt_data rd ON rd.receipt_id = r.id "
+        "WHERE ur.user_id = $1 "
+        "AND ($2::timestamp IS NULL OR r.created_at >= $2::timestamp) "
+        "AND ($3::timestamp IS NULL OR r.created_at <= $3::timestamp) "
+        "ORDER BY r.t DESC, r.id DESC",
+        "SELECT r.id, r.t, r.s, r.n, rd.retailer_name, "
+        "(SELECT COUNT(*) FROM receipt_items ri WHERE ri.receipt_data_id = rd.id), "
+        "EXISTS(SELECT 1 FROM transactions t WHERE t.receipt_id = r.id) "
+        "FROM receipts r "
+        "JOIN user_receipts ur ON ur.receipt_id = r.id "
+        "LEFT JOIN receipt_data rd ON rd.receipt_id = r.id "
+        "WHERE ur.user_id = $1 "
+        "AND ($2 IS NULL OR r.created_at >= $2) "
+        "AND ($3 IS NULL OR r.created_at <= $3) "
+        "ORDER BY r.t DESC, r.id DESC"
     };
-    template < class... Ts >
-    Overloaded(Ts...) -> Overloaded< Ts... >;
-
-    template < typename T >
-    T getVariantValue(const std::variant< int, double, std::string, bool > & value) {
-        return std::visit(
-         Overloaded{
-          [](int v) -> T { if constexpr (std::is_same_v<std::string, T>) {return std::to_string(v);} else {return static_cast< T >(v);} },
-          [](double v) -> T { if constexpr (std::is_same_v<std::string, T>) {return std::to_string(v);} else {return static_cast< T >(v);} },
-          [](const std::string & v) -> T {
-              if constexpr (std::is_same_v< T, std::string >) {
-                  return v;
-              } else {
-                  try {
-                      if constexpr (std::is_same_v< T, int >) {
-                          return std::stoi(v);
-                      } else if constexpr (std::is_same_v< T, int32_t >) {
-                          return std::stoi(v);
-                      } else if constexpr (std::is_same_v< T, int64_t >) {
-                          return std::stoll(v);
-                      } else if constexpr (std::is_same_v< T, double >) {
-                          return std::stod(v);
-                      } else if constexpr (std::is_same_v< T, bool >) {
-                          return v == "true" || v == "1" || v == "t";
-                      }
-                  } catch (...) {
-                      return T{};
-                  }
-              }
-              throw std::runtime_error("Bad variant");
-          },
-          [](bool v) -> T {
-              if constexpr (std::is_same_v< std::string, T >) {
-                  return std::to_string(v);
-              } else {
-                  return static_cast< T >(v);
-              }
-          } },
-         value);
+
+    /**
+     * @brief Totals of one category accumulated from the daily rollup
+     */
+    struct CategoryTotals {
+        int32_t categoryId = 0;
+        std::string name;
+        int32_t count = 0;
+        int64_t amount = 0;
+    };
+
+    /**
+     * @brief Fills category statistics sorted by amount, largest first
+     */
+    template < typename AddStats >
+    void fillCategoryStatistics(std::vector< CategoryTotals > categories, AddStats addStats) {
+        std::sort(categories.begin(), categories.end(), [](const CategoryTotals & lhs, const CategoryTotals & rhs) {
+            return lhs.amount > rhs.amount;
+        });
+
+        int64_t total = 0;
+        for (const auto & category: categories) {
+            total += category.amount;
+        }
+
+        for (const auto & category: categories) {
+            auto * categoryStats = addStats();
+            categoryStats->set_category_id(category.categoryId);
+            categoryStats->set_category_name(category.name);
+            categoryStats->set_transactions_count(category.count);
+            categoryStats->set_total_amount(static_cast< int32_t >(category.amount));
+
+            double percentage = 0.0;
+            if (total > 0) {
+                percentage = (static_cast< double >(category.amount) / static_cast< double >(total)) * 100.0;
+            }
+            categoryStats->set_percentage(percentage);
+        }
+    }
+
+    /**
+     * @brief Position of the last row of a transactions page
+     */
+    struct TransactionsCursor {
+        std::string timestamp;
+        int32_t id = 0;
+    };
+
+    /**
+     * @brief Encodes a page position into an opaque cursor
+     *
+     * The timestamp is kept in the database text form, so the comparison on the next page
+     * is exact up to microseconds.
+     */
+    std::string encodeCursor(const std::string & timestamp, int32_t id) {
+        return timestamp + '#' + std::to_string(id);
+    }
+
+    std::optional< TransactionsCursor > decodeCursor(const std::string & cursor) {
+        const auto separator = cursor.rfind('#');
+        if (separator == std::string::npos || separator == 0) {
+            return std::nullopt;
+        }
+
+        TransactionsCursor result;
+        const auto * idBegin = cursor.data() + separator + 1;
+        const auto * idEnd = cursor.data() + cursor.size();
+        const auto [ptr, ec] = std::from_chars(idBegin, idEnd, result.id);
+        if (ec != std::errc() || ptr != idEnd || idBegin == idEnd) {
+            return std::nullopt;
+        }
+        result.timestamp = cursor.substr(0, separator);
+        return result;
+    }
+
+    // Receipts per multi-row statement, 6 parameters each stay far below the bind limits of both databases
+    constexpr std::size_t QR_BATCH_CHUNK = 200;
+
+    // Rows per export chunk, a few dozen kilobytes on the wire
+    constexpr std::size_t EXPORT_CHUNK_ROWS = 256;
+
+    /**
+     * @brief Fills a transaction from the columns id, timestamp, type, amount, category_id,
+     * category name, receipt_id, comment and has_splits starting at the given one
+     */
+    void fillTransactionInfo(const cxx::QueryResult::Row & row, std::size_t first, TransactionInfo * transaction) {
+        transaction->set_id(row[first].as< int32_t >());
+        *transaction->mutable_timestamp() = stringToProtoTimestamp(row[first + 1].as< std::string >());
+        transaction->set_type(row[first + 2].as< int32_t >());
+        transaction->set_amount(row[first + 3].as< int32_t >());
+
+        if (!row[first + 4].isNull()) {
+            transaction->set_category_id(row[first + 4].as< int32_t >());
+        }
+
+        if (!row[first + 5].isNull()) {
+            transaction->set_category_name(row[first + 5].as< std::string >());
+        }
+
+        if (!row[first + 6].isNull()) {
+            transaction->set_receipt_id(row[first + 6].as< int32_t >());
+        }
+
+        if (!row[first + 7].isNull()) {
+            transaction->set_comment(row[first + 7].as< std::string >());
+        }
+
+        transaction->set_has_splits(row[first + 8].as< bool >());
+    }
+
+    /**
+     * @brief Fills a receipt from the columns id, t, s, n, retailer name, items count and has_transaction
+     */
+    void fillReceiptInfo(const cxx::QueryResult::Row & row, ReceiptInfo * receipt) {
+        receipt->set_id(row[0].as< int32_t >());
+        receipt->set_date(row[1].as< std::string >());
+        receipt->set_sum(row[2].as< int32_t >());
+        receipt->set_receipt_type(row[3].as< int32_t >());
+
+        if (!row[4].isNull()) {
+            receipt->set_retailer_name(row[4].as< std::string >());
+        }
+
+        receipt->set_items_count(row[5].as< int32_t >());
+        receipt->set_has_transaction(row[6].as< bool >());
+    }
+
+    /**
+     * @brief Parameters of the export statements: user, then the optional date range
+     */
+    std::vector< cxx::SqlParam > exportParams(int32_t userId, const ExportRequest & request) {
+        std::optional< std::string > fromDate, toDate;
+        if (request.has_from_date()) {
+            fromDate = toSqlTimestamp(request.from_date());
+        }
+        if (request.has_to_date()) {
+            toDate = toSqlTimestamp(request.to_date());
+        }
+        return { cxx::toSqlParam(userId), cxx::toSqlParam(fromDate), cxx::toSqlParam(toDate) };
+    }
+
+    /**
+     * @brief Reads an export statement through a cursor and writes its rows in chunks
+     *
+     * @param fill Adds a row to the chunk
+     * @param delivered Set to false once write() refused a chunk, the rest of the rows is not read then
+     * @return False if the statement failed
+     */
+    template < typename Chunk, typename Fill >
+    bool streamExport(cxx::IDatabase & db, const Statement & statement, const std::vector< cxx::SqlParam > & params, const std::function< bool(const Chunk &) > & write, bool & delivered, Fill fill) {
+        Chunk chunk;
+        auto transaction = db.makeTransaction();
+        return transaction->streamQuery(statement.text(db.dialect()), params, EXPORT_CHUNK_ROWS, [&](const cxx::QueryResult & rows) {
+            chunk.Clear();
+            for (const auto & row: rows) {
+                fill(row, chunk);
+            }
+            delivered = write(chunk);
+            return delivered;
+        });
+    }
+
+    /**
+     * @brief Fiscal document identity, the unique key of the receipts table
+     */
+    struct ReceiptKey {
+        int64_t fn;
+        int64_t i;
+        int64_t fp;
+
+        bool operator==(const ReceiptKey &) const = default;
+    };
+
+    struct ReceiptKeyHash {
+        std::size_t operator()(const ReceiptKey & key) const noexcept {
+            std::size_t hash = std::hash< int64_t >{}(key.fn);
+            hash = hash * 31 + std::hash< int64_t >{}(key.i);
+            return hash * 31 + std::hash< int64_t >{}(key.fp);
+        }
+    };
+
+    ReceiptKey receiptKey(const Receipt & receipt) {
+        return { static_cast< int64_t >(receipt.fn()), static_cast< int64_t >(receipt.i()), static_cast< int64_t >(receipt.fp()) };
+    }
+
+    /**
+     * @brief Builds "($1, $2), ($3, $4), ..." for the given number of rows and columns
+     */
+    std::string valuesPlaceholders(std::size_t rows, std::size_t columns) {
+        std::string sql;
+        std::size_t param = 0;
+        for (std::size_t row = 0; row < rows; ++row) {
+            sql += row == 0 ? "(" : ", (";
+            for (std::size_t column = 0; column < columns; ++column) {
+                sql += (column == 0 ? "$" : ", $") + std::to_string(++param);
+            }
+            sql += ')';
+        }
+        return sql;
+    }
+
+    /**
+     * @brief Inserts distinct receipts, links them to the user and queues them for enrichment
+     *
+     * Does in a few multi-row statements what add_receipt, link_receipt_to_user and
+     * create_receipt_request do for a single receipt.
+     * @param ids Receives the id of every receipt, in the order of receipts
+     * @return False if a statement failed
+     */
+    bool storeReceipts(cxx::ITransaction & transaction, int32_t userId, const std::vector< Receipt > & receipts, std::vector< int32_t > & ids) {
+        std::unordered_map< ReceiptKey, std::size_t, ReceiptKeyHash > positions;
+        for (std::size_t position = 0; position < receipts.size(); ++position) {
+            positions.emplace(receiptKey(receipts[position]), position);
+        }
+        ids.assign(receipts.size(), 0);
+
+        for (std::size_t begin = 0; begin < receipts.size(); begin += QR_BATCH_CHUNK) {
+            const std::size_t end = std::min(receipts.size(), begin + QR_BATCH_CHUNK);
+
+            std::vector< cxx::SqlParam > params;
+            params.reserve((end - begin) * 6);
+            for (std::size_t position = begin; position < end; ++position) {
+                const auto & receipt = receipts[position];
+                const auto key = receiptKey(receipt);
+                params.emplace_back(receipt.t());
+                params.emplace_back(static_cast< int64_t >(std::llround(receipt.s() * 100)));
+                params.emplace_back(key.fn);
+                params.emplace_back(key.i);
+                params.emplace_back(key.fp);
+                params.emplace_back(static_cast< int64_t >(receipt.n()));
+            }
+
+            // The no-op update makes RETURNING report receipts that already existed, as in add_receipt
+            auto inserted = transaction.executeQueryParams("INSERT INTO receipts (t, s, fn, i, fp, n) VALUES " + valuesPlaceholders(end - begin, 6) + " ON CONFLICT (fn, i, fp) DO UPDATE SET fn = EXCLUDED.fn RETURNING id, fn, i, fp", params);
+            if (!inserted.has_value() || inserted->size() != end - begin) {
+                return false;
+            }
+            for (const auto & row: *inserted) {
+                const auto it = positions.find({ row[1].as< int64_t >(), row[2].as< int64_t >(), row[3].as< int64_t >() });
+                if (it == positions.end()) {
+                    return false;
+                }
+                ids[it->second] = row[0].as< int32_t >();
+            }
+
+            params.clear();
+            for (std::size_t position = begin; position < end; ++position) {
+                params.emplace_back(static_cast< int64_t >(userId));
+                params.emplace_back(static_cast< int64_t >(ids[position]));
+            }
+            if (!transaction.executeQueryParams("INSERT INTO user_receipts (user_id, receipt_id) VALUES " + valuesPlaceholders(end - begin, 2) + " ON CONFLICT DO NOTHING", params).has_value()) {
+                return false;
+            }
+
+            params.clear();
+            std::string idList;
+            for (std::size_t position = begin; position < end; ++position) {
+                params.emplace_back(static_cast< int64_t >(ids[position]));
+                idList += (position == begin ? "$" : ", $") + std::to_string(params.size());
+            }
+            if (!transaction.executeQueryParams("INSERT INTO receipt_requests (receipt_id) "
+                                                "SELECT r.id FROM receipts r WHERE r.id IN ("
+                                                  + idList
+                                                  + ") AND NOT EXISTS (SELECT 1 FROM receipt_requests q WHERE q.receipt_id = r.id)",
+                                                params)
+                   .has_value()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Prepares (or finds in the connection cache) a statement and executes it
+     */
+    template < typename... Args >
+    std::optional< cxx::QueryResult > execStatement(cxx::IDatabase & db, cxx::ITransaction & transaction, const Statement & statement, Args &&... args) {
+        if (!transaction.prepare(statement.name, statement.text(db.dialect()))) {
+            return std::nullopt;
+        }
+        return transaction.execPrepared(statement.name, std::forward< Args >(args)...);
     }
 
 } // unnamed namespace
 
-FinanceServiceImpl::FinanceServiceImpl(std::shared_ptr< cxx::IDatabase > db)
-  : db_(std::move(db)) {
+FinanceServiceImpl::FinanceServiceImpl(std::shared_ptr< cxx::IDatabase > db, AuthCache::Settings authCacheSettings)
+  : db_(std::move(db))
+  , authCache_(authCacheSettings) {
+}
+
+void FinanceServiceImpl::invalidateToken(const std::string & token) {
+    authCache_.invalidate(token);
 }
 
 bool FinanceServiceImpl::authenticateUser(const std::string & token, int32_t & userId) {
@@ -102,16 +547,28 @@ bool FinanceServiceImpl::authenticateUser(const std::string & token, int32_t & u
         return false;
     }
 
-    try {
-        std::string query = "SELECT id FROM users WHERE token = '" + db_->escapeString(token) + "'";
+    switch (authCache_.find(token, userId)) {
+    case AuthCache::EStatus::AUTHENTICATED:
+        return true;
+    case AuthCache::EStatus::REJECTED:
+        return false;
+    case AuthCache::EStatus::MISS:
+        break;
+    }
 
-        auto resultOpt = db_->makeTransaction()->executeQuery(query);
+    try {
+        auto resultOpt = execStatement(*db_, *db_->makeTransaction(), FIND_USER_BY_TOKEN, token);
 
-        if (!resultOpt.has_value() || resultOpt.value().empty()) {
+        if (!resultOpt.has_value()) {
+            return false;
+        }
+        if (resultOpt.value().empty()) {
+            authCache_.storeRejected(token);
             return false;
         }
 
-        userId = getVariantValue< int32_t >(resultOpt.value()[0][0]);
+        userId = resultOpt.value()[0][0].as< int32_t >();
+        authCache_.storeUser(token, userId);
         return true;
     } catch (const std::exception & e) {
 
@@ -139,7 +596,7 @@ grpc::Status FinanceServiceImpl::Authenticate(grpc::ServerContext * /*context*/,
 
         if (resultOpt.has_value() && !resultOpt.value().empty()) {
 
-            token = getVariantValue< std::string >(resultOpt.value()[0][0]);
+            token = resultOpt.value()[0][0].as< std::string >();
         } else {
 
             token = "generated_token_" + deviceId;
@@ -152,7 +609,9 @@ grpc::Status FinanceServiceImpl::Authenticate(grpc::ServerContext * /*context*/,
                 return grpc::Status::OK;
             }
 
-            auto userId = getVariantValue< int32_t >(userResultOpt.value()[0][0]);
+            auto userId = userResultOpt.value()[0][0].as< int32_t >();
+            // The token may have been rejected before the user existed
+            authCache_.invalidate(token);
 
             std::string insertDataQuery = "INSERT INTO users_data (user_id, device_id, device_name) VALUES (" + std::to_string(userId) + ", '" + db_->escapeString(deviceId) + "', '" + db_->escapeString(deviceName) + "')";
 
@@ -195,7 +654,7 @@ grpc::Status FinanceServiceImpl::ProcessQRCode(grpc::ServerContext * /*context*/
         }
         date = receipt.t();
 
-        sum = static_cast< int32_t >(receipt.s() * 100);
+        sum = static_cast< int32_t >(std::llround(receipt.s() * 100));
         fn = receipt.fn();
         fd = receipt.i();
         fp = receipt.fp();
@@ -216,7 +675,7 @@ grpc::Status FinanceServiceImpl::ProcessQRCode(grpc::ServerContext * /*context*/
             return grpc::Status::OK;
         }
 
-        auto receiptId = getVariantValue< int32_t >(receiptResultOpt.value()[0][0]);
+        auto receiptId = receiptResultOpt.value()[0][0].as< int32_t >();
 
         std::string linkQuery = "SELECT link_receipt_to_user(" + std::to_string(userId) + ", " + std::to_string(receiptId) + ")";
 
@@ -264,26 +723,26 @@ grpc::Status FinanceServiceImpl::ProcessQRCode(grpc::ServerContext * /*context*/
 
             auto * retailer = receiptData->mutable_retailer();
 
-            if (row[0].index() != std::variant_npos) {
-                retailer->set_name(getVariantValue< std::string >(row[0]));
+            if (!row[0].isNull()) {
+                retailer->set_name(row[0].as< std::string >());
             }
-            if (row[1].index() != std::variant_npos) {
-                retailer->set_place(getVariantValue< std::string >(row[1]));
+            if (!row[1].isNull()) {
+                retailer->set_place(row[1].as< std::string >());
             }
-            if (row[2].index() != std::variant_npos) {
-                retailer->set_inn(getVariantValue< std::string >(row[2]));
+            if (!row[2].isNull()) {
+                retailer->set_inn(row[2].as< std::string >());
             }
-            if (row[3].index() != std::variant_npos) {
-                retailer->set_address(getVariantValue< std::string >(row[3]));
+            if (!row[3].isNull()) {
+                retailer->set_address(row[3].as< std::string >());
             }
 
             int32_t receiptDataId = 0;
-            if (row[4].index() != std::variant_npos) {
-                receiptDataId = getVariantValue< int32_t >(row[4]);
+            if (!row[4].isNull()) {
+                receiptDataId = row[4].as< int32_t >();
             }
 
             if (receiptDataId > 0) {
-                std::string itemsQuery = "SELECT id, name, price, quantity, sum, nds_type, payment_type, product_type, measurement_unit "
+                std::string itemsQuery = "SELECT id, name, price, quantity, amount, nds_type, payment_type, product_type, measurement_unit "
                                          "FROM receipt_items "
                                          "WHERE receipt_data_id = "
                                        + std::to_string(receiptDataId);
@@ -294,19 +753,19 @@ grpc::Status FinanceServiceImpl::ProcessQRCode(grpc::ServerContext * /*context*/
                     for (const auto & itemRow: itemsResultOpt.value()) {
                         auto * item = receiptData->add_items();
 
-                        if (itemRow[0].index() != std::variant_npos) {
-                            item->set_item_id(getVariantValue< uint64_t >(itemRow[0]));
+                        if (!itemRow[0].isNull()) {
+                            item->set_item_id(itemRow[0].as< uint64_t >());
                         }
 
-                        item->set_name(getVariantValue< std::string >(itemRow[1]));
-                        item->set_price(getVariantValue< double >(itemRow[2]) / 100.0);
-                        item->set_quantity(getVariantValue< double >(itemRow[3]));
-                        item->set_sum(getVariantValue< double >(itemRow[4]) / 100.0);
+                        item->set_name(itemRow[1].as< std::string >());
+                        item->set_price(itemRow[2].as< double >() / 100.0);
+                        item->set_quantity(itemRow[3].as< double >());
+                        item->set_sum(itemRow[4].as< double >() / 100.0);
 
-                        item->set_nds_type(static_cast< wallet::ReceiptItem::ENDSType >(getVariantValue< int32_t >(itemRow[5])));
-                        item->set_payment_type(static_cast< wallet::ReceiptItem::EPaymentType >(getVariantValue< int32_t >(itemRow[6])));
-                        item->set_product_type(static_cast< wallet::ReceiptItem::EProductType >(getVariantValue< int32_t >(itemRow[7])));
-                        item->set_measurement_unit(static_cast< wallet::ReceiptItem::EMeasurementUnit >(getVariantValue< int32_t >(itemRow[8])));
+                        item->set_nds_type(static_cast< wallet::ReceiptItem::ENDSType >(itemRow[5].as< int32_t >()));
+                        item->set_payment_type(static_cast< wallet::ReceiptItem::EPaymentType >(itemRow[6].as< int32_t >()));
+                        item->set_product_type(static_cast< wallet::ReceiptItem::EProductType >(itemRow[7].as< int32_t >()));
+                        item->set_measurement_unit(static_cast< wallet::ReceiptItem::EMeasurementUnit >(itemRow[8].as< int32_t >()));
                     }
                 }
             }
@@ -319,149 +778,174 @@ grpc::Status FinanceServiceImpl::ProcessQRCode(grpc::ServerContext * /*context*/
     }
 }
 
-grpc::Status FinanceServiceImpl::GetTransactions(grpc::ServerContext * /*context*/, const GetTransactionsRequest * request, TransactionsResponse * response) {
-    try {
-
-        int32_t userId;
-        if (!authenticateUser(request->auth().token(), userId)) {
-            setError(response, ErrorInfo::UNAUTHORIZED, "Invalid token");
-            return grpc::Status::OK;
+grpc::Status FinanceServiceImpl::ProcessQRCodes(grpc::ServerContext * /*context*/, grpc::ServerReaderWriter< QRCodeBatchResponse, QRCodeBatchRequest > * stream) {
+    std::vector< QRCodeBatchRequest > requests;
+    QRCodeBatchRequest request;
+    while (stream->Read(&request)) {
+        // The batch is kept in memory until the stream ends, its size is bounded before that
+        if (requests.size() == MAX_QR_BATCH_SIZE) {
+            return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Too many receipts in one batch");
         }
+        requests.push_back(std::move(request));
+        request.Clear();
+    }
 
-        std::string fromDate, toDate;
-        if (request->has_from_date()) {
-            fromDate = TimeUtil::ToString(request->from_date());
+    for (const auto & response: processQRCodeBatch(requests)) {
+        if (!stream->Write(response)) {
+            return grpc::Status::CANCELLED;
         }
-        if (request->has_to_date()) {
-            toDate = TimeUtil::ToString(request->to_date());
-        }
-
-        int32_t type = request->has_type() ? request->type() : -1;
-        int32_t categoryId = request->has_category_id() ? request->category_id() : 0;
-        int32_t limit = request->has_limit() ? request->limit() : 50;
-        int32_t offset = request->has_offset() ? request->offset() : 0;
-
-        std::stringstream sql;
-        sql << "SELECT t.id, t.timestamp, t.type, t.amount, t.category_id, c.name, "
-               "t.receipt_id, t.comment, "
-               "EXISTS(SELECT 1 FROM transaction_splits ts WHERE ts.transaction_id = t.id) "
-               "FROM transactions t "
-               "LEFT JOIN categories c ON c.id = t.category_id "
-               "WHERE t.user_id = "
-            << userId << " ";
+    }
+    return grpc::Status::OK;
+}
 
-        if (!fromDate.empty()) {
-            sql << "AND t.timestamp >= '" << db_->escapeString(fromDate) << "' ";
-        }
+std::vector< QRCodeBatchResponse > FinanceServiceImpl::processQRCodeBatch(const std::vector< QRCodeBatchRequest > & requests) {
+    std::vector< QRCodeBatchResponse > responses(requests.size());
+    for (std::size_t index = 0; index < requests.size(); ++index) {
+        responses[index].set_index(static_cast< int32_t >(index));
+    }
 
-        if (!toDate.empty()) {
-            sql << "AND t.timestamp <= '" << db_->escapeString(toDate) << "' ";
+    const auto auth = std::find_if(requests.begin(), requests.end(), [](const QRCodeBatchRequest & request) {
+        return !request.auth().token().empty();
+    });
+    int32_t userId;
+    if (auth == requests.end() || !authenticateUser(auth->auth().token(), userId)) {
+        for (auto & response: responses) {
+            setError(&response, ErrorInfo::UNAUTHORIZED, "Invalid token");
         }
+        return responses;
+    }
 
-        if (type >= 0) {
-            sql << "AND t.type = " << type << " ";
+    // Distinct receipts of the batch and the receipt every request refers to
+    std::vector< Receipt > receipts;
+    std::vector< std::optional< std::size_t > > receiptOf(requests.size());
+    std::unordered_map< ReceiptKey, std::size_t, ReceiptKeyHash > positions;
+    for (std::size_t index = 0; index < requests.size(); ++index) {
+        const auto & request = requests[index];
+        Receipt receipt;
+        if (request.has_qr_code_content()) {
+            try {
+                receipt = wallet::parseQRDataFromString(request.qr_code_content());
+            } catch (const std::exception & e) {
+                setError(&responses[index], ErrorInfo::PARSING_ERROR, "Failed to parse receipt data", e.what());
+                continue;
+            }
+        } else if (request.has_receipt()) {
+            receipt = request.receipt();
+        } else {
+            setError(&responses[index], ErrorInfo::PARSING_ERROR, "Failed to parse receipt data");
+            continue;
         }
 
-        if (categoryId > 0) {
-            sql << "AND t.category_id = " << categoryId << " ";
+        const auto [it, inserted] = positions.emplace(receiptKey(receipt), receipts.size());
+        if (inserted) {
+            receipts.push_back(std::move(receipt));
         }
+        receiptOf[index] = it->second;
+    }
 
-        sql << "ORDER BY t.timestamp DESC ";
-        sql << "LIMIT " << limit << " OFFSET " << offset;
+    if (receipts.empty()) {
+        return responses;
+    }
 
+    std::vector< int32_t > ids;
+    bool stored = false;
+    std::string details;
+    try {
         auto transaction = db_->makeTransaction();
-        auto resultOpt = transaction->executeQuery(sql.str());
-
-        auto * transactionsList = response->mutable_transactions();
-
-        if (resultOpt.has_value()) {
-            for (const auto & row: resultOpt.value()) {
-                auto * transaction = transactionsList->add_transactions();
-                transaction->set_id(getVariantValue< int32_t >(row[0]));
-
-                auto * timestamp = transaction->mutable_timestamp();
-                *timestamp = stringToProtoTimestamp(getVariantValue< std::string >(row[1]));
-
-                transaction->set_type(getVariantValue< int32_t >(row[2]));
-                transaction->set_amount(getVariantValue< int32_t >(row[3]));
-
-                if (row[4].index() != std::variant_npos) {
-                    transaction->set_category_id(getVariantValue< int32_t >(row[4]));
-                }
-
-                if (row[5].index() != std::variant_npos) {
-                    transaction->set_category_name(getVariantValue< std::string >(row[5]));
-                }
-
-                if (row[6].index() != std::variant_npos) {
-                    transaction->set_receipt_id(getVariantValue< int32_t >(row[6]));
-                }
-
-                if (row[7].index() != std::variant_npos) {
-                    transaction->set_comment(getVariantValue< std::string >(row[7]));
-                }
-
-                transaction->set_has_splits(getVariantValue< bool >(row[8]));
-            }
+        try {
+            stored = storeReceipts(*transaction, userId, receipts, ids);
+        } catch (const std::exception & e) {
+            details = e.what();
         }
-
-        std::stringstream countSql;
-        countSql << "SELECT COUNT(*) FROM transactions t WHERE t.user_id = " << userId << " ";
-
-        if (!fromDate.empty()) {
-            countSql << "AND t.timestamp >= '" << db_->escapeString(fromDate) << "' ";
+        // The destructor would commit the part of the batch stored before the failure
+        if (!stored) {
+            transaction->abort();
         }
+    } catch (const std::exception & e) {
+        details = e.what();
+    }
 
-        if (!toDate.empty()) {
-            countSql << "AND t.timestamp <= '" << db_->escapeString(toDate) << "' ";
+    for (std::size_t index = 0; index < requests.size(); ++index) {
+        if (!receiptOf[index].has_value()) {
+            continue;
         }
-
-        if (type >= 0) {
-            countSql << "AND t.type = " << type << " ";
+        if (stored) {
+            responses[index].set_receipt_id(ids[*receiptOf[index]]);
+        } else {
+            setError(&responses[index], ErrorInfo::SERVER_ERROR, "Failed to add receipts", details);
         }
+    }
+    return responses;
+}
 
-        if (categoryId > 0) {
-            countSql << "AND t.category_id = " << categoryId << " ";
-        }
+grpc::Status FinanceServiceImpl::GetTransactions(grpc::ServerContext * /*context*/, const GetTransactionsRequest * request, TransactionsResponse * response) {
+    try {
 
-        auto countResultOpt = transaction->executeQuery(countSql.str());
-        if (countResultOpt.has_value() && !countResultOpt.value().empty()) {
-            transactionsList->set_total_count(getVariantValue< int32_t >(countResultOpt.value()[0][0]));
+        int32_t userId;
+        if (!authenticateUser(request->auth().token(), userId)) {
+            setError(response, ErrorInfo::UNAUTHORIZED, "Invalid token");
+            return grpc::Status::OK;
         }
 
-        std::stringstream statsSql;
-        statsSql << "SELECT "
-                    "COALESCE(SUM(CASE WHEN type = 0 THEN amount ELSE 0 END), 0) as total_income, "
-                    "COALESCE(SUM(CASE WHEN type = 1 THEN amount ELSE 0 END), 0) as total_expense "
-                    "FROM transactions t "
-                    "WHERE t.user_id = "
-                 << userId << " ";
-
-        if (!fromDate.empty()) {
-            statsSql << "AND t.timestamp >= '" << db_->escapeString(fromDate) << "' ";
+        std::optional< std::string > fromDate, toDate;
+        if (request->has_from_date()) {
+            fromDate = toSqlTimestamp(request->from_date());
         }
-
-        if (!toDate.empty()) {
-            statsSql << "AND t.timestamp <= '" << db_->escapeString(toDate) << "' ";
+        if (request->has_to_date()) {
+            toDate = toSqlTimestamp(request->to_date());
         }
 
-        if (type >= 0) {
-            statsSql << "AND t.type = " << type << " ";
+        std::optional< int32_t > type;
+        if (request->has_type() && request->type() >= 0) {
+            type = request->type();
+        }
+        std::optional< int32_t > categoryId;
+        if (request->has_category_id() && request->category_id() > 0) {
+            categoryId = request->category_id();
         }
+        int32_t limit = request->has_limit() ? request->limit() : 50;
+        int32_t offset = request->has_offset() ? request->offset() : 0;
 
-        if (categoryId > 0) {
-            statsSql << "AND t.category_id = " << categoryId << " ";
+        std::optional< std::string > cursorTimestamp;
+        std::optional< int32_t > cursorId;
+        if (request->has_cursor()) {
+            auto cursor = decodeCursor(request->cursor());
+            if (!cursor.has_value()) {
+                setError(response, ErrorInfo::INVALID_REQUEST, "Invalid cursor");
+                return grpc::Status::OK;
+            }
+            cursorTimestamp = std::move(cursor->timestamp);
+            cursorId = cursor->id;
+            offset = 0;
         }
 
-        auto statsResultOpt = transaction->executeQuery(statsSql.str());
-        if (statsResultOpt.has_value() && !statsResultOpt.value().empty()) {
-            auto totalIncome = getVariantValue< int32_t >(statsResultOpt.value()[0][0]);
-            auto totalExpense = getVariantValue< int32_t >(statsResultOpt.value()[0][1]);
-            int32_t balance = totalIncome - totalExpense;
+        auto resultOpt = execStatement(*db_, *db_->makeTransaction(), SELECT_TRANSACTIONS, userId, fromDate, toDate, type, categoryId, cursorTimestamp, cursorId, limit, offset);
+
+        auto * transactionsList = response->mutable_transactions();
 
+        if (resultOpt.has_value() && !resultOpt.value().empty()) {
+            const auto & result = resultOpt.value();
+
+            auto totalIncome = result[0][1].as< int32_t >();
+            auto totalExpense = result[0][2].as< int32_t >();
+            transactionsList->set_total_count(result[0][0].as< int32_t >());
             transactionsList->set_total_income(totalIncome);
             transactionsList->set_total_expense(totalExpense);
-            transactionsList->set_balance(balance);
+            transactionsList->set_balance(totalIncome - totalExpense);
+
+            for (const auto & row: result) {
+                if (row[3].isNull()) {
+                    break;
+                }
+
+                fillTransactionInfo(row, 3, transactionsList->add_transactions());
+            }
+
+            // A full page may be followed by more rows
+            if (limit > 0 && transactionsList->transactions_size() == limit) {
+                const auto last = result[result.size() - 1];
+                transactionsList->set_next_cursor(encodeCursor(last[4].as< std::string >(), last[3].as< int32_t >()));
+            }
         }
 
         return grpc::Status::OK;
@@ -482,10 +966,10 @@ grpc::Status FinanceServiceImpl::GetReceipts(grpc::ServerContext * /*context*/,
 
         std::string fromDate, toDate;
         if (request->has_from_date()) {
-            fromDate = TimeUtil::ToString(request->from_date());
+            fromDate = toSqlTimestamp(request->from_date());
         }
         if (request->has_to_date()) {
-            toDate = TimeUtil::ToString(request->to_date());
+            toDate = toSqlTimestamp(request->to_date());
         }
 
         int32_t limit = request->has_limit() ? request->limit() : 50;
@@ -519,18 +1003,7 @@ grpc::Status FinanceServiceImpl::GetReceipts(grpc::ServerContext * /*context*/,
 
         if (resultOpt.has_value()) {
             for (const auto & row: resultOpt.value()) {
-                auto * receipt = receiptsList->add_receipts();
-                receipt->set_id(getVariantValue< int32_t >(row[0]));
-                receipt->set_date(getVariantValue< std::string >(row[1]));
-                receipt->set_sum(getVariantValue< int32_t >(row[2]));
-                receipt->set_receipt_type(getVariantValue< int32_t >(row[3]));
-
-                if (row[4].index() != std::variant_npos) {
-                    receipt->set_retailer_name(getVariantValue< std::string >(row[4]));
-                }
-
-                receipt->set_items_count(getVariantValue< int32_t >(row[5]));
-                receipt->set_has_transaction(getVariantValue< bool >(row[6]));
+                fillReceiptInfo(row, receiptsList->add_receipts());
             }
         }
 
@@ -538,7 +1011,7 @@ grpc::Status FinanceServiceImpl::GetReceipts(grpc::ServerContext * /*context*/,
         auto countResultOpt = transaction->executeQuery(countQuery);
 
         if (countResultOpt.has_value() && !countResultOpt.value().empty()) {
-            receiptsList->set_total_count(getVariantValue< int32_t >(countResultOpt.value()[0][0]));
+            receiptsList->set_total_count(countResultOpt.value()[0][0].as< int32_t >());
         }
 
         return grpc::Status::OK;
@@ -589,35 +1062,35 @@ grpc::Status FinanceServiceImpl::GetReceiptDetails(grpc::ServerContext * /*conte
 
         auto * receiptProto = receiptData->mutable_receipt();
         receiptProto->set_id(receiptId);
-        receiptProto->set_t(getVariantValue< std::string >(row[1]));
-        receiptProto->set_s(getVariantValue< double >(row[2]) / 100.0);
-        receiptProto->set_fn(getVariantValue< uint64_t >(row[3]));
-        receiptProto->set_i(getVariantValue< uint64_t >(row[4]));
-        receiptProto->set_fp(getVariantValue< uint64_t >(row[5]));
-        receiptProto->set_n(getVariantValue< int32_t >(row[6]));
+        receiptProto->set_t(row[1].as< std::string >());
+        receiptProto->set_s(row[2].as< double >() / 100.0);
+        receiptProto->set_fn(row[3].as< uint64_t >());
+        receiptProto->set_i(row[4].as< uint64_t >());
+        receiptProto->set_fp(row[5].as< uint64_t >());
+        receiptProto->set_n(row[6].as< int32_t >());
 
         auto * retailer = receiptData->mutable_retailer();
 
-        if (row[7].index() != std::variant_npos) {
-            retailer->set_name(getVariantValue< std::string >(row[7]));
+        if (!row[7].isNull()) {
+            retailer->set_name(row[7].as< std::string >());
         }
-        if (row[8].index() != std::variant_npos) {
-            retailer->set_place(getVariantValue< std::string >(row[8]));
+        if (!row[8].isNull()) {
+            retailer->set_place(row[8].as< std::string >());
         }
-        if (row[9].index() != std::variant_npos) {
-            retailer->set_inn(getVariantValue< std::string >(row[9]));
+        if (!row[9].isNull()) {
+            retailer->set_inn(row[9].as< std::string >());
         }
-        if (row[10].index() != std::variant_npos) {
-            retailer->set_address(getVariantValue< std::string >(row[10]));
+        if (!row[10].isNull()) {
+            retailer->set_address(row[10].as< std::string >());
         }
 
         int32_t receiptDataId = 0;
-        if (row[11].index() != std::variant_npos) {
-            receiptDataId = getVariantValue< int32_t >(row[11]);
+        if (!row[11].isNull()) {
+            receiptDataId = row[11].as< int32_t >();
         }
 
         if (receiptDataId > 0) {
-            std::string itemsQuery = "SELECT id, name, price, quantity, sum, nds_type, payment_type, product_type, measurement_unit "
+            std::string itemsQuery = "SELECT id, name, price, quantity, amount, nds_type, payment_type, product_type, measurement_unit "
                                      "FROM receipt_items "
                                      "WHERE receipt_data_id = "
                                    + std::to_string(receiptDataId);
@@ -628,19 +1101,19 @@ grpc::Status FinanceServiceImpl::GetReceiptDetails(grpc::ServerContext * /*conte
                 for (const auto & itemRow: itemsResultOpt.value()) {
                     auto * item = receiptData->add_items();
 
-                    if (itemRow[0].index() != std::variant_npos) {
-                        item->set_item_id(getVariantValue< uint64_t >(itemRow[0]));
+                    if (!itemRow[0].isNull()) {
+                        item->set_item_id(itemRow[0].as< uint64_t >());
                     }
 
-                    item->set_name(getVariantValue< std::string >(itemRow[1]));
-                    item->set_price(getVariantValue< double >(itemRow[2]) / 100.0);
-                    item->set_quantity(getVariantValue< double >(itemRow[3]));
-                    item->set_sum(getVariantValue< double >(itemRow[4]) / 100.0);
+                    item->set_name(itemRow[1].as< std::string >());
+                    item->set_price(itemRow[2].as< double >() / 100.0);
+                    item->set_quantity(itemRow[3].as< double >());
+                    item->set_sum(itemRow[4].as< double >() / 100.0);
 
-                    item->set_nds_type(static_cast< wallet::ReceiptItem::ENDSType >(getVariantValue< int32_t >(itemRow[5])));
-                    item->set_payment_type(static_cast< wallet::ReceiptItem::EPaymentType >(getVariantValue< int32_t >(itemRow[6])));
-                    item->set_product_type(static_cast< wallet::ReceiptItem::EProductType >(getVariantValue< int32_t >(itemRow[7])));
-                    item->set_measurement_unit(static_cast< wallet::ReceiptItem::EMeasurementUnit >(getVariantValue< int32_t >(itemRow[8])));
+                    item->set_nds_type(static_cast< wallet::ReceiptItem::ENDSType >(itemRow[5].as< int32_t >()));
+                    item->set_payment_type(static_cast< wallet::ReceiptItem::EPaymentType >(itemRow[6].as< int32_t >()));
+                    item->set_product_type(static_cast< wallet::ReceiptItem::EProductType >(itemRow[7].as< int32_t >()));
+                    item->set_measurement_unit(static_cast< wallet::ReceiptItem::EMeasurementUnit >(itemRow[8].as< int32_t >()));
                 }
             }
         }
@@ -650,7 +1123,7 @@ grpc::Status FinanceServiceImpl::GetReceiptDetails(grpc::ServerContext * /*conte
         auto transactionResultOpt = db_->makeTransaction()->executeQuery(transactionQuery);
 
         if (transactionResultOpt.has_value() && !transactionResultOpt.value().empty()) {
-            auto transactionId = getVariantValue< int32_t >(transactionResultOpt.value()[0][0]);
+            auto transactionId = transactionResultOpt.value()[0][0].as< int32_t >();
             auto * additionalInfo = receiptData->mutable_additional_info();
             (*additionalInfo)["transaction_id"] = std::to_string(transactionId);
         }
@@ -687,7 +1160,7 @@ grpc::Status FinanceServiceImpl::CreateTransaction(grpc::ServerContext * /*conte
         sql << "SELECT add_transaction(" << userId << ", "
             << transaction.type() << ", "
             << transaction.amount() << ", '"
-            << db_->escapeString(TimeUtil::ToString(transaction.timestamp())) << "'";
+            << db_->escapeString(toSqlTimestamp(transaction.timestamp())) << "'";
 
         if (transaction.has_category_id()) {
             sql << ", " << transaction.category_id();
@@ -716,7 +1189,7 @@ grpc::Status FinanceServiceImpl::CreateTransaction(grpc::ServerContext * /*conte
             return grpc::Status::OK;
         }
 
-        auto transactionId = getVariantValue< int32_t >(resultOpt.value()[0][0]);
+        auto transactionId = resultOpt.value()[0][0].as< int32_t >();
         response->set_transaction_id(transactionId);
 
         return grpc::Status::OK;
@@ -768,7 +1241,7 @@ grpc::Status FinanceServiceImpl::UpdateTransaction(grpc::ServerContext * /*conte
                                      "amount = "
             << transaction.amount() << ", "
                                        "timestamp = '"
-            << db_->escapeString(TimeUtil::ToString(transaction.timestamp())) << "'";
+            << db_->escapeString(toSqlTimestamp(transaction.timestamp())) << "'";
 
         if (transaction.has_category_id()) {
             sql << ", category_id = " << transaction.category_id();
@@ -861,21 +1334,21 @@ bool FinanceServiceImpl::getTransactionData(int32_t transactionId, TransactionDe
         details->set_id(transactionId);
 
         auto * timestamp = details->mutable_timestamp();
-        *timestamp = stringToProtoTimestamp(getVariantValue< std::string >(row[1]));
+        *timestamp = stringToProtoTimestamp(row[1].as< std::string >());
 
-        details->set_type(getVariantValue< int32_t >(row[2]));
-        details->set_amount(getVariantValue< int32_t >(row[3]));
+        details->set_type(row[2].as< int32_t >());
+        details->set_amount(row[3].as< int32_t >());
 
-        if (row[4].index() != std::variant_npos) {
-            details->set_category_id(getVariantValue< int32_t >(row[4]));
+        if (!row[4].isNull()) {
+            details->set_category_id(row[4].as< int32_t >());
         }
 
-        if (row[5].index() != std::variant_npos) {
-            details->set_category_name(getVariantValue< std::string >(row[5]));
+        if (!row[5].isNull()) {
+            details->set_category_name(row[5].as< std::string >());
         }
 
-        if (row[6].index() != std::variant_npos) {
-            auto receiptId = getVariantValue< int32_t >(row[6]);
+        if (!row[6].isNull()) {
+            auto receiptId = row[6].as< int32_t >();
             details->set_receipt_id(receiptId);
 
             std::string receiptQuery = "SELECT r.id, r.t, r.s, r.n, rd.retailer_name, "
@@ -890,22 +1363,22 @@ bool FinanceServiceImpl::getTransactionData(int32_t transactionId, TransactionDe
             if (receiptResultOpt.has_value() && !receiptResultOpt.value().empty()) {
                 const auto & receiptRow = receiptResultOpt.value()[0];
                 auto * receipt = details->mutable_receipt();
-                receipt->set_id(getVariantValue< int32_t >(receiptRow[0]));
-                receipt->set_date(getVariantValue< std::string >(receiptRow[1]));
-                receipt->set_sum(getVariantValue< int32_t >(receiptRow[2]));
-                receipt->set_receipt_type(getVariantValue< int32_t >(receiptRow[3]));
+                receipt->set_id(receiptRow[0].as< int32_t >());
+                receipt->set_date(receiptRow[1].as< std::string >());
+                receipt->set_sum(receiptRow[2].as< int32_t >());
+                receipt->set_receipt_type(receiptRow[3].as< int32_t >());
 
-                if (receiptRow[4].index() != std::variant_npos) {
-                    receipt->set_retailer_name(getVariantValue< std::string >(receiptRow[4]));
+                if (!receiptRow[4].isNull()) {
+                    receipt->set_retailer_name(receiptRow[4].as< std::string >());
                 }
 
-                receipt->set_items_count(getVariantValue< int32_t >(receiptRow[5]));
+                receipt->set_items_count(receiptRow[5].as< int32_t >());
                 receipt->set_has_transaction(true);
             }
         }
 
-        if (row[7].index() != std::variant_npos) {
-            details->set_comment(getVariantValue< std::string >(row[7]));
+        if (!row[7].isNull()) {
+            details->set_comment(row[7].as< std::string >());
         }
 
         std::string splitsQuery = "SELECT ts.id, ts.character_id, uc.name, ts.amount, ts.comment "
@@ -920,13 +1393,13 @@ bool FinanceServiceImpl::getTransactionData(int32_t transactionId, TransactionDe
         if (splitsResultOpt.has_value()) {
             for (const auto & splitRow: splitsResultOpt.value()) {
                 auto * split = details->add_splits();
-                split->set_id(getVariantValue< int32_t >(splitRow[0]));
-                split->set_character_id(getVariantValue< int32_t >(splitRow[1]));
-                split->set_character_name(getVariantValue< std::string >(splitRow[2]));
-                split->set_amount(getVariantValue< int32_t >(splitRow[3]));
+                split->set_id(splitRow[0].as< int32_t >());
+                split->set_character_id(splitRow[1].as< int32_t >());
+                split->set_character_name(splitRow[2].as< std::string >());
+                split->set_amount(splitRow[3].as< int32_t >());
 
-                if (splitRow[4].index() != std::variant_npos) {
-                    split->set_comment(getVariantValue< std::string >(splitRow[4]));
+                if (!splitRow[4].isNull()) {
+                    split->set_comment(splitRow[4].as< std::string >());
                 }
             }
         }
@@ -1035,7 +1508,7 @@ grpc::Status FinanceServiceImpl::CreateSplit(grpc::ServerContext * /*context*/,
             return grpc::Status::OK;
         }
 
-        auto splitId = getVariantValue< int32_t >(resultOpt.value()[0][0]);
+        auto splitId = resultOpt.value()[0][0].as< int32_t >();
         response->set_split_id(splitId);
 
         return grpc::Status::OK;
@@ -1150,8 +1623,8 @@ grpc::Status FinanceServiceImpl::GetCharacters(grpc::ServerContext * /*context*/
         if (resultOpt.has_value()) {
             for (const auto & row: resultOpt.value()) {
                 auto * character = charactersList->add_characters();
-                character->set_id(getVariantValue< int32_t >(row[0]));
-                character->set_name(getVariantValue< std::string >(row[1]));
+                character->set_id(row[0].as< int32_t >());
+                character->set_name(row[1].as< std::string >());
             }
         }
 
@@ -1205,7 +1678,7 @@ grpc::Status FinanceServiceImpl::ManageCharacter(grpc::ServerContext * /*context
                 return grpc::Status::OK;
             }
 
-            auto characterId = getVariantValue< int32_t >(resultOpt.value()[0][0]);
+            auto characterId = resultOpt.value()[0][0].as< int32_t >();
             response->set_character_id(characterId);
         }
 
@@ -1241,7 +1714,7 @@ grpc::Status FinanceServiceImpl::DeleteCharacter(grpc::ServerContext * /*context
             return grpc::Status::OK;
         }
 
-        auto characterName = getVariantValue< std::string >(accessResultOpt.value()[0][0]);
+        auto characterName = accessResultOpt.value()[0][0].as< std::string >();
         if (characterName == "Основной") {
             setError(response, ErrorInfo::INVALID_REQUEST, "Cannot delete the main character");
             return grpc::Status::OK;
@@ -1253,6 +1726,11 @@ grpc::Status FinanceServiceImpl::DeleteCharacter(grpc::ServerContext * /*context
 
         transaction->executeQuery(deleteSplitsQuery);
 
+        // The emptied rollup rows still reference the character
+        std::string deleteStatsQuery = "DELETE FROM user_daily_character_stats WHERE character_id = " + std::to_string(characterId);
+
+        transaction->executeQuery(deleteStatsQuery);
+
         std::string deleteCharacterQuery = "DELETE FROM user_characters WHERE id = " + std::to_string(characterId) + " AND user_id = " + std::to_string(userId);
 
         transaction->executeQuery(deleteCharacterQuery);
@@ -1283,8 +1761,8 @@ grpc::Status FinanceServiceImpl::GetCategories(grpc::ServerContext * /*context*/
         if (resultOpt.has_value()) {
             for (const auto & row: resultOpt.value()) {
                 auto * category = categoriesList->add_categories();
-                category->set_id(getVariantValue< int32_t >(row[0]));
-                category->set_name(getVariantValue< std::string >(row[1]));
+                category->set_id(row[0].as< int32_t >());
+                category->set_name(row[1].as< std::string >());
             }
         }
 
@@ -1338,7 +1816,7 @@ grpc::Status FinanceServiceImpl::ManageCategory(grpc::ServerContext * /*context*
                 return grpc::Status::OK;
             }
 
-            auto categoryId = getVariantValue< int32_t >(resultOpt.value()[0][0]);
+            auto categoryId = resultOpt.value()[0][0].as< int32_t >();
             response->set_category_id(categoryId);
         }
 
@@ -1402,225 +1880,101 @@ grpc::Status FinanceServiceImpl::GetStatistics(grpc::ServerContext * /*context*/
             return grpc::Status::OK;
         }
 
-        std::string fromDate, toDate;
+        std::optional< std::string > fromDate, toDate;
         if (request->has_from_date()) {
-            fromDate = TimeUtil::ToString(request->from_date());
+            fromDate = toSqlTimestamp(request->from_date());
         }
         if (request->has_to_date()) {
-            toDate = TimeUtil::ToString(request->to_date());
+            toDate = toSqlTimestamp(request->to_date());
         }
 
         auto * statistics = response->mutable_statistics();
-
-        std::stringstream sql;
-        sql << "SELECT "
-               "COALESCE(SUM(CASE WHEN type = 0 THEN amount ELSE 0 END), 0) as total_income, "
-               "COALESCE(SUM(CASE WHEN type = 1 THEN amount ELSE 0 END), 0) as total_expense, "
-               "COUNT(CASE WHEN type = 0 THEN 1 END) as income_count, "
-               "COUNT(CASE WHEN type = 1 THEN 1 END) as expense_count "
-               "FROM transactions "
-               "WHERE user_id = "
-            << userId;
-
-        if (!fromDate.empty()) {
-            sql << " AND timestamp >= '" << db_->escapeString(fromDate) << "'";
-        }
-
-        if (!toDate.empty()) {
-            sql << " AND timestamp <= '" << db_->escapeString(toDate) << "'";
-        }
-
-        auto transaction = db_->makeTransaction();
-        auto resultOpt = transaction->executeQuery(sql.str());
-
-        if (resultOpt.has_value() && !resultOpt.value().empty()) {
-            const auto & row = resultOpt.value()[0];
-            auto totalIncome = getVariantValue< int32_t >(row[0]);
-            auto totalExpense = getVariantValue< int32_t >(row[1]);
-            auto incomeCount = getVariantValue< int32_t >(row[2]);
-            auto expenseCount = getVariantValue< int32_t >(row[3]);
-
-            statistics->set_total_income(totalIncome);
-            statistics->set_total_expense(totalExpense);
-            statistics->set_balance(totalIncome - totalExpense);
-            statistics->set_income_transactions_count(incomeCount);
-            statistics->set_expense_transactions_count(expenseCount);
-        }
-
         auto * chartData = statistics->mutable_chart_data();
 
-        std::stringstream dailySql;
-        dailySql << "SELECT "
-                    "TO_CHAR(timestamp, 'YYYY-MM-DD') as date, "
-                    "COALESCE(SUM(CASE WHEN type = 0 THEN amount ELSE 0 END), 0) as daily_income, "
-                    "COALESCE(SUM(CASE WHEN type = 1 THEN amount ELSE 0 END), 0) as daily_expense "
-                    "FROM transactions "
-                    "WHERE user_id = "
-                 << userId;
-
-        if (!fromDate.empty()) {
-            dailySql << " AND timestamp >= '" << db_->escapeString(fromDate) << "'";
-        }
-
-        if (!toDate.empty()) {
-            dailySql << " AND timestamp <= '" << db_->escapeString(toDate) << "'";
-        }
-
-        dailySql << " GROUP BY TO_CHAR(timestamp, 'YYYY-MM-DD') "
-                    "ORDER BY TO_CHAR(timestamp, 'YYYY-MM-DD')";
-
-        auto dailyResultOpt = transaction->executeQuery(dailySql.str());
-
-        if (dailyResultOpt.has_value()) {
-            for (const auto & row: dailyResultOpt.value()) {
-                auto * dailyData = chartData->add_daily();
-                dailyData->set_date(getVariantValue< std::string >(row[0]));
-                dailyData->set_income(getVariantValue< int32_t >(row[1]));
-                dailyData->set_expense(getVariantValue< int32_t >(row[2]));
-            }
-        }
-
-        std::stringstream expenseCategorySql;
-        expenseCategorySql << "SELECT "
-                              "t.category_id, "
-                              "COALESCE(c.name, 'Без категории') as category_name, "
-                              "COUNT(t.id) as transactions_count, "
-                              "SUM(t.amount) as total_amount "
-                              "FROM transactions t "
-                              "LEFT JOIN categories c ON c.id = t.category_id "
-                              "WHERE t.user_id = "
-                           << userId << " AND t.type = 1";
-
-        if (!fromDate.empty()) {
-            expenseCategorySql << " AND t.timestamp >= '" << db_->escapeString(fromDate) << "'";
-        }
-
-        if (!toDate.empty()) {
-            expenseCategorySql << " AND t.timestamp <= '" << db_->escapeString(toDate) << "'";
-        }
-
-        expenseCategorySql << " GROUP BY t.category_id, c.name "
-                              "ORDER BY total_amount DESC";
-
-        auto expenseCategoryResultOpt = transaction->executeQuery(expenseCategorySql.str());
-
-        int32_t totalExpenseAmount = 0;
-        if (expenseCategoryResultOpt.has_value()) {
-            for (const auto & row: expenseCategoryResultOpt.value()) {
-                totalExpenseAmount += getVariantValue< int32_t >(row[3]);
-            }
-        }
-
-        if (expenseCategoryResultOpt.has_value()) {
-            for (const auto & row: expenseCategoryResultOpt.value()) {
-                auto * categoryStats = chartData->add_expenses_by_category();
-
-                categoryStats->set_category_id(row[0].index() != std::variant_npos ? getVariantValue< int32_t >(row[0]) : 0);
+        auto transaction = db_->makeTransaction();
+        auto resultOpt = execStatement(*db_, *transaction, SELECT_DAILY_STATS, userId, fromDate, toDate);
 
-                categoryStats->set_category_name(getVariantValue< std::string >(row[1]));
-                categoryStats->set_transactions_count(getVariantValue< int32_t >(row[2]));
-                categoryStats->set_total_amount(getVariantValue< int32_t >(row[3]));
+        if (resultOpt.has_value()) {
+            int64_t totalIncome = 0, totalExpense = 0;
+            int32_t incomeCount = 0, expenseCount = 0;
+            std::unordered_map< int32_t, CategoryTotals > incomeCategories, expenseCategories;
 
-                double percentage = 0.0;
-                if (totalExpenseAmount > 0) {
-                    percentage = (static_cast< double >(getVariantValue< int32_t >(row[3])) / totalExpenseAmount) * 100.0;
+            // Rows are ordered by day, one row per (day, type, category)
+            ChartData::DailyData * dailyData = nullptr;
+            for (const auto & row: resultOpt.value()) {
+                const auto day = row[0].asStringView();
+                if (dailyData == nullptr || dailyData->date() != day) {
+                    dailyData = chartData->add_daily();
+                    dailyData->set_date(std::string(day));
                 }
-                categoryStats->set_percentage(percentage);
-            }
-        }
-
-        std::stringstream incomeCategorySql;
-        incomeCategorySql << "SELECT "
-                             "t.category_id, "
-                             "COALESCE(c.name, 'Без категории') as category_name, "
-                             "COUNT(t.id) as transactions_count, "
-                             "SUM(t.amount) as total_amount "
-                             "FROM transactions t "
-                             "LEFT JOIN categories c ON c.id = t.category_id "
-                             "WHERE t.user_id = "
-                          << userId << " AND t.type = 0";
-
-        if (!fromDate.empty()) {
-            incomeCategorySql << " AND t.timestamp >= '" << db_->escapeString(fromDate) << "'";
-        }
-
-        if (!toDate.empty()) {
-            incomeCategorySql << " AND t.timestamp <= '" << db_->escapeString(toDate) << "'";
-        }
-
-        incomeCategorySql << " GROUP BY t.category_id, c.name "
-                             "ORDER BY total_amount DESC";
-
-        auto incomeCategoryResultOpt = transaction->executeQuery(incomeCategorySql.str());
-
-        int32_t totalIncomeAmount = 0;
-        if (incomeCategoryResultOpt.has_value()) {
-            for (const auto & row: incomeCategoryResultOpt.value()) {
-                totalIncomeAmount += getVariantValue< int32_t >(row[3]);
-            }
-        }
-
-        if (incomeCategoryResultOpt.has_value()) {
-            for (const auto & row: incomeCategoryResultOpt.value()) {
-                auto * categoryStats = chartData->add_incomes_by_category();
-
-                categoryStats->set_category_id(row[0].index() != std::variant_npos ? getVariantValue< int32_t >(row[0]) : 0);
 
-                categoryStats->set_category_name(getVariantValue< std::string >(row[1]));
-                categoryStats->set_transactions_count(getVariantValue< int32_t >(row[2]));
-                categoryStats->set_total_amount(getVariantValue< int32_t >(row[3]));
+                const bool isIncome = row[1].as< int32_t >() == 0;
+                const auto categoryId = row[2].as< int32_t >();
+                const auto count = row[4].as< int32_t >();
+                const auto amount = row[5].as< int64_t >();
 
-                double percentage = 0.0;
-                if (totalIncomeAmount > 0) {
-                    percentage = (static_cast< double >(getVariantValue< int32_t >(row[3])) / totalIncomeAmount) * 100.0;
+                auto & categories = isIncome ? incomeCategories : expenseCategories;
+                auto & category = categories[categoryId];
+                if (category.name.empty()) {
+                    category.categoryId = categoryId;
+                    category.name = row[3].as< std::string >();
+                }
+                category.count += count;
+                category.amount += amount;
+
+                if (isIncome) {
+                    dailyData->set_income(dailyData->income() + static_cast< int32_t >(amount));
+                    totalIncome += amount;
+                    incomeCount += count;
+                } else {
+                    dailyData->set_expense(dailyData->expense() + static_cast< int32_t >(amount));
+                    totalExpense += amount;
+                    expenseCount += count;
                 }
-                categoryStats->set_percentage(percentage);
             }
-        }
-
-        std::stringstream characterSql;
-        characterSql << "SELECT "
-                        "uc.id as character_id, "
-                        "uc.name as character_name, "
-                        "COUNT(ts.id) as splits_count, "
-                        "SUM(ts.amount) as total_amount "
-                        "FROM user_characters uc "
-                        "JOIN transaction_splits ts ON ts.character_id = uc.id "
-                        "JOIN transactions t ON t.id = ts.transaction_id "
-                        "WHERE uc.user_id = "
-                     << userId << " AND t.type = 1";
 
-        if (!fromDate.empty()) {
-            characterSql << " AND t.timestamp >= '" << db_->escapeString(fromDate) << "'";
-        }
+            statistics->set_total_income(static_cast< int32_t >(totalIncome));
+            statistics->set_total_expense(static_cast< int32_t >(totalExpense));
+            statistics->set_balance(static_cast< int32_t >(totalIncome - totalExpense));
+            statistics->set_income_transactions_count(incomeCount);
+            statistics->set_expense_transactions_count(expenseCount);
 
-        if (!toDate.empty()) {
-            characterSql << " AND t.timestamp <= '" << db_->escapeString(toDate) << "'";
+            auto toVector = [](std::unordered_map< int32_t, CategoryTotals > & categories) {
+                std::vector< CategoryTotals > result;
+                result.reserve(categories.size());
+                for (auto & [id, category]: categories) {
+                    result.push_back(std::move(category));
+                }
+                return result;
+            };
+            fillCategoryStatistics(toVector(expenseCategories), [chartData]() {
+                return chartData->add_expenses_by_category();
+            });
+            fillCategoryStatistics(toVector(incomeCategories), [chartData]() {
+                return chartData->add_incomes_by_category();
+            });
         }
 
-        characterSql << " GROUP BY uc.id, uc.name "
-                        "ORDER BY total_amount DESC";
-
-        auto characterResultOpt = transaction->executeQuery(characterSql.str());
+        auto characterResultOpt = execStatement(*db_, *transaction, SELECT_CHARACTER_STATS, userId, fromDate, toDate);
 
-        int32_t totalCharacterAmount = 0;
+        int64_t totalCharacterAmount = 0;
         if (characterResultOpt.has_value()) {
             for (const auto & row: characterResultOpt.value()) {
-                totalCharacterAmount += getVariantValue< int32_t >(row[3]);
+                totalCharacterAmount += row[3].as< int64_t >();
             }
         }
 
         if (characterResultOpt.has_value()) {
             for (const auto & row: characterResultOpt.value()) {
                 auto * characterStats = chartData->add_expenses_by_character();
-                characterStats->set_character_id(getVariantValue< int32_t >(row[0]));
-                characterStats->set_character_name(getVariantValue< std::string >(row[1]));
-                characterStats->set_splits_count(getVariantValue< int32_t >(row[2]));
-                characterStats->set_total_amount(getVariantValue< int32_t >(row[3]));
+                characterStats->set_character_id(row[0].as< int32_t >());
+                characterStats->set_character_name(row[1].as< std::string >());
+                characterStats->set_splits_count(row[2].as< int32_t >());
+                characterStats->set_total_amount(row[3].as< int32_t >());
 
                 double percentage = 0.0;
                 if (totalCharacterAmount > 0) {
-                    percentage = (static_cast< double >(getVariantValue< int32_t >(row[3])) / totalCharacterAmount) * 100.0;
+                    percentage = (static_cast< double >(row[3].as< int64_t >()) / static_cast< double >(totalCharacterAmount)) * 100.0;
                 }
                 characterStats->set_percentage(percentage);
             }
@@ -1633,6 +1987,67 @@ grpc::Status FinanceServiceImpl::GetStatistics(grpc::ServerContext * /*context*/
     }
 }
 
+grpc::Status FinanceServiceImpl::ExportTransactions(grpc::ServerContext * /*context*/, const ExportRequest * request, grpc::ServerWriter< TransactionsChunk > * writer) {
+    const bool delivered = exportTransactions(*request, [writer](const TransactionsChunk & chunk) {
+        return writer->Write(chunk);
+    });
+    return delivered ? grpc::Status::OK : grpc::Status(grpc::StatusCode::CANCELLED, "Client stopped reading the export");
+}
+
+grpc::Status FinanceServiceImpl::ExportReceipts(grpc::ServerContext * /*context*/, const ExportRequest * request, grpc::ServerWriter< ReceiptsChunk > * writer) {
+    const bool delivered = exportReceipts(*request, [writer](const ReceiptsChunk & chunk) {
+        return writer->Write(chunk);
+    });
+    return delivered ? grpc::Status::OK : grpc::Status(grpc::StatusCode::CANCELLED, "Client stopped reading the export");
+}
+
+bool FinanceServiceImpl::exportTransactions(const ExportRequest & request, const ChunkWriter< TransactionsChunk > & write) {
+    bool delivered = true;
+    TransactionsChunk error;
+    try {
+        int32_t userId;
+        if (!authenticateUser(request.auth().token(), userId)) {
+            setError(&error, ErrorInfo::UNAUTHORIZED, "Invalid token");
+            return write(error);
+        }
+
+        const auto fill = [](const cxx::QueryResult::Row & row, TransactionsChunk & chunk) {
+            fillTransactionInfo(row, 0, chunk.add_transactions());
+        };
+        if (streamExport(*db_, EXPORT_TRANSACTIONS, exportParams(userId, request), write, delivered, fill)) {
+            return delivered;
+        }
+        setError(&error, ErrorInfo::SERVER_ERROR, "Failed to export transactions");
+    } catch (const std::exception & e) {
+        setError(&error, ErrorInfo::SERVER_ERROR, "Server error", e.what());
+    }
+    // Chunks already written stay valid, the error closes the stream
+    return delivered && write(error);
+}
+
+bool FinanceServiceImpl::exportReceipts(const ExportRequest & request, const ChunkWriter< ReceiptsChunk > & write) {
+    bool delivered = true;
+    ReceiptsChunk error;
+    try {
+        int32_t userId;
+        if (!authenticateUser(request.auth().token(), userId)) {
+            setError(&error, ErrorInfo::UNAUTHORIZED, "Invalid token");
+            return write(error);
+        }
+
+        const auto fill = [](const cxx::QueryResult::Row & row, ReceiptsChunk & chunk) {
+            fillReceiptInfo(row, chunk.add_receipts());
+        };
+        if (streamExport(*db_, EXPORT_RECEIPTS, exportParams(userId, request), write, delivered, fill)) {
+            return delivered;
+        }
+        setError(&error, ErrorInfo::SERVER_ERROR, "Failed to export receipts");
+    } catch (const std::exception & e) {
+        setError(&error, ErrorInfo::SERVER_ERROR, "Server error", e.what());
+    }
+    return delivered && write(error);
+}
+
 template < typename ResponseType >
 void FinanceServiceImpl::setError(ResponseType * response, ErrorInfo::ErrorCode code, const std::string & message, const std::string & details) {
     auto * errorInfo = new ErrorInfo();
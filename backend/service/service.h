@@ -2,10 +2,14 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <backend/service/auth/auth_cache.h>
 #include <proto/wallet/service.grpc.pb.h>
 #include <utils/database/interface/i_database.h>
 
+#include <cstddef>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace wallet {
 
@@ -22,12 +26,20 @@ namespace wallet {
      * - Financial statistics and analytics
      */
     class FinanceServiceImpl final: public FinanceService::Service {
+    public:
+        /**
+         * @brief Requests one ProcessQRCodes stream may carry, longer streams are rejected
+         * with RESOURCE_EXHAUSTED before the rest is read
+         */
+        static constexpr std::size_t MAX_QR_BATCH_SIZE = 10'000;
+
     public:
         /**
          * @brief Constructor for FinanceServiceImpl
          * @param db Shared pointer to database interface
+         * @param authCacheSettings Parameters of the token authentication cache
          */
-        explicit FinanceServiceImpl(std::shared_ptr< cxx::IDatabase > db);
+        explicit FinanceServiceImpl(std::shared_ptr< cxx::IDatabase > db, AuthCache::Settings authCacheSettings = {});
 
         /**
          * @brief Default destructor
@@ -52,6 +64,30 @@ namespace wallet {
          */
         grpc::Status ProcessQRCode(grpc::ServerContext * context, const QRCodeRequest * request, ReceiptDetailsResponse * response) override;
 
+        /**
+         * @brief Registers a stream of scanned receipts in one transaction
+         *
+         * Requests are collected until the client closes its side of the stream, then
+         * processed with processQRCodeBatch() and answered in the same order. The call fails
+         * as soon as the stream exceeds MAX_QR_BATCH_SIZE requests.
+         * @param context The server context
+         * @param stream The stream of receipts and per-receipt results
+         * @return Status of the operation
+         */
+        grpc::Status ProcessQRCodes(grpc::ServerContext * context, grpc::ServerReaderWriter< QRCodeBatchResponse, QRCodeBatchRequest > * stream) override;
+
+        /**
+         * @brief Registers a batch of scanned receipts for one user
+         *
+         * The token of the first request that carries one is checked once for the whole batch.
+         * Receipts are deduplicated by (fn, i, fp), then inserted, linked to the user and queued
+         * for enrichment with a few multi-row statements in a single transaction.
+         * @param requests Receipts in the order they were received, at most MAX_QR_BATCH_SIZE
+         * are processed, the others are answered with an error
+         * @return Result of every request, in the same order
+         */
+        std::vector< QRCodeBatchResponse > processQRCodeBatch(const std::vector< QRCodeBatchRequest > & requests);
+
         /**
          * @brief Retrieves a list of receipts for the authenticated user
          * @param context The server context
@@ -205,9 +241,67 @@ namespace wallet {
          */
         grpc::Status GetStatistics(grpc::ServerContext * context, const GetStatisticsRequest * request, StatisticsResponse * response) override;
 
+        /**
+         * @brief Receives chunks of an export, returns false once the client is gone
+         */
+        template < typename Chunk >
+        using ChunkWriter = std::function< bool(const Chunk & chunk) >;
+
+        /**
+         * @brief Streams the whole transaction history of the user
+         *
+         * Rows are read through a database cursor and written in fixed-size chunks,
+         * see exportTransactions().
+         * @param context The server context
+         * @param request The request with authentication and date range
+         * @param writer The stream of transaction chunks
+         * @return Status of the operation, CANCELLED if the client stopped reading
+         */
+        grpc::Status ExportTransactions(grpc::ServerContext * context, const ExportRequest * request, grpc::ServerWriter< TransactionsChunk > * writer) override;
+
+        /**
+         * @brief Streams all receipts of the user
+         * @param context The server context
+         * @param request The request with authentication and date range
+         * @param writer The stream of receipt chunks
+         * @return Status of the operation, CANCELLED if the client stopped reading
+         */
+        grpc::Status ExportReceipts(grpc::ServerContext * context, const ExportRequest * request, grpc::ServerWriter< ReceiptsChunk > * writer) override;
+
+        /**
+         * @brief Writes the transactions of the user, newest first, in chunks of a fixed size
+         *
+         * Only one chunk is held in memory and the first one is written as soon as the
+         * database returns it. Failures are reported in the error of the last chunk.
+         * @param request The request with authentication and date range
+         * @param write Receives every chunk
+         * @return False if write() refused a chunk
+         */
+        bool exportTransactions(const ExportRequest & request, const ChunkWriter< TransactionsChunk > & write);
+
+        /**
+         * @brief Writes the receipts of the user, newest first, in chunks of a fixed size
+         * @param request The request with authentication and date range
+         * @param write Receives every chunk
+         * @return False if write() refused a chunk
+         */
+        bool exportReceipts(const ExportRequest & request, const ChunkWriter< ReceiptsChunk > & write);
+
+        /**
+         * @brief Drops the cached authentication result of a token
+         *
+         * Must be called whenever a token is assigned to or removed from a user
+         * outside of this service.
+         * @param token The authentication token
+         */
+        void invalidateToken(const std::string & token);
+
     private:
         /**
          * @brief Authenticates user by token and retrieves user ID
+         *
+         * Resolutions are served from the authentication cache, the database is queried
+         * only on a cache miss.
          * @param token The authentication token
          * @param userId Output parameter to store the authenticated user ID
          * @return True if authentication successful, false otherwise
@@ -252,6 +346,11 @@ namespace wallet {
          * @brief Database interface for executing queries
          */
         std::shared_ptr< cxx::IDatabase > db_;
+
+        /**
+         * @brief Cache of token to user ID resolutions
+         */
+        AuthCache authCache_;
     };
 
 } // namespace wallet
@@ -0,0 +1,296 @@
+#include "sqlite_profile.h"
+
+#include <sqlite_schema.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+using namespace wallet;
+
+namespace {
+
+    // PRAGMA user_version set at the end of db_sqlite.sql
+    constexpr int32_t SCHEMA_VERSION = 1;
+
+    /**
+     * @brief Statement of a function body, finalized when the call ends
+     *
+     * The bodies run on the connection of the calling query and are prepared per call:
+     * a cached statement would keep the connection busy when the database is closed.
+     */
+    class Query {
+    public:
+        Query(sqlite3 * conn, const char * sql)
+          : conn_(conn) {
+            if (sqlite3_prepare_v2(conn_, sql, -1, &stmt_, nullptr) != SQLITE_OK) {
+                throw std::runtime_error(sqlite3_errmsg(conn_));
+            }
+        }
+
+        ~Query() {
+            sqlite3_finalize(stmt_);
+        }
+
+        Query(const Query &) = delete;
+        Query & operator=(const Query &) = delete;
+
+        /**
+         * @brief Binds a function argument as is, NULL stays NULL
+         */
+        Query & bind(int index, sqlite3_value * value) {
+            check(sqlite3_bind_value(stmt_, index, value));
+            return *this;
+        }
+
+        Query & bind(int index, int64_t value) {
+            check(sqlite3_bind_int64(stmt_, index, value));
+            return *this;
+        }
+
+        Query & bind(int index, std::string_view value) {
+            check(sqlite3_bind_text(stmt_, index, value.data(), static_cast< int >(value.size()), SQLITE_TRANSIENT));
+            return *this;
+        }
+
+        /**
+         * @brief Executes the statement up to the next row
+         * @return True if a row is available
+         */
+        bool step() {
+            const int rc = sqlite3_step(stmt_);
+            if (rc == SQLITE_ROW) {
+                return true;
+            }
+            check(rc == SQLITE_DONE ? SQLITE_OK : rc);
+            return false;
+        }
+
+        int64_t int64(int column) const {
+            return sqlite3_column_int64(stmt_, column);
+        }
+
+        std::string text(int column) const {
+            const auto * text = reinterpret_cast< const char * >(sqlite3_column_text(stmt_, column));
+            return text != nullptr ? std::string(text, static_cast< std::size_t >(sqlite3_column_bytes(stmt_, column))) : std::string();
+        }
+
+        /**
+         * @brief Executes a statement that returns no rows
+         * @return Rowid of the inserted row
+         */
+        int64_t insert() {
+            step();
+            return sqlite3_last_insert_rowid(conn_);
+        }
+
+    private:
+        void check(int rc) const {
+            if (rc != SQLITE_OK) {
+                throw std::runtime_error(sqlite3_errmsg(conn_));
+            }
+        }
+
+    private:
+        sqlite3 * conn_;
+        sqlite3_stmt * stmt_ = nullptr;
+    };
+
+    /**
+     * @brief Converts the receipt time 'YYYYMMDDTHHMM[SS]' into 'YYYY-MM-DD HH:MM:SS'
+     */
+    std::string receiptTimestamp(const std::string & t) {
+        if (t.size() != 13 && t.size() != 15) {
+            throw std::runtime_error("Invalid receipt time: " + t);
+        }
+        const std::string seconds = t.size() == 15 ? t.substr(13, 2) : "00";
+        return t.substr(0, 4) + '-' + t.substr(4, 2) + '-' + t.substr(6, 2) + ' ' + t.substr(9, 2) + ':' + t.substr(11, 2) + ':' + seconds;
+    }
+
+    std::optional< int64_t > addUser(sqlite3 * conn, sqlite3_value ** args) {
+        const auto userId = Query(conn, "INSERT INTO users (token) VALUES (?1)").bind(1, args[0]).insert();
+        Query(conn, "INSERT INTO user_characters (user_id, name) VALUES (?1, 'Основной')").bind(1, userId).insert();
+        return userId;
+    }
+
+    std::optional< int64_t > addReceipt(sqlite3 * conn, sqlite3_value ** args) {
+        Query insert(conn,
+                     "INSERT INTO receipts (t, s, fn, i, fp, n) VALUES (?1, ?2, ?3, ?4, ?5, ?6) "
+                     "ON CONFLICT (fn, i, fp) DO NOTHING");
+        for (int i = 0; i < 6; ++i) {
+            insert.bind(i + 1, args[i]);
+        }
+        insert.step();
+
+        Query select(conn, "SELECT id FROM receipts WHERE fn = ?1 AND i = ?2 AND fp = ?3");
+        select.bind(1, args[2]).bind(2, args[3]).bind(3, args[4]);
+        if (!select.step()) {
+            return std::nullopt;
+        }
+        return select.int64(0);
+    }
+
+    std::optional< int64_t > linkReceiptToUser(sqlite3 * conn, sqlite3_value ** args) {
+        Query(conn, "INSERT INTO user_receipts (user_id, receipt_id) VALUES (?1, ?2) ON CONFLICT DO NOTHING")
+          .bind(1, args[0])
+          .bind(2, args[1])
+          .step();
+        return std::nullopt;
+    }
+
+    std::optional< int64_t > createReceiptRequest(sqlite3 * conn, sqlite3_value ** args) {
+        Query select(conn, "SELECT id FROM receipt_requests WHERE receipt_id = ?1 ORDER BY id LIMIT 1");
+        if (select.bind(1, args[0]).step()) {
+            return select.int64(0);
+        }
+        return Query(conn, "INSERT INTO receipt_requests (receipt_id) VALUES (?1)").bind(1, args[0]).insert();
+    }
+
+    std::optional< int64_t > createTransactionFromReceipt(sqlite3 * conn, sqlite3_value ** args) {
+        Query existing(conn, "SELECT id FROM transactions WHERE user_id = ?1 AND receipt_id = ?2 ORDER BY id LIMIT 1");
+        if (existing.bind(1, args[0]).bind(2, args[1]).step()) {
+            return existing.int64(0);
+        }
+
+        Query receipt(conn, "SELECT t, s FROM receipts WHERE id = ?1");
+        if (!receipt.bind(1, args[1]).step()) {
+            return std::nullopt;
+        }
+
+        return Query(conn,
+                     "INSERT INTO transactions (user_id, timestamp, type, amount, category_id, receipt_id, comment) "
+                     "VALUES (?1, ?2, 1, ?3, ?4, ?5, ?6)")
+          .bind(1, args[0])
+          .bind(2, receiptTimestamp(receipt.text(0)))
+          .bind(3, receipt.int64(1))
+          .bind(4, args[2])
+          .bind(5, args[1])
+          .bind(6, args[3])
+          .insert();
+    }
+
+    std::optional< int64_t > addTransaction(sqlite3 * conn, sqlite3_value ** args) {
+        Query insert(conn,
+                     "INSERT INTO transactions (user_id, type, amount, timestamp, category_id, receipt_id, comment) "
+                     "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)");
+        for (int i = 0; i < 7; ++i) {
+            insert.bind(i + 1, args[i]);
+        }
+        return insert.insert();
+    }
+
+    std::optional< int64_t > addTransactionSplit(sqlite3 * conn, sqlite3_value ** args) {
+        Query insert(conn, "INSERT INTO transaction_splits (transaction_id, character_id, amount, comment) VALUES (?1, ?2, ?3, ?4)");
+        for (int i = 0; i < 4; ++i) {
+            insert.bind(i + 1, args[i]);
+        }
+        return insert.insert();
+    }
+
+    std::optional< int64_t > addUserCharacter(sqlite3 * conn, sqlite3_value ** args) {
+        return Query(conn, "INSERT INTO user_characters (user_id, name) VALUES (?1, ?2)").bind(1, args[0]).bind(2, args[1]).insert();
+    }
+
+    std::optional< int64_t > addCategory(sqlite3 * conn, sqlite3_value ** args) {
+        Query(conn, "INSERT INTO categories (name) VALUES (?1) ON CONFLICT (name) DO NOTHING").bind(1, args[0]).step();
+
+        Query select(conn, "SELECT id FROM categories WHERE name = ?1");
+        if (!select.bind(1, args[0]).step()) {
+            return std::nullopt;
+        }
+        return select.int64(0);
+    }
+
+    using Function = std::optional< int64_t > (*)(sqlite3 * conn, sqlite3_value ** args);
+
+    /**
+     * @brief Adapts a function body to the SQLite callback, exceptions become SQL errors
+     */
+    template < Function function >
+    void call(sqlite3_context * context, int /*argc*/, sqlite3_value ** args) {
+        try {
+            const auto result = function(sqlite3_context_db_handle(context), args);
+            if (result.has_value()) {
+                sqlite3_result_int64(context, *result);
+            } else {
+                sqlite3_result_null(context);
+            }
+        } catch (const std::exception & e) {
+            sqlite3_result_error(context, e.what(), -1);
+        }
+    }
+
+    struct FunctionDefinition {
+        const char * name;
+        int argc;
+        void (*callback)(sqlite3_context *, int, sqlite3_value **);
+    };
+
+    constexpr FunctionDefinition FUNCTIONS[] = {
+        { "add_user", 1, &call< addUser > },
+        { "add_receipt", 6, &call< addReceipt > },
+        { "link_receipt_to_user", 2, &call< linkReceiptToUser > },
+        { "create_receipt_request", 1, &call< createReceiptRequest > },
+        { "create_transaction_from_receipt", 4, &call< createTransactionFromReceipt > },
+        { "add_transaction", 7, &call< addTransaction > },
+        { "add_transaction_split", 4, &call< addTransactionSplit > },
+        { "add_user_character", 2, &call< addUserCharacter > },
+        { "add_category", 1, &call< addCategory > },
+    };
+
+} // unnamed namespace
+
+bool wallet::registerSqliteFunctions(sqlite3 * conn) {
+    for (const auto & function: FUNCTIONS) {
+        // Not deterministic: every call writes
+        const int rc = sqlite3_create_function_v2(conn, function.name, function.argc, SQLITE_UTF8 | SQLITE_DIRECTONLY, nullptr, function.callback, nullptr, nullptr, nullptr);
+        if (rc != SQLITE_OK) {
+            SPDLOG_ERROR("Failed to register SQLite function {}: {}", function.name, sqlite3_errmsg(conn));
+            return false;
+        }
+    }
+    return true;
+}
+
+cxx::SQLiteDatabase::Settings wallet::sqliteServiceSettings(cxx::SQLiteDatabase::Settings settings) {
+    settings.foreignKeys = true;
+    // The service functions come first, a connection hook of the caller may rely on them
+    settings.onOpen = [onOpen = std::move(settings.onOpen)](sqlite3 * conn) {
+        return registerSqliteFunctions(conn) && (!onOpen || onOpen(conn));
+    };
+    return settings;
+}
+
+bool wallet::migrateSqliteSchema(cxx::SQLiteDatabase & db) {
+    const auto version = db.makeTransaction()->executeQuery("PRAGMA user_version");
+    if (!version.has_value() || version->empty()) {
+        return false;
+    }
+
+    const auto current = (*version)[0][0].as< int32_t >();
+    if (current >= SCHEMA_VERSION) {
+        return true;
+    }
+
+    SPDLOG_INFO("Migrating SQLite schema from version {} to {}", current, SCHEMA_VERSION);
+    if (db.executeScript("BEGIN IMMEDIATE;\n" + std::string(SERVICE_SCHEMA_SQL) + "\nCOMMIT;")) {
+        return true;
+    }
+    db.executeScript("ROLLBACK;");
+    return false;
+}
+
+std::shared_ptr< cxx::SQLiteDatabase > wallet::openSqliteDatabase(const std::string & path, cxx::SQLiteDatabase::Settings settings) {
+    auto db = std::make_shared< cxx::SQLiteDatabase >();
+    if (!db->connect(path, sqliteServiceSettings(std::move(settings)))) {
+        throw std::runtime_error("Cannot open SQLite database " + path);
+    }
+    if (!migrateSqliteSchema(*db)) {
+        throw std::runtime_error("Cannot migrate SQLite database " + path);
+    }
+    return db;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <utils/database/sqlite/sqlite_database.h>
+
+#include <memory>
+#include <string>
+
+namespace wallet {
+
+    /**
+     * @brief Registers the service functions of docs/service/db.sql on a SQLite connection
+     *
+     * add_user, add_receipt, link_receipt_to_user, create_receipt_request, create_transaction_from_receipt,
+     * add_transaction, add_transaction_split, add_user_character and add_category are implemented in C++
+     * with the semantics of their PostgreSQL versions, so the service queries run unchanged.
+     * The functions write to the database and cannot be used in triggers or views.
+     *
+     * @param conn Open connection
+     * @return True if all functions were registered
+     */
+    bool registerSqliteFunctions(sqlite3 * conn);
+
+    /**
+     * @brief Connection settings of the service: the given tuning, enforced foreign keys and the service functions
+     *
+     * @param settings Tuning of the caller, e.g. the pool size matching its concurrency
+     */
+    cxx::SQLiteDatabase::Settings sqliteServiceSettings(cxx::SQLiteDatabase::Settings settings = {});
+
+    /**
+     * @brief Creates the schema of docs/service/db_sqlite.sql or upgrades an older one
+     *
+     * The script runs in one transaction and only when PRAGMA user_version is behind it.
+     *
+     * @param db Connected database
+     * @return True if the schema is up to date
+     */
+    bool migrateSqliteSchema(cxx::SQLiteDatabase & db);
+
+    /**
+     * @brief Opens a database for the service in embedded mode and migrates its schema
+     *
+     * An in-memory database has a single connection whatever the pool size, so every
+     * transaction on it waits for the previous one to end.
+     *
+     * @param path Database file, ":memory:" for a private in-memory database
+     * @param settings Tuning of the caller, the pool must fit every transaction running at once
+     * @return Connected database
+     * @throws std::runtime_error if the database cannot be opened or migrated
+     */
+    std::shared_ptr< cxx::SQLiteDatabase > openSqliteDatabase(const std::string & path, cxx::SQLiteDatabase::Settings settings = {});
+
+} // namespace wallet
@@ -0,0 +1,332 @@
+#include <backend/service/service.h>
+#include <backend/service/sqlite/sqlite_profile.h>
+
+#include <google/protobuf/util/time_util.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace wallet;
+using google::protobuf::util::TimeUtil;
+
+namespace {
+
+    constexpr auto QR_CODE = "t=20240315T1430&s=432.10&fn=9284000100287274&i=28889&fp=3906849540&n=1";
+
+    /**
+     * @brief Service over a migrated in-memory SQLite database, as in the embedded mode
+     */
+    class FinanceServiceSqliteTest: public ::testing::Test {
+    public:
+        void SetUp() override {
+            db_ = openSqliteDatabase(":memory:");
+            service_ = std::make_unique< FinanceServiceImpl >(db_);
+            token_ = authenticate("device");
+        }
+
+    protected:
+        std::string authenticate(const std::string & deviceId) {
+            AuthRequest request;
+            request.set_device_id(deviceId);
+            AuthResponse response;
+            service_->Authenticate(&context_, &request, &response);
+            EXPECT_FALSE(response.has_error()) << response.error().message();
+            return response.token();
+        }
+
+        int32_t createTransaction(int32_t type, int32_t amount, const std::string & timestamp) {
+            CreateTransactionRequest request;
+            request.mutable_auth()->set_token(token_);
+            request.mutable_transaction()->set_type(type);
+            request.mutable_transaction()->set_amount(amount);
+            EXPECT_TRUE(TimeUtil::FromString(timestamp, request.mutable_transaction()->mutable_timestamp()));
+            CreateTransactionResponse response;
+            service_->CreateTransaction(&context_, &request, &response);
+            EXPECT_FALSE(response.has_error()) << response.error().message();
+            return response.transaction_id();
+        }
+
+        TransactionsList getTransactions(GetTransactionsRequest request) {
+            request.mutable_auth()->set_token(token_);
+            TransactionsResponse response;
+            service_->GetTransactions(&context_, &request, &response);
+            EXPECT_FALSE(response.has_error()) << response.error().message();
+            return response.transactions();
+        }
+
+        Statistics getStatistics() {
+            GetStatisticsRequest request;
+            request.mutable_auth()->set_token(token_);
+            StatisticsResponse response;
+            service_->GetStatistics(&context_, &request, &response);
+            EXPECT_FALSE(response.has_error()) << response.error().message();
+            return response.statistics();
+        }
+
+    protected:
+        grpc::ServerContext context_;
+        std::shared_ptr< cxx::SQLiteDatabase > db_;
+        std::unique_ptr< FinanceServiceImpl > service_;
+        std::string token_;
+    };
+
+    TEST_F(FinanceServiceSqliteTest, MigrationIsIdempotent) {
+        EXPECT_TRUE(migrateSqliteSchema(*db_));
+        EXPECT_EQ(authenticate("device"), token_);
+    }
+
+    TEST_F(FinanceServiceSqliteTest, NewUserHasMainCharacter) {
+        GetCharactersRequest request;
+        request.mutable_auth()->set_token(token_);
+        CharactersResponse response;
+        service_->GetCharacters(&context_, &request, &response);
+
+        ASSERT_FALSE(response.has_error()) << response.error().message();
+        ASSERT_EQ(response.characters_list().characters_size(), 1);
+        EXPECT_EQ(response.characters_list().characters(0).name(), "Основной");
+    }
+
+    TEST_F(FinanceServiceSqliteTest, ScannedReceiptCreatesOneTransaction) {
+        QRCodeRequest request;
+        request.mutable_auth()->set_token(token_);
+        request.set_qr_code_content(QR_CODE);
+        request.set_create_transaction(true);
+
+        ReceiptDetailsResponse first;
+        service_->ProcessQRCode(&context_, &request, &first);
+        ASSERT_FALSE(first.has_error()) << first.error().message();
+        ReceiptDetailsResponse second;
+        service_->ProcessQRCode(&context_, &request, &second);
+        ASSERT_FALSE(second.has_error()) << second.error().message();
+        EXPECT_EQ(first.receipt_data().receipt().id(), second.receipt_data().receipt().id());
+
+        const auto list = getTransactions({});
+        ASSERT_EQ(list.transactions_size(), 1);
+        EXPECT_EQ(list.transactions(0).type(), 1);
+        EXPECT_EQ(list.transactions(0).amount(), 43210);
+        EXPECT_EQ(list.transactions(0).receipt_id(), first.receipt_data().receipt().id());
+        EXPECT_EQ(list.total_expense(), 43210);
+
+        const auto statistics = getStatistics();
+        EXPECT_EQ(statistics.total_expense(), 43210);
+        EXPECT_EQ(statistics.expense_transactions_count(), 1);
+    }
+
+    TEST_F(FinanceServiceSqliteTest, BatchDeduplicatesReceipts) {
+        std::vector< QRCodeBatchRequest > requests(4);
+        requests[0].mutable_auth()->set_token(token_);
+        requests[0].set_qr_code_content(QR_CODE);
+        requests[1].set_qr_code_content("t=20240316T0910&s=15.00&fn=9284000100287274&i=28890&fp=1111111111&n=1");
+        requests[2].set_qr_code_content(QR_CODE);
+        requests[3].set_qr_code_content("not a receipt");
+
+        const auto responses = service_->processQRCodeBatch(requests);
+        ASSERT_EQ(responses.size(), 4);
+        for (int32_t index = 0; index < 3; ++index) {
+            EXPECT_EQ(responses[index].index(), index);
+            ASSERT_TRUE(responses[index].has_receipt_id()) << responses[index].error().message();
+        }
+        EXPECT_EQ(responses[0].receipt_id(), responses[2].receipt_id());
+        EXPECT_NE(responses[0].receipt_id(), responses[1].receipt_id());
+        ASSERT_TRUE(responses[3].has_error());
+        EXPECT_EQ(responses[3].error().code(), ErrorInfo::PARSING_ERROR);
+
+        // A single scan of a receipt from the batch finds the same row
+        QRCodeRequest single;
+        single.mutable_auth()->set_token(token_);
+        single.set_qr_code_content(QR_CODE);
+        ReceiptDetailsResponse details;
+        service_->ProcessQRCode(&context_, &single, &details);
+        ASSERT_FALSE(details.has_error()) << details.error().message();
+        EXPECT_EQ(details.receipt_data().receipt().id(), responses[0].receipt_id());
+
+        GetReceiptsRequest list;
+        list.mutable_auth()->set_token(token_);
+        ReceiptsResponse receipts;
+        service_->GetReceipts(&context_, &list, &receipts);
+        ASSERT_FALSE(receipts.has_error()) << receipts.error().message();
+        EXPECT_EQ(receipts.receipts().total_count(), 2);
+    }
+
+    TEST_F(FinanceServiceSqliteTest, BatchRequiresToken) {
+        std::vector< QRCodeBatchRequest > requests(2);
+        requests[0].set_qr_code_content(QR_CODE);
+        requests[1].mutable_auth()->set_token("unknown");
+        requests[1].set_qr_code_content(QR_CODE);
+
+        for (const auto & response: service_->processQRCodeBatch(requests)) {
+            ASSERT_TRUE(response.has_error());
+            EXPECT_EQ(response.error().code(), ErrorInfo::UNAUTHORIZED);
+        }
+    }
+
+    TEST_F(FinanceServiceSqliteTest, SumsAreRoundedToKopecks) {
+        // 0.29 * 100 is 28.999999999999996 in binary floating point
+        std::vector< QRCodeBatchRequest > batch(1);
+        batch[0].mutable_auth()->set_token(token_);
+        batch[0].set_qr_code_content("t=20240316T0910&s=0.29&fn=9284000100287274&i=28890&fp=1111111111&n=1");
+        ASSERT_TRUE(service_->processQRCodeBatch(batch)[0].has_receipt_id());
+
+        QRCodeRequest single;
+        single.mutable_auth()->set_token(token_);
+        single.set_qr_code_content("t=20240317T0910&s=0.57&fn=9284000100287274&i=28891&fp=2222222222&n=1");
+        ReceiptDetailsResponse details;
+        service_->ProcessQRCode(&context_, &single, &details);
+        ASSERT_FALSE(details.has_error()) << details.error().message();
+
+        ExportRequest request;
+        request.mutable_auth()->set_token(token_);
+        std::vector< int64_t > sums;
+        EXPECT_TRUE(service_->exportReceipts(request, [&sums](const ReceiptsChunk & chunk) {
+            for (const auto & receipt: chunk.receipts()) {
+                sums.push_back(receipt.sum());
+            }
+            return true;
+        }));
+        std::sort(sums.begin(), sums.end());
+        EXPECT_EQ(sums, std::vector< int64_t >({ 29, 57 }));
+    }
+
+    TEST_F(FinanceServiceSqliteTest, FiltersAndPagesTransactions) {
+        createTransaction(0, 1000, "2024-03-01T10:00:00Z");
+        createTransaction(1, 200, "2024-03-02T10:00:00Z");
+        createTransaction(1, 300, "2024-03-03T10:00:00.250Z");
+        createTransaction(1, 400, "2024-03-04T10:00:00Z");
+
+        GetTransactionsRequest range;
+        ASSERT_TRUE(TimeUtil::FromString("2024-03-02T00:00:00Z", range.mutable_from_date()));
+        ASSERT_TRUE(TimeUtil::FromString("2024-03-03T10:00:00.500Z", range.mutable_to_date()));
+        const auto filtered = getTransactions(range);
+        EXPECT_EQ(filtered.total_count(), 2);
+        EXPECT_EQ(filtered.total_expense(), 500);
+
+        GetTransactionsRequest page;
+        page.set_limit(3);
+        const auto first = getTransactions(page);
+        ASSERT_EQ(first.transactions_size(), 3);
+        EXPECT_EQ(first.total_count(), 4);
+        EXPECT_EQ(first.balance(), 100);
+        EXPECT_EQ(first.transactions(0).amount(), 400);
+        ASSERT_TRUE(first.has_next_cursor());
+
+        page.set_cursor(first.next_cursor());
+        const auto second = getTransactions(page);
+        ASSERT_EQ(second.transactions_size(), 1);
+        EXPECT_EQ(second.transactions(0).amount(), 1000);
+        EXPECT_FALSE(second.has_next_cursor());
+    }
+
+    TEST_F(FinanceServiceSqliteTest, ExportsTransactionsInChunks) {
+        for (int day = 0; day < 300; ++day) {
+            createTransaction(1, day + 1, TimeUtil::ToString(TimeUtil::SecondsToTimestamp(1'700'000'000 + day * 86'400)));
+        }
+
+        ExportRequest request;
+        request.mutable_auth()->set_token(token_);
+        std::vector< TransactionsChunk > chunks;
+        EXPECT_TRUE(service_->exportTransactions(request, [&chunks](const TransactionsChunk & chunk) {
+            chunks.push_back(chunk);
+            return true;
+        }));
+
+        ASSERT_EQ(chunks.size(), 2);
+        EXPECT_EQ(chunks[0].transactions_size(), 256);
+        EXPECT_EQ(chunks[1].transactions_size(), 44);
+        EXPECT_FALSE(chunks[1].has_error());
+        EXPECT_EQ(chunks[0].transactions(0).amount(), 300);
+        EXPECT_EQ(chunks[1].transactions(43).amount(), 1);
+
+        // The export stops reading once the client is gone
+        std::size_t written = 0;
+        EXPECT_FALSE(service_->exportTransactions(request, [&written](const TransactionsChunk &) {
+            ++written;
+            return false;
+        }));
+        EXPECT_EQ(written, 1);
+    }
+
+    TEST_F(FinanceServiceSqliteTest, ExportsReceiptsOfUser) {
+        std::vector< QRCodeBatchRequest > batch(1);
+        batch[0].mutable_auth()->set_token(token_);
+        batch[0].set_qr_code_content(QR_CODE);
+        service_->processQRCodeBatch(batch);
+
+        ExportRequest request;
+        request.mutable_auth()->set_token(token_);
+        std::vector< ReceiptsChunk > chunks;
+        EXPECT_TRUE(service_->exportReceipts(request, [&chunks](const ReceiptsChunk & chunk) {
+            chunks.push_back(chunk);
+            return true;
+        }));
+        ASSERT_EQ(chunks.size(), 1);
+        ASSERT_EQ(chunks[0].receipts_size(), 1);
+        EXPECT_EQ(chunks[0].receipts(0).sum(), 43210);
+
+        request.mutable_auth()->set_token("unknown");
+        chunks.clear();
+        service_->exportReceipts(request, [&chunks](const ReceiptsChunk & chunk) {
+            chunks.push_back(chunk);
+            return true;
+        });
+        ASSERT_EQ(chunks.size(), 1);
+        ASSERT_TRUE(chunks[0].has_error());
+        EXPECT_EQ(chunks[0].error().code(), ErrorInfo::UNAUTHORIZED);
+    }
+
+    TEST_F(FinanceServiceSqliteTest, DeletesCharacterWithSplits) {
+        const auto transactionId = createTransaction(1, 1000, "2024-03-01T10:00:00Z");
+
+        ManageCharacterRequest character;
+        character.mutable_auth()->set_token(token_);
+        character.set_name("Друг");
+        ManageCharacterResponse created;
+        service_->ManageCharacter(&context_, &character, &created);
+        ASSERT_FALSE(created.has_error()) << created.error().message();
+
+        CreateSplitRequest split;
+        split.mutable_auth()->set_token(token_);
+        split.mutable_split()->set_transaction_id(transactionId);
+        split.mutable_split()->set_character_id(created.character_id());
+        split.mutable_split()->set_amount(400);
+        CreateSplitResponse splitResponse;
+        service_->CreateSplit(&context_, &split, &splitResponse);
+        ASSERT_FALSE(splitResponse.has_error()) << splitResponse.error().message();
+        EXPECT_EQ(getStatistics().chart_data().expenses_by_character_size(), 1);
+
+        character.set_id(created.character_id());
+        Response deleted;
+        service_->DeleteCharacter(&context_, &character, &deleted);
+        EXPECT_FALSE(deleted.has_error()) << deleted.error().message();
+        EXPECT_EQ(getStatistics().chart_data().expenses_by_character_size(), 0);
+
+        GetCharactersRequest request;
+        request.mutable_auth()->set_token(token_);
+        CharactersResponse characters;
+        service_->GetCharacters(&context_, &request, &characters);
+        EXPECT_EQ(characters.characters_list().characters_size(), 1);
+    }
+
+    TEST(SqliteProfileTest, KeepsSettingsOfCaller) {
+        int opened = 0;
+        cxx::SQLiteDatabase::Settings settings;
+        settings.poolSize = 2;
+        settings.onOpen = [&opened](sqlite3 *) {
+            ++opened;
+            return true;
+        };
+        const auto service = sqliteServiceSettings(settings);
+        EXPECT_EQ(service.poolSize, 2);
+        EXPECT_TRUE(service.foreignKeys);
+
+        const auto db = openSqliteDatabase(":memory:", settings);
+        EXPECT_EQ(opened, 1);
+        // The service functions are registered next to the hook of the caller
+        const auto category = db->makeTransaction()->executeQuery("SELECT add_category('Food')");
+        ASSERT_TRUE(category.has_value());
+        EXPECT_EQ(category->size(), 1);
+    }
+
+} // unnamed namespace
@@ -66,4 +66,214 @@ namespace {
         // EXPECT_EQ(response.fiscal_sign(), "3906849540");
     }
 
+    TEST_F(FinanceServiceTest, AuthenticationIsCached) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params, std::vector< SqlParam >{ std::string("token") });
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+
+        grpc::ServerContext context;
+        GetCategoriesRequest request;
+        request.mutable_auth()->set_token("token");
+
+        for (int i = 0; i < 3; ++i) {
+            CategoriesResponse response;
+            EXPECT_TRUE(service_->GetCategories(&context, &request, &response).ok());
+            EXPECT_NE(response.error().code(), ErrorInfo::UNAUTHORIZED);
+        }
+    }
+
+    TEST_F(FinanceServiceTest, RejectedTokenIsCachedUntilInvalidated) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .Times(2)
+         .WillRepeatedly(Return(QueryResult(1)));
+
+        grpc::ServerContext context;
+        GetCategoriesRequest request;
+        request.mutable_auth()->set_token("bad");
+
+        for (int i = 0; i < 2; ++i) {
+            CategoriesResponse response;
+            service_->GetCategories(&context, &request, &response);
+            EXPECT_EQ(response.error().code(), ErrorInfo::UNAUTHORIZED);
+        }
+
+        service_->invalidateToken("bad");
+
+        CategoriesResponse response;
+        service_->GetCategories(&context, &request, &response);
+        EXPECT_EQ(response.error().code(), ErrorInfo::UNAUTHORIZED);
+    }
+
+    TEST_F(FinanceServiceTest, GetTransactionsReturnsPageWithTotalsAndCursor) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("select_transactions"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > & params) {
+             EXPECT_EQ(params.size(), 9);
+             EXPECT_EQ(params[5], SqlParam(std::string("2024-05-01 10:00:00.5")));
+             EXPECT_EQ(params[6], SqlParam(int64_t{ 40 }));
+             EXPECT_EQ(params[7], SqlParam(int64_t{ 2 }));
+             EXPECT_EQ(params[8], SqlParam(int64_t{ 0 }));
+
+             QueryResult result(12);
+             for (int32_t id: { 30, 20 }) {
+                 result.addInt(5);
+                 result.addInt(1000);
+                 result.addInt(300);
+                 result.addInt(id);
+                 result.addText("2024-04-01 12:00:00");
+                 result.addInt(1);
+                 result.addInt(150);
+                 result.addNull();
+                 result.addNull();
+                 result.addNull();
+                 result.addNull();
+                 result.addBool(id == 20);
+             }
+             return result;
+         });
+
+        grpc::ServerContext context;
+        GetTransactionsRequest request;
+        request.mutable_auth()->set_token("token");
+        request.set_limit(2);
+        request.set_offset(10);
+        request.set_cursor("2024-05-01 10:00:00.5#40");
+
+        TransactionsResponse response;
+        ASSERT_TRUE(service_->GetTransactions(&context, &request, &response).ok());
+        ASSERT_TRUE(response.has_transactions());
+
+        const auto & list = response.transactions();
+        EXPECT_EQ(list.total_count(), 5);
+        EXPECT_EQ(list.total_income(), 1000);
+        EXPECT_EQ(list.total_expense(), 300);
+        EXPECT_EQ(list.balance(), 700);
+        ASSERT_EQ(list.transactions_size(), 2);
+        EXPECT_FALSE(list.transactions(0).has_splits());
+        EXPECT_TRUE(list.transactions(1).has_splits());
+        EXPECT_EQ(list.next_cursor(), "2024-04-01 12:00:00#20");
+    }
+
+    TEST_F(FinanceServiceTest, GetTransactionsEmptyPageKeepsTotals) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("select_transactions"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(12);
+             result.addInt(3);
+             result.addInt(0);
+             result.addInt(0);
+             for (int i = 0; i < 9; ++i) {
+                 result.addNull();
+             }
+             return result;
+         });
+
+        grpc::ServerContext context;
+        GetTransactionsRequest request;
+        request.mutable_auth()->set_token("token");
+
+        TransactionsResponse response;
+        ASSERT_TRUE(service_->GetTransactions(&context, &request, &response).ok());
+        EXPECT_EQ(response.transactions().total_count(), 3);
+        EXPECT_EQ(response.transactions().transactions_size(), 0);
+        EXPECT_FALSE(response.transactions().has_next_cursor());
+    }
+
+    TEST_F(FinanceServiceTest, GetTransactionsRejectsInvalidCursor) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("select_transactions"), _)).Times(0);
+
+        grpc::ServerContext context;
+        GetTransactionsRequest request;
+        request.mutable_auth()->set_token("token");
+        request.set_cursor("2024-05-01#abc");
+
+        TransactionsResponse response;
+        ASSERT_TRUE(service_->GetTransactions(&context, &request, &response).ok());
+        EXPECT_EQ(response.error().code(), ErrorInfo::INVALID_REQUEST);
+    }
+
+    TEST_F(FinanceServiceTest, GetStatisticsAggregatesDailyRollup) {
+        EXPECT_CALL(*mockTransaction_, prepare).WillRepeatedly(Return(true));
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("find_user_by_token"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(1);
+             result.addInt(7);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("select_daily_stats"), _))
+         .WillOnce([](const std::string &, const std::vector< SqlParam > &) {
+             QueryResult result(6);
+             auto addRow = [&result](std::string_view day, int64_t type, int64_t categoryId, std::string_view name, int64_t count, int64_t amount) {
+                 result.addText(day);
+                 result.addInt(type);
+                 result.addInt(categoryId);
+                 result.addText(name);
+                 result.addInt(count);
+                 result.addInt(amount);
+             };
+             addRow("2024-05-01", 0, 0, "Без категории", 1, 5000);
+             addRow("2024-05-01", 1, 2, "Food", 2, 300);
+             addRow("2024-05-02", 1, 3, "Transport", 1, 100);
+             addRow("2024-05-02", 1, 2, "Food", 1, 600);
+             return result;
+         });
+        EXPECT_CALL(*mockTransaction_, execPreparedParams(StrEq("select_character_stats"), _))
+         .WillOnce(Return(QueryResult(4)));
+
+        grpc::ServerContext context;
+        GetStatisticsRequest request;
+        request.mutable_auth()->set_token("token");
+
+        StatisticsResponse response;
+        ASSERT_TRUE(service_->GetStatistics(&context, &request, &response).ok());
+        ASSERT_TRUE(response.has_statistics());
+
+        const auto & statistics = response.statistics();
+        EXPECT_EQ(statistics.total_income(), 5000);
+        EXPECT_EQ(statistics.total_expense(), 1000);
+        EXPECT_EQ(statistics.balance(), 4000);
+        EXPECT_EQ(statistics.income_transactions_count(), 1);
+        EXPECT_EQ(statistics.expense_transactions_count(), 4);
+
+        const auto & chart = statistics.chart_data();
+        ASSERT_EQ(chart.daily_size(), 2);
+        EXPECT_EQ(chart.daily(0).date(), "2024-05-01");
+        EXPECT_EQ(chart.daily(0).income(), 5000);
+        EXPECT_EQ(chart.daily(0).expense(), 300);
+        EXPECT_EQ(chart.daily(1).expense(), 700);
+
+        ASSERT_EQ(chart.expenses_by_category_size(), 2);
+        EXPECT_EQ(chart.expenses_by_category(0).category_name(), "Food");
+        EXPECT_EQ(chart.expenses_by_category(0).transactions_count(), 3);
+        EXPECT_EQ(chart.expenses_by_category(0).total_amount(), 900);
+        EXPECT_DOUBLE_EQ(chart.expenses_by_category(0).percentage(), 90.0);
+        ASSERT_EQ(chart.incomes_by_category_size(), 1);
+        EXPECT_EQ(chart.incomes_by_category(0).category_id(), 0);
+    }
+
 } // unnamed namespace
@@ -34,6 +34,15 @@ macro(GTEST)
   set(GTEST_NAME ${ARGV0})
 endmacro()
 
+macro(BENCHMARK)
+  if(ARGC GREATER 1)
+    message(FATAL_ERROR "Macro BENCHMARK: Bad args")
+  endif()
+  __RESET()
+  set(SUIT "BENCHMARK")
+  set(BENCHMARK_NAME ${ARGV0})
+endmacro()
+
 macro(PROTO)
   if(ARGC GREATER 2)
     message(FATAL_ERROR "Macro PROTO: Bad args")
@@ -146,6 +155,9 @@ macro(END)
       NAME ${GTEST_NAME}
       COMMAND ${GTEST_NAME}_test
     )
+  elseif(SUIT STREQUAL "BENCHMARK")
+    add_executable(${BENCHMARK_NAME}_benchmark ${SOURCES})
+    target_link_libraries(${BENCHMARK_NAME}_benchmark PUBLIC ${LIBRARIES} benchmark::benchmark benchmark::benchmark_main)
   elseif(SUIT STREQUAL "LIBRARY")
     add_library(${LIBRARY_NAME} ${LIBRARY_PARAM})
     target_sources(${LIBRARY_NAME} PRIVATE ${SOURCES})
@@ -190,3 +202,12 @@ macro(ADD_TESTS)
     add_subdirectory(${ARGV0})
   endif()
 endmacro()
+
+macro(ADD_BENCHMARKS)
+  if(ARGC GREATER 1)
+    message(FATAL_ERROR "Macro ADD_BENCHMARKS: Bad args")
+  endif()
+  if(BUILD_BENCHMARKS)
+    add_subdirectory(${ARGV0})
+  endif()
+endmacro()
@@ -7,6 +7,8 @@ CREATE TABLE users (
 -- 2. Таблица данных пользователей
 CREATE TABLE users_data (
     user_id INTEGER REFERENCES users(id),
+    device_id VARCHAR(255) NOT NULL, -- Идентификатор устройства
+    device_name VARCHAR(255), -- Название устройства
     created_at TIMESTAMP NOT NULL DEFAULT NOW()
 );
 
@@ -28,7 +30,11 @@ CREATE TABLE receipt_requests (
     id SERIAL PRIMARY KEY,
     receipt_id INTEGER REFERENCES receipts(id),
     ofd_data JSONB,
-    request_time TIMESTAMP NOT NULL DEFAULT NOW()
+    request_time TIMESTAMP NOT NULL DEFAULT NOW(),
+    status SMALLINT NOT NULL DEFAULT 0 CHECK (status IN (0, 1, 2, 3)), -- 0-ожидает, 1-обрабатывается, 2-готово, 3-ошибка
+    attempts INTEGER NOT NULL DEFAULT 0, -- количество попыток запроса в ОФД
+    next_attempt_at TIMESTAMP NOT NULL DEFAULT NOW(), -- время следующей попытки (или окончания аренды)
+    last_error TEXT
 );
 
 -- 5.1. Таблица уникальных товаров
@@ -92,7 +98,7 @@ CREATE TABLE user_characters (
 CREATE TABLE transactions (
     id SERIAL PRIMARY KEY,
     user_id INTEGER NOT NULL REFERENCES users(id),
-    tr_time TIMESTAMP NOT NULL,
+    timestamp TIMESTAMP NOT NULL,
     type SMALLINT NOT NULL CHECK (type IN (0, 1)), -- 0-доход, 1-расход
     amount INTEGER NOT NULL, -- сумма в копейках
     category_id INTEGER REFERENCES categories(id) DEFAULT NULL,
@@ -112,18 +118,194 @@ CREATE TABLE transaction_splits (
     UNIQUE (transaction_id, character_id)
 );
 
+-- 11. Дневные агрегаты транзакций пользователя (поддерживаются триггерами)
+CREATE TABLE user_daily_stats (
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    day DATE NOT NULL,
+    type SMALLINT NOT NULL CHECK (type IN (0, 1)), -- 0-доход, 1-расход
+    category_id INTEGER NOT NULL DEFAULT 0, -- 0 - без категории
+    transactions_count INTEGER NOT NULL DEFAULT 0,
+    total_amount BIGINT NOT NULL DEFAULT 0, -- сумма в копейках
+    PRIMARY KEY (user_id, day, type, category_id)
+);
+
+-- 12. Дневные агрегаты делений транзакций по персонажам (поддерживаются триггерами)
+CREATE TABLE user_daily_character_stats (
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    day DATE NOT NULL,
+    type SMALLINT NOT NULL CHECK (type IN (0, 1)), -- тип транзакции
+    character_id INTEGER NOT NULL REFERENCES user_characters(id),
+    splits_count INTEGER NOT NULL DEFAULT 0,
+    total_amount BIGINT NOT NULL DEFAULT 0, -- сумма в копейках
+    PRIMARY KEY (user_id, day, type, character_id)
+);
+
 
 -- Индексы
+CREATE INDEX idx_users_token ON users(token);
+CREATE INDEX idx_users_data_device_id ON users_data(device_id);
 CREATE INDEX idx_receipts_fn_i_fp ON receipts(fn, i, fp);
 CREATE INDEX idx_receipt_items_receipt_data_id ON receipt_items(receipt_data_id);
 CREATE INDEX idx_receipt_items_unique_item_uid ON receipt_items(unique_item_id);
 CREATE INDEX idx_user_receipts_user_id ON user_receipts(user_id);
 CREATE INDEX idx_user_receipts_receipt_id ON user_receipts(receipt_id);
 CREATE INDEX idx_receipt_data_receipt_id ON receipt_data(receipt_id);
+CREATE INDEX idx_receipt_requests_due ON receipt_requests(next_attempt_at) WHERE status IN (0, 1);
 
 CREATE INDEX idx_user_characters_user_id ON user_characters(user_id);
-CREATE INDEX idx_transactions_user_id ON transactions(user_id);
+CREATE INDEX idx_transactions_user_id_timestamp ON transactions(user_id, timestamp DESC, id DESC);
 CREATE INDEX idx_transactions_category_id ON transactions(category_id);
 CREATE INDEX idx_transactions_receipt_id ON transactions(receipt_id);
 CREATE INDEX idx_transaction_splits_transaction_id ON transaction_splits(transaction_id);
 CREATE INDEX idx_transaction_splits_character_id ON transaction_splits(character_id);
+
+
+-- Поддержка дневных агрегатов
+CREATE FUNCTION apply_user_daily_stats(p_user_id INTEGER, p_day DATE, p_type SMALLINT, p_category_id INTEGER, p_count INTEGER, p_amount BIGINT)
+RETURNS VOID AS $$
+    INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+    VALUES (p_user_id, p_day, p_type, COALESCE(p_category_id, 0), p_count, p_amount)
+    ON CONFLICT (user_id, day, type, category_id) DO UPDATE SET
+        transactions_count = user_daily_stats.transactions_count + EXCLUDED.transactions_count,
+        total_amount = user_daily_stats.total_amount + EXCLUDED.total_amount;
+$$ LANGUAGE sql;
+
+CREATE FUNCTION apply_user_daily_character_stats(p_user_id INTEGER, p_day DATE, p_type SMALLINT, p_character_id INTEGER, p_count INTEGER, p_amount BIGINT)
+RETURNS VOID AS $$
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    VALUES (p_user_id, p_day, p_type, p_character_id, p_count, p_amount)
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = user_daily_character_stats.splits_count + EXCLUDED.splits_count,
+        total_amount = user_daily_character_stats.total_amount + EXCLUDED.total_amount;
+$$ LANGUAGE sql;
+
+CREATE FUNCTION transactions_daily_stats_trigger() RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP IN ('UPDATE', 'DELETE') THEN
+        PERFORM apply_user_daily_stats(OLD.user_id, OLD.timestamp::date, OLD.type, OLD.category_id, -1, -OLD.amount);
+    END IF;
+    IF TG_OP IN ('INSERT', 'UPDATE') THEN
+        PERFORM apply_user_daily_stats(NEW.user_id, NEW.timestamp::date, NEW.type, NEW.category_id, 1, NEW.amount);
+    END IF;
+
+    -- Деления переезжают вместе с датой и типом транзакции
+    IF TG_OP = 'UPDATE' AND (OLD.timestamp::date, OLD.type, OLD.user_id) IS DISTINCT FROM (NEW.timestamp::date, NEW.type, NEW.user_id) THEN
+        PERFORM apply_user_daily_character_stats(OLD.user_id, OLD.timestamp::date, OLD.type, ts.character_id, -1, -ts.amount)
+        FROM transaction_splits ts WHERE ts.transaction_id = NEW.id;
+        PERFORM apply_user_daily_character_stats(NEW.user_id, NEW.timestamp::date, NEW.type, ts.character_id, 1, ts.amount)
+        FROM transaction_splits ts WHERE ts.transaction_id = NEW.id;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE FUNCTION transaction_splits_daily_stats_trigger() RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP IN ('UPDATE', 'DELETE') THEN
+        PERFORM apply_user_daily_character_stats(t.user_id, t.timestamp::date, t.type, OLD.character_id, -1, -OLD.amount)
+        FROM transactions t WHERE t.id = OLD.transaction_id;
+    END IF;
+    IF TG_OP IN ('INSERT', 'UPDATE') THEN
+        PERFORM apply_user_daily_character_stats(t.user_id, t.timestamp::date, t.type, NEW.character_id, 1, NEW.amount)
+        FROM transactions t WHERE t.id = NEW.transaction_id;
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER tr_transactions_daily_stats
+AFTER INSERT OR DELETE OR UPDATE OF user_id, timestamp, type, amount, category_id ON transactions
+FOR EACH ROW EXECUTE FUNCTION transactions_daily_stats_trigger();
+
+CREATE TRIGGER tr_transaction_splits_daily_stats
+AFTER INSERT OR DELETE OR UPDATE OF transaction_id, character_id, amount ON transaction_splits
+FOR EACH ROW EXECUTE FUNCTION transaction_splits_daily_stats_trigger();
+
+-- Функции, вызываемые сервисом. Для SQLite они реализованы на C++ (backend/service/sqlite)
+
+-- Новый пользователь с основным персонажем
+CREATE FUNCTION add_user(p_token VARCHAR) RETURNS INTEGER AS $$
+    WITH new_user AS (
+        INSERT INTO users (token) VALUES (p_token) RETURNING id
+    ), main_character AS (
+        INSERT INTO user_characters (user_id, name) SELECT id, 'Основной' FROM new_user
+    )
+    SELECT id FROM new_user;
+$$ LANGUAGE sql;
+
+-- Чек по фискальным признакам, повторно отсканированный чек не дублируется
+CREATE FUNCTION add_receipt(p_t VARCHAR, p_s INTEGER, p_fn BIGINT, p_i BIGINT, p_fp BIGINT, p_n INTEGER) RETURNS INTEGER AS $$
+    INSERT INTO receipts (t, s, fn, i, fp, n) VALUES (p_t, p_s, p_fn, p_i, p_fp, p_n)
+    ON CONFLICT (fn, i, fp) DO UPDATE SET fn = EXCLUDED.fn
+    RETURNING id;
+$$ LANGUAGE sql;
+
+CREATE FUNCTION link_receipt_to_user(p_user_id INTEGER, p_receipt_id INTEGER) RETURNS VOID AS $$
+    INSERT INTO user_receipts (user_id, receipt_id) VALUES (p_user_id, p_receipt_id)
+    ON CONFLICT DO NOTHING;
+$$ LANGUAGE sql;
+
+-- Запрос данных чека в ОФД, на чек создаётся один запрос
+CREATE FUNCTION create_receipt_request(p_receipt_id INTEGER) RETURNS INTEGER AS $$
+DECLARE
+    v_request_id INTEGER;
+BEGIN
+    SELECT id INTO v_request_id FROM receipt_requests WHERE receipt_id = p_receipt_id ORDER BY id LIMIT 1;
+    IF v_request_id IS NULL THEN
+        INSERT INTO receipt_requests (receipt_id) VALUES (p_receipt_id) RETURNING id INTO v_request_id;
+    END IF;
+    RETURN v_request_id;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Расход на сумму чека во время продажи, повторное сканирование не создаёт вторую транзакцию
+CREATE FUNCTION create_transaction_from_receipt(p_user_id INTEGER, p_receipt_id INTEGER, p_category_id INTEGER, p_comment TEXT) RETURNS INTEGER AS $$
+DECLARE
+    v_transaction_id INTEGER;
+BEGIN
+    SELECT id INTO v_transaction_id FROM transactions WHERE user_id = p_user_id AND receipt_id = p_receipt_id ORDER BY id LIMIT 1;
+    IF v_transaction_id IS NULL THEN
+        INSERT INTO transactions (user_id, timestamp, type, amount, category_id, receipt_id, comment)
+        SELECT p_user_id, to_timestamp(rpad(r.t, 15, '0'), 'YYYYMMDD"T"HH24MISS')::timestamp, 1, r.s, p_category_id, r.id, p_comment
+        FROM receipts r WHERE r.id = p_receipt_id
+        RETURNING id INTO v_transaction_id;
+    END IF;
+    RETURN v_transaction_id;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE FUNCTION add_transaction(p_user_id INTEGER, p_type INTEGER, p_amount INTEGER, p_timestamp TIMESTAMP, p_category_id INTEGER, p_receipt_id INTEGER, p_comment TEXT) RETURNS INTEGER AS $$
+    INSERT INTO transactions (user_id, timestamp, type, amount, category_id, receipt_id, comment)
+    VALUES (p_user_id, p_timestamp, p_type, p_amount, p_category_id, p_receipt_id, p_comment)
+    RETURNING id;
+$$ LANGUAGE sql;
+
+CREATE FUNCTION add_transaction_split(p_transaction_id INTEGER, p_character_id INTEGER, p_amount INTEGER, p_comment TEXT) RETURNS INTEGER AS $$
+    INSERT INTO transaction_splits (transaction_id, character_id, amount, comment)
+    VALUES (p_transaction_id, p_character_id, p_amount, p_comment)
+    RETURNING id;
+$$ LANGUAGE sql;
+
+CREATE FUNCTION add_user_character(p_user_id INTEGER, p_name VARCHAR) RETURNS INTEGER AS $$
+    INSERT INTO user_characters (user_id, name) VALUES (p_user_id, p_name)
+    RETURNING id;
+$$ LANGUAGE sql;
+
+-- Категория с существующим названием не дублируется
+CREATE FUNCTION add_category(p_name VARCHAR) RETURNS INTEGER AS $$
+    INSERT INTO categories (name) VALUES (p_name)
+    ON CONFLICT (name) DO UPDATE SET name = EXCLUDED.name
+    RETURNING id;
+$$ LANGUAGE sql;
+
+-- Заполнение агрегатов для уже существующих данных
+INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+SELECT user_id, timestamp::date, type, COALESCE(category_id, 0), COUNT(*), SUM(amount)
+FROM transactions
+GROUP BY user_id, timestamp::date, type, COALESCE(category_id, 0);
+
+INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+SELECT t.user_id, t.timestamp::date, t.type, ts.character_id, COUNT(*), SUM(ts.amount)
+FROM transaction_splits ts
+JOIN transactions t ON t.id = ts.transaction_id
+GROUP BY t.user_id, t.timestamp::date, t.type, ts.character_id;
@@ -0,0 +1,275 @@
+-- Схема db.sql для SQLite (встроенный режим сервера)
+--
+-- Отличия от PostgreSQL:
+--   * SERIAL -> INTEGER PRIMARY KEY AUTOINCREMENT, идентификаторы не переиспользуются
+--   * TIMESTAMP и DATE хранятся текстом 'ГГГГ-ММ-ДД ЧЧ:ММ:СС' и 'ГГГГ-ММ-ДД', такие строки сравниваются как даты
+--   * JSONB хранится текстом, NUMERIC - числом с плавающей точкой
+--   * Хранимые функции (add_user, add_receipt, ...) реализованы на C++ и регистрируются на каждом соединении
+--   * Триггеры дневных агрегатов разделены по операциям, SQLite не поддерживает TG_OP
+--
+-- Скрипт идемпотентен, версия схемы хранится в PRAGMA user_version.
+
+-- 1. Таблица пользователей и токенов
+CREATE TABLE IF NOT EXISTS users (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    token TEXT NOT NULL
+);
+
+-- 2. Таблица данных пользователей
+CREATE TABLE IF NOT EXISTS users_data (
+    user_id INTEGER REFERENCES users(id),
+    device_id TEXT NOT NULL, -- Идентификатор устройства
+    device_name TEXT, -- Название устройства
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+-- 3. Таблица чеков Receipt
+CREATE TABLE IF NOT EXISTS receipts (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    t TEXT NOT NULL, -- Дата и время продажи (ггггммддTччммcc)
+    s INTEGER NOT NULL, -- Сумма чека (в копейках)
+    fn INTEGER NOT NULL, -- Номер фискального накопителя
+    i INTEGER NOT NULL, -- Номер фискального документа
+    fp INTEGER NOT NULL, -- Фискальный признак документа
+    n INTEGER NOT NULL, -- Вид документа
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    UNIQUE (fn, i, fp) -- Составной уникальный ключ для чека
+);
+
+-- 4. Таблица запросов данных чека
+CREATE TABLE IF NOT EXISTS receipt_requests (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    receipt_id INTEGER REFERENCES receipts(id),
+    ofd_data TEXT,
+    request_time TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    status INTEGER NOT NULL DEFAULT 0 CHECK (status IN (0, 1, 2, 3)), -- 0-ожидает, 1-обрабатывается, 2-готово, 3-ошибка
+    attempts INTEGER NOT NULL DEFAULT 0, -- количество попыток запроса в ОФД
+    next_attempt_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP, -- время следующей попытки (или окончания аренды)
+    last_error TEXT
+);
+
+-- 5.1. Таблица уникальных товаров
+CREATE TABLE IF NOT EXISTS unique_items (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    name TEXT NOT NULL
+);
+
+-- 5.2. Таблица данных чеков ReceiptData
+CREATE TABLE IF NOT EXISTS receipt_data (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    receipt_id INTEGER NOT NULL REFERENCES receipts(id),
+    request_id INTEGER REFERENCES receipt_requests(id),
+    retailer_name TEXT,
+    retailer_place TEXT,
+    retailer_inn TEXT,
+    retailer_address TEXT,
+    additional_info TEXT,
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+-- 5.3. Таблица receipt_items
+CREATE TABLE IF NOT EXISTS receipt_items (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    receipt_data_id INTEGER NOT NULL REFERENCES receipt_data(id),
+    unique_item_id INTEGER REFERENCES unique_items(id) DEFAULT NULL,
+    name TEXT NOT NULL,
+    price INTEGER NOT NULL,
+    quantity REAL NOT NULL,
+    amount INTEGER NOT NULL,
+    nds_type INTEGER NOT NULL,
+    payment_type INTEGER NOT NULL,
+    product_type INTEGER NOT NULL,
+    measurement_unit INTEGER NOT NULL,
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+-- 6. Таблица соотношений id чека и id пользователя
+CREATE TABLE IF NOT EXISTS user_receipts (
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    receipt_id INTEGER NOT NULL REFERENCES receipts(id),
+    UNIQUE (user_id, receipt_id)
+);
+
+-- 7. Таблица названий категорий
+CREATE TABLE IF NOT EXISTS categories (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    name TEXT NOT NULL UNIQUE
+);
+
+-- 8. Таблица доп. персонажей у пользователя
+CREATE TABLE IF NOT EXISTS user_characters (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    name TEXT NOT NULL,
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    UNIQUE (user_id, name)
+);
+
+-- 9. Таблица доходов/расходов (транзакций) пользователя
+CREATE TABLE IF NOT EXISTS transactions (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    timestamp TEXT NOT NULL,
+    type INTEGER NOT NULL CHECK (type IN (0, 1)), -- 0-доход, 1-расход
+    amount INTEGER NOT NULL, -- сумма в копейках
+    category_id INTEGER REFERENCES categories(id) DEFAULT NULL,
+    receipt_id INTEGER REFERENCES receipts(id) DEFAULT NULL,
+    comment TEXT,
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+-- 10. Таблица делений транзакций пользователя
+CREATE TABLE IF NOT EXISTS transaction_splits (
+    id INTEGER PRIMARY KEY AUTOINCREMENT,
+    transaction_id INTEGER NOT NULL REFERENCES transactions(id),
+    character_id INTEGER NOT NULL REFERENCES user_characters(id),
+    amount INTEGER NOT NULL, -- сумма в копейках
+    comment TEXT,
+    created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    UNIQUE (transaction_id, character_id)
+);
+
+-- 11. Дневные агрегаты транзакций пользователя (поддерживаются триггерами)
+CREATE TABLE IF NOT EXISTS user_daily_stats (
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    day TEXT NOT NULL,
+    type INTEGER NOT NULL CHECK (type IN (0, 1)), -- 0-доход, 1-расход
+    category_id INTEGER NOT NULL DEFAULT 0, -- 0 - без категории
+    transactions_count INTEGER NOT NULL DEFAULT 0,
+    total_amount INTEGER NOT NULL DEFAULT 0, -- сумма в копейках
+    PRIMARY KEY (user_id, day, type, category_id)
+) WITHOUT ROWID;
+
+-- 12. Дневные агрегаты делений транзакций по персонажам (поддерживаются триггерами)
+CREATE TABLE IF NOT EXISTS user_daily_character_stats (
+    user_id INTEGER NOT NULL REFERENCES users(id),
+    day TEXT NOT NULL,
+    type INTEGER NOT NULL CHECK (type IN (0, 1)), -- тип транзакции
+    character_id INTEGER NOT NULL REFERENCES user_characters(id),
+    splits_count INTEGER NOT NULL DEFAULT 0,
+    total_amount INTEGER NOT NULL DEFAULT 0, -- сумма в копейках
+    PRIMARY KEY (user_id, day, type, character_id)
+) WITHOUT ROWID;
+
+
+-- Индексы
+CREATE INDEX IF NOT EXISTS idx_users_token ON users(token);
+CREATE INDEX IF NOT EXISTS idx_users_data_device_id ON users_data(device_id);
+CREATE INDEX IF NOT EXISTS idx_receipts_fn_i_fp ON receipts(fn, i, fp);
+CREATE INDEX IF NOT EXISTS idx_receipt_items_receipt_data_id ON receipt_items(receipt_data_id);
+CREATE INDEX IF NOT EXISTS idx_receipt_items_unique_item_uid ON receipt_items(unique_item_id);
+CREATE INDEX IF NOT EXISTS idx_user_receipts_user_id ON user_receipts(user_id);
+CREATE INDEX IF NOT EXISTS idx_user_receipts_receipt_id ON user_receipts(receipt_id);
+CREATE INDEX IF NOT EXISTS idx_receipt_data_receipt_id ON receipt_data(receipt_id);
+CREATE INDEX IF NOT EXISTS idx_receipt_requests_due ON receipt_requests(next_attempt_at) WHERE status IN (0, 1);
+
+CREATE INDEX IF NOT EXISTS idx_user_characters_user_id ON user_characters(user_id);
+CREATE INDEX IF NOT EXISTS idx_transactions_user_id_timestamp ON transactions(user_id, timestamp DESC, id DESC);
+CREATE INDEX IF NOT EXISTS idx_transactions_category_id ON transactions(category_id);
+CREATE INDEX IF NOT EXISTS idx_transactions_receipt_id ON transactions(receipt_id);
+CREATE INDEX IF NOT EXISTS idx_transaction_splits_transaction_id ON transaction_splits(transaction_id);
+CREATE INDEX IF NOT EXISTS idx_transaction_splits_character_id ON transaction_splits(character_id);
+
+
+-- Поддержка дневных агрегатов транзакций
+CREATE TRIGGER IF NOT EXISTS tr_transactions_daily_stats_insert
+AFTER INSERT ON transactions
+BEGIN
+    INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+    VALUES (NEW.user_id, date(NEW.timestamp), NEW.type, COALESCE(NEW.category_id, 0), 1, NEW.amount)
+    ON CONFLICT (user_id, day, type, category_id) DO UPDATE SET
+        transactions_count = transactions_count + excluded.transactions_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+CREATE TRIGGER IF NOT EXISTS tr_transactions_daily_stats_delete
+AFTER DELETE ON transactions
+BEGIN
+    INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+    VALUES (OLD.user_id, date(OLD.timestamp), OLD.type, COALESCE(OLD.category_id, 0), -1, -OLD.amount)
+    ON CONFLICT (user_id, day, type, category_id) DO UPDATE SET
+        transactions_count = transactions_count + excluded.transactions_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+CREATE TRIGGER IF NOT EXISTS tr_transactions_daily_stats_update
+AFTER UPDATE OF user_id, timestamp, type, amount, category_id ON transactions
+BEGIN
+    INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+    VALUES (OLD.user_id, date(OLD.timestamp), OLD.type, COALESCE(OLD.category_id, 0), -1, -OLD.amount)
+    ON CONFLICT (user_id, day, type, category_id) DO UPDATE SET
+        transactions_count = transactions_count + excluded.transactions_count,
+        total_amount = total_amount + excluded.total_amount;
+
+    INSERT INTO user_daily_stats (user_id, day, type, category_id, transactions_count, total_amount)
+    VALUES (NEW.user_id, date(NEW.timestamp), NEW.type, COALESCE(NEW.category_id, 0), 1, NEW.amount)
+    ON CONFLICT (user_id, day, type, category_id) DO UPDATE SET
+        transactions_count = transactions_count + excluded.transactions_count,
+        total_amount = total_amount + excluded.total_amount;
+
+    -- Деления переезжают вместе с датой и типом транзакции
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT OLD.user_id, date(OLD.timestamp), OLD.type, ts.character_id, -1, -ts.amount
+    FROM transaction_splits ts
+    WHERE ts.transaction_id = NEW.id
+    AND (date(OLD.timestamp), OLD.type, OLD.user_id) IS NOT (date(NEW.timestamp), NEW.type, NEW.user_id)
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT NEW.user_id, date(NEW.timestamp), NEW.type, ts.character_id, 1, ts.amount
+    FROM transaction_splits ts
+    WHERE ts.transaction_id = NEW.id
+    AND (date(OLD.timestamp), OLD.type, OLD.user_id) IS NOT (date(NEW.timestamp), NEW.type, NEW.user_id)
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+-- Поддержка дневных агрегатов делений
+CREATE TRIGGER IF NOT EXISTS tr_transaction_splits_daily_stats_insert
+AFTER INSERT ON transaction_splits
+BEGIN
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT t.user_id, date(t.timestamp), t.type, NEW.character_id, 1, NEW.amount
+    FROM transactions t
+    WHERE t.id = NEW.transaction_id
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+CREATE TRIGGER IF NOT EXISTS tr_transaction_splits_daily_stats_delete
+AFTER DELETE ON transaction_splits
+BEGIN
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT t.user_id, date(t.timestamp), t.type, OLD.character_id, -1, -OLD.amount
+    FROM transactions t
+    WHERE t.id = OLD.transaction_id
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+CREATE TRIGGER IF NOT EXISTS tr_transaction_splits_daily_stats_update
+AFTER UPDATE OF transaction_id, character_id, amount ON transaction_splits
+BEGIN
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT t.user_id, date(t.timestamp), t.type, OLD.character_id, -1, -OLD.amount
+    FROM transactions t
+    WHERE t.id = OLD.transaction_id
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+
+    INSERT INTO user_daily_character_stats (user_id, day, type, character_id, splits_count, total_amount)
+    SELECT t.user_id, date(t.timestamp), t.type, NEW.character_id, 1, NEW.amount
+    FROM transactions t
+    WHERE t.id = NEW.transaction_id
+    ON CONFLICT (user_id, day, type, character_id) DO UPDATE SET
+        splits_count = splits_count + excluded.splits_count,
+        total_amount = total_amount + excluded.total_amount;
+END;
+
+PRAGMA user_version = 1;
@@ -15,7 +15,7 @@ namespace cxx {
         ~JniCameraSink() override = default;
 
         /**
-         * @brief Copies frame data from Java make new frame
+         * @brief Copies frame data from Java into a reused frame
          *
          * @param data image data
          * @param width image width
@@ -29,7 +29,8 @@ extern "C"
 
         auto mainLoop = std::make_unique< cxx::MainLoop >(
          camera,
-         client);
+         client,
+         WALLET_USER_TOKEN);
         mainActivity->setMainLoop(std::move(mainLoop));
 
         mainActivity->setBackgroudColor(BACKGROUD_COLOR);
@@ -0,0 +1,78 @@
+#include <platforms/common/camera/frame.h>
+
+#include <benchmark/benchmark.h>
+
+#include <opencv4/opencv2/core.hpp>
+
+#include <cstring>
+#include <memory>
+
+using namespace cxx;
+
+namespace {
+
+    constexpr int CHANNELS = 4;
+
+    /**
+     * @brief Landscape RGBA frame of the size given by the benchmark arguments
+     */
+    std::shared_ptr< Frame > makeFrame(const benchmark::State & state) {
+        const int width = static_cast< int >(state.range(0));
+        const int height = static_cast< int >(state.range(1));
+        auto frame = Frame::allocate(width, height, CHANNELS);
+        for (std::size_t i = 0; i < frame->capacity; ++i) {
+            frame->data[i] = static_cast< int8_t >(i * 31);
+        }
+        return frame;
+    }
+
+    /**
+     * @brief The previous Frame::rotate: cloned crop, cv::rotate into a new matrix and two copies back
+     */
+    void rotateWithOpenCV(Frame & frame, int cropWidth, int cropHeight) {
+        cv::Mat mat(frame.height, frame.width, CV_MAKETYPE(CV_8U, frame.channels), frame.data.get());
+        frame.width = cropWidth;
+        frame.height = cropHeight;
+        memcpy(
+         frame.data.get(),
+         mat(cv::Rect((mat.cols - cropWidth) / 2, (mat.rows - cropHeight) / 2, cropWidth, cropHeight)).clone().data,
+         cropWidth * cropHeight * frame.channels);
+
+        cv::Mat rgbaMat(frame.height, frame.width, CV_MAKETYPE(CV_8U, frame.channels), frame.data.get());
+        cv::Mat rotatedMat;
+        cv::rotate(rgbaMat, rotatedMat, cv::ROTATE_90_CLOCKWISE);
+        memcpy(frame.data.get(), rotatedMat.data, cropWidth * cropHeight * frame.channels);
+        std::swap(frame.width, frame.height);
+    }
+
+    // Both variants crop the center two thirds, as the preview of MainLoop does
+    void BM_RotateOpenCV(benchmark::State & state) {
+        auto frame = makeFrame(state);
+        const int width = frame->width;
+        const int height = frame->height;
+        for (auto _: state) {
+            frame->width = width;
+            frame->height = height;
+            rotateWithOpenCV(*frame, width * 2 / 3, height * 2 / 3);
+            benchmark::DoNotOptimize(frame->data.get());
+        }
+        state.SetBytesProcessed(state.iterations() * (width * 2 / 3) * (height * 2 / 3) * CHANNELS);
+    }
+
+    void BM_RotateTiled(benchmark::State & state) {
+        auto frame = makeFrame(state);
+        const int width = frame->width;
+        const int height = frame->height;
+        for (auto _: state) {
+            frame->width = width;
+            frame->height = height;
+            frame->rotate(width * 2 / 3, height * 2 / 3);
+            benchmark::DoNotOptimize(frame->data.get());
+        }
+        state.SetBytesProcessed(state.iterations() * (width * 2 / 3) * (height * 2 / 3) * CHANNELS);
+    }
+
+    BENCHMARK(BM_RotateOpenCV)->Args({ 960, 720 })->Args({ 1920, 1080 });
+    BENCHMARK(BM_RotateTiled)->Args({ 960, 720 })->Args({ 1920, 1080 });
+
+} // unnamed namespace
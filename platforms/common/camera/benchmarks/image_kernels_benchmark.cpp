@@ -0,0 +1,106 @@
+#include <platforms/common/camera/image_kernels.h>
+
+#include <benchmark/benchmark.h>
+
+#include <opencv4/opencv2/core.hpp>
+#include <opencv4/opencv2/imgproc.hpp>
+
+using namespace cxx;
+
+namespace {
+
+    constexpr int CROP_SIZE = 256;
+
+    /**
+     * @brief RGBA frame of the size given by the benchmark arguments
+     */
+    cv::Mat makeRgba(const benchmark::State & state) {
+        cv::Mat rgba(static_cast< int >(state.range(1)), static_cast< int >(state.range(0)), CV_8UC4);
+        cv::randu(rgba, cv::Scalar::all(0), cv::Scalar::all(256));
+        return rgba;
+    }
+
+    ImageRegion region(const cv::Mat & rgba) {
+        return { rgba.data, rgba.cols, rgba.rows, 4, rgba.step };
+    }
+
+    GrayImage image(cv::Mat & gray) {
+        return { gray.data, gray.cols, gray.rows, gray.step };
+    }
+
+    void setProcessed(benchmark::State & state, const cv::Mat & rgba) {
+        state.SetBytesProcessed(state.iterations() * rgba.total() * rgba.elemSize());
+    }
+
+    /**
+     * @brief The previous path: the full frame for display and the center square for the detector
+     * are converted separately
+     */
+    void BM_GrayOpenCV(benchmark::State & state) {
+        const cv::Mat rgba = makeRgba(state);
+        const cv::Rect roi((rgba.cols - CROP_SIZE) / 2, (rgba.rows - CROP_SIZE) / 2, CROP_SIZE, CROP_SIZE);
+        cv::Mat gray;
+        cv::Mat crop;
+        for (auto _: state) {
+            cv::cvtColor(rgba, gray, cv::COLOR_RGBA2GRAY);
+            cv::cvtColor(rgba(roi), crop, cv::COLOR_RGBA2GRAY);
+            benchmark::DoNotOptimize(gray.data);
+            benchmark::DoNotOptimize(crop.data);
+        }
+        setProcessed(state, rgba);
+    }
+
+    /**
+     * @brief Both images in one pass, with the instruction set given by the third argument
+     */
+    void BM_GrayFused(benchmark::State & state) {
+        const auto isa = static_cast< EKernelIsa >(state.range(2));
+        if (!isKernelIsaSupported(isa)) {
+            state.SkipWithError("Instruction set is not supported by the CPU");
+            return;
+        }
+        const cv::Mat rgba = makeRgba(state);
+        cv::Mat gray(rgba.rows, rgba.cols, CV_8UC1);
+        cv::Mat crop(CROP_SIZE, CROP_SIZE, CV_8UC1);
+        for (auto _: state) {
+            rgbaToGray(region(rgba), image(gray), (rgba.cols - CROP_SIZE) / 2, (rgba.rows - CROP_SIZE) / 2, image(crop), isa);
+            benchmark::DoNotOptimize(gray.data);
+            benchmark::DoNotOptimize(crop.data);
+        }
+        setProcessed(state, rgba);
+    }
+
+    void BM_GrayHalfOpenCV(benchmark::State & state) {
+        const cv::Mat rgba = makeRgba(state);
+        cv::Mat gray;
+        cv::Mat half;
+        for (auto _: state) {
+            cv::cvtColor(rgba, gray, cv::COLOR_RGBA2GRAY);
+            cv::resize(gray, half, cv::Size(rgba.cols / 2, rgba.rows / 2), 0, 0, cv::INTER_AREA);
+            benchmark::DoNotOptimize(half.data);
+        }
+        setProcessed(state, rgba);
+    }
+
+    void BM_GrayHalf(benchmark::State & state) {
+        const cv::Mat rgba = makeRgba(state);
+        cv::Mat half(rgba.rows / 2, rgba.cols / 2, CV_8UC1);
+        for (auto _: state) {
+            rgbaToGrayHalf(region(rgba), image(half));
+            benchmark::DoNotOptimize(half.data);
+        }
+        setProcessed(state, rgba);
+    }
+
+    // Rotated previews of 960x720 and 1920x1080 camera frames
+    BENCHMARK(BM_GrayOpenCV)->Args({ 480, 640 })->Args({ 720, 1280 });
+    BENCHMARK(BM_GrayFused)->ArgNames({ "width", "height", "isa" })->Apply([](benchmark::internal::Benchmark * benchmark) {
+        for (const auto isa: { EKernelIsa::SCALAR, EKernelIsa::SSE41, EKernelIsa::AVX2, EKernelIsa::NEON }) {
+            benchmark->Args({ 480, 640, static_cast< int >(isa) });
+            benchmark->Args({ 720, 1280, static_cast< int >(isa) });
+        }
+    });
+    BENCHMARK(BM_GrayHalfOpenCV)->Args({ 1920, 1080 });
+    BENCHMARK(BM_GrayHalf)->Args({ 1920, 1080 });
+
+} // unnamed namespace
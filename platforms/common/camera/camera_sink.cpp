@@ -1,13 +1,65 @@
 #include "camera_sink.h"
 
+#include <atomic>
+#include <utility>
+
 using namespace cxx;
 
+namespace {
+
+    /**
+     * @brief The frame is referenced only by the given pointer and may be overwritten
+     *
+     * Other owners may only release a frame the producer holds, so the count cannot grow back.
+     */
+    bool isUnique(const std::shared_ptr< Frame > & frame) {
+        if (frame.use_count() != 1) {
+            return false;
+        }
+        // Orders the pixel reads of the released owners before the following writes
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+} // unnamed namespace
+
 auto CameraSink::getLastFrame() const -> std::shared_ptr< Frame > {
-    std::lock_guard lock(mutex_);
-    return lastFrame_;
+    frames_.update();
+    return frames_.front();
 }
 
 void CameraSink::loadNewFrame(std::shared_ptr< Frame > newFrame) {
-    std::lock_guard lock(mutex_);
-    lastFrame_ = std::move(newFrame);
+    frames_.back() = std::move(newFrame);
+    frames_.publish();
+}
+
+auto CameraSink::loadNewFrame(const void * pixels, int width, int height, int channels) -> bool {
+    if (!acquireBackFrame()) {
+        return false;
+    }
+
+    auto & frame = frames_.back();
+    if (!frame || !frame->assign(pixels, width, height, channels)) {
+        // First frames or a new resolution
+        frame = Frame::allocate(width, height, channels);
+        frame->assign(pixels, width, height, channels);
+    }
+    frames_.publish();
+    return true;
+}
+
+auto CameraSink::acquireBackFrame() -> bool {
+    auto & frame = frames_.back();
+    if (!frame || isUnique(frame)) {
+        return true;
+    }
+
+    for (auto & spare: spares_) {
+        if (!spare || isUnique(spare)) {
+            // The held frame waits among the spares until its readers release it
+            std::swap(frame, spare);
+            return true;
+        }
+    }
+    return false;
 }
@@ -1,24 +1,68 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <memory>
-#include <mutex>
+
+#include <utils/concurrency/triple_buffer/triple_buffer.h>
 
 #include "frame.h"
 
 namespace cxx {
 
+    /**
+     * @brief Hands the latest camera frame from the camera thread to the render thread
+     *
+     * Frames are exchanged through a wait-free triple buffer, so the camera callback and
+     * the render thread never block each other. Pixels are copied into frames that are
+     * allocated once and reused, nothing is allocated per frame while the resolution
+     * stays the same.
+     *
+     * A frame returned by getLastFrame() may be kept as long as needed, e.g. by a detector:
+     * the sink does not write into a frame while someone else holds it and uses one of
+     * SPARE_FRAMES frames instead. When all of them are held, new frames are dropped.
+     *
+     * loadNewFrame() must be called from one thread, getLastFrame() from another one.
+     */
     class CameraSink {
+    public:
+        /**
+         * @brief Frames kept in addition to the three buffers for frames held by readers
+         */
+        static constexpr std::size_t SPARE_FRAMES = 2;
+
     public:
         CameraSink() = default;
         virtual ~CameraSink() = default;
 
         auto getLastFrame() const -> std::shared_ptr< Frame >;
+
+        /**
+         * @brief Publishes a frame allocated by the caller
+         */
         void loadNewFrame(std::shared_ptr< Frame > newFrame);
 
+        /**
+         * @brief Copies pixels into a reusable frame and publishes it
+         *
+         * @return False if the frame was dropped because every frame is held by readers
+         */
+        auto loadNewFrame(const void * pixels, int width, int height, int channels) -> bool;
+
+    private:
+        /**
+         * @brief Makes the back buffer hold a frame nobody else reads
+         */
+        auto acquireBackFrame() -> bool;
+
     private:
-        // TODO: atomic_shared
-        std::shared_ptr< Frame > lastFrame_;
-        mutable std::mutex mutex_;
+        // Taking the latest frame switches the front buffer, which does not change the observable state
+        mutable TripleBuffer< std::shared_ptr< Frame > > frames_;
+
+        /**
+         * @brief Frames swapped out of the back buffer while held by readers, used by the producer only
+         */
+        std::array< std::shared_ptr< Frame >, SPARE_FRAMES > spares_;
     };
 
 } // namespace cxx
@@ -1,23 +1,60 @@
 #include "frame.h"
+#include "frame_transform.h"
 
-#include <opencv4/opencv2/core.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
 
 using namespace cxx;
 
+auto Frame::allocate(int width, int height, int channels) -> std::shared_ptr< Frame > {
+    const auto size = static_cast< std::size_t >(width) * height * channels;
+    return std::make_shared< Frame >(std::make_unique_for_overwrite< int8_t[] >(size), width, height, channels, size);
+}
+
+auto Frame::assign(const void * pixels, int width, int height, int channels) -> bool {
+    const auto size = static_cast< std::size_t >(width) * height * channels;
+    if (size > capacity) {
+        return false;
+    }
+    memcpy(data.get(), pixels, size);
+    this->width = width;
+    this->height = height;
+    this->channels = channels;
+    return true;
+}
+
 void Frame::rotate() {
-    cv::Mat mat(height, width, CV_MAKETYPE(CV_8U, channels), data.get());
-    width = 640;
-    height = 480;
-    memcpy(
-     data.get(),
-     mat(cv::Rect((mat.cols - width) / 2, (mat.rows - height) / 2, width, height)).clone().data,
-     width * height * channels);
-
-    cv::Mat rgbaMat(height, width, CV_MAKETYPE(CV_8U, channels), data.get());
-    cv::Mat rotatedMat;
-    cv::rotate(rgbaMat, rotatedMat, cv::ROTATE_90_CLOCKWISE);
-    memcpy(data.get(), rotatedMat.data, width * height * channels);
-    std::swap(width, height);
+    rotate(width, height);
+}
+
+void Frame::rotate(int cropWidth, int cropHeight) {
+    cropWidth = std::clamp(cropWidth, 0, width);
+    cropHeight = std::clamp(cropHeight, 0, height);
+    // Frames made by the caller do not set their capacity, the buffers are swapped below
+    capacity = std::max(capacity, static_cast< std::size_t >(width) * height * channels);
+    const auto size = static_cast< std::size_t >(cropWidth) * cropHeight * channels;
+    if (scratchCapacity < size) {
+        // Room for the whole frame, so later crops of any size fit
+        scratchCapacity = capacity;
+        scratch = std::make_unique_for_overwrite< int8_t[] >(scratchCapacity);
+    }
+
+    const auto stride = static_cast< std::size_t >(width) * channels;
+    const auto offset = static_cast< std::size_t >((height - cropHeight) / 2) * stride + static_cast< std::size_t >((width - cropWidth) / 2) * channels;
+    const ImageRegion region{
+        reinterpret_cast< const uint8_t * >(data.get()) + offset,
+        cropWidth,
+        cropHeight,
+        channels,
+        stride
+    };
+    rotateClockwise(region, reinterpret_cast< uint8_t * >(scratch.get()));
+
+    std::swap(data, scratch);
+    std::swap(capacity, scratchCapacity);
+    width = cropHeight;
+    height = cropWidth;
 }
 
 auto Frame::isVertical() const -> bool {
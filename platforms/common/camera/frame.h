@@ -1,16 +1,52 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace cxx {
     struct Frame final {
+        /**
+         * @brief Allocates a frame with room for width * height * channels bytes
+         */
+        static auto allocate(int width, int height, int channels) -> std::shared_ptr< Frame >;
+
+        /**
+         * @brief Copies pixels into the frame without reallocating
+         *
+         * @return False if the pixels do not fit into the buffer of the frame
+         */
+        auto assign(const void * pixels, int width, int height, int channels) -> bool;
+
+        /**
+         * @brief Rotates the frame by 90 degrees clockwise
+         */
         void rotate();
+
+        /**
+         * @brief Crops the center of the frame and rotates it by 90 degrees clockwise
+         *
+         * The result is written into the scratch buffer in one pass, which then becomes the
+         * data of the frame. The scratch buffer is allocated once and reused.
+         *
+         * @param cropWidth Width of the centered region, at most the frame width
+         * @param cropHeight Height of the centered region, at most the frame height
+         */
+        void rotate(int cropWidth, int cropHeight);
+
         auto isVertical() const -> bool;
 
     public:
-        const std::unique_ptr< int8_t[] > data;
+        std::unique_ptr< int8_t[] > data;
         int width;
         int height;
-        const int channels;
+        int channels;
+        std::size_t capacity = 0;
+
+        /**
+         * @brief Destination of rotate(), swapped with data afterwards
+         */
+        std::unique_ptr< int8_t[] > scratch;
+        std::size_t scratchCapacity = 0;
     };
 } // namespace cxx
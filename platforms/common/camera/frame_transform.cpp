@@ -0,0 +1,66 @@
+#include "frame_transform.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace cxx;
+
+namespace {
+
+    // 32 x 32 RGBA pixels: a tile of the source and of the destination fit into L1 together
+    constexpr int TILE = 32;
+
+    /**
+     * @brief Copies the pixels of one tile, source pixel (x, y) goes to destination (height - 1 - y, x)
+     *
+     * Channels is a compile-time constant for common layouts, so copying a pixel is a single move.
+     */
+    template < int Channels >
+    void rotateTile(const ImageRegion & region, int channels, uint8_t * dst, int tileX, int tileY) {
+        const int pixelSize = Channels > 0 ? Channels : channels;
+        const std::size_t dstStride = static_cast< std::size_t >(region.height) * pixelSize;
+        const int endX = std::min(tileX + TILE, region.width);
+        const int endY = std::min(tileY + TILE, region.height);
+
+        for (int y = tileY; y < endY; ++y) {
+            const uint8_t * src = region.data + y * region.stride + static_cast< std::size_t >(tileX) * pixelSize;
+            uint8_t * out = dst + static_cast< std::size_t >(tileX) * dstStride + static_cast< std::size_t >(region.height - 1 - y) * pixelSize;
+            for (int x = tileX; x < endX; ++x) {
+                if constexpr (Channels > 0) {
+                    memcpy(out, src, Channels);
+                } else {
+                    memcpy(out, src, pixelSize);
+                }
+                src += pixelSize;
+                out += dstStride;
+            }
+        }
+    }
+
+    template < int Channels >
+    void rotateTiled(const ImageRegion & region, uint8_t * dst) {
+        for (int tileY = 0; tileY < region.height; tileY += TILE) {
+            for (int tileX = 0; tileX < region.width; tileX += TILE) {
+                rotateTile< Channels >(region, region.channels, dst, tileX, tileY);
+            }
+        }
+    }
+
+} // unnamed namespace
+
+void cxx::rotateClockwise(const ImageRegion & region, uint8_t * dst) {
+    switch (region.channels) {
+    case 1:
+        rotateTiled< 1 >(region, dst);
+        break;
+    case 3:
+        rotateTiled< 3 >(region, dst);
+        break;
+    case 4:
+        rotateTiled< 4 >(region, dst);
+        break;
+    default:
+        rotateTiled< 0 >(region, dst);
+        break;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cxx {
+
+    /**
+     * @brief Rectangular region of an interleaved 8-bit image
+     */
+    struct ImageRegion {
+        const uint8_t * data; /**< First pixel of the region */
+        int width;
+        int height;
+        int channels;
+        std::size_t stride; /**< Bytes between the starts of two image rows */
+    };
+
+    /**
+     * @brief Copies a region rotated by 90 degrees clockwise
+     *
+     * The image is transposed tile by tile, so both the rows read and the rows written stay
+     * in cache. One pass, no allocations.
+     *
+     * @param region Source region
+     * @param dst Destination of region.height x region.width pixels, rows tightly packed.
+     *            Must not overlap the source.
+     */
+    void rotateClockwise(const ImageRegion & region, uint8_t * dst);
+
+} // namespace cxx
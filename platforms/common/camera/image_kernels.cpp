@@ -0,0 +1,230 @@
+#include "image_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CXX_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define CXX_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+using namespace cxx;
+
+namespace {
+
+    // Fixed-point luma weights of OpenCV, they sum up to 1 << GRAY_SHIFT
+    constexpr int R_WEIGHT = 4899;
+    constexpr int G_WEIGHT = 9617;
+    constexpr int B_WEIGHT = 1868;
+    constexpr int GRAY_SHIFT = 14;
+
+    constexpr int CHANNELS = 4;
+
+    // Gray pixels of the two rows averaged by the half kernel, kept on the stack
+    constexpr int HALF_CHUNK = 512;
+
+    /**
+     * @brief Converts width RGBA pixels to gray
+     */
+    using GrayRow = void (*)(const uint8_t * src, uint8_t * dst, int width);
+
+    void grayRowScalar(const uint8_t * src, uint8_t * dst, int width) {
+        for (int x = 0; x < width; ++x, src += CHANNELS) {
+            dst[x] = static_cast< uint8_t >((src[0] * R_WEIGHT + src[1] * G_WEIGHT + src[2] * B_WEIGHT + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+        }
+    }
+
+#ifdef CXX_KERNELS_X86
+    /**
+     * @brief 8 pixels per step: the weighted R + G and B + 0 sums of a pixel come from one
+     * multiply-add of 16-bit lanes, a horizontal add joins them
+     */
+    __attribute__((target("sse4.1"))) void grayRowSse41(const uint8_t * src, uint8_t * dst, int width) {
+        const __m128i weights = _mm_setr_epi16(R_WEIGHT, G_WEIGHT, B_WEIGHT, 0, R_WEIGHT, G_WEIGHT, B_WEIGHT, 0);
+        const __m128i round = _mm_set1_epi32(1 << (GRAY_SHIFT - 1));
+        const __m128i zero = _mm_setzero_si128();
+
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast< const __m128i * >(src + x * CHANNELS));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast< const __m128i * >(src + x * CHANNELS + 16));
+
+            const __m128i sums0 = _mm_hadd_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), weights), _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), weights));
+            const __m128i sums1 = _mm_hadd_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), weights), _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), weights));
+
+            const __m128i gray0 = _mm_srli_epi32(_mm_add_epi32(sums0, round), GRAY_SHIFT);
+            const __m128i gray1 = _mm_srli_epi32(_mm_add_epi32(sums1, round), GRAY_SHIFT);
+            const __m128i gray16 = _mm_packus_epi32(gray0, gray1);
+            _mm_storel_epi64(reinterpret_cast< __m128i * >(dst + x), _mm_packus_epi16(gray16, gray16));
+        }
+        grayRowScalar(src + x * CHANNELS, dst + x, width - x);
+    }
+
+    /**
+     * @brief The SSE4.1 scheme on 16 pixels per step
+     *
+     * AVX2 unpacks and packs within 128-bit lanes, a qword permutation restores the pixel order.
+     */
+    __attribute__((target("avx2"))) void grayRowAvx2(const uint8_t * src, uint8_t * dst, int width) {
+        const __m256i weights = _mm256_setr_epi16(
+         R_WEIGHT, G_WEIGHT, B_WEIGHT, 0, R_WEIGHT, G_WEIGHT, B_WEIGHT, 0,
+         R_WEIGHT, G_WEIGHT, B_WEIGHT, 0, R_WEIGHT, G_WEIGHT, B_WEIGHT, 0);
+        const __m256i round = _mm256_set1_epi32(1 << (GRAY_SHIFT - 1));
+        const __m256i zero = _mm256_setzero_si256();
+
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(src + x * CHANNELS));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(src + x * CHANNELS + 32));
+
+            // Lanes hold pixels 0-3 | 4-7 and 8-11 | 12-15
+            const __m256i sums0 = _mm256_hadd_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), weights), _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), weights));
+            const __m256i sums1 = _mm256_hadd_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), weights), _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), weights));
+
+            const __m256i gray0 = _mm256_srli_epi32(_mm256_add_epi32(sums0, round), GRAY_SHIFT);
+            const __m256i gray1 = _mm256_srli_epi32(_mm256_add_epi32(sums1, round), GRAY_SHIFT);
+            // Qwords 0-3, 8-11 | 4-7, 12-15 reordered to 0-3, 4-7 | 8-11, 12-15
+            const __m256i gray16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(gray0, gray1), 0xD8);
+            const __m128i gray8 = _mm_packus_epi16(_mm256_castsi256_si128(gray16), _mm256_extracti128_si256(gray16, 1));
+            _mm_storeu_si128(reinterpret_cast< __m128i * >(dst + x), gray8);
+        }
+        grayRowScalar(src + x * CHANNELS, dst + x, width - x);
+    }
+#endif
+
+#ifdef CXX_KERNELS_NEON
+    /**
+     * @brief 16 pixels per step, deinterleaved by the load; the rounding narrowing shift
+     * matches the scalar rounding exactly
+     */
+    void grayRowNeon(const uint8_t * src, uint8_t * dst, int width) {
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            const uint8x16x4_t pixels = vld4q_u8(src + x * CHANNELS);
+
+            const auto gray8 = [](uint8x8_t r, uint8x8_t g, uint8x8_t b) {
+                const uint16x8_t r16 = vmovl_u8(r);
+                const uint16x8_t g16 = vmovl_u8(g);
+                const uint16x8_t b16 = vmovl_u8(b);
+
+                uint32x4_t lo = vmull_n_u16(vget_low_u16(r16), R_WEIGHT);
+                lo = vmlal_n_u16(lo, vget_low_u16(g16), G_WEIGHT);
+                lo = vmlal_n_u16(lo, vget_low_u16(b16), B_WEIGHT);
+                uint32x4_t hi = vmull_n_u16(vget_high_u16(r16), R_WEIGHT);
+                hi = vmlal_n_u16(hi, vget_high_u16(g16), G_WEIGHT);
+                hi = vmlal_n_u16(hi, vget_high_u16(b16), B_WEIGHT);
+
+                return vmovn_u16(vcombine_u16(vrshrn_n_u32(lo, GRAY_SHIFT), vrshrn_n_u32(hi, GRAY_SHIFT)));
+            };
+
+            const uint8x8_t first = gray8(vget_low_u8(pixels.val[0]), vget_low_u8(pixels.val[1]), vget_low_u8(pixels.val[2]));
+            const uint8x8_t second = gray8(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]), vget_high_u8(pixels.val[2]));
+            vst1q_u8(dst + x, vcombine_u8(first, second));
+        }
+        grayRowScalar(src + x * CHANNELS, dst + x, width - x);
+    }
+#endif
+
+    GrayRow grayRow(EKernelIsa isa) {
+        if (!isKernelIsaSupported(isa)) {
+            return grayRowScalar;
+        }
+        switch (isa) {
+#ifdef CXX_KERNELS_X86
+        case EKernelIsa::SSE41:
+            return grayRowSse41;
+        case EKernelIsa::AVX2:
+            return grayRowAvx2;
+#endif
+#ifdef CXX_KERNELS_NEON
+        case EKernelIsa::NEON:
+            return grayRowNeon;
+#endif
+        default:
+            return grayRowScalar;
+        }
+    }
+
+    const uint8_t * row(const ImageRegion & image, int y) {
+        return image.data + y * image.stride;
+    }
+
+    uint8_t * row(const GrayImage & image, int y) {
+        return image.data + y * image.stride;
+    }
+
+} // unnamed namespace
+
+bool cxx::isKernelIsaSupported(EKernelIsa isa) {
+    switch (isa) {
+    case EKernelIsa::SCALAR:
+        return true;
+#ifdef CXX_KERNELS_X86
+    case EKernelIsa::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case EKernelIsa::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#ifdef CXX_KERNELS_NEON
+    case EKernelIsa::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+EKernelIsa cxx::bestKernelIsa() {
+    static const EKernelIsa best = []() {
+        for (const auto isa: { EKernelIsa::AVX2, EKernelIsa::SSE41, EKernelIsa::NEON }) {
+            if (isKernelIsaSupported(isa)) {
+                return isa;
+            }
+        }
+        return EKernelIsa::SCALAR;
+    }();
+    return best;
+}
+
+void cxx::rgbaToGray(const ImageRegion & src, const GrayImage & dst, EKernelIsa isa) {
+    const auto convert = grayRow(isa);
+    for (int y = 0; y < src.height; ++y) {
+        convert(row(src, y), row(dst, y), src.width);
+    }
+}
+
+void cxx::rgbaToGray(const ImageRegion & src, const GrayImage & dst, int cropX, int cropY, const GrayImage & crop, EKernelIsa isa) {
+    const auto convert = grayRow(isa);
+    for (int y = 0; y < src.height; ++y) {
+        convert(row(src, y), row(dst, y), src.width);
+        if (y >= cropY && y < cropY + crop.height) {
+            memcpy(row(crop, y - cropY), row(dst, y) + cropX, crop.width);
+        }
+    }
+}
+
+void cxx::rgbaToGrayHalf(const ImageRegion & src, const GrayImage & dst, EKernelIsa isa) {
+    const auto convert = grayRow(isa);
+    uint8_t top[HALF_CHUNK];
+    uint8_t bottom[HALF_CHUNK];
+
+    for (int y = 0; y < dst.height; ++y) {
+        const uint8_t * srcTop = row(src, 2 * y);
+        const uint8_t * srcBottom = row(src, 2 * y + 1);
+        uint8_t * out = row(dst, y);
+
+        for (int x = 0; x < dst.width; x += HALF_CHUNK / 2) {
+            const int count = std::min(HALF_CHUNK / 2, dst.width - x);
+            convert(srcTop + 2 * x * CHANNELS, top, 2 * count);
+            convert(srcBottom + 2 * x * CHANNELS, bottom, 2 * count);
+            for (int i = 0; i < count; ++i) {
+                out[x + i] = static_cast< uint8_t >((top[2 * i] + top[2 * i + 1] + bottom[2 * i] + bottom[2 * i + 1] + 2) >> 2);
+            }
+        }
+    }
+}
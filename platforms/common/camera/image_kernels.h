@@ -0,0 +1,78 @@
+#pragma once
+
+#include "frame_transform.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cxx {
+
+    /**
+     * @brief Writable 8-bit single channel image
+     */
+    struct GrayImage {
+        uint8_t * data;
+        int width;
+        int height;
+        std::size_t stride; /**< Bytes between the starts of two rows */
+    };
+
+    /**
+     * @brief Instruction sets the image kernels are implemented with
+     */
+    enum class EKernelIsa {
+        SCALAR, /**< Portable C++ */
+        SSE41,  /**< x86 SSE4.1, selected at run time */
+        AVX2,   /**< x86 AVX2, selected at run time */
+        NEON    /**< ARM NEON, always present on arm64 */
+    };
+
+    /**
+     * @brief Whether the CPU runs the kernels of the instruction set
+     */
+    bool isKernelIsaSupported(EKernelIsa isa);
+
+    /**
+     * @brief Fastest instruction set supported by the CPU
+     */
+    EKernelIsa bestKernelIsa();
+
+    /**
+     * @brief Converts an RGBA region to gray
+     *
+     * Bit-exact with cv::cvtColor and COLOR_RGBA2GRAY: Y = (4899 R + 9617 G + 1868 B + 2^13) >> 14.
+     *
+     * @param src Region with 4 channels
+     * @param dst Image of the same size
+     * @param isa Instruction set, the scalar code runs if the CPU does not support it
+     */
+    void rgbaToGray(const ImageRegion & src, const GrayImage & dst, EKernelIsa isa = bestKernelIsa());
+
+    /**
+     * @brief Converts an RGBA region to gray and copies a part of it into another image
+     *
+     * Produces a full image and a crop of it in one pass over the source: every part row is
+     * copied right after its row is converted, while it is in cache.
+     *
+     * @param src Region with 4 channels
+     * @param dst Image of the same size
+     * @param cropX Left column of the part in src
+     * @param cropY Top row of the part in src
+     * @param crop Receives the part, of its size; the part must lie inside src
+     * @param isa Instruction set, the scalar code runs if the CPU does not support it
+     */
+    void rgbaToGray(const ImageRegion & src, const GrayImage & dst, int cropX, int cropY, const GrayImage & crop, EKernelIsa isa = bestKernelIsa());
+
+    /**
+     * @brief Converts an RGBA region to gray at half the size
+     *
+     * Every output pixel is the rounded mean of a 2x2 block of gray pixels, bit-exact with
+     * cv::cvtColor followed by cv::resize with INTER_AREA. An odd last row or column is skipped.
+     *
+     * @param src Region with 4 channels
+     * @param dst Image of src.width / 2 x src.height / 2 pixels
+     * @param isa Instruction set, the scalar code runs if the CPU does not support it
+     */
+    void rgbaToGrayHalf(const ImageRegion & src, const GrayImage & dst, EKernelIsa isa = bestKernelIsa());
+
+} // namespace cxx
@@ -0,0 +1,130 @@
+#include <platforms/common/camera/image_kernels.h>
+
+#include <gtest/gtest.h>
+
+#include <opencv4/opencv2/core.hpp>
+#include <opencv4/opencv2/core/utility.hpp>
+#include <opencv4/opencv2/imgproc.hpp>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace cxx;
+
+namespace {
+
+    /**
+     * @brief Runs every case with each instruction set the CPU supports
+     */
+    class ImageKernelsTest: public ::testing::TestWithParam< EKernelIsa > {
+    public:
+        void SetUp() override {
+            if (!isKernelIsaSupported(GetParam())) {
+                GTEST_SKIP() << "Instruction set is not supported by the CPU";
+            }
+            // IPP rounds differently, the kernels follow the fixed-point code of OpenCV
+            cv::ipp::setUseIPP(false);
+        }
+
+    protected:
+        static cv::Mat randomRgba(int width, int height) {
+            cv::Mat rgba(height, width, CV_8UC4);
+            std::mt19937 random(width * 7919 + height);
+            std::uniform_int_distribution< int > byte(0, 255);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width * 4; ++x) {
+                    rgba.ptr< uint8_t >(y)[x] = static_cast< uint8_t >(byte(random));
+                }
+            }
+            // Extremes, where rounding and saturation differ first
+            rgba.ptr< uint8_t >(0)[0] = 255;
+            rgba.ptr< uint8_t >(0)[1] = 255;
+            rgba.ptr< uint8_t >(0)[2] = 255;
+            return rgba;
+        }
+
+        static ImageRegion region(const cv::Mat & rgba) {
+            return { rgba.data, rgba.cols, rgba.rows, 4, rgba.step };
+        }
+
+        static GrayImage image(cv::Mat & gray) {
+            return { gray.data, gray.cols, gray.rows, gray.step };
+        }
+
+        static bool equal(const cv::Mat & lhs, const cv::Mat & rhs) {
+            return lhs.size() == rhs.size() && cv::countNonZero(lhs != rhs) == 0;
+        }
+    };
+
+    const std::vector< std::pair< int, int > > SIZES = { { 1, 1 }, { 7, 3 }, { 17, 5 }, { 33, 9 }, { 256, 256 }, { 641, 479 }, { 960, 720 } };
+
+    TEST_P(ImageKernelsTest, GrayMatchesOpenCV) {
+        for (const auto & [width, height]: SIZES) {
+            const cv::Mat rgba = randomRgba(width, height);
+            cv::Mat expected;
+            cv::cvtColor(rgba, expected, cv::COLOR_RGBA2GRAY);
+
+            cv::Mat gray(height, width, CV_8UC1);
+            rgbaToGray(region(rgba), image(gray), GetParam());
+            EXPECT_TRUE(equal(gray, expected)) << width << "x" << height;
+        }
+    }
+
+    TEST_P(ImageKernelsTest, GrayOfRegionMatchesOpenCV) {
+        const cv::Mat rgba = randomRgba(120, 80);
+        const cv::Rect roi(13, 7, 61, 50);
+        cv::Mat expected;
+        cv::cvtColor(rgba(roi), expected, cv::COLOR_RGBA2GRAY);
+
+        cv::Mat gray(roi.height, roi.width, CV_8UC1);
+        rgbaToGray(region(rgba(roi)), image(gray), GetParam());
+        EXPECT_TRUE(equal(gray, expected));
+    }
+
+    TEST_P(ImageKernelsTest, CropIsCopiedInTheSamePass) {
+        const cv::Mat rgba = randomRgba(640, 480);
+        const cv::Rect roi(192, 112, 256, 256);
+        cv::Mat expected;
+        cv::cvtColor(rgba, expected, cv::COLOR_RGBA2GRAY);
+
+        cv::Mat gray(rgba.rows, rgba.cols, CV_8UC1);
+        cv::Mat crop(roi.height, roi.width, CV_8UC1);
+        rgbaToGray(region(rgba), image(gray), roi.x, roi.y, image(crop), GetParam());
+        EXPECT_TRUE(equal(gray, expected));
+        EXPECT_TRUE(equal(crop, expected(roi)));
+    }
+
+    TEST_P(ImageKernelsTest, HalfMatchesOpenCVArea) {
+        for (const auto & [width, height]: std::vector< std::pair< int, int > >{ { 2, 2 }, { 34, 18 }, { 1282, 722 } }) {
+            const cv::Mat rgba = randomRgba(width, height);
+            cv::Mat gray;
+            cv::cvtColor(rgba, gray, cv::COLOR_RGBA2GRAY);
+            cv::Mat expected;
+            cv::resize(gray, expected, cv::Size(width / 2, height / 2), 0, 0, cv::INTER_AREA);
+
+            cv::Mat half(height / 2, width / 2, CV_8UC1);
+            rgbaToGrayHalf(region(rgba), image(half), GetParam());
+            EXPECT_TRUE(equal(half, expected)) << width << "x" << height;
+        }
+    }
+
+    INSTANTIATE_TEST_SUITE_P(
+     Isa,
+     ImageKernelsTest,
+     ::testing::Values(EKernelIsa::SCALAR, EKernelIsa::SSE41, EKernelIsa::AVX2, EKernelIsa::NEON),
+     [](const ::testing::TestParamInfo< EKernelIsa > & info) {
+         switch (info.param) {
+         case EKernelIsa::SCALAR:
+             return "Scalar";
+         case EKernelIsa::SSE41:
+             return "Sse41";
+         case EKernelIsa::AVX2:
+             return "Avx2";
+         case EKernelIsa::NEON:
+             return "Neon";
+         }
+         return "Unknown";
+     });
+
+} // unnamed namespace
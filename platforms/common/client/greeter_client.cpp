@@ -3,42 +3,74 @@
 
 #include <spdlog/spdlog.h>
 
-ReceiptScannerClient::ReceiptScannerClient(const std::shared_ptr< Channel > & channel)
-  : stub_(FinanceService::NewStub(channel)) {
+namespace {
+
+    IReceiptScannerClient::Response toResponse(const Status & status, const ReceiptDetailsResponse & response) {
+        if (!status.ok()) {
+            SPDLOG_ERROR("ProcessQRCode failed: {}", status.error_message());
+            if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED) {
+                return { .error = "Server did not answer in time" };
+            }
+            return { .error = "Server is unavailable" };
+        }
+
+        if (!response.has_receipt_data()) {
+            return { .error = response.error().message() };
+        }
+        const auto & receipt = response.receipt_data().receipt();
+        return {
+            .t = receipt.t(),
+            .s = receipt.s(),
+            .fn = std::to_string(receipt.fn()),
+            .i = std::to_string(receipt.i()),
+            .fp = std::to_string(receipt.fp()),
+            .n = receipt.n(),
+        };
+    }
+
+} // unnamed namespace
+
+ReceiptScannerClient::ReceiptScannerClient(const std::shared_ptr< Channel > & channel, std::chrono::milliseconds deadline)
+  : stub_(FinanceService::NewStub(channel))
+  , deadline_(deadline) {
+}
+
+ReceiptScannerClient::~ReceiptScannerClient() {
+    std::unique_lock lock(mutex_);
+    for (auto & call: calls_) {
+        call.context.TryCancel();
+    }
+    finished_.wait(lock, [this]() {
+        return calls_.empty();
+    });
 }
 
-ReceiptScannerClient::Response ReceiptScannerClient::ProcessQRCode(const std::string & user_id, const std::string & qr_code) {
-    QRCodeRequest request;
-    request.set_user_id(user_id);
-    request.set_qr_code_content(qr_code);
-    request.set_timestamp(
+void ReceiptScannerClient::ProcessQRCode(const std::string & token, const std::string & qr_code, Callback callback) {
+    std::list< Call >::iterator call;
+    {
+        std::lock_guard lock(mutex_);
+        call = calls_.emplace(calls_.end());
+    }
+    call->callback = std::move(callback);
+    call->context.set_deadline(std::chrono::system_clock::now() + deadline_);
+
+    call->request.mutable_auth()->set_token(token);
+    call->request.set_qr_code_content(qr_code);
+    call->request.mutable_scanned_at()->set_seconds(
      std::chrono::duration_cast< std::chrono::seconds >(
       std::chrono::system_clock::now().time_since_epoch())
       .count());
 
-    ReceiptResponse response;
-    ClientContext context;
-
-    // Вызываем удаленный метод
-    Status status = stub_->ProcessQRCode(&context, request, &response);
+    stub_->async()->ProcessQRCode(&call->context, &call->request, &call->response, [this, call](Status status) {
+        finish(call, status);
+    });
+}
 
-    // Проверяем статус ответа
-    if (!status.ok()) {
-        std::cerr << "RPC failed: " << status.error_message() << std::endl;
-        return Response{ .error = "something wrong" };
-    }
+void ReceiptScannerClient::finish(std::list< Call >::iterator call, const Status & status) {
+    call->callback(toResponse(status, call->response));
 
-    Response result;
-    // Обрабатываем результат
-    if (response.has_receipt()) {
-        result.fn = response.receipt().fn();
-        result.fp = response.receipt().fp();
-        result.i = response.receipt().i();
-        result.n = response.receipt().n();
-        result.s = response.receipt().s();
-        result.t = response.receipt().t();
-    } else {
-        result.error = response.error().message();
-    }
-    return result;
+    std::lock_guard lock(mutex_);
+    calls_.erase(call);
+    // The destructor may return as soon as the last call is erased, nothing is touched after it
+    finished_.notify_all();
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <vector>
 
 #include <platforms/common/client/interface/i_greeter_client.h>
 #include <grpcpp/grpcpp.h>
@@ -14,18 +17,51 @@ using grpc::Status;
 
 using wallet::FinanceService;
 using wallet::QRCodeRequest;
-using wallet::ReceiptResponse;
-using wallet::ReceiptData;
-using wallet::ReceiptItem;
-using wallet::ErrorInfo;
+using wallet::ReceiptDetailsResponse;
 
+/**
+ * @brief Scanner client on the gRPC callback API
+ *
+ * Calls never block the caller: every request is started on the shared channel and
+ * completes on a gRPC thread, so any number of them may be in flight at once. Each call
+ * gets its own deadline.
+ */
 class ReceiptScannerClient: public IReceiptScannerClient {
 public:
-    ReceiptScannerClient(const std::shared_ptr< Channel > & channel);
-    ~ReceiptScannerClient() override = default;
+    static constexpr std::chrono::milliseconds DEFAULT_DEADLINE{ 10'000 };
 
-    Response ProcessQRCode(const std::string& user_id, const std::string& qr_code) override;
+public:
+    /**
+     * @param channel Channel reused by every call
+     * @param deadline Time a call may take, it fails with an error after it
+     */
+    explicit ReceiptScannerClient(const std::shared_ptr< Channel > & channel, std::chrono::milliseconds deadline = DEFAULT_DEADLINE);
+
+    /**
+     * @brief Cancels the calls in flight and waits until their callbacks return
+     */
+    ~ReceiptScannerClient() override;
+
+    void ProcessQRCode(const std::string & token, const std::string & qr_code, Callback callback) override;
+
+private:
+    /**
+     * @brief State of one call, kept until it completes
+     */
+    struct Call {
+        ClientContext context;
+        QRCodeRequest request;
+        ReceiptDetailsResponse response;
+        Callback callback;
+    };
+
+    void finish(std::list< Call >::iterator call, const Status & status);
 
 private:
     std::unique_ptr< FinanceService::Stub > stub_;
+    const std::chrono::milliseconds deadline_;
+
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    std::list< Call > calls_; /**< Calls in flight */
 };
@@ -1,21 +1,38 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <string>
 
 class IReceiptScannerClient {
 public:
     struct Response {
         std::string t;
-        double s;
+        double s = 0;
         std::string fn;
         std::string i;
         std::string fp;
-        int32_t n;
+        int32_t n = 0;
         std::string error{""};
     };
 
+    /**
+     * @brief Receives the outcome of a request, called exactly once
+     */
+    using Callback = std::function< void(Response) >;
+
 public:
     virtual ~IReceiptScannerClient() = default;
 
-    virtual Response ProcessQRCode(const std::string & user_id, const std::string & qr_code) = 0;
+    /**
+     * @brief Sends a QR code without waiting for the answer
+     *
+     * Several requests may be in flight at once. The callback runs on a thread of the client,
+     * not on the caller's one; errors and timeouts are reported through Response::error.
+     *
+     * @param token Token of the user
+     * @param qr_code Content of the QR code
+     * @param callback Receives the outcome
+     */
+    virtual void ProcessQRCode(const std::string & token, const std::string & qr_code, Callback callback) = 0;
 };
@@ -0,0 +1,128 @@
+#include "qr_detector.h"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+using namespace cxx;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    QrDetector::Duration since(Clock::time_point start) {
+        return std::chrono::duration_cast< QrDetector::Duration >(Clock::now() - start);
+    }
+
+} // unnamed namespace
+
+QrDetector::QrDetector(int cropSize)
+  : cropSize_(cropSize)
+  , mailbox_(cropSize * cropSize)
+  , input_(cropSize * cropSize)
+  , work_(cropSize * cropSize)
+  , worker_([this]() {
+      run();
+  }) {
+}
+
+QrDetector::~QrDetector() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    wakeUp_.notify_one();
+    worker_.join();
+}
+
+GrayImage QrDetector::input() noexcept {
+    return { input_.data(), cropSize_, cropSize_, static_cast< std::size_t >(cropSize_) };
+}
+
+void QrDetector::submit() {
+    {
+        std::lock_guard lock(mutex_);
+        if (pending_) {
+            ++droppedFrames_;
+        }
+        input_.swap(mailbox_);
+        pending_ = true;
+    }
+    wakeUp_.notify_one();
+}
+
+bool QrDetector::poll(Result & result) {
+    if (!results_.update()) {
+        return false;
+    }
+    // generation_ only changes on this thread, reading it needs no lock
+    const auto & latest = results_.front();
+    if (latest.generation != generation_) {
+        return false;
+    }
+    result = latest;
+    return true;
+}
+
+void QrDetector::reset() {
+    std::lock_guard lock(mutex_);
+    ++generation_;
+    pending_ = false;
+}
+
+int QrDetector::cropSize() const noexcept {
+    return cropSize_;
+}
+
+void QrDetector::run() {
+    uint64_t processedFrames = 0;
+    while (true) {
+        uint64_t droppedFrames = 0;
+        uint64_t generation = 0;
+        {
+            std::unique_lock lock(mutex_);
+            wakeUp_.wait(lock, [this]() {
+                return stopped_ || pending_;
+            });
+            if (stopped_) {
+                return;
+            }
+            mailbox_.swap(work_);
+            pending_ = false;
+            droppedFrames = droppedFrames_;
+            generation = generation_;
+        }
+
+        auto & result = results_.back();
+        try {
+            process(result);
+        } catch (const cv::Exception & e) {
+            SPDLOG_ERROR("QrDetector: {}", e.what());
+            result = {};
+        }
+        result.processedFrames = ++processedFrames;
+        result.droppedFrames = droppedFrames;
+        result.generation = generation;
+        results_.publish();
+    }
+}
+
+void QrDetector::process(Result & result) {
+    result.detected = false;
+    result.corners.clear();
+    result.content.clear();
+    result.timings = {};
+
+    const cv::Mat grayMat(cropSize_, cropSize_, CV_8UC1, work_.data());
+
+    auto start = Clock::now();
+    result.detected = detector_.detect(grayMat, result.corners);
+    result.timings.detect = since(start);
+    if (!result.detected) {
+        return;
+    }
+
+    start = Clock::now();
+    result.content = detector_.decode(grayMat, result.corners);
+    result.timings.decode = since(start);
+}
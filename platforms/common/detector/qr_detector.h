@@ -0,0 +1,145 @@
+#pragma once
+
+#include <platforms/common/camera/image_kernels.h>
+#include <utils/concurrency/triple_buffer/triple_buffer.h>
+
+#include <opencv4/opencv2/core.hpp>
+#include <opencv4/opencv2/objdetect.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Detects and decodes QR codes in gray images on a dedicated thread
+     *
+     * The worker owns the detector and processes one image at a time. Images submitted while
+     * it is busy replace each other in a single-slot mailbox, so the worker always takes the
+     * latest one and never falls behind the camera. Results are published through a triple
+     * buffer, reading them never blocks the render thread.
+     *
+     * The caller writes the square searched for a code straight into the input buffer, usually
+     * while converting the camera frame for display. Input, mailbox and worker buffers are
+     * swapped on submit, no image is copied or allocated.
+     *
+     * Images and results are tagged with the number of resets, so after reset() neither an
+     * image still queued nor a result of an earlier image is returned by poll().
+     */
+    class QrDetector final {
+    public:
+        using Duration = std::chrono::microseconds;
+
+        /**
+         * @brief Time spent in each stage of the last processed frame
+         */
+        struct Timings {
+            Duration detect{}; /**< Search for the code corners */
+            Duration decode{}; /**< Decoding, zero if nothing was detected */
+        };
+
+        /**
+         * @brief Outcome of the last processed frame
+         */
+        struct Result {
+            bool detected = false;
+            std::vector< cv::Point2f > corners; /**< Corners in coordinates of the searched square */
+            std::string content;                /**< Decoded text, empty if not decoded */
+            Timings timings;
+            uint64_t processedFrames = 0; /**< Images processed since the start */
+            uint64_t droppedFrames = 0;   /**< Images replaced in the mailbox before processing */
+            uint64_t generation = 0;      /**< Resets before the image was submitted */
+        };
+
+    public:
+        /**
+         * @brief Starts the worker
+         *
+         * @param cropSize Side of the searched square
+         */
+        explicit QrDetector(int cropSize);
+
+        /**
+         * @brief Stops the worker, the image in progress is finished first
+         */
+        ~QrDetector();
+
+        QrDetector(const QrDetector &) = delete;
+        QrDetector & operator=(const QrDetector &) = delete;
+
+        /**
+         * @brief Buffer of cropSize x cropSize pixels the next image is written to
+         *
+         * Must be used from the thread that submits. The buffer changes after every submit.
+         */
+        GrayImage input() noexcept;
+
+        /**
+         * @brief Queues the image written to the input, replacing the one not taken by the worker yet
+         */
+        void submit();
+
+        /**
+         * @brief Takes the latest result if there is a new one
+         *
+         * Must be called from the thread that submits.
+         * @param result Receives the result
+         * @return True if an image submitted after the last reset was processed since the previous call
+         */
+        bool poll(Result & result);
+
+        /**
+         * @brief Discards the queued image and every result not polled yet
+         *
+         * Must be called from the thread that submits. The image in progress is finished,
+         * but its result is never returned.
+         */
+        void reset();
+
+        /**
+         * @brief Side of the searched square
+         */
+        int cropSize() const noexcept;
+
+    private:
+        void run();
+
+        /**
+         * @brief Runs every stage on the worker image
+         */
+        void process(Result & result);
+
+    private:
+        const int cropSize_;
+
+        std::mutex mutex_;
+        std::condition_variable wakeUp_;
+        std::vector< uint8_t > mailbox_;
+        bool pending_ = false; /**< The mailbox holds an image */
+        uint64_t droppedFrames_ = 0;
+        uint64_t generation_ = 0; /**< Written by the submitting thread under the mutex */
+        bool stopped_ = false;
+
+        TripleBuffer< Result > results_;
+
+        /**
+         * @brief Used by the submitting thread only
+         */
+        std::vector< uint8_t > input_;
+
+        /**
+         * @brief Used by the worker only
+         */
+        std::vector< uint8_t > work_;
+        cv::QRCodeDetectorAruco detector_;
+
+        // Started last, when everything it uses is constructed
+        std::thread worker_;
+    };
+
+} // namespace cxx
@@ -1,4 +1,5 @@
 #include "main_loop.h"
+#include "platforms/common/camera/image_kernels.h"
 #include "platforms/common/client/interface/i_greeter_client.h"
 
 // include for android build
@@ -17,23 +18,56 @@
 #include <opencv4/opencv2/objdetect.hpp>
 #include <opencv4/opencv2/opencv.hpp>
 
+#include <chrono>
+
 using namespace cxx;
 
-static std::mutex mutex;
-static std::atomic_bool busy = false;
-static bool lastBool = false;
-static cv::Mat lastCorners;
-static std::string lastResult = "";
 constexpr int cropSize = 256;
 
 MainLoop::MainLoop(
  std::shared_ptr< ICamera > camera,
- std::shared_ptr< IReceiptScannerClient > client)
+ std::shared_ptr< IReceiptScannerClient > client,
+ std::string token)
   : camera_(std::move(camera))
-  , client_(std::move(client)) {
+  , client_(std::move(client))
+  , token_(std::move(token))
+  , detector_(cropSize) {
+}
+
+void MainLoop::requestReceipt(const std::string & qrCode) {
+    const auto request = ++lastRequest_;
+    if (token_.empty()) {
+        // The server rejects requests without a token, there is no point in sending them
+        waitingResponse_ = false;
+        getResponse_ = true;
+        lastResponse_ = {};
+        lastResponse_.error = "No user token is configured";
+        return;
+    }
+    waitingResponse_ = true;
+    getResponse_ = false;
+    client_->ProcessQRCode(
+     token_,
+     qrCode,
+     [this, request, weakTasks = std::weak_ptr< TaskQueue >(uiTasks_)](IReceiptScannerClient::Response response) {
+         // Called on a thread of the client, the state of the loop is changed on the render thread
+         if (auto tasks = weakTasks.lock()) {
+             tasks->post([this, request, response = std::move(response)]() mutable {
+                 if (request != lastRequest_) {
+                     return;
+                 }
+                 lastResponse_ = std::move(response);
+                 waitingResponse_ = false;
+                 getResponse_ = true;
+             });
+         }
+     });
 }
 
 void MainLoop::draw(const std::shared_ptr< Context > & context) {
+    // Network answers are applied here, rendering never waits for them
+    uiTasks_->runPending();
+
     static GLuint textureId = 0;
     static GLuint textureId2 = 0;
     if (!textureId) {
@@ -64,9 +98,7 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
     ImGui::PopStyleColor();
 
     ImGui::Text("Hello from another window!");
-    static bool getResponse = false;
     static bool showCamera = true;
-    static IReceiptScannerClient::Response lastResponse;
     if (auto lastFrame = camera_->lastFrame(); showCamera && lastFrame && textureId) {
         static bool rotateImg = true;
         ImGui::Checkbox("Rotate", &rotateImg);
@@ -74,69 +106,50 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         if (rotateImg && !lastFrame->isVertical()) {
-            lastFrame->rotate();
+            // The preview shows the center two thirds of the camera image
+            lastFrame->rotate(lastFrame->width * 2 / 3, lastFrame->height * 2 / 3);
         }
-        if (!busy) {
-            busy = true;
-            auto t = std::thread([frame = lastFrame]() mutable {
-                cv::UMat bgMat;
-                {
-                    cv::Mat rgbMat(frame->height, frame->width, CV_MAKETYPE(CV_8U, frame->channels), frame->data.get());
-                    const int offsetW = (rgbMat.cols - cropSize) / 2;
-                    const int offsetH = (rgbMat.rows - cropSize) / 2;
-                    const cv::Rect roi(offsetW, offsetH, cropSize, cropSize);
-                    cv::cvtColor(rgbMat(roi), bgMat, cv::COLOR_RGBA2GRAY);
-                    frame.reset();
-                }
-                static auto qrDet = cv::QRCodeDetectorAruco();
-
-                cv::Mat corners;
-                bool detectResult = qrDet.detect(bgMat, corners);
-                {
-                    std::lock_guard< std::mutex > lock(mutex);
-                    lastBool = detectResult;
-                    lastCorners = corners;
-                }
-
-                if (detectResult) {
-                    cv::Mat points, rectImage;
-                    std::string decodeResult = qrDet.detectAndDecode(bgMat, points, rectImage);
-                    {
-                        std::lock_guard< std::mutex > lock(mutex);
-                        lastResult = std::move(decodeResult);
-                    }
-                }
-
-                busy = false;
-            });
-            t.detach();
+        detector_.poll(detection_);
+
+        ImGui::Text("detectionResult = %i", detection_.detected);
+        ImGui::Text("Result = \'%s\'", detection_.content.c_str());
+        ImGui::Text(
+         "Gray %.2f ms, detect %.1f ms, decode %.1f ms, frames %llu, dropped %llu",
+         grayTime_.count() / 1000.0,
+         detection_.timings.detect.count() / 1000.0,
+         detection_.timings.decode.count() / 1000.0,
+         static_cast< unsigned long long >(detection_.processedFrames),
+         static_cast< unsigned long long >(detection_.droppedFrames));
+        if (!detection_.content.empty()) {
+            requestReceipt(detection_.content);
+            showCamera = false;
         }
 
-        {
-            std::lock_guard< std::mutex > lock(mutex);
-            ImGui::Text("detectionResult = %i", lastBool);
-            ImGui::Text("Result = \'%s\'", lastResult.c_str());
-            if (!lastResult.empty()) {
-                lastResponse = client_->ProcessQRCode("testuser", lastResult);
-                showCamera = false;
-                getResponse = true;
-            }
-        }
-
-        const int cropSize = 256;
-        static std::weak_ptr< cxx::Frame > lastWeak;
+        // Frames are reused by the camera sink, a new frame is a different object than the last one
+        static const cxx::Frame * lastShown = nullptr;
 
         static int offsetW;
         static int offsetH;
 
-        if (lastWeak.expired()) {
-            lastWeak = lastFrame;
-            cv::Mat bgMat;
+        // The sink returns the same frame until a new one arrives, every frame is searched once
+        if (lastShown != lastFrame.get() && lastFrame->width >= cropSize && lastFrame->height >= cropSize) {
+            lastShown = lastFrame.get();
             cv::Mat rgbMat(lastFrame->height, lastFrame->width, CV_MAKETYPE(CV_8U, lastFrame->channels), lastFrame->data.get());
             offsetW = (rgbMat.cols - cropSize) / 2;
             offsetH = (rgbMat.rows - cropSize) / 2;
-            const cv::Rect roi(offsetW, offsetH, cropSize, cropSize);
-            cv::cvtColor(rgbMat, bgMat, cv::COLOR_RGBA2GRAY);
+
+            // The display texture and the detector input come from one pass over the frame
+            preview_.resize(lastFrame->width * lastFrame->height);
+            cv::Mat bgMat(lastFrame->height, lastFrame->width, CV_8UC1, preview_.data());
+            const auto start = std::chrono::steady_clock::now();
+            rgbaToGray(
+             { rgbMat.data, rgbMat.cols, rgbMat.rows, lastFrame->channels, rgbMat.step },
+             { bgMat.data, bgMat.cols, bgMat.rows, bgMat.step },
+             offsetW,
+             offsetH,
+             detector_.input());
+            grayTime_ = std::chrono::duration_cast< QrDetector::Duration >(std::chrono::steady_clock::now() - start);
+            detector_.submit();
 
             // cv::Mat tmp = rgbMat(roi).clone();
             // rgbMat /= 0.7;
@@ -144,11 +157,11 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
 
             // rgbMat.copyTo(rgbMat);
 
-            if (std::lock_guard< std::mutex > lock(mutex); !lastCorners.empty()) {
+            if (detection_.corners.size() == 4) {
                 std::vector< cv::Point > qrPoints;
                 qrPoints.reserve(4);
-                for (int i = 0; i < 4; i++) {
-                    qrPoints.push_back(cv::Point(offsetW + lastCorners.at< float >(0, i * 2), offsetH + lastCorners.at< float >(0, i * 2 + 1)));
+                for (const auto & corner: detection_.corners) {
+                    qrPoints.push_back(cv::Point(offsetW + corner.x, offsetH + corner.y));
                 }
 
                 cv::polylines(bgMat, qrPoints, true, cv::Scalar(0, 0, 255), 3); // Красный цвет, толщина 3 пикселя
@@ -168,7 +181,10 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cropSize, cropSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgbMat(roi).clone().data);
+            // The square is uploaded straight from the frame, rows are lastFrame->width pixels apart
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, lastFrame->width);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, cropSize, cropSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgbMat.ptr(offsetH, offsetW));
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
         }
 
         ImGui::SetCursorPosX((ImGui::GetWindowSize().x - lastFrame->width * 1.5f) * 0.5f);
@@ -188,16 +204,19 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
          2.0f);
     }
 
-    if (getResponse) {
-        if (!lastResponse.error.empty()) {
-            ImGui::Text("Error: %s", lastResponse.error.c_str());
+    if (waitingResponse_) {
+        ImGui::Text("Waiting for the server...");
+    }
+    if (getResponse_) {
+        if (!lastResponse_.error.empty()) {
+            ImGui::Text("Error: %s", lastResponse_.error.c_str());
         } else {
-            ImGui::Text("t = %s", lastResponse.t.c_str());
-            ImGui::Text("s = %f", lastResponse.s);
-            ImGui::Text("fn = %s", lastResponse.fn.c_str());
-            ImGui::Text("i = %s", lastResponse.i.c_str());
-            ImGui::Text("fp = %s", lastResponse.fp.c_str());
-            ImGui::Text("n = %d", lastResponse.n);
+            ImGui::Text("t = %s", lastResponse_.t.c_str());
+            ImGui::Text("s = %f", lastResponse_.s);
+            ImGui::Text("fn = %s", lastResponse_.fn.c_str());
+            ImGui::Text("i = %s", lastResponse_.i.c_str());
+            ImGui::Text("fp = %s", lastResponse_.fp.c_str());
+            ImGui::Text("n = %d", lastResponse_.n);
         }
     }
 
@@ -210,8 +229,13 @@ void MainLoop::draw(const std::shared_ptr< Context > & context) {
         SPDLOG_INFO("mainLoopStep: %s", "Open Camera");
         camera_->openCamera();
         showCamera = true;
-        getResponse = false;
-        lastResult.clear();
+        // An answer to the previous code is not shown anymore
+        ++lastRequest_;
+        waitingResponse_ = false;
+        getResponse_ = false;
+        // Neither a code queued before nor its result may be sent again
+        detector_.reset();
+        detection_ = {};
     }
     // ImGui::PopItemWidth();
     ImGui::End();
@@ -2,8 +2,13 @@
 
 #include <platforms/common/camera/i_camera.h>
 #include <platforms/common/client/interface/i_greeter_client.h>
+#include <platforms/common/detector/qr_detector.h>
+#include <utils/concurrency/task_queue/task_queue.h>
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "context.h"
 
@@ -13,16 +18,47 @@ namespace cxx {
      */
     class MainLoop final {
     public:
-        explicit MainLoop(
+        /**
+         * @brief Constructor for MainLoop
+         * @param camera Camera the codes are searched in
+         * @param client Client the decoded codes are sent with
+         * @param token Token of the user the receipts are added for
+         */
+        MainLoop(
          std::shared_ptr< ICamera > camera,
-         std::shared_ptr< IReceiptScannerClient > client);
+         std::shared_ptr< IReceiptScannerClient > client,
+         std::string token);
         ~MainLoop() = default;
 
         void draw(const std::shared_ptr< Context > & context);
 
+    private:
+        /**
+         * @brief Sends the decoded code, the answer is shown once it arrives
+         */
+        void requestReceipt(const std::string & qrCode);
+
     private:
         const std::shared_ptr< ICamera > camera_;
         const std::shared_ptr< IReceiptScannerClient > client_;
+        const std::string token_;
+
+        QrDetector detector_;
+        QrDetector::Result detection_;
+
+        std::vector< uint8_t > preview_; /**< Gray frame shown in the preview */
+        QrDetector::Duration grayTime_{}; /**< Conversion of the last frame */
+
+        /**
+         * @brief Answers of the client, run at the start of draw()
+         *
+         * Shared with the callbacks of requests, which may complete after the loop is destroyed.
+         */
+        const std::shared_ptr< TaskQueue > uiTasks_ = std::make_shared< TaskQueue >();
+        uint64_t lastRequest_ = 0; /**< Only the answer to the latest request is shown */
+        bool waitingResponse_ = false;
+        bool getResponse_ = false;
+        IReceiptScannerClient::Response lastResponse_;
 
         // State settings
         bool fff_ = true;
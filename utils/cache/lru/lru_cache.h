@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace cxx {
+
+    /**
+     * @brief Bounded key-value cache with least-recently-used eviction
+     *
+     * Lookups and insertions promote the entry to the most recently used position.
+     * When the cache is full, inserting a new key evicts the least recently used entry.
+     * An optional callback is invoked for every entry that leaves the cache (eviction,
+     * erase or clear), which lets owners release resources bound to the value.
+     *
+     * The cache is not thread-safe, callers are expected to provide synchronization.
+     *
+     * @tparam Key Key type, must be hashable
+     * @tparam Value Value type
+     * @tparam Hash Hash function for keys
+     */
+    template < typename Key, typename Value, typename Hash = std::hash< Key > >
+    class LruCache final {
+    public:
+        /**
+         * @brief Callback invoked for every entry removed from the cache
+         */
+        using RemoveCallback = std::function< void(const Key &, Value &) >;
+
+    public:
+        /**
+         * @brief Constructs an empty cache
+         *
+         * @param capacity Maximum number of entries, must be greater than zero
+         * @param onRemove Callback invoked for removed entries
+         */
+        explicit LruCache(std::size_t capacity, RemoveCallback onRemove = {})
+          : capacity_(capacity == 0 ? 1 : capacity)
+          , onRemove_(std::move(onRemove)) {
+            index_.reserve(capacity_);
+        }
+
+        ~LruCache() {
+            clear();
+        }
+
+        LruCache(const LruCache &) = delete;
+        LruCache & operator=(const LruCache &) = delete;
+
+        /**
+         * @brief Finds an entry and marks it as most recently used
+         *
+         * @param key Key to look up
+         * @return Pointer to the cached value or nullptr if the key is absent.
+         *         The pointer stays valid until the entry is removed.
+         */
+        Value * find(const Key & key) {
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                return nullptr;
+            }
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return &it->second->second;
+        }
+
+        /**
+         * @brief Checks for an entry without changing its position
+         *
+         * @param key Key to look up
+         * @return True if the key is cached
+         */
+        bool contains(const Key & key) const {
+            return index_.contains(key);
+        }
+
+        /**
+         * @brief Inserts or replaces an entry and marks it as most recently used
+         *
+         * Replacing an existing value does not invoke the remove callback for it.
+         *
+         * @param key Key of the entry
+         * @param value Value to store
+         * @return Reference to the stored value
+         */
+        Value & insert(const Key & key, Value value) {
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                it->second->second = std::move(value);
+                entries_.splice(entries_.begin(), entries_, it->second);
+                return it->second->second;
+            }
+
+            if (entries_.size() >= capacity_) {
+                evictLast();
+            }
+
+            entries_.emplace_front(key, std::move(value));
+            index_.emplace(key, entries_.begin());
+            return entries_.front().second;
+        }
+
+        /**
+         * @brief Removes an entry
+         *
+         * @param key Key of the entry
+         * @return True if the entry was present
+         */
+        bool erase(const Key & key) {
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                return false;
+            }
+            auto entry = it->second;
+            index_.erase(it);
+            if (onRemove_) {
+                onRemove_(entry->first, entry->second);
+            }
+            entries_.erase(entry);
+            return true;
+        }
+
+        /**
+         * @brief Removes all entries
+         */
+        void clear() {
+            while (!entries_.empty()) {
+                evictLast();
+            }
+        }
+
+        /**
+         * @brief Number of cached entries
+         */
+        std::size_t size() const noexcept {
+            return entries_.size();
+        }
+
+        /**
+         * @brief Maximum number of entries
+         */
+        std::size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+    private:
+        void evictLast() {
+            auto & last = entries_.back();
+            index_.erase(last.first);
+            if (onRemove_) {
+                onRemove_(last.first, last.second);
+            }
+            entries_.pop_back();
+        }
+
+    private:
+        using Entries = std::list< std::pair< Key, Value > >;
+
+        const std::size_t capacity_;
+        RemoveCallback onRemove_;
+        Entries entries_;
+        std::unordered_map< Key, typename Entries::iterator, Hash > index_;
+    };
+
+} // namespace cxx
@@ -0,0 +1,71 @@
+#include <utils/cache/lru/lru_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace cxx;
+
+TEST(LruCacheTest, FindReturnsInsertedValue) {
+    LruCache< std::string, int > cache(2);
+    cache.insert("a", 1);
+
+    ASSERT_NE(cache.find("a"), nullptr);
+    EXPECT_EQ(*cache.find("a"), 1);
+    EXPECT_EQ(cache.find("b"), nullptr);
+}
+
+TEST(LruCacheTest, EvictsLeastRecentlyUsed) {
+    std::vector< std::string > removed;
+    LruCache< std::string, int > cache(2, [&removed](const std::string & key, int &) {
+        removed.push_back(key);
+    });
+
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    ASSERT_NE(cache.find("a"), nullptr); // "b" becomes the oldest
+    cache.insert("c", 3);
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+    EXPECT_EQ(removed, std::vector< std::string >{ "b" });
+}
+
+TEST(LruCacheTest, InsertReplacesExistingValue) {
+    int removedCount = 0;
+    LruCache< std::string, int > cache(2, [&removedCount](const std::string &, int &) {
+        ++removedCount;
+    });
+
+    cache.insert("a", 1);
+    cache.insert("a", 2);
+
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(*cache.find("a"), 2);
+    EXPECT_EQ(removedCount, 0);
+}
+
+TEST(LruCacheTest, EraseAndClearInvokeCallback) {
+    std::vector< std::string > removed;
+    {
+        LruCache< std::string, int > cache(4, [&removed](const std::string & key, int &) {
+            removed.push_back(key);
+        });
+        cache.insert("a", 1);
+        cache.insert("b", 2);
+        cache.insert("c", 3);
+
+        EXPECT_TRUE(cache.erase("b"));
+        EXPECT_FALSE(cache.erase("b"));
+
+        cache.clear();
+        EXPECT_EQ(cache.size(), 0);
+
+        cache.insert("d", 4);
+    }
+
+    EXPECT_EQ(removed, (std::vector< std::string >{ "b", "a", "c", "d" }));
+}
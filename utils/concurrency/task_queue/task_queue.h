@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Tasks posted from any thread and run on the thread that owns the queue
+     *
+     * Lets background threads hand results over to a loop that must not block, such as the
+     * render loop: post() only takes a short lock, runPending() takes everything posted so far
+     * at once and runs it outside of the lock, so tasks may post new ones.
+     */
+    class TaskQueue final {
+    public:
+        using Task = std::function< void() >;
+
+    public:
+        TaskQueue() = default;
+
+        TaskQueue(const TaskQueue &) = delete;
+        TaskQueue & operator=(const TaskQueue &) = delete;
+
+        /**
+         * @brief Queues a task, may be called from any thread
+         */
+        void post(Task task) {
+            std::lock_guard lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+
+        /**
+         * @brief Runs the tasks posted before the call in their order
+         *
+         * Must be called from a single thread. Tasks posted while running are left for the next call.
+         * @return Number of tasks run
+         */
+        std::size_t runPending() {
+            {
+                std::lock_guard lock(mutex_);
+                running_.swap(tasks_);
+            }
+            for (auto & task: running_) {
+                task();
+            }
+            const auto count = running_.size();
+            // Keeps the capacity, posting does not allocate once the queue has grown
+            running_.clear();
+            return count;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector< Task > tasks_;
+
+        /**
+         * @brief Used by runPending() only
+         */
+        std::vector< Task > running_;
+    };
+
+} // namespace cxx
@@ -0,0 +1,63 @@
+#include <utils/concurrency/task_queue/task_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace cxx;
+
+TEST(TaskQueueTest, RunsTasksInOrder) {
+    TaskQueue queue;
+    std::vector< int > order;
+    for (int i = 0; i < 3; ++i) {
+        queue.post([&order, i]() {
+            order.push_back(i);
+        });
+    }
+
+    EXPECT_EQ(queue.runPending(), 3);
+    EXPECT_EQ(order, std::vector< int >({ 0, 1, 2 }));
+    EXPECT_EQ(queue.runPending(), 0);
+}
+
+TEST(TaskQueueTest, TasksPostedWhileRunningWaitForNextCall) {
+    TaskQueue queue;
+    int runs = 0;
+    queue.post([&queue, &runs]() {
+        ++runs;
+        queue.post([&runs]() {
+            ++runs;
+        });
+    });
+
+    EXPECT_EQ(queue.runPending(), 1);
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(queue.runPending(), 1);
+    EXPECT_EQ(runs, 2);
+}
+
+TEST(TaskQueueTest, CollectsTasksOfManyThreads) {
+    TaskQueue queue;
+    constexpr int THREADS = 4;
+    constexpr int TASKS = 10'000;
+
+    std::vector< std::thread > producers;
+    for (int t = 0; t < THREADS; ++t) {
+        producers.emplace_back([&queue]() {
+            for (int i = 0; i < TASKS; ++i) {
+                queue.post([]() {});
+            }
+        });
+    }
+
+    std::size_t runs = 0;
+    while (runs < THREADS * TASKS) {
+        runs += queue.runPending();
+    }
+    for (auto & producer: producers) {
+        producer.join();
+    }
+    EXPECT_EQ(runs, THREADS * TASKS);
+    EXPECT_EQ(queue.runPending(), 0);
+}
@@ -0,0 +1,62 @@
+#include <utils/concurrency/triple_buffer/triple_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace cxx;
+
+TEST(TripleBufferTest, ConsumerGetsLatestValue) {
+    TripleBuffer< int > buffer(0);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front(), 0);
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    ASSERT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.front(), 2);
+}
+
+TEST(TripleBufferTest, BuffersAreNotShared) {
+    TripleBuffer< int > buffer(0);
+    for (int value = 1; value < 10; ++value) {
+        buffer.back() = value;
+        buffer.publish();
+        EXPECT_NE(&buffer.back(), &buffer.front());
+        ASSERT_TRUE(buffer.update());
+        EXPECT_EQ(buffer.front(), value);
+        EXPECT_NE(&buffer.back(), &buffer.front());
+    }
+}
+
+TEST(TripleBufferTest, ConcurrentReaderSeesCompleteValues) {
+    struct Pair {
+        long first = 0;
+        long second = 0;
+    };
+    TripleBuffer< Pair > buffer;
+    constexpr long LAST = 200'000;
+
+    std::thread producer([&buffer]() {
+        for (long value = 1; value <= LAST; ++value) {
+            buffer.back() = { value, -value };
+            buffer.publish();
+        }
+    });
+
+    long seen = 0;
+    while (seen < LAST) {
+        if (buffer.update()) {
+            const auto pair = buffer.front();
+            ASSERT_EQ(pair.first, -pair.second);
+            ASSERT_GT(pair.first, seen);
+            seen = pair.first;
+        }
+    }
+    producer.join();
+}
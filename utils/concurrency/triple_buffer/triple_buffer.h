@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace cxx {
+
+    /**
+     * @brief Wait-free exchange of the latest value between one producer and one consumer
+     *
+     * Three buffers rotate between the roles of back (written by the producer), front
+     * (read by the consumer) and a spare one holding the latest published value. Publishing
+     * swaps the back buffer with the spare one, taking an update swaps the spare buffer
+     * with the front one. Both are a single atomic exchange, so neither side ever waits
+     * for the other, and a buffer is never accessed by both sides at the same time.
+     *
+     * Values published while the consumer does not take them are overwritten, the consumer
+     * always gets the latest one. Buffers are reused as they are, the producer overwrites
+     * whatever the back buffer held three publications ago.
+     *
+     * Each of back()/publish() and front()/update() must be called from a single thread.
+     *
+     * @tparam T Buffer type
+     */
+    template < typename T >
+    class TripleBuffer final {
+    public:
+        TripleBuffer() = default;
+
+        /**
+         * @brief Constructs the three buffers as copies of the value
+         */
+        explicit TripleBuffer(const T & value)
+          : buffers_{ value, value, value } {
+        }
+
+        TripleBuffer(const TripleBuffer &) = delete;
+        TripleBuffer & operator=(const TripleBuffer &) = delete;
+
+        /**
+         * @brief Buffer owned by the producer, filled before publish()
+         */
+        T & back() noexcept {
+            return buffers_[back_];
+        }
+
+        /**
+         * @brief Makes the back buffer the latest value and takes the spare buffer as the next back one
+         */
+        void publish() noexcept {
+            // Releases the writes to the back buffer and acquires the reads the consumer did on the spare one
+            const auto previous = state_.exchange(static_cast< uint8_t >(back_ | FRESH), std::memory_order_acq_rel);
+            back_ = previous & INDEX;
+        }
+
+        /**
+         * @brief Takes the latest published value if it was not taken yet
+         *
+         * @return True if front() now holds a newer value
+         */
+        bool update() noexcept {
+            if ((state_.load(std::memory_order_relaxed) & FRESH) == 0) {
+                return false;
+            }
+            const auto previous = state_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & INDEX;
+            return true;
+        }
+
+        /**
+         * @brief Buffer owned by the consumer, holds the value taken by the last update()
+         */
+        T & front() noexcept {
+            return buffers_[front_];
+        }
+
+    private:
+        static constexpr uint8_t INDEX = 0x3;
+        static constexpr uint8_t FRESH = 0x4;
+
+        // Producer and consumer state on separate cache lines, they are written from different threads
+        static constexpr std::size_t CACHE_LINE = 64;
+
+    private:
+        std::array< T, 3 > buffers_{};
+
+        /**
+         * @brief Index of the spare buffer and the FRESH flag if it holds an unread value
+         */
+        alignas(CACHE_LINE) std::atomic< uint8_t > state_{ 1 };
+
+        alignas(CACHE_LINE) uint8_t back_ = 0;
+
+        alignas(CACHE_LINE) uint8_t front_ = 2;
+    };
+
+} // namespace cxx
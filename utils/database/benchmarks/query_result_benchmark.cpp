@@ -0,0 +1,136 @@
+#ifdef POSTGRES_TEST
+#include <utils/database/postgres/psql_database.h>
+#endif
+#include <utils/database/sqlite/sqlite_database.h>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cxx;
+
+namespace {
+
+    using DatabaseFactory = std::function< std::shared_ptr< IDatabase >() >;
+
+    constexpr const char * TABLE_NAME = "benchmark_rows";
+    constexpr int64_t TABLE_ROWS = 10'000;
+
+    std::shared_ptr< IDatabase > createSQLiteInMemory() {
+        auto db = std::make_shared< SQLiteDatabase >();
+        db->connectInMemory();
+        return db;
+    }
+
+#ifdef POSTGRES_TEST
+    std::shared_ptr< IDatabase > createPostgreSQL() {
+        auto db = std::make_shared< PsqlDatabase >();
+        db->connect("dbname=postgres");
+        return db;
+    }
+#endif
+
+    /**
+     * @brief Creates the database with a table of TABLE_ROWS rows of every column type
+     */
+    std::shared_ptr< IDatabase > makeSeededDatabase(benchmark::State & state, const DatabaseFactory & factory) {
+        auto db = factory();
+        if (!db->isReady()) {
+            state.SkipWithError("Database is not available");
+            return nullptr;
+        }
+
+        auto transaction = db->makeTransaction();
+        if (transaction->isTableExist(TABLE_NAME)) {
+            transaction->dropTable(TABLE_NAME);
+        }
+        transaction->createTable(TABLE_NAME,
+                                 { { "id", Col::EDataType::INTEGER, Col::EConstraint::PRIMARY_KEY },
+                                   { "name", Col::EDataType::TEXT, Col::EConstraint::NOT_NULL },
+                                   { "amount", Col::EDataType::INTEGER },
+                                   { "price", Col::EDataType::REAL },
+                                   { "active", Col::EDataType::BOOLEAN } });
+
+        std::vector< std::vector< SqlParam > > rows;
+        rows.reserve(TABLE_ROWS);
+        for (int64_t id = 1; id <= TABLE_ROWS; ++id) {
+            rows.push_back({ id, "Товар " + std::to_string(id), id * 100, static_cast< double >(id) / 4, id % 2 == 0 });
+        }
+        if (!transaction->insertBulk(TABLE_NAME, { "id", "name", "amount", "price", "active" }, rows)) {
+            state.SkipWithError("Failed to seed the table");
+            return nullptr;
+        }
+        transaction->commit();
+        return db;
+    }
+
+    /**
+     * @brief Reads every field the way the service handlers do
+     */
+    int64_t consume(const QueryResult & result) {
+        int64_t checksum = 0;
+        for (const auto & row: result) {
+            checksum += row[0].as< int32_t >();
+            checksum += static_cast< int64_t >(row[1].as< std::string >().size());
+            checksum += row[2].as< int64_t >();
+            checksum += static_cast< int64_t >(row[3].as< double >());
+            checksum += row[4].as< bool >() ? 1 : 0;
+        }
+        return checksum;
+    }
+
+    void BM_SelectRows(benchmark::State & state, const DatabaseFactory & factory) {
+        const auto db = makeSeededDatabase(state, factory);
+        if (db == nullptr) {
+            return;
+        }
+
+        const auto query = "SELECT id, name, amount, price, active FROM " + std::string(TABLE_NAME) + " ORDER BY id LIMIT " + std::to_string(state.range(0));
+        for (auto _: state) {
+            auto result = db->makeTransaction()->executeQuery(query);
+            if (!result.has_value()) {
+                state.SkipWithError("Query failed");
+                break;
+            }
+            benchmark::DoNotOptimize(consume(*result));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_ExecPrepared(benchmark::State & state, const DatabaseFactory & factory) {
+        const auto db = makeSeededDatabase(state, factory);
+        if (db == nullptr) {
+            return;
+        }
+
+        const auto sql = "SELECT id, name, amount, price, active FROM " + std::string(TABLE_NAME) + " WHERE id > $1 ORDER BY id LIMIT $2";
+        int64_t from = 0;
+        for (auto _: state) {
+            auto transaction = db->makeTransaction();
+            if (!transaction->prepare("benchmark_select_rows", sql)) {
+                state.SkipWithError("Prepare failed");
+                break;
+            }
+            auto result = transaction->execPrepared("benchmark_select_rows", from, state.range(0));
+            if (!result.has_value()) {
+                state.SkipWithError("Query failed");
+                break;
+            }
+            benchmark::DoNotOptimize(consume(*result));
+            from = (from + state.range(0)) % (TABLE_ROWS - state.range(0));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    BENCHMARK_CAPTURE(BM_SelectRows, SQLite, createSQLiteInMemory)->Arg(1)->Arg(100)->Arg(TABLE_ROWS);
+    BENCHMARK_CAPTURE(BM_ExecPrepared, SQLite, createSQLiteInMemory)->Arg(1)->Arg(100);
+
+#ifdef POSTGRES_TEST
+    BENCHMARK_CAPTURE(BM_SelectRows, PostgreSQL, createPostgreSQL)->Arg(1)->Arg(100)->Arg(TABLE_ROWS);
+    BENCHMARK_CAPTURE(BM_ExecPrepared, PostgreSQL, createPostgreSQL)->Arg(1)->Arg(100);
+#endif
+
+} // unnamed namespace
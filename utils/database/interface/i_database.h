@@ -6,6 +6,14 @@
 
 namespace cxx {
 
+    /**
+     * @brief SQL dialect of a database, for the statements that cannot be written portably
+     */
+    enum class ESqlDialect {
+        POSTGRES,
+        SQLITE
+    };
+
     /**
      * @class IDatabase
      * @brief Interface defining the common operations for database access.
@@ -44,6 +52,11 @@ namespace cxx {
          * @return Escaped string safe for SQL queries
          */
         virtual std::string escapeString(const std::string & str) = 0;
+
+        /**
+         * @brief SQL dialect understood by the database
+         */
+        virtual ESqlDialect dialect() const noexcept = 0;
     };
 
 } // namespace cxx
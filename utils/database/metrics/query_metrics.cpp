@@ -0,0 +1,205 @@
+#include "query_metrics.h"
+
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <unordered_map>
+
+using namespace cxx;
+
+namespace {
+
+    constexpr std::size_t MAX_SHAPE_LENGTH = 160;
+    const std::string OTHER_SHAPE = "other";
+
+    bool isIdentifierChar(char c) {
+        return std::isalnum(static_cast< unsigned char >(c)) || c == '_';
+    }
+
+    bool endsWith(const std::string & str, std::string_view suffix) {
+        return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    /**
+     * @brief Appends a placeholder, a placeholder following "?," is merged into it
+     */
+    void appendPlaceholder(std::string & out) {
+        if (endsWith(out, "?, ")) {
+            out.resize(out.size() - 2);
+        } else if (endsWith(out, "?,")) {
+            out.resize(out.size() - 1);
+        } else {
+            out += '?';
+        }
+    }
+
+    /**
+     * @brief Series of one query shape, resolved in the registry once
+     */
+    struct ShapeMetrics {
+        explicit ShapeMetrics(std::string shape)
+          : labels{ { "query", std::move(shape) } }
+          , duration(&MetricsRegistry::global().histogram("db_query_duration_seconds", "Database query latency by query shape", labels)) {
+        }
+
+        /**
+         * @brief Created on the first failure, so shapes that never fail have no error series
+         */
+        Counter & errorCounter() {
+            auto * counter = errors.load(std::memory_order_acquire);
+            if (!counter) {
+                // Concurrent callers get the same series from the registry
+                counter = &MetricsRegistry::global().counter("db_query_errors_total", "Failed database queries by query shape", labels);
+                errors.store(counter, std::memory_order_release);
+            }
+            return *counter;
+        }
+
+        const MetricsRegistry::Labels labels;
+        Histogram * const duration;
+        std::atomic< Counter * > errors{ nullptr };
+    };
+
+    /**
+     * @brief Shapes admitted to their own series
+     *
+     * Entries are never removed, so their addresses stay valid. Once MAX_SHAPES shapes are
+     * admitted the table never changes again and is read without the lock.
+     */
+    class ShapeTable final {
+    public:
+        ShapeMetrics & find(const std::string & shape) {
+            if (full_.load(std::memory_order_acquire)) {
+                const auto it = shapes_.find(shape);
+                return it != shapes_.end() ? it->second : other_;
+            }
+
+            std::lock_guard lock(mutex_);
+            if (const auto it = shapes_.find(shape); it != shapes_.end()) {
+                return it->second;
+            }
+            if (shapes_.size() == QueryTimer::MAX_SHAPES) {
+                return other_;
+            }
+            auto & metrics = shapes_.try_emplace(shape, shape).first->second;
+            if (shapes_.size() == QueryTimer::MAX_SHAPES) {
+                full_.store(true, std::memory_order_release);
+            }
+            return metrics;
+        }
+
+        /**
+         * @brief Whether the series are the shared ones of OTHER_SHAPE
+         */
+        bool isOther(const ShapeMetrics & metrics) const noexcept {
+            return &metrics == &other_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::unordered_map< std::string, ShapeMetrics > shapes_;
+        std::atomic< bool > full_ = false;
+        ShapeMetrics other_{ OTHER_SHAPE };
+    };
+
+    /**
+     * @brief Series of the shape, the hot path is a lookup in a per-thread cache
+     */
+    ShapeMetrics & shapeMetrics(const std::string & shape) {
+        static ShapeTable table;
+        // Bounded by MAX_SHAPES, shapes that fall into "other" are not cached
+        thread_local std::unordered_map< std::string, ShapeMetrics * > cache;
+
+        if (const auto it = cache.find(shape); it != cache.end()) {
+            return *it->second;
+        }
+        auto & metrics = table.find(shape);
+        if (!table.isOther(metrics)) {
+            cache.emplace(shape, &metrics);
+        }
+        return metrics;
+    }
+
+} // unnamed namespace
+
+std::string cxx::queryShape(std::string_view query) {
+    std::string out;
+    out.reserve(std::min(query.size(), MAX_SHAPE_LENGTH));
+
+    bool pendingSpace = false;
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const char c = query[i];
+        if (std::isspace(static_cast< unsigned char >(c))) {
+            pendingSpace = !out.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            out += ' ';
+            pendingSpace = false;
+        }
+
+        if (c == '\'') {
+            // String literal, '' inside is an escaped quote
+            for (++i; i < query.size(); ++i) {
+                if (query[i] == '\'') {
+                    if (i + 1 < query.size() && query[i + 1] == '\'') {
+                        ++i;
+                    } else {
+                        break;
+                    }
+                }
+            }
+            appendPlaceholder(out);
+        } else if (c == '$' && i + 1 < query.size() && std::isdigit(static_cast< unsigned char >(query[i + 1]))) {
+            while (i + 1 < query.size() && std::isdigit(static_cast< unsigned char >(query[i + 1]))) {
+                ++i;
+            }
+            appendPlaceholder(out);
+        } else if (std::isdigit(static_cast< unsigned char >(c)) && (out.empty() || !isIdentifierChar(out.back()))) {
+            while (i + 1 < query.size() && (std::isdigit(static_cast< unsigned char >(query[i + 1])) || query[i + 1] == '.')) {
+                ++i;
+            }
+            appendPlaceholder(out);
+        } else {
+            out += c;
+        }
+
+        if (out.size() > MAX_SHAPE_LENGTH * 4) {
+            break;
+        }
+    }
+
+    // Multi-row VALUES lists differ only in the number of tuples
+    for (const std::string_view repeated: { "(?), (?)", "(?),(?)" }) {
+        for (auto pos = out.find(repeated); pos != std::string::npos; pos = out.find(repeated, pos)) {
+            out.erase(pos + 3, repeated.size() - 3);
+        }
+    }
+
+    if (out.size() > MAX_SHAPE_LENGTH) {
+        out.resize(MAX_SHAPE_LENGTH);
+    }
+    return out;
+}
+
+QueryTimer::QueryTimer(std::string shape)
+  : shape_(std::move(shape))
+  , start_(std::chrono::steady_clock::now()) {
+}
+
+QueryTimer::~QueryTimer() {
+    finish(false);
+}
+
+void QueryTimer::finish(bool succeeded) {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    auto & metrics = shapeMetrics(shape_);
+    metrics.duration->record(std::chrono::steady_clock::now() - start_);
+    if (!succeeded) {
+        metrics.errorCounter().inc();
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <utils/metrics/registry/metrics_registry.h>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace cxx {
+
+    /**
+     * @brief Normalizes a SQL query to its shape for grouping metrics
+     *
+     * String and numeric literals and $N placeholders become '?', lists of them collapse
+     * to a single '?', repeated VALUES tuples collapse to one and whitespace is squeezed,
+     * so queries differing only in values share a shape. Long shapes are truncated.
+     *
+     * @param query SQL query text
+     * @return Shape of the query
+     */
+    std::string queryShape(std::string_view query);
+
+    /**
+     * @brief Measures one database query and records it in the global MetricsRegistry
+     *
+     * Records db_query_duration_seconds and db_query_errors_total labeled with the query
+     * shape. Only the first QueryTimer::MAX_SHAPES distinct shapes get their own series,
+     * the rest are recorded as "other" to bound the number of series.
+     */
+    class QueryTimer final {
+    public:
+        static constexpr std::size_t MAX_SHAPES = 128;
+
+    public:
+        /**
+         * @brief Starts the measurement
+         *
+         * @param shape Query shape from queryShape() or a prepared statement name
+         */
+        explicit QueryTimer(std::string shape);
+
+        QueryTimer(const QueryTimer &) = delete;
+        QueryTimer & operator=(const QueryTimer &) = delete;
+
+        /**
+         * @brief Records the elapsed time and the outcome, later calls are ignored
+         *
+         * @param succeeded Whether the query succeeded
+         */
+        void finish(bool succeeded);
+
+        /**
+         * @brief Records the query as failed if finish() was not called, e.g. on exception
+         */
+        ~QueryTimer();
+
+    private:
+        std::string shape_;
+        const std::chrono::steady_clock::time_point start_;
+        bool finished_ = false;
+    };
+
+} // namespace cxx
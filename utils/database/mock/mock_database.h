@@ -13,6 +13,7 @@ namespace cxx {
         MOCK_METHOD(std::shared_ptr< ITransaction >, makeTransaction, (), (override));
         MOCK_METHOD(bool, isReady, (), (const, noexcept, override));
         MOCK_METHOD(std::string, escapeString, (const std::string &), (override));
+        MOCK_METHOD(ESqlDialect, dialect, (), (const, noexcept, override));
     };
 
 } // namespace cxx
@@ -15,10 +15,15 @@ namespace cxx {
         MOCK_METHOD(bool, dropTable, (const std::string &), (override));
         MOCK_METHOD(std::optional< QueryResult >, select, (const std::string &, const std::vector< std::string > &), (override));
         MOCK_METHOD(bool, insert, (const std::string &, const std::vector< std::string > &, const std::vector< std::string > &), (override));
+        MOCK_METHOD(bool, insertBulk, (const std::string &, const std::vector< std::string > &, (const std::vector< std::vector< SqlParam > > &)), (override));
         MOCK_METHOD(bool, update, (const std::string &, (const std::vector< std::pair< std::string, std::string > > &), const std::string &), (override));
         MOCK_METHOD(bool, deleteFrom, (const std::string &, const std::string &), (override));
         MOCK_METHOD(bool, isTableExist, (const std::string &), (override));
         MOCK_METHOD(std::optional< QueryResult >, executeQuery, (const std::string &), (override));
+        MOCK_METHOD(std::optional< QueryResult >, executeQueryParams, (const std::string &, const std::vector< SqlParam > &), (override));
+        MOCK_METHOD(bool, streamQuery, (const std::string &, const std::vector< SqlParam > &, std::size_t, const ChunkHandler &), (override));
+        MOCK_METHOD(bool, prepare, (const std::string &, const std::string &), (override));
+        MOCK_METHOD(std::optional< QueryResult >, execPreparedParams, (const std::string &, const std::vector< SqlParam > &), (override));
         MOCK_METHOD(std::string, escapeString, (const std::string &), (override));
     };
 
@@ -0,0 +1,57 @@
+#include "psql_connection.h"
+
+#include <spdlog/spdlog.h>
+
+using namespace cxx;
+
+PsqlConnection::PsqlConnection(const std::string & connectionString, std::size_t statementCacheSize)
+  : conn_(connectionString)
+  , prepared_(statementCacheSize, [this](const std::string & name, bool &) {
+      if (closing_) {
+          return;
+      }
+      try {
+          conn_.unprepare(name);
+      } catch (const std::exception & e) {
+          SPDLOG_WARN("Failed to deallocate prepared statement {}: {}", name, e.what());
+      }
+  }) {
+}
+
+PsqlConnection::~PsqlConnection() {
+    // Server drops prepared statements together with the session
+    closing_ = true;
+}
+
+pqxx::connection & PsqlConnection::raw() noexcept {
+    return conn_;
+}
+
+bool PsqlConnection::isOpen() const noexcept {
+    return conn_.is_open();
+}
+
+void PsqlConnection::registerStatement(const std::string & name, const std::string & sql) {
+    auto it = statements_.find(name);
+    if (it == statements_.end()) {
+        statements_.emplace(name, sql);
+    } else if (it->second != sql) {
+        it->second = sql;
+        prepared_.erase(name);
+    }
+}
+
+bool PsqlConnection::ensurePrepared(const std::string & name) {
+    if (prepared_.find(name) != nullptr) {
+        return true;
+    }
+
+    auto it = statements_.find(name);
+    if (it == statements_.end()) {
+        return false;
+    }
+
+    conn_.prepare(name, it->second);
+    prepared_.insert(name, true);
+    return true;
+}
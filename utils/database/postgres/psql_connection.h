@@ -0,0 +1,86 @@
+#pragma once
+
+#include <utils/cache/lru/lru_cache.h>
+
+#include <pqxx/pqxx>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace cxx {
+
+    /**
+     * @brief PostgreSQL connection with its prepared statement cache
+     *
+     * Prepared statements live on the server side of a particular session, so the
+     * cache is bound to the connection. Statements registered with registerStatement()
+     * are prepared lazily; at most statementCacheSize of them stay prepared on the
+     * server at the same time, the least recently used ones are deallocated and
+     * transparently re-prepared on their next use.
+     */
+    class PsqlConnection final {
+    public:
+        /**
+         * @brief Opens a new connection
+         *
+         * @param connectionString PostgreSQL connection string
+         * @param statementCacheSize Maximum number of statements prepared on the server
+         * @throws std::exception if the connection can not be opened
+         */
+        PsqlConnection(const std::string & connectionString, std::size_t statementCacheSize);
+
+        ~PsqlConnection();
+
+        PsqlConnection(const PsqlConnection &) = delete;
+        PsqlConnection & operator=(const PsqlConnection &) = delete;
+
+        /**
+         * @brief Underlying pqxx connection
+         */
+        pqxx::connection & raw() noexcept;
+
+        /**
+         * @brief Checks that the connection is open
+         */
+        bool isOpen() const noexcept;
+
+        /**
+         * @brief Remembers the SQL text of a named statement
+         *
+         * Registering the same name with a different SQL text replaces the statement.
+         *
+         * @param name Statement name
+         * @param sql SQL text of the statement
+         */
+        void registerStatement(const std::string & name, const std::string & sql);
+
+        /**
+         * @brief Makes sure a registered statement is prepared on the server
+         *
+         * @param name Statement name
+         * @return False if the statement was never registered
+         * @throws std::exception if the server rejects the statement
+         */
+        bool ensurePrepared(const std::string & name);
+
+    private:
+        pqxx::connection conn_;
+
+        /**
+         * @brief SQL text of every registered statement
+         */
+        std::unordered_map< std::string, std::string > statements_;
+
+        /**
+         * @brief Names of the statements currently prepared on the server
+         */
+        LruCache< std::string, bool > prepared_;
+
+        /**
+         * @brief Set on destruction, statements are not deallocated one by one then
+         */
+        bool closing_ = false;
+    };
+
+} // namespace cxx
@@ -0,0 +1,151 @@
+#include "psql_connection_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <stdexcept>
+
+using namespace cxx;
+
+std::shared_ptr< PsqlConnectionPool > PsqlConnectionPool::create(std::string connectionString, Settings settings) {
+    // Constructor is private, std::make_shared can not be used
+    return std::shared_ptr< PsqlConnectionPool >(new PsqlConnectionPool(std::move(connectionString), settings));
+}
+
+PsqlConnectionPool::PsqlConnectionPool(std::string connectionString, Settings settings)
+  : connectionString_(std::move(connectionString))
+  , settings_(settings) {
+    if (settings_.maxSize == 0 || settings_.minSize > settings_.maxSize) {
+        throw std::invalid_argument("Invalid connection pool size");
+    }
+    for (std::size_t i = 0; i < settings_.minSize; ++i) {
+        idle_.push_back({ open(), Clock::now() });
+        ++total_;
+    }
+}
+
+PsqlConnectionPool::~PsqlConnectionPool() {
+    close();
+}
+
+PsqlConnectionPool::Connection PsqlConnectionPool::acquire() {
+    const auto deadline = Clock::now() + settings_.acquireTimeout;
+
+    std::unique_lock lock(mutex_);
+    while (true) {
+        if (closed_) {
+            throw std::runtime_error("Connection pool is closed");
+        }
+
+        while (!idle_.empty()) {
+            // The most recently returned connection is the warmest one
+            IdleConnection idle = std::move(idle_.back());
+            idle_.pop_back();
+
+            lock.unlock();
+            const bool healthy = isHealthy(idle);
+            if (healthy) {
+                return makeLease(std::move(idle.conn));
+            }
+            SPDLOG_WARN("Dropping broken idle PostgreSQL connection");
+            idle.conn.reset();
+            lock.lock();
+            --total_;
+        }
+
+        if (total_ < settings_.maxSize) {
+            ++total_;
+            lock.unlock();
+            try {
+                return makeLease(open());
+            } catch (...) {
+                lock.lock();
+                --total_;
+                available_.notify_one();
+                throw;
+            }
+        }
+
+        ++waiting_;
+        const auto status = available_.wait_until(lock, deadline);
+        --waiting_;
+        if (status == std::cv_status::timeout && idle_.empty() && total_ >= settings_.maxSize) {
+            throw std::runtime_error("Timed out waiting for a free PostgreSQL connection");
+        }
+    }
+}
+
+void PsqlConnectionPool::close() {
+    std::deque< IdleConnection > idle;
+    {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        total_ -= idle_.size();
+        idle.swap(idle_);
+    }
+    available_.notify_all();
+    // Connections are closed outside the lock
+}
+
+std::size_t PsqlConnectionPool::size() const {
+    std::lock_guard lock(mutex_);
+    return total_;
+}
+
+std::size_t PsqlConnectionPool::idleCount() const {
+    std::lock_guard lock(mutex_);
+    return idle_.size();
+}
+
+std::size_t PsqlConnectionPool::waitingCount() const {
+    std::lock_guard lock(mutex_);
+    return waiting_;
+}
+
+const PsqlConnectionPool::Settings & PsqlConnectionPool::settings() const noexcept {
+    return settings_;
+}
+
+PsqlConnectionPool::Connection PsqlConnectionPool::makeLease(std::unique_ptr< PsqlConnection > conn) {
+    std::weak_ptr< PsqlConnectionPool > weakPool = weak_from_this();
+    return Connection(conn.release(), [weakPool](PsqlConnection * conn) {
+        if (auto pool = weakPool.lock()) {
+            pool->release(conn);
+        } else {
+            delete conn;
+        }
+    });
+}
+
+void PsqlConnectionPool::release(PsqlConnection * conn) {
+    std::unique_ptr< PsqlConnection > owned(conn);
+    {
+        std::lock_guard lock(mutex_);
+        if (!closed_ && owned->isOpen()) {
+            idle_.push_back({ std::move(owned), Clock::now() });
+        } else {
+            --total_;
+        }
+    }
+    available_.notify_one();
+}
+
+std::unique_ptr< PsqlConnection > PsqlConnectionPool::open() const {
+    return std::make_unique< PsqlConnection >(connectionString_, settings_.statementCacheSize);
+}
+
+bool PsqlConnectionPool::isHealthy(const IdleConnection & idle) const {
+    if (!idle.conn->isOpen()) {
+        return false;
+    }
+    if (Clock::now() - idle.since < settings_.healthCheckAfter) {
+        return true;
+    }
+    try {
+        pqxx::nontransaction check(idle.conn->raw());
+        check.exec("SELECT 1");
+        return true;
+    } catch (const std::exception & e) {
+        SPDLOG_WARN("PostgreSQL connection health check failed: {}", e.what());
+        return false;
+    }
+}
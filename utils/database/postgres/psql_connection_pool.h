@@ -0,0 +1,146 @@
+#pragma once
+
+#include <utils/database/postgres/psql_connection.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace cxx {
+
+    /**
+     * @brief Bounded pool of PostgreSQL connections
+     *
+     * The pool keeps between Settings::minSize and Settings::maxSize open connections.
+     * Connections are handed out as shared pointers whose deleter returns the connection
+     * back to the pool, so the lease lives exactly as long as the last owner
+     * (normally a PsqlTransaction). When every connection is busy, callers wait
+     * until a connection is returned or Settings::acquireTimeout expires.
+     *
+     * Connections that stayed idle longer than Settings::healthCheckAfter are validated
+     * with a trivial query before being handed out; broken connections are dropped and
+     * replaced transparently.
+     *
+     * The pool must be created through PsqlConnectionPool::create, because leases keep
+     * a weak reference to it: connections released after the pool is destroyed are closed.
+     */
+    class PsqlConnectionPool final: public std::enable_shared_from_this< PsqlConnectionPool > {
+    public:
+        /**
+         * @brief Pool sizing and health-check parameters
+         */
+        struct Settings {
+            std::size_t minSize = 1;                                 /**< Connections opened eagerly */
+            std::size_t maxSize = 8;                                 /**< Upper bound of open connections */
+            std::chrono::milliseconds acquireTimeout{ 5000 };        /**< Max wait for a free connection */
+            std::chrono::milliseconds healthCheckAfter{ 30'000 };    /**< Idle time before a connection is re-validated */
+            std::size_t statementCacheSize = 64;                     /**< Prepared statements kept per connection */
+        };
+
+        using Connection = std::shared_ptr< PsqlConnection >;
+
+    public:
+        /**
+         * @brief Creates a pool and eagerly opens Settings::minSize connections
+         *
+         * @param connectionString PostgreSQL connection string
+         * @param settings Pool sizing parameters
+         * @return Shared pointer to the created pool
+         * @throws std::exception if the initial connections cannot be opened
+         */
+        static std::shared_ptr< PsqlConnectionPool > create(std::string connectionString, Settings settings);
+
+        ~PsqlConnectionPool();
+
+        PsqlConnectionPool(const PsqlConnectionPool &) = delete;
+        PsqlConnectionPool & operator=(const PsqlConnectionPool &) = delete;
+
+        /**
+         * @brief Leases a connection from the pool
+         *
+         * Reuses an idle connection if there is one, opens a new connection while the pool
+         * is below its maximum size, otherwise waits for a connection to be returned.
+         *
+         * @return Leased connection, returned to the pool when the last copy is destroyed
+         * @throws std::runtime_error if no connection became available within Settings::acquireTimeout
+         * @throws std::exception if a new connection cannot be opened
+         */
+        Connection acquire();
+
+        /**
+         * @brief Closes idle connections and fails all pending and future acquisitions
+         *
+         * Leased connections are closed when they are returned.
+         */
+        void close();
+
+        /**
+         * @brief Number of open connections, both idle and leased
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Number of connections waiting in the pool
+         */
+        std::size_t idleCount() const;
+
+        /**
+         * @brief Number of callers currently waiting for a connection
+         */
+        std::size_t waitingCount() const;
+
+        /**
+         * @brief Pool parameters
+         */
+        const Settings & settings() const noexcept;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Idle connection together with the time it was returned
+         */
+        struct IdleConnection {
+            std::unique_ptr< PsqlConnection > conn;
+            Clock::time_point since;
+        };
+
+        PsqlConnectionPool(std::string connectionString, Settings settings);
+
+        /**
+         * @brief Wraps a raw connection into a lease that returns it to this pool
+         */
+        Connection makeLease(std::unique_ptr< PsqlConnection > conn);
+
+        /**
+         * @brief Returns a leased connection, called from the lease deleter
+         */
+        void release(PsqlConnection * conn);
+
+        /**
+         * @brief Opens a new connection
+         */
+        std::unique_ptr< PsqlConnection > open() const;
+
+        /**
+         * @brief Checks that an idle connection still works
+         */
+        bool isHealthy(const IdleConnection & idle) const;
+
+    private:
+        const std::string connectionString_;
+        const Settings settings_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+        std::deque< IdleConnection > idle_;
+        std::size_t total_ = 0;
+        std::size_t waiting_ = 0;
+        bool closed_ = false;
+    };
+
+} // namespace cxx
@@ -6,6 +6,7 @@
 #include <spdlog/spdlog.h>
 
 #include <sstream>
+#include <stdexcept>
 
 using namespace cxx;
 
@@ -35,14 +36,15 @@ PsqlDatabase::~PsqlDatabase() {
     disconnect();
 }
 
-bool PsqlDatabase::connect(const ConnectionInfo & connectionInfo) {
-    return connect(connectionInfo.toString());
+bool PsqlDatabase::connect(const ConnectionInfo & connectionInfo, const PoolSettings & poolSettings) {
+    return connect(connectionInfo.toString(), poolSettings);
 }
 
-bool PsqlDatabase::connect(const std::string & connectionString) {
+bool PsqlDatabase::connect(const std::string & connectionString, const PoolSettings & poolSettings) {
+    disconnect();
     try {
-        conn_ = std::make_unique< pqxx::connection >(connectionString);
-        return conn_->is_open();
+        pool_ = PsqlConnectionPool::create(connectionString, poolSettings);
+        return true;
     } catch (const std::exception & e) {
         SPDLOG_ERROR("Connection error: {}", e.what());
         return false;
@@ -50,20 +52,31 @@ bool PsqlDatabase::connect(const std::string & connectionString) {
 }
 
 void PsqlDatabase::disconnect() {
-    if (conn_) {
-        conn_->close();
+    if (pool_) {
+        pool_->close();
     }
-    conn_.reset();
+    pool_.reset();
 }
 
 std::shared_ptr< ITransaction > PsqlDatabase::makeTransaction() {
-    return std::make_shared< PsqlTransaction >(std::make_unique< pqxx::work >(*conn_));
+    if (!pool_) {
+        throw std::runtime_error("Database is not connected");
+    }
+    return std::make_shared< PsqlTransaction >(pool_->acquire());
 }
 
 bool PsqlDatabase::isReady() const noexcept {
-    return static_cast< bool >(conn_);
+    return static_cast< bool >(pool_);
+}
+
+std::shared_ptr< const PsqlConnectionPool > PsqlDatabase::pool() const noexcept {
+    return pool_;
 }
 
 std::string PsqlDatabase::escapeString(const std::string & str) {
     return PsqlTransaction::escapeStringStatic(str);
 }
+
+ESqlDialect PsqlDatabase::dialect() const noexcept {
+    return ESqlDialect::POSTGRES;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utils/database/interface/i_database.h>
+#include <utils/database/postgres/psql_connection_pool.h>
 #include <utils/database/transaction/interface/i_transaction.h>
 
 #include <pqxx/pqxx>
@@ -16,6 +17,10 @@ namespace cxx {
      *
      * This class provides PostgreSQL-specific database functionality, including
      * connection management and transaction creation.
+     *
+     * Connections are kept in a PsqlConnectionPool: every transaction leases its own
+     * connection for its lifetime, so transactions created from different threads
+     * run concurrently.
      */
     class PsqlDatabase final: public IDatabase {
     public:
@@ -39,6 +44,8 @@ namespace cxx {
             std::string toString() const;
         };
 
+        using PoolSettings = PsqlConnectionPool::Settings;
+
     public:
         PsqlDatabase();
         ~PsqlDatabase() override;
@@ -47,22 +54,25 @@ namespace cxx {
          * @brief Connects to a PostgreSQL database using connection information structure
          *
          * @param connectionInfo The connection parameters
+         * @param poolSettings Connection pool sizing parameters
          * @return True if connection was successful, false otherwise
          */
-        bool connect(const ConnectionInfo & connectionInfo);
+        bool connect(const ConnectionInfo & connectionInfo, const PoolSettings & poolSettings = {});
 
         /**
          * @brief Connects to a PostgreSQL database using a connection string
          *
          * @param connectionString PostgreSQL connection string
+         * @param poolSettings Connection pool sizing parameters
          * @return True if connection was successful, false otherwise
          */
-        bool connect(const std::string & connectionString);
+        bool connect(const std::string & connectionString, const PoolSettings & poolSettings = {});
 
         /**
-         * @brief Closes the current database connection
+         * @brief Closes the connection pool
          *
-         * Releases any resources associated with the current connection.
+         * Idle connections are closed immediately, leased ones when their
+         * transactions are finished.
          */
         void disconnect();
 
@@ -71,7 +81,10 @@ namespace cxx {
         /**
          * @brief Creates a new transaction object for this database
          *
+         * Leases a connection from the pool; blocks while all connections are busy.
+         *
          * @return Shared pointer to an ITransaction interface for transaction operations
+         * @throws std::runtime_error if no connection became available in time
          */
         std::shared_ptr< ITransaction > makeTransaction() override;
 
@@ -90,14 +103,25 @@ namespace cxx {
          */
         std::string escapeString(const std::string & str) override;
 
+        /**
+         * @brief PostgreSQL dialect
+         */
+        ESqlDialect dialect() const noexcept override;
+
+        /**
+         * @brief Connection pool, e.g. for exporting its size
+         *
+         * @return Pool or null if no connection is established
+         */
+        std::shared_ptr< const PsqlConnectionPool > pool() const noexcept;
+
     private:
         /**
-         * @brief PostgreSQL database connection handle
+         * @brief Pool of PostgreSQL connections
          *
-         * Unique pointer to the underlying pqxx connection object.
          * Null if no connection is established.
          */
-        std::unique_ptr< pqxx::connection > conn_;
+        std::shared_ptr< PsqlConnectionPool > pool_;
     };
 
 } // namespace cxx
@@ -1,11 +1,128 @@
 #include "psql_transaction.h"
 
+#include <utils/database/metrics/query_metrics.h>
+
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <charconv>
+
 using namespace cxx;
 
-PsqlTransaction::PsqlTransaction(std::unique_ptr< pqxx::work > txn)
-  : txn_{ std::move(txn) } {
+namespace {
+
+    /**
+     * @brief How the text representation of a column is decoded
+     */
+    enum class EColumnKind {
+        BOOLEAN,
+        INTEGER,
+        REAL,
+        TEXT
+    };
+
+    EColumnKind columnKind(pqxx::oid type) {
+        // Built-in type OIDs, see pg_type.dat
+        switch (type) {
+        case 16: // bool
+            return EColumnKind::BOOLEAN;
+        case 20: // int8
+        case 21: // int2
+        case 23: // int4
+        case 26: // oid
+            return EColumnKind::INTEGER;
+        case 700:  // float4
+        case 701:  // float8
+        case 1700: // numeric
+            return EColumnKind::REAL;
+        default:
+            return EColumnKind::TEXT;
+        }
+    }
+
+    QueryResult toQueryResult(const pqxx::result & result) {
+        const auto columns = static_cast< std::size_t >(result.columns());
+
+        std::vector< EColumnKind > kinds;
+        kinds.reserve(columns);
+        for (std::size_t column = 0; column < columns; ++column) {
+            kinds.push_back(columnKind(result.column_type(static_cast< pqxx::row::size_type >(column))));
+        }
+
+        QueryResult queryResult(columns);
+        queryResult.reserve(result.size());
+        for (const auto & row: result) {
+            for (std::size_t column = 0; column < columns; ++column) {
+                const auto field = row[static_cast< pqxx::row::size_type >(column)];
+                if (field.is_null()) {
+                    queryResult.addNull();
+                    continue;
+                }
+
+                const std::string_view text = field.view();
+                switch (kinds[column]) {
+                case EColumnKind::BOOLEAN:
+                    queryResult.addBool(!text.empty() && text.front() == 't');
+                    break;
+                case EColumnKind::INTEGER:
+                    queryResult.addIntFromText(text);
+                    break;
+                case EColumnKind::REAL:
+                    queryResult.addRealFromText(text);
+                    break;
+                case EColumnKind::TEXT:
+                    queryResult.addText(text);
+                    break;
+                }
+            }
+        }
+        return queryResult;
+    }
+
+    pqxx::params toPqxxParams(const std::vector< SqlParam > & params) {
+        pqxx::params result;
+        result.reserve(params.size());
+        for (const auto & param: params) {
+            std::visit(
+             [&result](const auto & value) {
+                 if constexpr (std::is_same_v< std::decay_t< decltype(value) >, std::monostate >) {
+                     result.append();
+                 } else {
+                     result.append(value);
+                 }
+             },
+             param);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Text representation of a value for COPY, std::nullopt is NULL
+     */
+    std::optional< std::string > toCopyValue(const SqlParam & param) {
+        return std::visit(
+         [](const auto & value) -> std::optional< std::string > {
+             using Type = std::decay_t< decltype(value) >;
+             if constexpr (std::is_same_v< Type, std::monostate >) {
+                 return std::nullopt;
+             } else if constexpr (std::is_same_v< Type, bool >) {
+                 return value ? "t" : "f";
+             } else if constexpr (std::is_same_v< Type, std::string >) {
+                 return value;
+             } else {
+                 std::array< char, 32 > buffer{};
+                 const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+                 return std::string(buffer.data(), end);
+             }
+         },
+         param);
+    }
+
+} // unnamed namespace
+
+PsqlTransaction::PsqlTransaction(PsqlConnectionPool::Connection conn)
+  : conn_{ std::move(conn) }
+  , txn_{ std::make_unique< pqxx::work >(conn_->raw()) } {
 }
 
 PsqlTransaction::~PsqlTransaction() {
@@ -34,26 +151,129 @@ void PsqlTransaction::commit() {
 
 std::optional< QueryResult > PsqlTransaction::executeQueryUnsafe(const std::string & query) {
     try {
-        pqxx::result result = txn_->exec(query);
+        return toQueryResult(txn_->exec(query));
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Query execution error: {}", e.what());
+        return std::nullopt;
+    }
+}
 
-        QueryResult queryResult;
-        for (const auto & row: result) {
-            std::vector< std::variant< int, double, std::string, bool > > rowData;
+std::optional< QueryResult > PsqlTransaction::executeQueryParams(const std::string & query, const std::vector< SqlParam > & params) {
+    if (!txn_) {
+        SPDLOG_ERROR("Failed to execute query. Transcation is closed");
+        return std::nullopt;
+    }
+    QueryTimer timer(queryShape(query));
+    try {
+        auto result = toQueryResult(txn_->exec_params(query, toPqxxParams(params)));
+        timer.finish(true);
+        return result;
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Query execution error: {}", e.what());
+        return std::nullopt;
+    }
+}
 
-            for (auto field = 0; field < row.size(); ++field) {
-                if (row[field].is_null()) {
-                    rowData.push_back(std::string("NULL"));
-                } else {
-                    rowData.push_back(std::string(row[field].c_str()));
-                }
+bool PsqlTransaction::streamQuery(const std::string & query, const std::vector< SqlParam > & params, std::size_t chunkRows, const ChunkHandler & onChunk) {
+    if (!txn_) {
+        SPDLOG_ERROR("Failed to stream query. Transcation is closed");
+        return false;
+    }
+    if (chunkRows == 0) {
+        return false;
+    }
+
+    QueryTimer timer(queryShape(query));
+    // Cursors live until the end of the transaction, a unique name keeps several streams apart
+    const std::string cursor = "stream_cursor_" + std::to_string(++cursors_);
+    try {
+        txn_->exec_params("DECLARE " + cursor + " NO SCROLL CURSOR FOR " + query, toPqxxParams(params));
+        const std::string fetch = "FETCH FORWARD " + std::to_string(chunkRows) + " FROM " + cursor;
+        while (true) {
+            const auto chunk = txn_->exec(fetch);
+            if (chunk.empty() || !onChunk(toQueryResult(chunk)) || chunk.size() < chunkRows) {
+                break;
             }
+        }
+        txn_->exec("CLOSE " + cursor);
+        timer.finish(true);
+        return true;
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Query streaming error: {}", e.what());
+        return false;
+    }
+}
+
+bool PsqlTransaction::insertBulk(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) {
+    if (rows.size() < COPY_MIN_ROWS) {
+        return BaseTransaction::insertBulk(tableName, colNames, rows);
+    }
+    if (!txn_ || colNames.empty()) {
+        return false;
+    }
 
-            queryResult.push_back(rowData);
+    for (const auto & row: rows) {
+        if (row.size() != colNames.size()) {
+            SPDLOG_ERROR("Bulk insert into {}: row has {} values, expected {}", tableName, row.size(), colNames.size());
+            return false;
         }
+    }
 
-        return queryResult;
+    QueryTimer timer("COPY " + tableName);
+    try {
+        std::string columns;
+        for (const auto & colName: colNames) {
+            if (!columns.empty()) {
+                columns += ", ";
+            }
+            columns += txn_->quote_name(colName);
+        }
+
+        auto stream = pqxx::stream_to::raw_table(*txn_, txn_->quote_name(tableName), columns);
+        std::vector< std::optional< std::string > > values;
+        values.reserve(colNames.size());
+        for (const auto & row: rows) {
+            values.clear();
+            for (const auto & param: row) {
+                values.push_back(toCopyValue(param));
+            }
+            stream.write_row(values);
+        }
+        stream.complete();
+        timer.finish(true);
+        return true;
     } catch (const std::exception & e) {
-        SPDLOG_ERROR("Query execution error: {}", e.what());
+        SPDLOG_ERROR("COPY into {} failed: {}", tableName, e.what());
+        return false;
+    }
+}
+
+bool PsqlTransaction::prepare(const std::string & name, const std::string & sql) {
+    try {
+        conn_->registerStatement(name, sql);
+        return conn_->ensurePrepared(name);
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Failed to prepare statement {}: {}", name, e.what());
+        return false;
+    }
+}
+
+std::optional< QueryResult > PsqlTransaction::execPreparedParams(const std::string & name, const std::vector< SqlParam > & params) {
+    if (!txn_) {
+        SPDLOG_ERROR("Failed to execute statement {}. Transcation is closed", name);
+        return std::nullopt;
+    }
+    QueryTimer timer(name);
+    try {
+        if (!conn_->ensurePrepared(name)) {
+            SPDLOG_ERROR("Unknown prepared statement: {}", name);
+            return std::nullopt;
+        }
+        auto result = toQueryResult(txn_->exec_prepared(name, toPqxxParams(params)));
+        timer.finish(true);
+        return result;
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Prepared statement {} execution error: {}", name, e.what());
         return std::nullopt;
     }
 }
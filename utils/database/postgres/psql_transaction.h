@@ -3,6 +3,7 @@
 #include <optional>
 #include <pqxx/pqxx>
 
+#include <utils/database/postgres/psql_connection_pool.h>
 #include <utils/database/transaction/base/base_transaction.h>
 
 namespace cxx {
@@ -18,9 +19,12 @@ namespace cxx {
         /**
          * @brief Constructor for PsqlTransaction
          *
-         * @param txn Unique pointer to a pqxx transaction object
+         * Opens a pqxx transaction on the leased connection. The lease is kept
+         * until the transaction object is destroyed.
+         *
+         * @param conn Connection leased from PsqlConnectionPool
          */
-        PsqlTransaction(std::unique_ptr< pqxx::work > txn);
+        PsqlTransaction(PsqlConnectionPool::Connection conn);
 
         ~PsqlTransaction() override;
 
@@ -40,6 +44,64 @@ namespace cxx {
          */
         void commit() override;
 
+        /**
+         * @brief Executes a one-off query via pqxx::transaction_base::exec_params
+         *
+         * @param query SQL text with $1, $2, ... placeholders
+         * @param params Parameter values in order
+         * @return Optional QueryResult containing the result or empty on failure
+         */
+        std::optional< QueryResult > executeQueryParams(const std::string & query, const std::vector< SqlParam > & params) override;
+
+        /**
+         * @brief Reads a query through a server-side cursor, FETCH returns one chunk at a time
+         *
+         * The cursor is declared with the bound parameters and closed when reading stops.
+         *
+         * @param query SQL text with $1, $2, ... placeholders
+         * @param params Parameter values in order
+         * @param chunkRows Rows fetched per round trip
+         * @param onChunk Called with every non-empty chunk in order
+         * @return False if the query failed
+         */
+        bool streamQuery(const std::string & query, const std::vector< SqlParam > & params, std::size_t chunkRows, const ChunkHandler & onChunk) override;
+
+        /**
+         * @brief Inserts many rows, large inputs are streamed with COPY ... FROM STDIN
+         *
+         * Inputs of at least COPY_MIN_ROWS rows go through pqxx::stream_to, smaller ones use
+         * the multi-row INSERT of BaseTransaction, which is cheaper to set up.
+         *
+         * @param tableName Table to insert into
+         * @param colNames Names of columns for insertion
+         * @param rows Values of every row, in the order of colNames
+         * @return True if all rows were inserted, false otherwise
+         */
+        bool insertBulk(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) override;
+
+        /**
+         * @brief Smallest number of rows written with COPY
+         */
+        static constexpr std::size_t COPY_MIN_ROWS = 64;
+
+        /**
+         * @brief Registers a prepared statement on the leased connection
+         *
+         * @param name Unique statement name
+         * @param sql SQL text with $1, $2, ... placeholders
+         * @return True if the statement is prepared, false otherwise
+         */
+        bool prepare(const std::string & name, const std::string & sql) override;
+
+        /**
+         * @brief Executes a prepared statement via pqxx::transaction_base::exec_prepared
+         *
+         * @param name Statement name
+         * @param params Parameter values in order
+         * @return Optional QueryResult containing the result or empty on failure
+         */
+        std::optional< QueryResult > execPreparedParams(const std::string & name, const std::vector< SqlParam > & params) override;
+
         static std::string escapeStringStatic(const std::string & str);
 
     private:
@@ -62,6 +124,14 @@ namespace cxx {
         std::string escapeString(const std::string & str) override;
 
     private:
+        /**
+         * @brief Leased connection the transaction runs on
+         *
+         * Declared before txn_ so that the transaction is finished before
+         * the connection goes back to the pool.
+         */
+        PsqlConnectionPool::Connection conn_;
+
         /**
          * @brief PostgreSQL transaction object
          *
@@ -69,6 +139,11 @@ namespace cxx {
          * that manages the actual database transaction.
          */
         std::unique_ptr< pqxx::work > txn_;
+
+        /**
+         * @brief Cursors declared by streamQuery(), gives every cursor a unique name
+         */
+        std::size_t cursors_ = 0;
     };
 
 } // namespace cxx
@@ -0,0 +1,169 @@
+#include "sqlite_connection.h"
+
+#include <spdlog/spdlog.h>
+
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    const char * synchronousName(SQLiteConnection::ESynchronous synchronous) {
+        switch (synchronous) {
+        case SQLiteConnection::ESynchronous::OFF:
+            return "OFF";
+        case SQLiteConnection::ESynchronous::NORMAL:
+            return "NORMAL";
+        case SQLiteConnection::ESynchronous::FULL:
+            return "FULL";
+        }
+        return "FULL";
+    }
+
+    sqlite3 * openHandle(const std::string & path) {
+        sqlite3 * conn = nullptr;
+        const int rc = sqlite3_open_v2(path.c_str(), &conn, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            if (conn == nullptr) {
+                throw std::runtime_error("SQLite error: Unable to allocate memory for database connection");
+            }
+            std::string error = sqlite3_errmsg(conn);
+            sqlite3_close(conn);
+            throw std::runtime_error("SQLite error: " + error);
+        }
+        return conn;
+    }
+
+    std::string savepointName(std::size_t level) {
+        return "level_" + std::to_string(level);
+    }
+
+} // unnamed namespace
+
+SQLiteConnection::SQLiteConnection(const std::string & path, const Settings & settings)
+  : conn_(openHandle(path))
+  , statements_(conn_, settings.statementCacheSize) {
+    if (!configure(settings)) {
+        sqlite3_close(conn_);
+        throw std::runtime_error("SQLite error: Failed to configure connection to " + path);
+    }
+}
+
+SQLiteConnection::~SQLiteConnection() {
+    // Cached statements must be finalized before the connection is closed
+    statements_.clear();
+    sqlite3_close(conn_);
+}
+
+sqlite3 * SQLiteConnection::raw() const noexcept {
+    return conn_;
+}
+
+SQLiteStatementCache & SQLiteConnection::statements() noexcept {
+    return statements_;
+}
+
+std::size_t SQLiteConnection::enter() noexcept {
+    return depth_++;
+}
+
+void SQLiteConnection::leave() noexcept {
+    --depth_;
+}
+
+bool SQLiteConnection::begin(std::size_t level, bool write) {
+    if (!begun_) {
+        if (!execute(write ? "BEGIN IMMEDIATE" : "BEGIN DEFERRED")) {
+            return false;
+        }
+        begun_ = true;
+        savepoints_ = 0;
+    }
+    // Enclosing transactions that ran nothing yet get their savepoints here as well
+    while (savepoints_ < level) {
+        if (!execute("SAVEPOINT " + savepointName(savepoints_ + 1))) {
+            return false;
+        }
+        ++savepoints_;
+    }
+    return true;
+}
+
+bool SQLiteConnection::commit(std::size_t level) {
+    if (level > 0) {
+        if (savepoints_ < level) {
+            return true;
+        }
+        savepoints_ = level - 1;
+        return execute("RELEASE " + savepointName(level));
+    }
+
+    if (!begun_) {
+        return true;
+    }
+    if (!execute("COMMIT")) {
+        rollback(0);
+        return false;
+    }
+    begun_ = false;
+    savepoints_ = 0;
+    return true;
+}
+
+void SQLiteConnection::rollback(std::size_t level) {
+    if (level > 0) {
+        if (savepoints_ < level) {
+            return;
+        }
+        savepoints_ = level - 1;
+        // ROLLBACK TO keeps the savepoint on the stack
+        execute("ROLLBACK TO " + savepointName(level));
+        execute("RELEASE " + savepointName(level));
+        return;
+    }
+
+    if (!begun_) {
+        return;
+    }
+    begun_ = false;
+    savepoints_ = 0;
+    // Fails harmlessly if SQLite already rolled back after an error
+    if (sqlite3_get_autocommit(conn_) == 0) {
+        execute("ROLLBACK");
+    }
+}
+
+bool SQLiteConnection::configure(const Settings & settings) {
+    sqlite3_busy_timeout(conn_, static_cast< int >(settings.busyTimeout.count()));
+
+    std::string pragmas;
+    if (settings.wal) {
+        pragmas += "PRAGMA journal_mode = WAL;";
+    }
+    pragmas += std::string("PRAGMA synchronous = ") + synchronousName(settings.synchronous) + ";";
+    pragmas += "PRAGMA mmap_size = " + std::to_string(settings.mmapSize) + ";";
+    pragmas += std::string("PRAGMA foreign_keys = ") + (settings.foreignKeys ? "ON" : "OFF") + ";";
+
+    char * error = nullptr;
+    if (sqlite3_exec(conn_, pragmas.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite error: {}", error != nullptr ? error : sqlite3_errmsg(conn_));
+        sqlite3_free(error);
+        return false;
+    }
+
+    if (settings.onOpen && !settings.onOpen(conn_)) {
+        SPDLOG_ERROR("SQLite error: Failed to prepare the connection: {}", sqlite3_errmsg(conn_));
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteConnection::execute(const std::string & sql) {
+    char * error = nullptr;
+    if (sqlite3_exec(conn_, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite error in {}: {}", sql, error != nullptr ? error : sqlite3_errmsg(conn_));
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <utils/database/sqlite/sqlite_statement_cache.h>
+
+#include <sqlite3.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace cxx {
+
+    /**
+     * @brief SQLite connection with its compiled statement cache and transaction state
+     *
+     * The connection is opened with SQLITE_OPEN_NOMUTEX: SQLite does not serialize calls on it,
+     * so it must be used by one thread at a time. SQLiteConnectionPool guarantees that by
+     * leasing a connection to a single thread.
+     *
+     * Transactions on the connection nest: the outermost one is a BEGIN ... COMMIT block,
+     * every nested one is a savepoint inside it. Nothing is sent to the database until the
+     * first statement of a transaction runs.
+     */
+    class SQLiteConnection final {
+    public:
+        /**
+         * @brief Durability of commits, see PRAGMA synchronous
+         */
+        enum class ESynchronous {
+            OFF,    /**< No fsync, an OS crash may corrupt the database */
+            NORMAL, /**< In WAL mode fsync only at checkpoints, a power loss may roll back the last commits */
+            FULL    /**< Fsync on every commit */
+        };
+
+        /**
+         * @brief Tuning applied to every opened connection
+         *
+         * The defaults suit a server: in WAL mode readers do not block the writer and a commit
+         * appends to the log instead of rewriting pages, so NORMAL synchronization is safe.
+         */
+        struct Settings {
+            bool wal = true;                                  /**< Write-ahead log, ignored for in-memory databases */
+            ESynchronous synchronous = ESynchronous::NORMAL;  /**< Durability of commits */
+            int64_t mmapSize = 256LL * 1024 * 1024;           /**< Bytes of the file read through a memory map, zero disables it */
+            bool foreignKeys = false;                         /**< Enforce REFERENCES constraints, SQLite ignores them by default */
+            std::chrono::milliseconds busyTimeout{ 5'000 };   /**< Wait for locks held by other connections and for a free connection */
+            std::size_t poolSize = 8;                         /**< Connections open at the same time, always one for in-memory databases */
+            std::size_t statementCacheSize = 64;              /**< Compiled statements kept per connection */
+            std::function< bool(sqlite3 * conn) > onOpen;     /**< Prepares a new connection, e.g. registers application functions */
+        };
+
+    public:
+        /**
+         * @brief Opens and configures a new connection
+         *
+         * @param path Database file, ":memory:" for a private in-memory database
+         * @param settings Connection tuning
+         * @throws std::runtime_error if the database cannot be opened or the settings cannot be applied
+         */
+        SQLiteConnection(const std::string & path, const Settings & settings);
+
+        ~SQLiteConnection();
+
+        SQLiteConnection(const SQLiteConnection &) = delete;
+        SQLiteConnection & operator=(const SQLiteConnection &) = delete;
+
+        /**
+         * @brief Underlying SQLite handle
+         */
+        sqlite3 * raw() const noexcept;
+
+        /**
+         * @brief Compiled statements of this connection
+         */
+        SQLiteStatementCache & statements() noexcept;
+
+        /**
+         * @brief Registers a new transaction on the connection
+         *
+         * @return Nesting level of the transaction, zero for the outermost one
+         */
+        std::size_t enter() noexcept;
+
+        /**
+         * @brief Unregisters the innermost transaction
+         */
+        void leave() noexcept;
+
+        /**
+         * @brief Opens the transaction of the given level and all enclosing ones if not open yet
+         *
+         * The outermost transaction starts with BEGIN IMMEDIATE if its first statement writes,
+         * so the write lock is taken up front and waits in the busy handler instead of failing
+         * on upgrade. A transaction that starts with a read uses BEGIN DEFERRED and may get
+         * SQLITE_BUSY if it writes later while another connection holds the write lock.
+         *
+         * @param level Nesting level returned by enter()
+         * @param write True if the first statement modifies the database
+         * @return True if the transaction is open
+         */
+        bool begin(std::size_t level, bool write);
+
+        /**
+         * @brief Commits the outermost transaction or releases the savepoint of a nested one
+         *
+         * @param level Nesting level returned by enter()
+         * @return False if the database rejected the commit; the transaction is rolled back then
+         */
+        bool commit(std::size_t level);
+
+        /**
+         * @brief Rolls back the outermost transaction or the savepoint of a nested one
+         *
+         * @param level Nesting level returned by enter()
+         */
+        void rollback(std::size_t level);
+
+    private:
+        /**
+         * @brief Applies the settings to the open connection
+         *
+         * @return True if all settings were applied
+         */
+        bool configure(const Settings & settings);
+
+        /**
+         * @brief Runs a transaction control statement
+         */
+        bool execute(const std::string & sql);
+
+    private:
+        sqlite3 * conn_ = nullptr;
+
+        SQLiteStatementCache statements_;
+
+        /**
+         * @brief Live transactions, the next one gets this nesting level
+         */
+        std::size_t depth_ = 0;
+
+        /**
+         * @brief BEGIN was issued and not yet committed or rolled back
+         */
+        bool begun_ = false;
+
+        /**
+         * @brief Savepoints of nested transactions currently open, savepoint N belongs to level N
+         */
+        std::size_t savepoints_ = 0;
+    };
+
+} // namespace cxx
@@ -0,0 +1,137 @@
+#include "sqlite_connection_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    bool isInMemory(const std::string & path) {
+        return path.empty() || path == ":memory:";
+    }
+
+} // unnamed namespace
+
+std::shared_ptr< SQLiteConnectionPool > SQLiteConnectionPool::create(std::string path, SQLiteConnection::Settings settings) {
+    // Constructor is private, std::make_shared can not be used
+    return std::shared_ptr< SQLiteConnectionPool >(new SQLiteConnectionPool(std::move(path), std::move(settings)));
+}
+
+SQLiteConnectionPool::SQLiteConnectionPool(std::string path, SQLiteConnection::Settings settings)
+  : path_(std::move(path))
+  , settings_(std::move(settings))
+  , maxSize_(isInMemory(path_) ? 1 : settings_.poolSize) {
+    if (maxSize_ == 0) {
+        throw std::invalid_argument("Invalid connection pool size");
+    }
+    // Fails early on a wrong path or settings, and keeps an in-memory database alive
+    idle_.push_back(open());
+    ++total_;
+}
+
+SQLiteConnectionPool::~SQLiteConnectionPool() {
+    close();
+}
+
+SQLiteConnectionPool::Connection SQLiteConnectionPool::acquire() {
+    const auto deadline = Clock::now() + settings_.busyTimeout;
+
+    std::unique_lock lock(mutex_);
+    if (auto it = leased_.find(std::this_thread::get_id()); it != leased_.end()) {
+        if (auto conn = it->second.weak.lock()) {
+            return conn;
+        }
+    }
+
+    while (true) {
+        if (closed_) {
+            throw std::runtime_error("Connection pool is closed");
+        }
+
+        if (!idle_.empty()) {
+            // The most recently returned connection is the warmest one
+            auto conn = std::move(idle_.back());
+            idle_.pop_back();
+            return makeLease(std::move(conn));
+        }
+
+        if (total_ < maxSize_) {
+            ++total_;
+            lock.unlock();
+            std::unique_ptr< SQLiteConnection > conn;
+            try {
+                conn = open();
+            } catch (...) {
+                lock.lock();
+                --total_;
+                available_.notify_one();
+                throw;
+            }
+            lock.lock();
+            return makeLease(std::move(conn));
+        }
+
+        if (available_.wait_until(lock, deadline) == std::cv_status::timeout && idle_.empty()) {
+            throw std::runtime_error("Timed out waiting for a free SQLite connection");
+        }
+    }
+}
+
+void SQLiteConnectionPool::close() {
+    std::vector< std::unique_ptr< SQLiteConnection > > idle;
+    {
+        std::lock_guard lock(mutex_);
+        closed_ = true;
+        total_ -= idle_.size();
+        idle.swap(idle_);
+    }
+    available_.notify_all();
+    // Connections are closed outside the lock
+}
+
+std::size_t SQLiteConnectionPool::size() const {
+    std::lock_guard lock(mutex_);
+    return total_;
+}
+
+std::size_t SQLiteConnectionPool::idleCount() const {
+    std::lock_guard lock(mutex_);
+    return idle_.size();
+}
+
+SQLiteConnectionPool::Connection SQLiteConnectionPool::makeLease(std::unique_ptr< SQLiteConnection > conn) {
+    const auto owner = std::this_thread::get_id();
+    std::weak_ptr< SQLiteConnectionPool > weakPool = weak_from_this();
+    Connection lease(conn.release(), [weakPool, owner](SQLiteConnection * conn) {
+        if (auto pool = weakPool.lock()) {
+            pool->release(conn, owner);
+        } else {
+            delete conn;
+        }
+    });
+    leased_[owner] = Lease{ lease.get(), lease };
+    return lease;
+}
+
+void SQLiteConnectionPool::release(SQLiteConnection * conn, std::thread::id owner) {
+    std::unique_ptr< SQLiteConnection > owned(conn);
+    {
+        std::lock_guard lock(mutex_);
+        // The thread may already hold a newer lease if the old one was released elsewhere
+        if (auto it = leased_.find(owner); it != leased_.end() && it->second.conn == conn) {
+            leased_.erase(it);
+        }
+        if (!closed_) {
+            idle_.push_back(std::move(owned));
+        } else {
+            --total_;
+        }
+    }
+    available_.notify_one();
+}
+
+std::unique_ptr< SQLiteConnection > SQLiteConnectionPool::open() const {
+    return std::make_unique< SQLiteConnection >(path_, settings_);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <utils/database/sqlite/sqlite_connection.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Bounded pool of SQLite connections leased per thread
+     *
+     * A connection opened with SQLITE_OPEN_NOMUTEX may be used by one thread at a time, so a
+     * lease belongs to the thread that acquired it: while it is alive, every acquire() from
+     * that thread returns the same connection. This is how transactions nest and how a
+     * transaction sees its own uncommitted changes. Other threads get other connections;
+     * when Settings::poolSize connections are leased, they wait up to Settings::busyTimeout.
+     *
+     * Every in-memory database is private to its connection, so the pool of ":memory:"
+     * holds a single connection shared by all threads in turn.
+     *
+     * The pool must be created through SQLiteConnectionPool::create, because leases keep
+     * a weak reference to it: connections released after the pool is destroyed are closed.
+     */
+    class SQLiteConnectionPool final: public std::enable_shared_from_this< SQLiteConnectionPool > {
+    public:
+        using Connection = std::shared_ptr< SQLiteConnection >;
+
+    public:
+        /**
+         * @brief Creates a pool and opens its first connection
+         *
+         * @param path Database file, ":memory:" for a private in-memory database
+         * @param settings Connection tuning and pool size
+         * @return Shared pointer to the created pool
+         * @throws std::exception if the first connection cannot be opened
+         */
+        static std::shared_ptr< SQLiteConnectionPool > create(std::string path, SQLiteConnection::Settings settings);
+
+        ~SQLiteConnectionPool();
+
+        SQLiteConnectionPool(const SQLiteConnectionPool &) = delete;
+        SQLiteConnectionPool & operator=(const SQLiteConnectionPool &) = delete;
+
+        /**
+         * @brief Leases the connection of the calling thread
+         *
+         * Returns the connection already leased by this thread, otherwise reuses an idle one,
+         * opens a new one while the pool is below its size or waits for one to be returned.
+         *
+         * @return Leased connection, returned to the pool when the last copy is destroyed
+         * @throws std::runtime_error if no connection became available within Settings::busyTimeout
+         * @throws std::exception if a new connection cannot be opened
+         */
+        Connection acquire();
+
+        /**
+         * @brief Closes idle connections and fails all pending and future acquisitions
+         *
+         * Leased connections are closed when they are returned.
+         */
+        void close();
+
+        /**
+         * @brief Number of open connections, both idle and leased
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Number of connections waiting in the pool
+         */
+        std::size_t idleCount() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Connection currently leased by a thread
+         */
+        struct Lease {
+            SQLiteConnection * conn;
+            std::weak_ptr< SQLiteConnection > weak;
+        };
+
+        SQLiteConnectionPool(std::string path, SQLiteConnection::Settings settings);
+
+        /**
+         * @brief Wraps a raw connection into a lease of the calling thread, called under the lock
+         */
+        Connection makeLease(std::unique_ptr< SQLiteConnection > conn);
+
+        /**
+         * @brief Returns a leased connection, called from the lease deleter
+         */
+        void release(SQLiteConnection * conn, std::thread::id owner);
+
+        /**
+         * @brief Opens a new connection
+         */
+        std::unique_ptr< SQLiteConnection > open() const;
+
+    private:
+        const std::string path_;
+        const SQLiteConnection::Settings settings_;
+        const std::size_t maxSize_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+        std::vector< std::unique_ptr< SQLiteConnection > > idle_;
+        std::unordered_map< std::thread::id, Lease > leased_;
+        std::size_t total_ = 0;
+        bool closed_ = false;
+    };
+
+} // namespace cxx
@@ -3,6 +3,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include <stdexcept>
+
 using namespace cxx;
 
 SQLiteDatabase::~SQLiteDatabase() {
@@ -13,41 +15,74 @@ bool SQLiteDatabase::connectInMemory() {
     return connect(":memory:");
 }
 
+bool SQLiteDatabase::connectInMemory(const Settings & settings) {
+    return connect(":memory:", settings);
+}
+
 bool SQLiteDatabase::connect(const std::string & connectionInfo) {
-    if (conn_) {
-        disconnect();
+    return connect(connectionInfo, Settings{});
+}
+
+bool SQLiteDatabase::connect(const std::string & connectionInfo, const Settings & settings) {
+    disconnect();
+
+    try {
+        pool_ = SQLiteConnectionPool::create(connectionInfo, settings);
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("Failed to connect to SQLite database {}: {}", connectionInfo, e.what());
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteDatabase::executeScript(const std::string & sql) {
+    if (!pool_) {
+        return false;
     }
 
-    int rc = sqlite3_open(connectionInfo.c_str(), &conn_);
-    if (rc != SQLITE_OK) {
-        if (conn_) {
-            SPDLOG_ERROR("SQLite error: {}", sqlite3_errmsg(conn_));
-            sqlite3_close(conn_);
-            conn_ = nullptr;
-        } else {
-            SPDLOG_ERROR("SQLite error: Unable to allocate memory for database connection");
-        }
+    SQLiteConnectionPool::Connection conn;
+    try {
+        conn = pool_->acquire();
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("SQLite script error: {}", e.what());
         return false;
     }
 
+    char * error = nullptr;
+    if (sqlite3_exec(conn->raw(), sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite script error: {}", error != nullptr ? error : sqlite3_errmsg(conn->raw()));
+        sqlite3_free(error);
+        return false;
+    }
     return true;
 }
 
 void SQLiteDatabase::disconnect() {
-    if (conn_) {
-        sqlite3_close(conn_);
-        conn_ = nullptr;
+    if (pool_) {
+        pool_->close();
+        pool_.reset();
     }
 }
 
 std::shared_ptr< ITransaction > SQLiteDatabase::makeTransaction() {
-    return std::make_shared< SQLiteTransaction >(conn_);
+    if (!pool_) {
+        throw std::runtime_error("Database is not connected");
+    }
+    return std::make_shared< SQLiteTransaction >(pool_->acquire());
 }
 
 bool SQLiteDatabase::isReady() const noexcept {
-    return static_cast< bool >(conn_);
+    return static_cast< bool >(pool_);
+}
+
+std::shared_ptr< const SQLiteConnectionPool > SQLiteDatabase::pool() const noexcept {
+    return pool_;
 }
 
 std::string SQLiteDatabase::escapeString(const std::string & str) {
     return SQLiteTransaction::escapeStringStatic(str);
 }
+
+ESqlDialect SQLiteDatabase::dialect() const noexcept {
+    return ESqlDialect::SQLITE;
+}
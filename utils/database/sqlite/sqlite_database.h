@@ -2,6 +2,10 @@
 
 #include <sqlite3.h>
 #include <utils/database/interface/i_database.h>
+#include <utils/database/sqlite/sqlite_connection_pool.h>
+
+#include <memory>
+#include <string>
 
 namespace cxx {
 
@@ -10,8 +14,16 @@ namespace cxx {
      *
      * This class provides SQLite-specific database functionality, including
      * connection management and transaction creation.
+     *
+     * Each thread works through its own connection from a SQLiteConnectionPool, and each
+     * transaction is a real BEGIN ... COMMIT block on it, so statements of one transaction
+     * share a single commit instead of syncing one by one.
      */
     class SQLiteDatabase final: public IDatabase {
+    public:
+        using ESynchronous = SQLiteConnection::ESynchronous;
+        using Settings = SQLiteConnection::Settings;
+
     public:
         SQLiteDatabase() = default;
         ~SQLiteDatabase() override;
@@ -27,17 +39,45 @@ namespace cxx {
         bool connectInMemory();
 
         /**
-         * @brief Connects to a SQLite database file
+         * @brief Creates an in-memory SQLite database with the given connection settings
+         *
+         * @param settings Connection tuning
+         * @return True if connection was successful, false otherwise
+         */
+        bool connectInMemory(const Settings & settings);
+
+        /**
+         * @brief Connects to a SQLite database file with the default settings
          *
          * @param connectionInfo Path to the SQLite database file
          * @return True if connection was successful, false otherwise
          */
         bool connect(const std::string & connectionInfo);
 
+        /**
+         * @brief Connects to a SQLite database file
+         *
+         * @param connectionInfo Path to the SQLite database file
+         * @param settings Connection tuning
+         * @return True if connection was successful and the settings were applied, false otherwise
+         */
+        bool connect(const std::string & connectionInfo, const Settings & settings);
+
+        /**
+         * @brief Executes several statements separated by semicolons, e.g. a schema migration
+         *
+         * The script runs on the connection of the calling thread, inside its open transaction if any.
+         *
+         * @param sql SQL script
+         * @return True if every statement succeeded, false otherwise
+         */
+        bool executeScript(const std::string & sql);
+
         /**
          * @brief Closes the current database connection
          *
          * Releases any resources associated with the current connection.
+         * Connections leased by live transactions are closed when those transactions end.
          */
         void disconnect();
 
@@ -65,14 +105,23 @@ namespace cxx {
          */
         std::string escapeString(const std::string & str) override;
 
+        /**
+         * @brief SQLite dialect
+         */
+        ESqlDialect dialect() const noexcept override;
+
+        /**
+         * @brief Connection pool, null if not connected
+         */
+        std::shared_ptr< const SQLiteConnectionPool > pool() const noexcept;
+
     private:
         /**
-         * @brief SQLite database connection handle
+         * @brief Per-thread connections to the database
          *
-         * Pointer to the underlying SQLite database connection.
          * Null if no connection is established.
          */
-        sqlite3 * conn_ = nullptr;
+        std::shared_ptr< SQLiteConnectionPool > pool_;
     };
 
 } // namespace cxx
@@ -0,0 +1,58 @@
+#include "sqlite_statement_cache.h"
+
+#include <spdlog/spdlog.h>
+
+using namespace cxx;
+
+SQLiteStatementCache::SQLiteStatementCache(sqlite3 * conn, std::size_t capacity)
+  : conn_(conn)
+  , compiled_(capacity, [](const std::string &, sqlite3_stmt *& stmt) {
+      sqlite3_finalize(stmt);
+  }) {
+}
+
+SQLiteStatementCache::~SQLiteStatementCache() {
+    clear();
+}
+
+bool SQLiteStatementCache::prepare(const std::string & name, const std::string & sql) {
+    auto it = statements_.find(name);
+    if (it == statements_.end()) {
+        statements_.emplace(name, sql);
+    } else if (it->second != sql) {
+        it->second = sql;
+        compiled_.erase(name);
+    } else if (compiled_.contains(name)) {
+        return true;
+    }
+    return compile(name, sql) != nullptr;
+}
+
+sqlite3_stmt * SQLiteStatementCache::acquire(const std::string & name) {
+    if (auto * stmt = compiled_.find(name)) {
+        sqlite3_reset(*stmt);
+        sqlite3_clear_bindings(*stmt);
+        return *stmt;
+    }
+
+    auto it = statements_.find(name);
+    if (it == statements_.end()) {
+        return nullptr;
+    }
+    return compile(name, it->second);
+}
+
+void SQLiteStatementCache::clear() {
+    compiled_.clear();
+}
+
+sqlite3_stmt * SQLiteStatementCache::compile(const std::string & name, const std::string & sql) {
+    sqlite3_stmt * stmt = nullptr;
+    if (sqlite3_prepare_v3(conn_, sql.c_str(), static_cast< int >(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite prepare error for statement {}: {}", name, sqlite3_errmsg(conn_));
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    compiled_.insert(name, stmt);
+    return stmt;
+}
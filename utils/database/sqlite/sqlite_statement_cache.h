@@ -0,0 +1,82 @@
+#pragma once
+
+#include <utils/cache/lru/lru_cache.h>
+
+#include <sqlite3.h>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace cxx {
+
+    /**
+     * @brief Cache of compiled SQLite statements bound to one connection
+     *
+     * Keeps the SQL text of every registered statement and at most `capacity`
+     * compiled sqlite3_stmt handles. The least recently used handles are finalized
+     * when the cache is full and recompiled on their next use.
+     */
+    class SQLiteStatementCache final {
+    public:
+        /**
+         * @brief Constructs an empty cache
+         *
+         * @param conn Connection the statements are compiled for
+         * @param capacity Maximum number of compiled statements
+         */
+        SQLiteStatementCache(sqlite3 * conn, std::size_t capacity);
+
+        ~SQLiteStatementCache();
+
+        SQLiteStatementCache(const SQLiteStatementCache &) = delete;
+        SQLiteStatementCache & operator=(const SQLiteStatementCache &) = delete;
+
+        /**
+         * @brief Registers a statement and compiles it
+         *
+         * Registering the same name with a different SQL text replaces the statement.
+         *
+         * @param name Statement name
+         * @param sql SQL text of the statement
+         * @return True if the statement compiled successfully
+         */
+        bool prepare(const std::string & name, const std::string & sql);
+
+        /**
+         * @brief Returns a compiled, reset statement ready for binding
+         *
+         * @param name Statement name
+         * @return Statement handle owned by the cache or nullptr if the statement
+         *         is unknown or fails to compile
+         */
+        sqlite3_stmt * acquire(const std::string & name);
+
+        /**
+         * @brief Finalizes every compiled statement
+         *
+         * Must be called before the connection is closed.
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief Compiles a statement and puts it into the cache
+         */
+        sqlite3_stmt * compile(const std::string & name, const std::string & sql);
+
+    private:
+        sqlite3 * conn_;
+
+        /**
+         * @brief SQL text of every registered statement
+         */
+        std::unordered_map< std::string, std::string > statements_;
+
+        /**
+         * @brief Compiled statements
+         */
+        LruCache< std::string, sqlite3_stmt * > compiled_;
+    };
+
+} // namespace cxx
@@ -1,21 +1,120 @@
 #include "sqlite_transaction.h"
 
+#include <utils/database/metrics/query_metrics.h>
+
 #include <spdlog/spdlog.h>
 
+#include <charconv>
+#include <memory>
+
 using namespace cxx;
 
-SQLiteTransaction::SQLiteTransaction(sqlite3 * conn)
-  : conn_(conn) {
+namespace {
+
+    template < class... Ts >
+    struct Overloaded: Ts... {
+        using Ts::operator()...;
+    };
+    template < class... Ts >
+    Overloaded(Ts...) -> Overloaded< Ts... >;
+
+    /**
+     * @brief Columns holding booleans
+     *
+     * SQLite has no boolean storage class, BOOLEAN columns are recognized by their declared type.
+     */
+    std::vector< bool > booleanColumns(sqlite3_stmt * stmt) {
+        const int columnCount = sqlite3_column_count(stmt);
+        std::vector< bool > booleans(columnCount);
+        for (int i = 0; i < columnCount; ++i) {
+            const char * declType = sqlite3_column_decltype(stmt, i);
+            booleans[i] = declType != nullptr && sqlite3_stricmp(declType, "BOOLEAN") == 0;
+        }
+        return booleans;
+    }
+
+    /**
+     * @brief Copies the current row of a stepped statement into the result
+     */
+    void appendRow(sqlite3_stmt * stmt, const std::vector< bool > & booleans, QueryResult & result) {
+        const int columnCount = static_cast< int >(booleans.size());
+        for (int i = 0; i < columnCount; ++i) {
+            switch (sqlite3_column_type(stmt, i)) {
+            case SQLITE_INTEGER: {
+                const sqlite3_int64 val = sqlite3_column_int64(stmt, i);
+                if (booleans[i]) {
+                    result.addBool(val != 0);
+                } else {
+                    result.addInt(val);
+                }
+                break;
+            }
+            case SQLITE_FLOAT:
+                result.addReal(sqlite3_column_double(stmt, i));
+                break;
+            case SQLITE_TEXT: {
+                const auto * text = reinterpret_cast< const char * >(sqlite3_column_text(stmt, i));
+                result.addText(std::string_view(text, sqlite3_column_bytes(stmt, i)));
+                break;
+            }
+            case SQLITE_BLOB: {
+                const auto * data = static_cast< const char * >(sqlite3_column_blob(stmt, i));
+                result.addText(std::string_view(data != nullptr ? data : "", sqlite3_column_bytes(stmt, i)));
+                break;
+            }
+            default:
+                result.addNull();
+                break;
+            }
+        }
+    }
+
+} // unnamed namespace
+
+SQLiteTransaction::SQLiteTransaction(SQLiteConnectionPool::Connection conn)
+  : conn_(std::move(conn))
+  , level_(conn_->enter()) {
 }
 
 SQLiteTransaction::~SQLiteTransaction() {
     SPDLOG_DEBUG("Closing SQLiteTransaction");
+    if (conn_) {
+        if (!conn_->commit(level_)) {
+            SPDLOG_ERROR("Failed to commit SQLite transaction, changes were rolled back");
+        }
+        close();
+    }
 }
 
 void SQLiteTransaction::abort() {
+    if (conn_) {
+        conn_->rollback(level_);
+        close();
+    } else {
+        SPDLOG_ERROR("Failed to abort transcation. Transcation is closed");
+    }
 }
 
 void SQLiteTransaction::commit() {
+    if (conn_) {
+        if (!conn_->commit(level_)) {
+            SPDLOG_ERROR("Failed to commit SQLite transaction, changes were rolled back");
+        }
+        close();
+    } else {
+        SPDLOG_ERROR("Failed to commit transcation. Transcation is closed");
+    }
+}
+
+void SQLiteTransaction::close() {
+    conn_->leave();
+    conn_.reset();
+}
+
+bool SQLiteTransaction::begin(sqlite3_stmt * stmt) {
+    // A SELECT calling an application function that writes is read-only for SQLite,
+    // but it takes no read snapshot either, so the nested write still acquires the lock
+    return conn_->begin(level_, sqlite3_stmt_readonly(stmt) == 0);
 }
 
 bool SQLiteTransaction::isTableExist(const std::string & tableName) {
@@ -29,64 +128,190 @@ bool SQLiteTransaction::isTableExist(const std::string & tableName) {
 }
 
 std::optional< QueryResult > SQLiteTransaction::executeQueryUnsafe(const std::string & query) {
+    if (!conn_) {
+        SPDLOG_ERROR("Failed to execute query. Transcation is closed");
+        return std::nullopt;
+    }
+
     sqlite3_stmt * stmt = nullptr;
-    int rc = sqlite3_prepare_v2(conn_, query.c_str(), -1, &stmt, nullptr);
+    int rc = sqlite3_prepare_v2(conn_->raw(), query.c_str(), -1, &stmt, nullptr);
 
     if (rc != SQLITE_OK) {
-        SPDLOG_ERROR("SQLite prepare error: {}", sqlite3_errmsg(conn_));
+        SPDLOG_ERROR("SQLite prepare error: {}", sqlite3_errmsg(conn_->raw()));
         return std::nullopt;
     }
 
-    QueryResult result;
-    int columnCount = sqlite3_column_count(stmt);
+    std::optional< QueryResult > result;
+    if (begin(stmt)) {
+        result = readRows(stmt);
+    }
+    sqlite3_finalize(stmt);
+    return result;
+}
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        std::vector< std::variant< int, double, std::string, bool > > row;
-        row.reserve(columnCount);
+bool SQLiteTransaction::anonymousBulkPlaceholders() const noexcept {
+    return true;
+}
 
-        for (int i = 0; i < columnCount; ++i) {
-            int type = sqlite3_column_type(stmt, i);
+std::optional< QueryResult > SQLiteTransaction::executeQueryParams(const std::string & query, const std::vector< SqlParam > & params) {
+    if (!conn_) {
+        SPDLOG_ERROR("Failed to execute query. Transcation is closed");
+        return std::nullopt;
+    }
 
-            switch (type) {
-            case SQLITE_INTEGER: {
-                int val = sqlite3_column_int(stmt, i);
-                // Если это булевское значение (0 или 1)
-                if (std::string(sqlite3_column_decltype(stmt, i) ? sqlite3_column_decltype(stmt, i) : "") == "BOOLEAN") {
-                    row.push_back(val != 0);
-                } else {
-                    row.push_back(val);
-                }
-                break;
-            }
-            case SQLITE_FLOAT: {
-                double val = sqlite3_column_double(stmt, i);
-                row.push_back(val);
-                break;
-            }
-            case SQLITE_TEXT: {
-                const char * text = reinterpret_cast< const char * >(sqlite3_column_text(stmt, i));
-                row.push_back(std::string(text));
-                break;
-            }
-            case SQLITE_NULL: {
-                // По умолчанию используем строку для NULL значений
-                row.push_back(std::string(""));
-                break;
+    QueryTimer timer(queryShape(query));
+    sqlite3_stmt * stmt = nullptr;
+    if (sqlite3_prepare_v2(conn_->raw(), query.c_str(), static_cast< int >(query.size()), &stmt, nullptr) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite prepare error: {}", sqlite3_errmsg(conn_->raw()));
+        return std::nullopt;
+    }
+
+    std::optional< QueryResult > result;
+    if (!bindParams(stmt, params)) {
+        SPDLOG_ERROR("SQLite bind error: {}", sqlite3_errmsg(conn_->raw()));
+    } else if (begin(stmt)) {
+        result = readRows(stmt);
+    }
+    sqlite3_finalize(stmt);
+    timer.finish(result.has_value());
+    return result;
+}
+
+bool SQLiteTransaction::streamQuery(const std::string & query, const std::vector< SqlParam > & params, std::size_t chunkRows, const ChunkHandler & onChunk) {
+    if (!conn_) {
+        SPDLOG_ERROR("Failed to stream query. Transcation is closed");
+        return false;
+    }
+    if (chunkRows == 0) {
+        return false;
+    }
+
+    QueryTimer timer(queryShape(query));
+    sqlite3_stmt * stmt = nullptr;
+    if (sqlite3_prepare_v2(conn_->raw(), query.c_str(), static_cast< int >(query.size()), &stmt, nullptr) != SQLITE_OK) {
+        SPDLOG_ERROR("SQLite prepare error: {}", sqlite3_errmsg(conn_->raw()));
+        return false;
+    }
+    // The handler may throw, the statement must be finalized anyway
+    const std::unique_ptr< sqlite3_stmt, int (*)(sqlite3_stmt *) > guard(stmt, &sqlite3_finalize);
+
+    bool succeeded = false;
+    if (!bindParams(stmt, params)) {
+        SPDLOG_ERROR("SQLite bind error: {}", sqlite3_errmsg(conn_->raw()));
+    } else if (begin(stmt)) {
+        // Rows are stepped out of the b-tree on demand, only the current chunk is materialized
+        const auto booleans = booleanColumns(stmt);
+        QueryResult chunk(booleans.size());
+        int rc = SQLITE_OK;
+        bool reading = true;
+        while (reading && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            appendRow(stmt, booleans, chunk);
+            if (chunk.size() == chunkRows) {
+                reading = onChunk(chunk);
+                chunk = QueryResult(booleans.size());
             }
-            default: {
-                // Для неизвестных типов также используем строку
-                row.push_back(std::string(""));
-                break;
+        }
+        if (reading && rc != SQLITE_DONE) {
+            SPDLOG_ERROR("SQLite step error: {}", sqlite3_errmsg(conn_->raw()));
+        } else {
+            if (reading && !chunk.empty()) {
+                onChunk(chunk);
             }
+            succeeded = true;
+        }
+    }
+    timer.finish(succeeded);
+    return succeeded;
+}
+
+bool SQLiteTransaction::prepare(const std::string & name, const std::string & sql) {
+    if (!conn_) {
+        SPDLOG_ERROR("Failed to prepare statement {}. Transcation is closed", name);
+        return false;
+    }
+    return conn_->statements().prepare(name, sql);
+}
+
+std::optional< QueryResult > SQLiteTransaction::execPreparedParams(const std::string & name, const std::vector< SqlParam > & params) {
+    if (!conn_) {
+        SPDLOG_ERROR("Failed to execute statement {}. Transcation is closed", name);
+        return std::nullopt;
+    }
+
+    QueryTimer timer(name);
+    sqlite3_stmt * stmt = conn_->statements().acquire(name);
+    if (stmt == nullptr) {
+        SPDLOG_ERROR("Unknown prepared statement: {}", name);
+        return std::nullopt;
+    }
+
+    if (!bindParams(stmt, params)) {
+        SPDLOG_ERROR("SQLite bind error for statement {}: {}", name, sqlite3_errmsg(conn_->raw()));
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return std::nullopt;
+    }
+
+    std::optional< QueryResult > result;
+    if (begin(stmt)) {
+        result = readRows(stmt);
+    }
+    // Release bound text and read locks, the statement itself stays cached
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    timer.finish(result.has_value());
+    return result;
+}
+
+bool SQLiteTransaction::bindParams(sqlite3_stmt * stmt, const std::vector< SqlParam > & params) const {
+    // Walk the parameters of the statement once, looking them up by name is linear per call
+    const int count = sqlite3_bind_parameter_count(stmt);
+    if (params.size() != static_cast< std::size_t >(count)) {
+        SPDLOG_ERROR("SQLite bind error: {} parameters for {} placeholders", params.size(), count);
+        return false;
+    }
+    for (int index = 1; index <= count; ++index) {
+        // Statements use Postgres-style $N placeholders, plain ? falls back to the position
+        std::size_t position = static_cast< std::size_t >(index - 1);
+        if (const char * name = sqlite3_bind_parameter_name(stmt, index); name != nullptr && name[0] == '$') {
+            const std::string_view number(name + 1);
+            const auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), position);
+            if (ec != std::errc() || ptr != number.data() + number.size() || position == 0) {
+                return false;
             }
+            --position;
+        }
+        if (position >= params.size()) {
+            SPDLOG_ERROR("SQLite bind error: no parameter for ${}", position + 1);
+            return false;
+        }
+
+        const int rc = std::visit(
+         Overloaded{
+          [&](std::monostate) { return sqlite3_bind_null(stmt, index); },
+          [&](int64_t value) { return sqlite3_bind_int64(stmt, index, value); },
+          [&](double value) { return sqlite3_bind_double(stmt, index, value); },
+          [&](const std::string & value) { return sqlite3_bind_text(stmt, index, value.data(), static_cast< int >(value.size()), SQLITE_STATIC); },
+          [&](bool value) { return sqlite3_bind_int(stmt, index, value ? 1 : 0); } },
+         params[position]);
+        if (rc != SQLITE_OK) {
+            return false;
         }
-        result.push_back(std::move(row));
     }
+    return true;
+}
 
-    sqlite3_finalize(stmt);
+std::optional< QueryResult > SQLiteTransaction::readRows(sqlite3_stmt * stmt) const {
+    const auto booleans = booleanColumns(stmt);
+
+    QueryResult result(booleans.size());
+    int rc = SQLITE_OK;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        appendRow(stmt, booleans, result);
+    }
 
     if (rc != SQLITE_DONE) {
-        SPDLOG_ERROR("SQLite step error: {}", sqlite3_errmsg(conn_));
+        SPDLOG_ERROR("SQLite step error: {}", sqlite3_errmsg(conn_->raw()));
         return std::nullopt;
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sqlite3.h>
+#include <utils/database/sqlite/sqlite_connection_pool.h>
 #include <utils/database/transaction/base/base_transaction.h>
 
 namespace cxx {
@@ -10,15 +11,20 @@ namespace cxx {
      *
      * This class provides SQLite-specific functionality for managing database transactions,
      * such as commit, abort, and executing queries against a SQLite database.
+     *
+     * The transaction begins with its first statement: BEGIN IMMEDIATE if that statement writes,
+     * BEGIN DEFERRED otherwise. It is committed by commit() or, like PsqlTransaction, on destruction
+     * if still open. A transaction created while another one is open on the same thread shares its
+     * connection and becomes a savepoint inside it.
      */
     class SQLiteTransaction final: public BaseTransaction {
     public:
         /**
          * @brief Constructor for SQLiteTransaction
          *
-         * @param conn Pointer to an active SQLite database connection
+         * @param conn Connection leased for the lifetime of the transaction
          */
-        SQLiteTransaction(sqlite3 * conn);
+        explicit SQLiteTransaction(SQLiteConnectionPool::Connection conn);
 
         ~SQLiteTransaction() override;
 
@@ -46,6 +52,44 @@ namespace cxx {
          */
         bool isTableExist(const std::string & tableName) override;
 
+        /**
+         * @brief Compiles, binds and executes a one-off statement
+         *
+         * @param query SQL text with $1, $2, ... placeholders
+         * @param params Parameter values in order
+         * @return Optional QueryResult containing the result or empty on failure
+         */
+        std::optional< QueryResult > executeQueryParams(const std::string & query, const std::vector< SqlParam > & params) override;
+
+        /**
+         * @brief Steps a one-off statement and hands its rows over in chunks
+         *
+         * @param query SQL text with $1, $2, ... placeholders
+         * @param params Parameter values in order
+         * @param chunkRows Maximum number of rows in one chunk
+         * @param onChunk Called with every non-empty chunk in order
+         * @return False if the query failed
+         */
+        bool streamQuery(const std::string & query, const std::vector< SqlParam > & params, std::size_t chunkRows, const ChunkHandler & onChunk) override;
+
+        /**
+         * @brief Registers and compiles a prepared statement
+         *
+         * @param name Unique statement name
+         * @param sql SQL text with $1, $2, ... placeholders
+         * @return True if the statement compiled successfully, false otherwise
+         */
+        bool prepare(const std::string & name, const std::string & sql) override;
+
+        /**
+         * @brief Binds parameters to a cached sqlite3_stmt and executes it
+         *
+         * @param name Statement name
+         * @param params Parameter values in order
+         * @return Optional QueryResult containing the result or empty on failure
+         */
+        std::optional< QueryResult > execPreparedParams(const std::string & name, const std::vector< SqlParam > & params) override;
+
         static std::string escapeStringStatic(const std::string & str);
 
     private:
@@ -59,6 +103,13 @@ namespace cxx {
          */
         std::optional< QueryResult > executeQueryUnsafe(const std::string & query) override;
 
+        /**
+         * @brief SQLite resolves every named parameter with a linear search while parsing
+         *
+         * @return True, so bulk inserts with thousands of parameters prepare in linear time
+         */
+        bool anonymousBulkPlaceholders() const noexcept override;
+
         /**
          * @brief Escapes a string for safe use in SQLite SQL queries
          *
@@ -67,14 +118,48 @@ namespace cxx {
          */
         std::string escapeString(const std::string & str) override;
 
-    private:
         /**
-         * @brief SQLite database connection handle
+         * @brief Binds parameters to $N placeholders, or by position for plain ? placeholders
+         *
+         * Text values are bound without copying and must outlive the execution.
+         *
+         * @param stmt Statement to bind
+         * @param params Parameter values in order
+         * @return True if every placeholder was bound and no parameter was left over
+         */
+        bool bindParams(sqlite3_stmt * stmt, const std::vector< SqlParam > & params) const;
+
+        /**
+         * @brief Steps through a compiled statement and collects its rows
+         *
+         * @param stmt Statement to execute
+         * @return Optional QueryResult containing the rows or empty on failure
+         */
+        std::optional< QueryResult > readRows(sqlite3_stmt * stmt) const;
+
+        /**
+         * @brief Begins the transaction before its first statement runs
          *
-         * Pointer to the underlying SQLite database connection.
-         * Null if no connection is established.
+         * @param stmt Compiled statement about to run, decides between a read and a write transaction
+         * @return False if the transaction cannot begin
+         */
+        bool begin(sqlite3_stmt * stmt);
+
+        /**
+         * @brief Returns the connection to the enclosing transaction or the pool
+         */
+        void close();
+
+    private:
+        /**
+         * @brief Leased connection, null after commit or abort
+         */
+        SQLiteConnectionPool::Connection conn_;
+
+        /**
+         * @brief Nesting level on the connection, zero for the outermost transaction
          */
-        sqlite3 * conn_ = nullptr;
+        std::size_t level_ = 0;
     };
 
 } // namespace cxx
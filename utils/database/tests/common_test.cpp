@@ -5,7 +5,14 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace cxx;
 
@@ -83,11 +90,11 @@ TEST_P(DatabaseTest, InsertData) {
     ASSERT_EQ(result->size(), 1);
 
     const auto & row = result->at(0);
-    ASSERT_EQ(std::get< int >(row.at(0)), 1);                  // id
-    ASSERT_EQ(std::get< std::string >(row.at(1)), "Alice");    // name
-    ASSERT_EQ(std::get< int >(row.at(2)), 30);                 // age
-    ASSERT_DOUBLE_EQ(std::get< double >(row.at(3)), 50000.50); // salary
-    ASSERT_EQ(std::get< bool >(row.at(4)), true);              // active
+    ASSERT_EQ(row.at(0).as< int >(), 1);                  // id
+    ASSERT_EQ(row.at(1).as< std::string >(), "Alice");    // name
+    ASSERT_EQ(row.at(2).as< int >(), 30);                 // age
+    ASSERT_DOUBLE_EQ(row.at(3).as< double >(), 50000.50); // salary
+    ASSERT_EQ(row.at(4).as< bool >(), true);              // active
 }
 
 TEST_P(DatabaseTest, SelectData) {
@@ -130,9 +137,9 @@ TEST_P(DatabaseTest, UpdateData) {
     ASSERT_EQ(result->size(), 1);
 
     const auto & row = result->at(0);
-    ASSERT_EQ(std::get< std::string >(row.at(0)), "Alice Updated"); // name
-    ASSERT_EQ(std::get< int >(row.at(1)), 31);                      // age
-    ASSERT_EQ(std::get< bool >(row.at(2)), false);                  // active
+    ASSERT_EQ(row.at(0).as< std::string >(), "Alice Updated"); // name
+    ASSERT_EQ(row.at(1).as< int >(), 31);                      // age
+    ASSERT_EQ(row.at(2).as< bool >(), false);                  // active
 }
 
 TEST_P(DatabaseTest, DeleteData) {
@@ -188,12 +195,17 @@ TEST_P(DatabaseTest, DataTypes) {
     ASSERT_EQ(result->size(), 1);
 
     const auto & row = result->at(0);
-    ASSERT_EQ(std::get< int >(row.at(0)), 42);
-    ASSERT_DOUBLE_EQ(std::get< double >(row.at(1)), 3.14);
-    ASSERT_EQ(std::get< std::string >(row.at(2)), "hello");
-    ASSERT_EQ(std::get< bool >(row.at(3)), true);
-    ASSERT_EQ(std::get< std::string >(row.at(4)), "2023-07-15");
-    ASSERT_EQ(std::get< std::string >(row.at(5)), "2023-07-15 14:30:00");
+    ASSERT_EQ(row.at(0).as< int >(), 42);
+    ASSERT_DOUBLE_EQ(row.at(1).as< double >(), 3.14);
+    ASSERT_EQ(row.at(2).as< std::string >(), "hello");
+    ASSERT_EQ(row.at(3).as< bool >(), true);
+    ASSERT_EQ(row.at(4).as< std::string >(), "2023-07-15");
+    ASSERT_EQ(row.at(5).as< std::string >(), "2023-07-15 14:30:00");
+
+    EXPECT_EQ(row.at(0).type(), QueryResult::EType::INTEGER);
+    EXPECT_EQ(row.at(1).type(), QueryResult::EType::REAL);
+    EXPECT_EQ(row.at(2).type(), QueryResult::EType::TEXT);
+    EXPECT_EQ(row.at(3).type(), QueryResult::EType::BOOLEAN);
 }
 
 TEST_P(DatabaseTest, Constraints) {
@@ -262,6 +274,110 @@ TEST_P(DatabaseTest, CheckExistence) {
     EXPECT_FALSE(db_->makeTransaction()->isTableExist("non_existent_table"));
 }
 
+TEST_P(DatabaseTest, PreparedStatements) {
+    ASSERT_TRUE(db_->makeTransaction()->createTable("test_table", getTestTableColumns()));
+
+    {
+        auto transaction = db_->makeTransaction();
+        ASSERT_TRUE(transaction->prepare("insert_test", "INSERT INTO test_table (id, name, age, salary, active) VALUES ($1, $2, $3, $4, $5)"));
+        ASSERT_TRUE(transaction->execPrepared("insert_test", 1, "Alice", 30, 50000.5, true).has_value());
+        ASSERT_TRUE(transaction->execPrepared("insert_test", 2, std::string("Bob"), std::nullopt, std::optional< double >{}, false).has_value());
+    }
+
+    auto transaction = db_->makeTransaction();
+    ASSERT_TRUE(transaction->prepare("select_test", "SELECT name, age FROM test_table WHERE id = $1"));
+    // Preparing the same statement again is a cache hit
+    ASSERT_TRUE(transaction->prepare("select_test", "SELECT name, age FROM test_table WHERE id = $1"));
+
+    auto result = transaction->execPrepared("select_test", 2);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 1);
+    EXPECT_EQ(result->at(0).at(0).as< std::string >(), "Bob");
+    EXPECT_TRUE(result->at(0).at(1).isNull());
+
+    result = transaction->execPrepared("select_test", 3);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->empty());
+
+    EXPECT_FALSE(transaction->execPrepared("unknown_statement").has_value());
+}
+
+TEST_P(DatabaseTest, BulkInsert) {
+    ASSERT_TRUE(db_->makeTransaction()->createTable("test_table", getTestTableColumns()));
+
+    // Enough rows for several INSERT chunks and for the COPY path of PostgreSQL
+    constexpr int64_t ROWS = 20000;
+    std::vector< std::vector< SqlParam > > rows;
+    rows.reserve(ROWS);
+    for (int64_t id = 1; id <= ROWS; ++id) {
+        rows.push_back({ id, "name " + std::to_string(id), id % 100, id * 0.5, id % 2 == 0 });
+    }
+    rows[1][1] = std::string("O'Brien");
+    rows[2][2] = std::monostate{};
+
+    {
+        auto transaction = db_->makeTransaction();
+        ASSERT_TRUE(transaction->insertBulk("test_table", { "id", "name", "age", "salary", "active" }, rows));
+        // Row of a wrong size is rejected before anything is written
+        ASSERT_FALSE(transaction->insertBulk("test_table", { "id", "name" }, { { int64_t{ ROWS + 1 } } }));
+    }
+
+    auto transaction = db_->makeTransaction();
+    auto result = transaction->executeQuery("SELECT COUNT(*) FROM test_table");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->at(0).at(0).as< int64_t >(), ROWS);
+
+    result = transaction->executeQueryParams("SELECT name, age, salary, active FROM test_table WHERE id IN ($1, $2) ORDER BY id", { int64_t{ 2 }, int64_t{ 3 } });
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 2);
+    EXPECT_EQ(result->at(0).at(0).as< std::string >(), "O'Brien");
+    EXPECT_TRUE(result->at(0).at(3).as< bool >());
+    EXPECT_TRUE(result->at(1).at(1).isNull());
+    EXPECT_DOUBLE_EQ(result->at(1).at(2).as< double >(), 1.5);
+}
+
+TEST_P(DatabaseTest, ParamCountMismatch) {
+    // A failed statement aborts a PostgreSQL transaction, every query gets its own
+    EXPECT_TRUE(db_->makeTransaction()->executeQueryParams("SELECT $1", { int64_t{ 1 } }).has_value());
+    EXPECT_FALSE(db_->makeTransaction()->executeQueryParams("SELECT $1", { int64_t{ 1 }, int64_t{ 2 } }).has_value());
+    EXPECT_FALSE(db_->makeTransaction()->executeQueryParams("SELECT $1, $2", { int64_t{ 1 } }).has_value());
+}
+
+TEST_P(DatabaseTest, StreamQuery) {
+    ASSERT_TRUE(db_->makeTransaction()->createTable("test_table", getTestTableColumns()));
+    std::vector< std::vector< SqlParam > > rows;
+    for (int64_t id = 1; id <= 10; ++id) {
+        rows.push_back({ id, "name " + std::to_string(id), id, id * 0.5, id % 2 == 0 });
+    }
+    ASSERT_TRUE(db_->makeTransaction()->insertBulk("test_table", { "id", "name", "age", "salary", "active" }, rows));
+
+    auto transaction = db_->makeTransaction();
+    std::vector< std::size_t > sizes;
+    int64_t next = 2;
+    ASSERT_TRUE(transaction->streamQuery("SELECT id, active FROM test_table WHERE id >= $1 ORDER BY id", { int64_t{ 2 } }, 4, [&](const QueryResult & chunk) {
+        sizes.push_back(chunk.size());
+        for (const auto & row: chunk) {
+            EXPECT_EQ(row[0].as< int64_t >(), next);
+            EXPECT_EQ(row[1].as< bool >(), next % 2 == 0);
+            ++next;
+        }
+        return true;
+    }));
+    EXPECT_EQ(sizes, (std::vector< std::size_t >{ 4, 4, 1 }));
+
+    // Stopping early is not an error and leaves the transaction usable
+    sizes.clear();
+    ASSERT_TRUE(transaction->streamQuery("SELECT id FROM test_table ORDER BY id", {}, 3, [&](const QueryResult & chunk) {
+        sizes.push_back(chunk.size());
+        return false;
+    }));
+    EXPECT_EQ(sizes, (std::vector< std::size_t >{ 3 }));
+
+    EXPECT_FALSE(transaction->streamQuery("SELECT missing FROM test_table", {}, 3, [](const QueryResult &) {
+        return true;
+    }));
+}
+
 INSTANTIATE_TEST_SUITE_P(
  SQLite,
  DatabaseTest,
@@ -293,7 +409,152 @@ TEST_P(SQLiteDatabaseTest, ConnectFile) {
     ASSERT_TRUE(db->isReady());
 }
 
+TEST_P(SQLiteDatabaseTest, ConnectAppliesSettings) {
+    auto db = std::reinterpret_pointer_cast< SQLiteDatabase >(db_);
+    const std::string path = ::testing::TempDir() + "sqlite_settings_test.db";
+    std::remove(path.c_str());
+
+    SQLiteDatabase::Settings settings;
+    settings.foreignKeys = true;
+    bool opened = false;
+    settings.onOpen = [&opened](sqlite3 *) {
+        opened = true;
+        return true;
+    };
+    ASSERT_TRUE(db->connect(path, settings));
+    EXPECT_TRUE(opened);
+    EXPECT_EQ(db->dialect(), ESqlDialect::SQLITE);
+
+    auto transaction = db->makeTransaction();
+    auto result = transaction->executeQuery("PRAGMA journal_mode");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->at(0).at(0).as< std::string >(), "wal");
+    result = transaction->executeQuery("PRAGMA foreign_keys");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->at(0).at(0).as< int32_t >(), 1);
+
+    EXPECT_TRUE(db->executeScript("CREATE TABLE parent (id INTEGER PRIMARY KEY); CREATE TABLE child (parent_id INTEGER REFERENCES parent(id));"));
+    EXPECT_FALSE(db->executeScript("INSERT INTO child (parent_id) VALUES (1);"));
+
+    settings.onOpen = [](sqlite3 *) {
+        return false;
+    };
+    EXPECT_FALSE(db->connect(path, settings));
+    EXPECT_FALSE(db->isReady());
+    std::remove(path.c_str());
+}
+
+TEST_P(SQLiteDatabaseTest, TransactionCommitsOnDestructionAndRollsBackOnAbort) {
+    ASSERT_TRUE(db_->makeTransaction()->executeQuery("CREATE TABLE items (id INTEGER)").has_value());
+
+    {
+        auto transaction = db_->makeTransaction();
+        ASSERT_TRUE(transaction->executeQuery("INSERT INTO items VALUES (1)").has_value());
+        transaction->abort();
+    }
+    {
+        auto transaction = db_->makeTransaction();
+        ASSERT_TRUE(transaction->executeQuery("INSERT INTO items VALUES (2)").has_value());
+    }
+
+    auto result = db_->makeTransaction()->executeQuery("SELECT id FROM items");
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 1);
+    EXPECT_EQ(result->at(0).at(0).as< int32_t >(), 2);
+}
+
+TEST_P(SQLiteDatabaseTest, NestedTransactionIsSavepoint) {
+    ASSERT_TRUE(db_->makeTransaction()->executeQuery("CREATE TABLE items (id INTEGER)").has_value());
+
+    auto outer = db_->makeTransaction();
+    ASSERT_TRUE(outer->executeQuery("INSERT INTO items VALUES (1)").has_value());
+    {
+        auto inner = db_->makeTransaction();
+        ASSERT_TRUE(inner->executeQuery("INSERT INTO items VALUES (2)").has_value());
+        inner->abort();
+    }
+    {
+        auto inner = db_->makeTransaction();
+        ASSERT_TRUE(inner->executeQuery("INSERT INTO items VALUES (3)").has_value());
+    }
+    // Uncommitted changes are visible on the connection of the thread
+    auto result = db_->makeTransaction()->executeQuery("SELECT id FROM items ORDER BY id");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->size(), 2);
+    outer->abort();
+
+    result = db_->makeTransaction()->executeQuery("SELECT id FROM items");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->empty());
+}
+
+TEST_P(SQLiteDatabaseTest, ConcurrentWritersUseOwnConnections) {
+    auto db = std::reinterpret_pointer_cast< SQLiteDatabase >(db_);
+    const std::string path = ::testing::TempDir() + "sqlite_concurrency_test.db";
+    std::remove(path.c_str());
+    ASSERT_TRUE(db->connect(path));
+    ASSERT_TRUE(db->executeScript("CREATE TABLE items (thread INTEGER, id INTEGER)"));
+
+    constexpr int THREADS = 4;
+    constexpr int TRANSACTIONS = 50;
+    std::atomic< int > failures = 0;
+    std::vector< std::thread > threads;
+    for (int thread = 0; thread < THREADS; ++thread) {
+        threads.emplace_back([&, thread] {
+            for (int id = 0; id < TRANSACTIONS; ++id) {
+                auto transaction = db->makeTransaction();
+                // The second row must land in the same transaction as the first one
+                for (int row = 0; row < 2; ++row) {
+                    if (!transaction->executeQueryParams("INSERT INTO items VALUES ($1, $2)", { thread, id }).has_value()) {
+                        ++failures;
+                    }
+                }
+            }
+        });
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_LE(db->pool()->size(), static_cast< std::size_t >(THREADS));
+    auto result = db->makeTransaction()->executeQuery("SELECT COUNT(*) FROM items");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->at(0).at(0).as< int32_t >(), THREADS * TRANSACTIONS * 2);
+
+    db->disconnect();
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(
  SQLiteOnly,
  SQLiteDatabaseTest,
  ::testing::Values(createSQLiteInMemory));
+
+#ifdef POSTGRES_TEST
+TEST(PsqlConnectionPoolTest, LeaseIsReturnedWithTransaction) {
+    PsqlDatabase db;
+    ASSERT_TRUE(db.connect("dbname=postgres", PsqlDatabase::PoolSettings{ .minSize = 1, .maxSize = 2 }));
+
+    {
+        auto first = db.makeTransaction();
+        auto second = db.makeTransaction();
+        ASSERT_TRUE(first->executeQuery("SELECT 1").has_value());
+        ASSERT_TRUE(second->executeQuery("SELECT 1").has_value());
+    }
+
+    auto third = db.makeTransaction();
+    ASSERT_TRUE(third->executeQuery("SELECT 1").has_value());
+}
+
+TEST(PsqlConnectionPoolTest, AcquireTimesOutWhenExhausted) {
+    PsqlDatabase db;
+    ASSERT_TRUE(db.connect("dbname=postgres",
+                           PsqlDatabase::PoolSettings{ .minSize = 1, .maxSize = 1, .acquireTimeout = std::chrono::milliseconds(50) }));
+
+    auto busy = db.makeTransaction();
+    EXPECT_THROW(db.makeTransaction(), std::runtime_error);
+}
+#endif
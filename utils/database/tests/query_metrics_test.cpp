@@ -0,0 +1,72 @@
+#include <utils/database/metrics/query_metrics.h>
+#include <utils/database/sqlite/sqlite_database.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cxx;
+
+TEST(QueryShapeTest, LiteralsBecomePlaceholders) {
+    EXPECT_EQ(queryShape("SELECT id FROM users WHERE token = 'abc''d' AND age > 18"), "SELECT id FROM users WHERE token = ? AND age > ?");
+    EXPECT_EQ(queryShape("SELECT * FROM t1 WHERE salary = 1.5 AND id = $12"), "SELECT * FROM t1 WHERE salary = ? AND id = ?");
+}
+
+TEST(QueryShapeTest, ListsAndWhitespaceCollapse) {
+    EXPECT_EQ(queryShape("  SELECT *\n  FROM t\n WHERE id IN (1, 2,3,  4)  "), "SELECT * FROM t WHERE id IN (?)");
+    EXPECT_EQ(queryShape("INSERT INTO t (a, b) VALUES (1, 'x'), (2, 'y'),(3, 'z')"), "INSERT INTO t (a, b) VALUES (?)");
+    EXPECT_EQ(queryShape("INSERT INTO t (a, b) VALUES ($1, $2), ($3, $4)"), queryShape("INSERT INTO t (a, b) VALUES ($1, $2)"));
+}
+
+TEST(QueryShapeTest, LongShapesAreTruncated) {
+    EXPECT_EQ(queryShape("SELECT " + std::string(1000, 'a')).size(), 160);
+}
+
+TEST(QueryTimerTest, QueriesAreRecordedByShape) {
+    auto db = std::make_shared< SQLiteDatabase >();
+    ASSERT_TRUE(db->connectInMemory());
+
+    auto & registry = MetricsRegistry::global();
+    const MetricsRegistry::Labels labels = { { "query", "SELECT ?" } };
+    const auto before = registry.histogram("db_query_duration_seconds", "", labels).snapshot().count();
+    const auto errorsBefore = registry.counter("db_query_errors_total", "", { { "query", "SELECT FROM nowhere" } }).value();
+
+    auto transaction = db->makeTransaction();
+    ASSERT_TRUE(transaction->executeQuery("SELECT 1").has_value());
+    ASSERT_TRUE(transaction->executeQuery("SELECT 2").has_value());
+    ASSERT_FALSE(transaction->executeQuery("SELECT FROM nowhere").has_value());
+
+    EXPECT_EQ(registry.histogram("db_query_duration_seconds", "", labels).snapshot().count(), before + 2);
+    EXPECT_EQ(registry.counter("db_query_errors_total", "", { { "query", "SELECT FROM nowhere" } }).value(), errorsBefore + 1);
+}
+
+TEST(QueryTimerTest, ShapesBeyondLimitShareOtherSeries) {
+    auto & registry = MetricsRegistry::global();
+    const auto otherBefore = registry.histogram("db_query_duration_seconds", "", { { "query", "other" } }).snapshot().count();
+
+    constexpr std::size_t THREADS = 4;
+    constexpr std::size_t SHAPES = QueryTimer::MAX_SHAPES * 2;
+    std::vector< std::thread > threads;
+    for (std::size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([]() {
+            for (std::size_t shape = 0; shape < SHAPES; ++shape) {
+                QueryTimer("limit test " + std::to_string(shape)).finish(true);
+            }
+        });
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+
+    // Every thread records every shape once, at least the second half of them is not admitted
+    std::size_t admitted = 0;
+    for (std::size_t shape = 0; shape < SHAPES; ++shape) {
+        const auto count = registry.histogram("db_query_duration_seconds", "", { { "query", "limit test " + std::to_string(shape) } }).snapshot().count();
+        EXPECT_TRUE(count == 0 || count == THREADS) << shape;
+        admitted += count / THREADS;
+    }
+    EXPECT_LE(admitted, QueryTimer::MAX_SHAPES);
+    EXPECT_EQ(registry.histogram("db_query_duration_seconds", "", { { "query", "other" } }).snapshot().count(), otherBefore + (SHAPES - admitted) * THREADS);
+}
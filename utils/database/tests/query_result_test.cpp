@@ -0,0 +1,91 @@
+#include <utils/database/transaction/interface/query_result.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cxx;
+
+namespace {
+
+    QueryResult makeResult() {
+        QueryResult result(3);
+        result.addInt(1);
+        result.addText("Alice");
+        result.addReal(2.5);
+
+        result.addIntFromText("42");
+        result.addNull();
+        result.addBool(true);
+        return result;
+    }
+
+} // unnamed namespace
+
+TEST(QueryResultTest, Dimensions) {
+    const auto result = makeResult();
+    EXPECT_EQ(result.size(), 2);
+    EXPECT_EQ(result.columns(), 3);
+    EXPECT_FALSE(result.empty());
+
+    EXPECT_TRUE(QueryResult().empty());
+    EXPECT_TRUE(QueryResult(4).empty());
+}
+
+TEST(QueryResultTest, TypedAccess) {
+    const auto result = makeResult();
+
+    EXPECT_EQ(result[0][0].type(), QueryResult::EType::INTEGER);
+    EXPECT_EQ(result[0][0].asInt32(), 1);
+    EXPECT_EQ(result[0][1].asStringView(), "Alice");
+    EXPECT_DOUBLE_EQ(result[0][2].asDouble(), 2.5);
+
+    EXPECT_EQ(result[1][0].type(), QueryResult::EType::INTEGER);
+    EXPECT_EQ(result[1][0].asInt64(), 42);
+    EXPECT_TRUE(result[1][1].isNull());
+    EXPECT_EQ(result[1][2].type(), QueryResult::EType::BOOLEAN);
+    EXPECT_TRUE(result[1][2].asBool());
+}
+
+TEST(QueryResultTest, Conversions) {
+    QueryResult result(6);
+    result.addText("17");
+    result.addText("3.75");
+    result.addText("t");
+    result.addInt(5);
+    result.addRealFromText("not a number");
+    result.addNull();
+
+    const auto row = result.at(0);
+    EXPECT_EQ(row[0].as< int32_t >(), 17);
+    EXPECT_DOUBLE_EQ(row[1].as< double >(), 3.75);
+    EXPECT_EQ(row[1].as< int32_t >(), 3);
+    EXPECT_TRUE(row[2].as< bool >());
+    EXPECT_EQ(row[3].as< std::string >(), "5");
+    EXPECT_DOUBLE_EQ(row[3].as< double >(), 5.0);
+    EXPECT_EQ(row[4].type(), QueryResult::EType::TEXT);
+    EXPECT_EQ(row[4].as< std::string >(), "not a number");
+    EXPECT_EQ(row[5].as< int32_t >(), 0);
+    EXPECT_EQ(row[5].as< std::string >(), "");
+    EXPECT_FALSE(row[5].as< bool >());
+}
+
+TEST(QueryResultTest, RowIteration) {
+    const auto result = makeResult();
+
+    std::vector< int64_t > ids;
+    for (const auto & row: result) {
+        ids.push_back(row[0].asInt64());
+    }
+    EXPECT_EQ(ids, (std::vector< int64_t >{ 1, 42 }));
+    EXPECT_EQ(result.end() - result.begin(), 2);
+}
+
+TEST(QueryResultTest, BoundsChecking) {
+    const auto result = makeResult();
+    EXPECT_THROW(result.at(2), std::out_of_range);
+    EXPECT_THROW(result.at(0).at(3), std::out_of_range);
+    EXPECT_NO_THROW(result.at(1, 2));
+}
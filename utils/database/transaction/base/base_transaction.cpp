@@ -1,10 +1,50 @@
 #include "base_transaction.h"
 
+#include <utils/database/metrics/query_metrics.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
 #include <optional>
 #include <sstream>
 
 using namespace cxx;
 
+namespace {
+
+    // Fits both SQLite (SQLITE_MAX_VARIABLE_NUMBER since 3.32) and PostgreSQL (65535)
+    constexpr std::size_t MAX_BULK_PARAMETERS = 32766;
+
+    std::string makeBulkInsertQuery(const std::string & table, const std::string & columns, std::size_t columnsCount, std::size_t rowsCount, bool anonymous) {
+        std::string query;
+        query.reserve(table.size() + columns.size() + rowsCount * columnsCount * 8 + 32);
+        query += "INSERT INTO ";
+        query += table;
+        query += " (";
+        query += columns;
+        query += ") VALUES ";
+
+        std::size_t parameter = 1;
+        for (std::size_t row = 0; row < rowsCount; ++row) {
+            query += row == 0 ? "(" : ", (";
+            for (std::size_t column = 0; column < columnsCount; ++column) {
+                if (column != 0) {
+                    query += ", ";
+                }
+                if (anonymous) {
+                    query += '?';
+                } else {
+                    query += '$';
+                    query += std::to_string(parameter++);
+                }
+            }
+            query += ')';
+        }
+        return query;
+    }
+
+} // unnamed namespace
+
 bool BaseTransaction::createTable(const std::string & name, const std::vector< Col > & cols) {
     std::stringstream query;
     query << "CREATE TABLE " << escapeString(name) << " (";
@@ -84,6 +124,46 @@ bool BaseTransaction::insert(const std::string & tableName, const std::vector< s
     return result.has_value();
 }
 
+bool BaseTransaction::insertBulk(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) {
+    if (colNames.empty()) {
+        return false;
+    }
+    if (rows.empty()) {
+        return true;
+    }
+
+    const std::string table = escapeString(tableName);
+    std::string columns;
+    for (const auto & colName: colNames) {
+        if (!columns.empty()) {
+            columns += ", ";
+        }
+        columns += escapeString(colName);
+    }
+
+    const std::size_t chunkRows = std::max< std::size_t >(1, MAX_BULK_PARAMETERS / colNames.size());
+    std::vector< SqlParam > params;
+    params.reserve(std::min(rows.size(), chunkRows) * colNames.size());
+
+    for (std::size_t begin = 0; begin < rows.size(); begin += chunkRows) {
+        const std::size_t count = std::min(chunkRows, rows.size() - begin);
+
+        params.clear();
+        for (std::size_t row = begin; row < begin + count; ++row) {
+            if (rows[row].size() != colNames.size()) {
+                SPDLOG_ERROR("Bulk insert into {}: row {} has {} values, expected {}", tableName, row, rows[row].size(), colNames.size());
+                return false;
+            }
+            params.insert(params.end(), rows[row].begin(), rows[row].end());
+        }
+
+        if (!executeQueryParams(makeBulkInsertQuery(table, columns, colNames.size(), count, anonymousBulkPlaceholders()), params).has_value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool BaseTransaction::update(const std::string & tableName, const std::vector< std::pair< std::string, std::string > > & colValuePairs, const std::string & whereCondition) {
     if (colValuePairs.empty()) {
         return false;
@@ -131,25 +211,16 @@ bool BaseTransaction::isTableExist(const std::string & tableName) {
     query << "');";
 
     auto result = executeQueryUnsafe(query.str());
-    if (!result.has_value() || result->empty() || (*result)[0].empty()) {
+    if (!result.has_value() || result->empty() || result->columns() == 0) {
         return false;
     }
 
-    // Convert the result to boolean
-    auto & value = (*result)[0][0];
-    if (std::holds_alternative< std::string >(value)) {
-        std::string stringVal = std::get< std::string >(value);
-        return stringVal == "t" || stringVal == "true" || stringVal == "1";
-    } else if (std::holds_alternative< bool >(value)) {
-        return std::get< bool >(value);
-    } else if (std::holds_alternative< int >(value)) {
-        return std::get< int >(value) != 0;
-    }
-
-    return false;
+    return (*result)[0][0].asBool();
 }
 
 std::optional< QueryResult > BaseTransaction::executeQuery(const std::string & query) {
-    // TODO: some checks
-    return executeQueryUnsafe(query);
+    QueryTimer timer(queryShape(query));
+    auto result = executeQueryUnsafe(query);
+    timer.finish(result.has_value());
+    return result;
 }
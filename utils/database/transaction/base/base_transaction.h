@@ -59,6 +59,20 @@ namespace cxx {
          */
         bool insert(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::string > & values) override;
 
+        /**
+         * @brief Inserts many rows with multi-row INSERT statements
+         *
+         * Rows are split into chunks that fit the bind parameter limit, every chunk is one
+         * statement executed with executeQueryParams(). The statements are not cached:
+         * their text depends on the number of rows.
+         *
+         * @param tableName Table to insert into
+         * @param colNames Names of columns for insertion
+         * @param rows Values of every row, in the order of colNames
+         * @return True if all rows were inserted, false otherwise
+         */
+        bool insertBulk(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) override;
+
         /**
          * @brief Updates data in a table
          *
@@ -95,6 +109,15 @@ namespace cxx {
          */
         virtual std::optional< QueryResult > executeQueryUnsafe(const std::string & query) = 0;
 
+        /**
+         * @brief Whether insertBulk() emits anonymous ? placeholders instead of $N
+         *
+         * @return False by default, backends whose parser looks named parameters up slowly return true
+         */
+        virtual bool anonymousBulkPlaceholders() const noexcept {
+            return false;
+        }
+
     private:
         /**
          * @brief Helper method to execute a function with error checking
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <utils/database/transaction/interface/query_result.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -53,13 +61,47 @@ namespace cxx {
     std::string_view constraintToSql(Col::EConstraint constraint);
 
     /**
-     * @brief Represents the result of a database query
+     * @brief Value bound to a parameter of a prepared statement
+     *
+     * std::monostate binds SQL NULL.
+     */
+    using SqlParam = std::variant< std::monostate, int64_t, double, std::string, bool >;
+
+    /**
+     * @brief Converts a C++ value to a prepared statement parameter
+     *
+     * Integers are widened to int64_t, floating point values to double, anything
+     * convertible to std::string_view is bound as text. std::nullopt, nullptr and
+     * empty std::optional values are bound as NULL.
      *
-     * A two-dimensional vector where the outer vector represents rows
-     * and the inner vector represents columns. Each cell can contain
-     * different types of data.
+     * @param value The value to convert
+     * @return Parameter holding the converted value
      */
-    using QueryResult = std::vector< std::vector< std::variant< int, double, std::string, bool > > >;
+    template < typename T >
+    SqlParam toSqlParam(T && value) {
+        using Type = std::remove_cvref_t< T >;
+        if constexpr (std::is_same_v< Type, SqlParam >) {
+            return std::forward< T >(value);
+        } else if constexpr (std::is_same_v< Type, std::nullopt_t > || std::is_same_v< Type, std::nullptr_t > || std::is_same_v< Type, std::monostate >) {
+            return std::monostate{};
+        } else if constexpr (std::is_same_v< Type, bool >) {
+            return value;
+        } else if constexpr (std::is_integral_v< Type > || std::is_enum_v< Type >) {
+            return static_cast< int64_t >(value);
+        } else if constexpr (std::is_floating_point_v< Type >) {
+            return static_cast< double >(value);
+        } else if constexpr (std::is_same_v< Type, std::string >) {
+            return std::string(std::forward< T >(value));
+        } else if constexpr (std::is_convertible_v< const Type &, std::string_view >) {
+            return std::string(std::string_view(value));
+        } else {
+            // std::optional< U >
+            if (!value.has_value()) {
+                return std::monostate{};
+            }
+            return toSqlParam(*std::forward< T >(value));
+        }
+    }
 
     /**
      * @brief Interface for Database Transaction
@@ -88,6 +130,71 @@ namespace cxx {
          */
         virtual std::optional< QueryResult > executeQuery(const std::string & query) = 0;
 
+        /**
+         * @brief Executes a one-off SQL query with bound parameters
+         *
+         * Parameters are referenced as $1, $2, ... in the SQL text. Unlike prepare() and
+         * execPrepared() the statement is not cached, use it for queries whose text varies.
+         *
+         * @param query The SQL query to execute
+         * @param params Parameter values in order, $1 first
+         * @return Optional result set (empty if the query fails)
+         */
+        virtual std::optional< QueryResult > executeQueryParams(const std::string & query, const std::vector< SqlParam > & params) = 0;
+
+        /**
+         * @brief Callback receiving the rows of a streamed query, returns false to stop reading
+         */
+        using ChunkHandler = std::function< bool(const QueryResult & chunk) >;
+
+        /**
+         * @brief Executes a query and hands its rows over in chunks as they are read
+         *
+         * At most chunkRows rows are held in memory at a time, whatever the size of the
+         * result. Parameters are referenced as $1, $2, ... in the SQL text.
+         *
+         * @param query The SQL query to execute
+         * @param params Parameter values in order, $1 first
+         * @param chunkRows Maximum number of rows in one chunk, at least one
+         * @param onChunk Called with every non-empty chunk in order
+         * @return False if the query failed; stopping early through onChunk is not a failure
+         */
+        virtual bool streamQuery(const std::string & query, const std::vector< SqlParam > & params, std::size_t chunkRows, const ChunkHandler & onChunk) = 0;
+
+        /**
+         * @brief Registers a prepared statement on the underlying connection
+         *
+         * Parameters are referenced as $1, $2, ... in the SQL text. Statements are cached
+         * per connection, so preparing an already known statement is a cheap lookup and
+         * hot queries are parsed and planned only once per connection.
+         *
+         * @param name Unique statement name
+         * @param sql SQL text of the statement
+         * @return True if the statement is ready for execution, false otherwise
+         */
+        virtual bool prepare(const std::string & name, const std::string & sql) = 0;
+
+        /**
+         * @brief Executes a statement registered with prepare()
+         *
+         * @param name Statement name
+         * @param params Parameter values in order, $1 first
+         * @return Optional result set (empty if the statement is unknown or fails)
+         */
+        virtual std::optional< QueryResult > execPreparedParams(const std::string & name, const std::vector< SqlParam > & params) = 0;
+
+        /**
+         * @brief Executes a statement registered with prepare()
+         *
+         * @param name Statement name
+         * @param args Parameter values in order, converted with toSqlParam()
+         * @return Optional result set (empty if the statement is unknown or fails)
+         */
+        template < typename... Args >
+        std::optional< QueryResult > execPrepared(const std::string & name, Args &&... args) {
+            return execPreparedParams(name, std::vector< SqlParam >{ toSqlParam(std::forward< Args >(args))... });
+        }
+
         /**
          * @brief Creates a new table in the database
          * @param name Name of the table to create
@@ -120,6 +227,20 @@ namespace cxx {
          */
         virtual bool insert(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::string > & values) = 0;
 
+        /**
+         * @brief Inserts many rows into a table
+         *
+         * Values are bound with their types instead of being quoted as strings. Rows are sent
+         * in batches of multi-row INSERT statements, backends may use a faster native path
+         * such as COPY for large inputs.
+         *
+         * @param tableName Table to insert into
+         * @param colNames Names of columns for insertion
+         * @param rows Values of every row, in the order of colNames
+         * @return True if all rows were inserted, false otherwise
+         */
+        virtual bool insertBulk(const std::string & tableName, const std::vector< std::string > & colNames, const std::vector< std::vector< SqlParam > > & rows) = 0;
+
         /**
          * @brief Updates data in a table
          * @param tableName Table to update
@@ -0,0 +1,284 @@
+#include "query_result.h"
+
+#include <charconv>
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    template < typename T >
+    T parseNumber(std::string_view text) noexcept {
+        T value{};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+} // unnamed namespace
+
+// Field
+
+QueryResult::Field::Field(const QueryResult & result, const Cell & cell) noexcept
+  : result_(&result)
+  , cell_(&cell) {
+}
+
+QueryResult::EType QueryResult::Field::type() const noexcept {
+    return cell_->type;
+}
+
+bool QueryResult::Field::isNull() const noexcept {
+    return cell_->type == EType::NULL_VALUE;
+}
+
+int32_t QueryResult::Field::asInt32() const noexcept {
+    return static_cast< int32_t >(asInt64());
+}
+
+int64_t QueryResult::Field::asInt64() const noexcept {
+    switch (cell_->type) {
+    case EType::INTEGER:
+    case EType::BOOLEAN:
+        return cell_->integer;
+    case EType::REAL:
+        return static_cast< int64_t >(cell_->real);
+    case EType::TEXT:
+        return parseNumber< int64_t >(asStringView());
+    case EType::NULL_VALUE:
+        break;
+    }
+    return 0;
+}
+
+double QueryResult::Field::asDouble() const noexcept {
+    switch (cell_->type) {
+    case EType::REAL:
+        return cell_->real;
+    case EType::INTEGER:
+    case EType::BOOLEAN:
+        return static_cast< double >(cell_->integer);
+    case EType::TEXT:
+        return parseNumber< double >(asStringView());
+    case EType::NULL_VALUE:
+        break;
+    }
+    return 0.0;
+}
+
+bool QueryResult::Field::asBool() const noexcept {
+    switch (cell_->type) {
+    case EType::INTEGER:
+    case EType::BOOLEAN:
+        return cell_->integer != 0;
+    case EType::REAL:
+        return cell_->real != 0.0;
+    case EType::TEXT: {
+        const auto text = asStringView();
+        return text == "t" || text == "true" || text == "1";
+    }
+    case EType::NULL_VALUE:
+        break;
+    }
+    return false;
+}
+
+std::string_view QueryResult::Field::asStringView() const noexcept {
+    if (cell_->type != EType::TEXT) {
+        return {};
+    }
+    return std::string_view(result_->arena_).substr(cell_->offset, cell_->length);
+}
+
+std::string QueryResult::Field::asString() const {
+    switch (cell_->type) {
+    case EType::TEXT:
+        return std::string(asStringView());
+    case EType::INTEGER:
+    case EType::BOOLEAN:
+        return std::to_string(cell_->integer);
+    case EType::REAL: {
+        char buffer[32];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), cell_->real);
+        return ec == std::errc() ? std::string(buffer, end) : std::string();
+    }
+    case EType::NULL_VALUE:
+        break;
+    }
+    return {};
+}
+
+// Row
+
+QueryResult::Row::Row(const QueryResult & result, std::size_t row) noexcept
+  : result_(&result)
+  , cells_(result.cells_.data() + row * result.columns_) {
+}
+
+std::size_t QueryResult::Row::size() const noexcept {
+    return result_->columns_;
+}
+
+bool QueryResult::Row::empty() const noexcept {
+    return result_->columns_ == 0;
+}
+
+QueryResult::Field QueryResult::Row::operator[](std::size_t column) const noexcept {
+    return Field(*result_, cells_[column]);
+}
+
+QueryResult::Field QueryResult::Row::at(std::size_t column) const {
+    if (column >= result_->columns_) {
+        throw std::out_of_range("QueryResult column index out of range");
+    }
+    return (*this)[column];
+}
+
+// Iterator
+
+QueryResult::Iterator::Iterator(const QueryResult & result, std::size_t row) noexcept
+  : result_(&result)
+  , row_(row) {
+}
+
+QueryResult::Row QueryResult::Iterator::operator*() const noexcept {
+    return Row(*result_, row_);
+}
+
+QueryResult::Row QueryResult::Iterator::operator[](difference_type offset) const noexcept {
+    return Row(*result_, row_ + offset);
+}
+
+QueryResult::Iterator & QueryResult::Iterator::operator++() noexcept {
+    ++row_;
+    return *this;
+}
+
+QueryResult::Iterator QueryResult::Iterator::operator++(int) noexcept {
+    auto copy = *this;
+    ++row_;
+    return copy;
+}
+
+QueryResult::Iterator & QueryResult::Iterator::operator--() noexcept {
+    --row_;
+    return *this;
+}
+
+QueryResult::Iterator QueryResult::Iterator::operator--(int) noexcept {
+    auto copy = *this;
+    --row_;
+    return copy;
+}
+
+QueryResult::Iterator & QueryResult::Iterator::operator+=(difference_type offset) noexcept {
+    row_ += offset;
+    return *this;
+}
+
+QueryResult::Iterator & QueryResult::Iterator::operator-=(difference_type offset) noexcept {
+    row_ -= offset;
+    return *this;
+}
+
+// QueryResult
+
+QueryResult::QueryResult(std::size_t columns)
+  : columns_(columns) {
+}
+
+std::size_t QueryResult::size() const noexcept {
+    return columns_ == 0 ? 0 : cells_.size() / columns_;
+}
+
+bool QueryResult::empty() const noexcept {
+    return size() == 0;
+}
+
+std::size_t QueryResult::columns() const noexcept {
+    return columns_;
+}
+
+QueryResult::Row QueryResult::operator[](std::size_t row) const noexcept {
+    return Row(*this, row);
+}
+
+QueryResult::Row QueryResult::at(std::size_t row) const {
+    if (row >= size()) {
+        throw std::out_of_range("QueryResult row index out of range");
+    }
+    return (*this)[row];
+}
+
+QueryResult::Field QueryResult::at(std::size_t row, std::size_t column) const {
+    return at(row).at(column);
+}
+
+QueryResult::Iterator QueryResult::begin() const noexcept {
+    return Iterator(*this, 0);
+}
+
+QueryResult::Iterator QueryResult::end() const noexcept {
+    return Iterator(*this, size());
+}
+
+void QueryResult::setColumns(std::size_t columns) {
+    if (!cells_.empty()) {
+        throw std::logic_error("QueryResult columns can not be changed after filling");
+    }
+    columns_ = columns;
+}
+
+void QueryResult::reserve(std::size_t rows, std::size_t textBytes) {
+    cells_.reserve(rows * columns_);
+    arena_.reserve(textBytes);
+}
+
+void QueryResult::addNull() {
+    cells_.emplace_back().integer = 0;
+}
+
+void QueryResult::addInt(int64_t value) {
+    auto & cell = cells_.emplace_back();
+    cell.integer = value;
+    cell.type = EType::INTEGER;
+}
+
+void QueryResult::addReal(double value) {
+    auto & cell = cells_.emplace_back();
+    cell.real = value;
+    cell.type = EType::REAL;
+}
+
+void QueryResult::addBool(bool value) {
+    auto & cell = cells_.emplace_back();
+    cell.integer = value ? 1 : 0;
+    cell.type = EType::BOOLEAN;
+}
+
+void QueryResult::addText(std::string_view value) {
+    auto & cell = cells_.emplace_back();
+    cell.offset = arena_.size();
+    cell.length = static_cast< uint32_t >(value.size());
+    cell.type = EType::TEXT;
+    arena_.append(value);
+}
+
+void QueryResult::addIntFromText(std::string_view text) {
+    int64_t value = 0;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec == std::errc() && ptr == text.data() + text.size()) {
+        addInt(value);
+    } else {
+        addText(text);
+    }
+}
+
+void QueryResult::addRealFromText(std::string_view text) {
+    double value = 0.0;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec == std::errc() && ptr == text.data() + text.size()) {
+        addReal(value);
+    } else {
+        addText(text);
+    }
+}
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Represents the result of a database query
+     *
+     * Cells are stored in a single flat array in row-major order, one fixed-size record
+     * per cell. Numbers and booleans are stored inline, text is appended to one contiguous
+     * arena shared by the whole result. A result therefore needs two heap allocations
+     * regardless of the number of rows, instead of one vector per row and one string per cell.
+     *
+     * Drivers fill the result with the add* methods, decoding values directly from
+     * their buffers. Readers access rows through lightweight Row and Field views.
+     * The views are invalidated when the result is modified or destroyed.
+     */
+    class QueryResult final {
+    public:
+        /**
+         * @brief Type of a stored cell
+         */
+        enum class EType : uint8_t {
+            NULL_VALUE, /**< SQL NULL */
+            INTEGER,    /**< 64-bit signed integer */
+            REAL,       /**< Double precision floating point */
+            TEXT,       /**< Text stored in the arena */
+            BOOLEAN     /**< Boolean value */
+        };
+
+    private:
+        /**
+         * @brief Stored cell, 16 bytes
+         */
+        struct Cell {
+            union {
+                int64_t integer;
+                double real;
+                uint64_t offset; /**< Offset of the text in the arena */
+            };
+            uint32_t length = 0; /**< Length of the text */
+            EType type = EType::NULL_VALUE;
+        };
+
+    public:
+        /**
+         * @brief View of a single cell
+         *
+         * Typed accessors convert between representations the same way for every backend:
+         * numbers are parsed from text with std::from_chars, NULL converts to zero, false
+         * or an empty string.
+         */
+        class Field final {
+        public:
+            /**
+             * @brief Type of the stored value
+             */
+            EType type() const noexcept;
+
+            /**
+             * @brief Checks whether the value is SQL NULL
+             */
+            bool isNull() const noexcept;
+
+            /**
+             * @brief Value as 32-bit integer, truncated if stored as a wider or real number
+             */
+            int32_t asInt32() const noexcept;
+
+            /**
+             * @brief Value as 64-bit integer
+             */
+            int64_t asInt64() const noexcept;
+
+            /**
+             * @brief Value as double
+             */
+            double asDouble() const noexcept;
+
+            /**
+             * @brief Value as boolean, text values "t", "true" and "1" are true
+             */
+            bool asBool() const noexcept;
+
+            /**
+             * @brief Text value without copying
+             *
+             * @return View into the result arena for text values, empty view otherwise
+             */
+            std::string_view asStringView() const noexcept;
+
+            /**
+             * @brief Value converted to a string
+             */
+            std::string asString() const;
+
+            /**
+             * @brief Generic accessor for integral, floating point, bool and string types
+             *
+             * @tparam T Requested type
+             * @return Converted value
+             */
+            template < typename T >
+            T as() const {
+                if constexpr (std::is_same_v< T, bool >) {
+                    return asBool();
+                } else if constexpr (std::is_same_v< T, std::string >) {
+                    return asString();
+                } else if constexpr (std::is_same_v< T, std::string_view >) {
+                    return asStringView();
+                } else if constexpr (std::is_floating_point_v< T >) {
+                    return static_cast< T >(asDouble());
+                } else if constexpr (std::is_integral_v< T > && sizeof(T) <= sizeof(int32_t)) {
+                    return static_cast< T >(asInt32());
+                } else {
+                    static_assert(std::is_integral_v< T >, "Unsupported field type");
+                    return static_cast< T >(asInt64());
+                }
+            }
+
+        private:
+            friend class QueryResult;
+
+            Field(const QueryResult & result, const Cell & cell) noexcept;
+
+            const QueryResult * result_;
+            const Cell * cell_;
+        };
+
+        /**
+         * @brief View of a single row
+         */
+        class Row final {
+        public:
+            /**
+             * @brief Number of fields in the row
+             */
+            std::size_t size() const noexcept;
+
+            /**
+             * @brief Checks whether the row has no fields
+             */
+            bool empty() const noexcept;
+
+            /**
+             * @brief Field by column index without bounds checking
+             */
+            Field operator[](std::size_t column) const noexcept;
+
+            /**
+             * @brief Field by column index
+             *
+             * @throws std::out_of_range if the index is out of range
+             */
+            Field at(std::size_t column) const;
+
+        private:
+            friend class QueryResult;
+
+            Row(const QueryResult & result, std::size_t row) noexcept;
+
+            const QueryResult * result_;
+            const Cell * cells_;
+        };
+
+        /**
+         * @brief Random access iterator over rows
+         */
+        class Iterator final {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Row;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Row;
+
+            Iterator() = default;
+
+            Row operator*() const noexcept;
+            Row operator[](difference_type offset) const noexcept;
+
+            Iterator & operator++() noexcept;
+            Iterator operator++(int) noexcept;
+            Iterator & operator--() noexcept;
+            Iterator operator--(int) noexcept;
+            Iterator & operator+=(difference_type offset) noexcept;
+            Iterator & operator-=(difference_type offset) noexcept;
+
+            friend Iterator operator+(Iterator it, difference_type offset) noexcept {
+                return it += offset;
+            }
+
+            friend Iterator operator+(difference_type offset, Iterator it) noexcept {
+                return it += offset;
+            }
+
+            friend Iterator operator-(Iterator it, difference_type offset) noexcept {
+                return it -= offset;
+            }
+
+            friend difference_type operator-(const Iterator & lhs, const Iterator & rhs) noexcept {
+                return static_cast< difference_type >(lhs.row_) - static_cast< difference_type >(rhs.row_);
+            }
+
+            friend bool operator==(const Iterator & lhs, const Iterator & rhs) noexcept {
+                return lhs.row_ == rhs.row_;
+            }
+
+            friend auto operator<=>(const Iterator & lhs, const Iterator & rhs) noexcept {
+                return lhs.row_ <=> rhs.row_;
+            }
+
+        private:
+            friend class QueryResult;
+
+            Iterator(const QueryResult & result, std::size_t row) noexcept;
+
+            const QueryResult * result_ = nullptr;
+            std::size_t row_ = 0;
+        };
+
+    public:
+        /**
+         * @brief Constructs an empty result without columns
+         */
+        QueryResult() = default;
+
+        /**
+         * @brief Constructs an empty result with a fixed number of columns
+         *
+         * @param columns Number of fields in every row
+         */
+        explicit QueryResult(std::size_t columns);
+
+        /**
+         * @brief Number of rows
+         */
+        std::size_t size() const noexcept;
+
+        /**
+         * @brief Checks whether the result has no rows
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Number of fields in every row
+         */
+        std::size_t columns() const noexcept;
+
+        /**
+         * @brief Row by index without bounds checking
+         */
+        Row operator[](std::size_t row) const noexcept;
+
+        /**
+         * @brief Row by index
+         *
+         * @throws std::out_of_range if the index is out of range
+         */
+        Row at(std::size_t row) const;
+
+        /**
+         * @brief Field by row and column index
+         *
+         * @throws std::out_of_range if an index is out of range
+         */
+        Field at(std::size_t row, std::size_t column) const;
+
+        Iterator begin() const noexcept;
+        Iterator end() const noexcept;
+
+        // Filling, used by database drivers
+
+        /**
+         * @brief Sets the number of columns of an empty result
+         *
+         * @param columns Number of fields in every row
+         */
+        void setColumns(std::size_t columns);
+
+        /**
+         * @brief Reserves memory for rows and text
+         *
+         * @param rows Expected number of rows
+         * @param textBytes Expected total size of text values
+         */
+        void reserve(std::size_t rows, std::size_t textBytes = 0);
+
+        /**
+         * @brief Appends a NULL cell to the current row
+         */
+        void addNull();
+
+        /**
+         * @brief Appends an integer cell to the current row
+         */
+        void addInt(int64_t value);
+
+        /**
+         * @brief Appends a real cell to the current row
+         */
+        void addReal(double value);
+
+        /**
+         * @brief Appends a boolean cell to the current row
+         */
+        void addBool(bool value);
+
+        /**
+         * @brief Appends a text cell to the current row, the text is copied into the arena
+         */
+        void addText(std::string_view value);
+
+        /**
+         * @brief Appends an integer cell parsed from text, stored as text if parsing fails
+         */
+        void addIntFromText(std::string_view text);
+
+        /**
+         * @brief Appends a real cell parsed from text, stored as text if parsing fails
+         */
+        void addRealFromText(std::string_view text);
+
+    private:
+        std::size_t columns_ = 0;
+        std::vector< Cell > cells_;
+        std::string arena_;
+    };
+
+} // namespace cxx
@@ -0,0 +1,63 @@
+#include <utils/executor/thread_pool/thread_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+using namespace cxx;
+
+TEST(ThreadPoolTest, ExecutesAllTasks) {
+    std::atomic< int > counter = 0;
+    {
+        ThreadPool pool(4);
+        EXPECT_EQ(pool.threadCount(), 4);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_TRUE(pool.submit([&counter]() {
+                ++counter;
+            }));
+        }
+    }
+    EXPECT_EQ(counter, 1000);
+}
+
+TEST(ThreadPoolTest, RejectsWhenQueueIsFull) {
+    ThreadPool pool(1, 1);
+
+    std::promise< void > release;
+    auto released = release.get_future().share();
+    std::promise< void > started;
+
+    ASSERT_TRUE(pool.submit([&started, released]() {
+        started.set_value();
+        released.wait();
+    }));
+    started.get_future().wait();
+
+    EXPECT_TRUE(pool.submit([]() {}));
+    EXPECT_FALSE(pool.submit([]() {}));
+    EXPECT_EQ(pool.queueSize(), 1);
+
+    release.set_value();
+}
+
+TEST(ThreadPoolTest, RejectsAfterShutdown) {
+    ThreadPool pool(2);
+    pool.shutdown();
+    EXPECT_FALSE(pool.submit([]() {}));
+}
+
+TEST(ThreadPoolTest, SurvivesThrowingTasks) {
+    ThreadPool pool(1);
+    ASSERT_TRUE(pool.submit([]() {
+        throw std::runtime_error("task failure");
+    }));
+
+    std::promise< int > result;
+    ASSERT_TRUE(pool.submit([&result]() {
+        result.set_value(42);
+    }));
+    EXPECT_EQ(result.get_future().get(), 42);
+}
@@ -0,0 +1,81 @@
+#include "thread_pool.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+
+using namespace cxx;
+
+ThreadPool::ThreadPool(std::size_t threads, std::size_t maxQueueSize)
+  : maxQueueSize_(maxQueueSize) {
+    threads = std::max< std::size_t >(threads, 1);
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+bool ThreadPool::submit(Task task) {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopped_ || (maxQueueSize_ != 0 && tasks_.size() >= maxQueueSize_)) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+    return true;
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    available_.notify_all();
+
+    for (auto & worker: workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+std::size_t ThreadPool::threadCount() const noexcept {
+    return workers_.size();
+}
+
+std::size_t ThreadPool::queueSize() const {
+    std::lock_guard lock(mutex_);
+    return tasks_.size();
+}
+
+void ThreadPool::run() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(mutex_);
+            available_.wait(lock, [this]() {
+                return stopped_ || !tasks_.empty();
+            });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception & e) {
+            SPDLOG_ERROR("Thread pool task failed: {}", e.what());
+        } catch (...) {
+            SPDLOG_ERROR("Thread pool task failed with unknown exception");
+        }
+    }
+}
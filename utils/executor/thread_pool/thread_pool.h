@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Fixed-size pool of worker threads executing tasks in FIFO order
+     *
+     * The queue may be bounded: when it is full, submit() rejects the task instead of
+     * blocking the caller, so producers running on latency-sensitive threads can fail
+     * fast. Exceptions thrown by tasks are logged and do not terminate the worker.
+     */
+    class ThreadPool final {
+    public:
+        using Task = std::function< void() >;
+
+    public:
+        /**
+         * @brief Starts the worker threads
+         *
+         * @param threads Number of worker threads, at least one thread is started
+         * @param maxQueueSize Maximum number of pending tasks, zero means unbounded
+         */
+        explicit ThreadPool(std::size_t threads, std::size_t maxQueueSize = 0);
+
+        /**
+         * @brief Executes the pending tasks and joins the workers
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool & operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief Enqueues a task
+         *
+         * @param task Task to execute
+         * @return False if the pool is shut down or the queue is full
+         */
+        bool submit(Task task);
+
+        /**
+         * @brief Stops accepting tasks, executes the pending ones and joins the workers
+         *
+         * Must not be called from a worker thread.
+         */
+        void shutdown();
+
+        /**
+         * @brief Number of worker threads
+         */
+        std::size_t threadCount() const noexcept;
+
+        /**
+         * @brief Number of tasks waiting for a worker
+         */
+        std::size_t queueSize() const;
+
+    private:
+        void run();
+
+    private:
+        const std::size_t maxQueueSize_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable available_;
+        std::deque< Task > tasks_;
+        bool stopped_ = false;
+
+        std::vector< std::thread > workers_;
+    };
+
+} // namespace cxx
@@ -111,6 +111,7 @@ IHttpClient::Response CurlHttpClient::performRequest(const std::string & url, co
     Response response;
     std::string responseBody;
 
+    std::lock_guard lock(mutex_);
     curl_easy_reset(curl_);
 
     // Set URL
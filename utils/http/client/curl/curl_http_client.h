@@ -4,6 +4,7 @@
 
 #include <curl/curl.h>
 
+#include <mutex>
 #include <string>
 
 namespace cxx {
@@ -123,6 +124,9 @@ namespace cxx {
         /** @brief The CURL handle used for HTTP operations. */
         CURL * curl_;
 
+        /** @brief Serializes requests, a CURL easy handle must not be used by several threads at once. */
+        std::mutex mutex_;
+
         /**
          * @brief Internal method to perform HTTP requests.
          *
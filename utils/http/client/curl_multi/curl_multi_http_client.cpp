@@ -0,0 +1,341 @@
+#include "curl_multi_http_client.h"
+
+#include <utils/string/trim.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    const IHttpClient::Headers DEFAULT_HEADERS = {
+        { "User-Agent", "CurlMultiHttpClient/1.0" }
+    };
+
+    // Upper bound of a single wait, requests queued meanwhile wake the loop up immediately
+    constexpr int POLL_TIMEOUT_MS = 1000;
+
+    size_t writeCallback(void * contents, size_t size, size_t nmemb, std::string * userp) {
+        userp->append(static_cast< char * >(contents), size * nmemb);
+        return size * nmemb;
+    }
+
+    size_t headerCallback(char * buffer, size_t size, size_t nitems, IHttpClient::Headers * headers) {
+        const size_t headerSize = size * nitems;
+        std::string header(buffer, headerSize);
+
+        // Remove trailing \r\n
+        if (header.size() >= 2 && header.compare(header.size() - 2, 2, "\r\n") == 0) {
+            header.resize(header.size() - 2);
+        }
+
+        const size_t colonPos = header.find(':');
+        if (colonPos != std::string::npos) {
+            std::string name = header.substr(0, colonPos);
+            std::string value = header.substr(colonPos + 1);
+
+            ltrim(value);
+            rtrim(name);
+            rtrim(value);
+
+            (*headers)[name] = value;
+        }
+
+        return headerSize;
+    }
+
+    IHttpClient::Headers mergeHeaders(const IHttpClient::Headers & init, IHttpClient::Headers over) {
+        over.insert(init.begin(), init.end());
+        return over;
+    }
+
+    struct curl_slist * headersToCurlList(const IHttpClient::Headers & headers) {
+        struct curl_slist * curlHeaders = nullptr;
+
+        for (const auto & header: headers) {
+            const std::string headerStr = header.first + ": " + header.second;
+            curlHeaders = curl_slist_append(curlHeaders, headerStr.c_str());
+        }
+
+        return curlHeaders;
+    }
+
+    std::exception_ptr makeError(const std::string & message) {
+        return std::make_exception_ptr(std::runtime_error(message));
+    }
+
+} // unnamed namespace
+
+CurlMultiHttpClient::CurlMultiHttpClient(Settings settings, Headers initialHeaders)
+  : settings_(std::move(settings))
+  , initialHeaders_(mergeHeaders(DEFAULT_HEADERS, std::move(initialHeaders)))
+  , share_(nullptr)
+  , multi_(nullptr) {
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    share_ = curl_share_init();
+    multi_ = curl_multi_init();
+    if (!share_ || !multi_) {
+        if (multi_) {
+            curl_multi_cleanup(multi_);
+        }
+        if (share_) {
+            curl_share_cleanup(share_);
+        }
+        curl_global_cleanup();
+        throw std::runtime_error("Failed to initialize curl");
+    }
+
+    // All easy handles are used by the event loop thread only, so the share needs no lock callbacks.
+    // Connections are already pooled by the multi handle for every handle added to it.
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, settings_.maxHostConnections);
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+
+    idleHandles_.reserve(settings_.maxTransfers);
+    loop_ = std::thread(&CurlMultiHttpClient::run, this);
+}
+
+CurlMultiHttpClient::~CurlMultiHttpClient() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+    curl_multi_wakeup(multi_);
+    if (loop_.joinable()) {
+        loop_.join();
+    }
+
+    for (CURL * easy: idleHandles_) {
+        curl_easy_cleanup(easy);
+    }
+    curl_multi_cleanup(multi_);
+    curl_share_cleanup(share_);
+    curl_global_cleanup();
+}
+
+void CurlMultiHttpClient::async(Request request, Callback callback) {
+    auto transfer = std::make_unique< Transfer >();
+    transfer->request = std::move(request);
+    transfer->callback = std::move(callback);
+
+    {
+        std::lock_guard lock(mutex_);
+        if (!stopped_) {
+            pending_.push_back(std::move(transfer));
+        }
+    }
+    if (transfer) {
+        transfer->callback(makeError("HTTP client is stopped"), {});
+        return;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future< IHttpClient::Response > CurlMultiHttpClient::async(Request request) {
+    auto promise = std::make_shared< std::promise< Response > >();
+    auto future = promise->get_future();
+    async(std::move(request), [promise](std::exception_ptr error, Response response) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(std::move(response));
+        }
+    });
+    return future;
+}
+
+IHttpClient::Response CurlMultiHttpClient::get(const std::string & url, Headers headers) {
+    return perform({ .method = "GET", .url = url, .body = {}, .headers = std::move(headers) });
+}
+
+IHttpClient::Response CurlMultiHttpClient::post(const std::string & url, const std::string & body, Headers headers) {
+    return perform({ .method = "POST", .url = url, .body = body, .headers = std::move(headers) });
+}
+
+IHttpClient::Response CurlMultiHttpClient::put(const std::string & url, const std::string & body, Headers headers) {
+    return perform({ .method = "PUT", .url = url, .body = body, .headers = std::move(headers) });
+}
+
+IHttpClient::Response CurlMultiHttpClient::del(const std::string & url, Headers headers) {
+    return perform({ .method = "DELETE", .url = url, .body = {}, .headers = std::move(headers) });
+}
+
+std::size_t CurlMultiHttpClient::activeTransfers() const {
+    std::lock_guard lock(mutex_);
+    return active_;
+}
+
+IHttpClient::Response CurlMultiHttpClient::perform(Request request) {
+    return async(std::move(request)).get();
+}
+
+void CurlMultiHttpClient::run() {
+    while (true) {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopped_) {
+                break;
+            }
+        }
+
+        startPending();
+
+        int stillRunning = 0;
+        const CURLMcode code = curl_multi_perform(multi_, &stillRunning);
+        if (code != CURLM_OK) {
+            SPDLOG_ERROR("curl_multi_perform() failed: {}", curl_multi_strerror(code));
+        }
+
+        int messagesLeft = 0;
+        while (CURLMsg * message = curl_multi_info_read(multi_, &messagesLeft)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL * easy = message->easy_handle;
+            const CURLcode result = message->data.result;
+
+            Transfer * transfer = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &transfer);
+            if (result != CURLE_OK) {
+                complete(transfer, makeError(std::string("curl transfer failed: ") + curl_easy_strerror(result)));
+                continue;
+            }
+
+            long statusCode = 0;
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &statusCode);
+            transfer->response.statusCode = static_cast< int >(statusCode);
+            complete(transfer, nullptr);
+        }
+
+        curl_multi_poll(multi_, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
+    }
+
+    // Fail everything left, callbacks may not outlive the client
+    while (!running_.empty()) {
+        complete(running_.back().get(), makeError("HTTP client is stopped"));
+    }
+
+    std::deque< std::unique_ptr< Transfer > > pending;
+    {
+        std::lock_guard lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto & transfer: pending) {
+        transfer->callback(makeError("HTTP client is stopped"), {});
+    }
+}
+
+void CurlMultiHttpClient::startPending() {
+    while (true) {
+        std::unique_ptr< Transfer > transfer;
+        {
+            std::lock_guard lock(mutex_);
+            if (pending_.empty() || running_.size() >= settings_.maxTransfers) {
+                return;
+            }
+            transfer = std::move(pending_.front());
+            pending_.pop_front();
+            ++active_;
+        }
+        start(std::move(transfer));
+    }
+}
+
+void CurlMultiHttpClient::start(std::unique_ptr< Transfer > transfer) {
+    CURL * easy = acquireHandle();
+    if (!easy) {
+        {
+            std::lock_guard lock(mutex_);
+            --active_;
+        }
+        transfer->callback(makeError("Failed to initialize curl"), {});
+        return;
+    }
+
+    auto & request = transfer->request;
+    transfer->easy = easy;
+
+    // Reset keeps live connections, they belong to the multi handle
+    curl_easy_reset(easy);
+    curl_easy_setopt(easy, CURLOPT_SHARE, share_);
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, &transfer->response.body);
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer->response.headers);
+
+    // Request headers over client headers
+    transfer->headers = headersToCurlList(mergeHeaders(initialHeaders_, std::move(request.headers)));
+    if (transfer->headers) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+    }
+
+    if (request.method != "GET") {
+        curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    }
+    if ((request.method == "POST" || request.method == "PUT") && !request.body.empty()) {
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast< long >(request.body.length()));
+    }
+
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, settings_.followRedirects ? 1L : 0L);
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, settings_.verifySSL ? 1L : 0L);
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, settings_.verifySSL ? 2L : 0L);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, settings_.connectTimeout);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT, settings_.timeout);
+    curl_easy_setopt(easy, CURLOPT_VERBOSE, settings_.verbose ? 1L : 0L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+
+    const CURLMcode code = curl_multi_add_handle(multi_, easy);
+    Transfer * raw = transfer.get();
+    running_.push_back(std::move(transfer));
+    if (code != CURLM_OK) {
+        complete(raw, makeError(std::string("curl_multi_add_handle() failed: ") + curl_multi_strerror(code)));
+    }
+}
+
+void CurlMultiHttpClient::complete(Transfer * transfer, std::exception_ptr error) {
+    const auto it = std::find_if(running_.begin(), running_.end(), [transfer](const auto & item) {
+        return item.get() == transfer;
+    });
+    if (it == running_.end()) {
+        return;
+    }
+    std::unique_ptr< Transfer > owned = std::move(*it);
+    running_.erase(it);
+
+    curl_multi_remove_handle(multi_, owned->easy);
+    if (owned->headers) {
+        curl_slist_free_all(owned->headers);
+        owned->headers = nullptr;
+    }
+    idleHandles_.push_back(owned->easy);
+
+    {
+        std::lock_guard lock(mutex_);
+        --active_;
+    }
+
+    try {
+        owned->callback(error, error ? Response{} : std::move(owned->response));
+    } catch (const std::exception & e) {
+        SPDLOG_ERROR("HTTP callback failed: {}", e.what());
+    }
+}
+
+CURL * CurlMultiHttpClient::acquireHandle() {
+    if (!idleHandles_.empty()) {
+        CURL * easy = idleHandles_.back();
+        idleHandles_.pop_back();
+        return easy;
+    }
+    return curl_easy_init();
+}
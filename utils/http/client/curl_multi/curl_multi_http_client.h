@@ -0,0 +1,240 @@
+#pragma once
+
+#include <utils/http/client/interface/i_http_client.h>
+
+#include <curl/curl.h>
+
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @class CurlMultiHttpClient
+     * @brief Concurrent HTTP client driving all transfers on one curl_multi event loop.
+     *
+     * Requests are queued from any thread and executed by a single background thread,
+     * so one client keeps many requests in flight without a thread per request.
+     * Easy handles are pooled and reused. Connections are kept alive in the connection
+     * cache of the multi handle, DNS and TLS session caches are shared between the handles
+     * through a CURLSH share handle.
+     *
+     * The blocking IHttpClient methods are thread-safe and wait for their own transfer
+     * only, so several threads calling them concurrently are multiplexed on the same loop.
+     */
+    class CurlMultiHttpClient final: public IHttpClient {
+    public:
+        /**
+         * @struct Settings
+         * @brief Configuration settings for the HTTP client.
+         */
+        struct Settings {
+            /** @brief Whether to follow HTTP redirects. Default is true. */
+            bool followRedirects = true;
+
+            /** @brief Whether to verify SSL certificates. Default is true. */
+            bool verifySSL = true;
+
+            /** @brief Connection timeout in seconds. Default is 10 seconds. */
+            long connectTimeout = 10;
+
+            /** @brief Operation timeout in seconds. Default is 30 seconds. */
+            long timeout = 30;
+
+            /** @brief Enable verbose output for debugging. Default is false. */
+            bool verbose = false;
+
+            /** @brief Max transfers in flight, further requests wait in the queue. Default is 64. */
+            std::size_t maxTransfers = 64;
+
+            /** @brief Max open connections to a single host, 0 for no limit. Default is 0. */
+            long maxHostConnections = 0;
+        };
+
+        /**
+         * @struct Request
+         * @brief Description of a single HTTP request.
+         */
+        struct Request {
+            /** @brief HTTP method (GET, POST, PUT, DELETE). */
+            std::string method = "GET";
+
+            /** @brief The URL to request. */
+            std::string url;
+
+            /** @brief The request body (for POST and PUT requests). */
+            std::string body;
+
+            /** @brief Additional headers to include in this request. */
+            Headers headers;
+        };
+
+        /**
+         * @brief Completion callback, error is set if the transfer failed.
+         *
+         * Callbacks run on the event loop thread and must not block.
+         */
+        using Callback = std::function< void(std::exception_ptr error, Response response) >;
+
+        /**
+         * @brief Constructs a CurlMultiHttpClient and starts its event loop.
+         *
+         * @param settings Configuration settings for the HTTP client.
+         * @param initialHeaders Headers to be included in every request.
+         * @throw std::runtime_error If curl initialization fails.
+         */
+        explicit CurlMultiHttpClient(
+         Settings settings,
+         Headers initialHeaders = {});
+
+        /**
+         * @brief Stops the event loop, unfinished requests fail with an error.
+         */
+        ~CurlMultiHttpClient() override;
+
+        CurlMultiHttpClient(const CurlMultiHttpClient &) = delete;
+        CurlMultiHttpClient & operator=(const CurlMultiHttpClient &) = delete;
+
+        /**
+         * @brief Queues a request and returns immediately.
+         *
+         * @param request The request to perform.
+         * @param callback Called once with the response or the error.
+         */
+        void async(Request request, Callback callback);
+
+        /**
+         * @brief Queues a request and returns a future for its response.
+         *
+         * @param request The request to perform.
+         * @return std::future< Response > Response, holds std::runtime_error if the request fails.
+         */
+        std::future< Response > async(Request request);
+
+        // IHttpClient interface implementation
+
+        /**
+         * @brief Performs an HTTP GET request.
+         *
+         * @param url The URL to request.
+         * @param headers Additional headers to include in this request.
+         * @return Response The HTTP response with status code, body, and headers.
+         * @throw std::runtime_error If the request fails.
+         */
+        Response get(const std::string & url, Headers headers = {}) override;
+
+        /**
+         * @brief Performs an HTTP POST request.
+         *
+         * @param url The URL to request.
+         * @param body The request body to send.
+         * @param headers Additional headers to include in this request.
+         * @return Response The HTTP response with status code, body, and headers.
+         * @throw std::runtime_error If the request fails.
+         */
+        Response post(const std::string & url, const std::string & body, Headers headers = {}) override;
+
+        /**
+         * @brief Performs an HTTP PUT request.
+         *
+         * @param url The URL to request.
+         * @param body The request body to send.
+         * @param headers Additional headers to include in this request.
+         * @return Response The HTTP response with status code, body, and headers.
+         * @throw std::runtime_error If the request fails.
+         */
+        Response put(const std::string & url, const std::string & body, Headers headers = {}) override;
+
+        /**
+         * @brief Performs an HTTP DELETE request.
+         *
+         * @param url The URL to request.
+         * @param headers Additional headers to include in this request.
+         * @return Response The HTTP response with status code, body, and headers.
+         * @throw std::runtime_error If the request fails.
+         */
+        Response del(const std::string & url, Headers headers = {}) override;
+
+        /**
+         * @brief Number of transfers currently running on the event loop.
+         */
+        std::size_t activeTransfers() const;
+
+    private:
+        /**
+         * @brief State of a running transfer, owned by the event loop.
+         */
+        struct Transfer {
+            Request request;
+            Callback callback;
+            CURL * easy = nullptr;
+            struct curl_slist * headers = nullptr;
+            Response response;
+        };
+
+        /**
+         * @brief Event loop: starts queued requests, polls the multi handle and completes transfers.
+         */
+        void run();
+
+        /**
+         * @brief Moves queued requests to the multi handle while below Settings::maxTransfers.
+         */
+        void startPending();
+
+        /**
+         * @brief Configures a pooled easy handle for the transfer and adds it to the multi handle.
+         */
+        void start(std::unique_ptr< Transfer > transfer);
+
+        /**
+         * @brief Finishes the transfer, returns its handle to the pool and invokes the callback.
+         */
+        void complete(Transfer * transfer, std::exception_ptr error);
+
+        /**
+         * @brief Takes an idle easy handle from the pool or creates a new one.
+         */
+        CURL * acquireHandle();
+
+        /**
+         * @brief Queues a request and waits for its response.
+         */
+        Response perform(Request request);
+
+    private:
+        /** @brief Client configuration settings. */
+        const Settings settings_;
+
+        /** @brief Headers to be included in every request. */
+        const Headers initialHeaders_;
+
+        /** @brief Share handle with the DNS and TLS session caches. */
+        CURLSH * share_;
+
+        /** @brief Multi handle driving all transfers. */
+        CURLM * multi_;
+
+        /** @brief Idle easy handles, used only by the event loop. */
+        std::vector< CURL * > idleHandles_;
+
+        /** @brief Running transfers, used only by the event loop. */
+        std::vector< std::unique_ptr< Transfer > > running_;
+
+        mutable std::mutex mutex_;
+        std::deque< std::unique_ptr< Transfer > > pending_;
+        std::size_t active_ = 0;
+        bool stopped_ = false;
+
+        std::thread loop_;
+    };
+
+} // namespace cxx
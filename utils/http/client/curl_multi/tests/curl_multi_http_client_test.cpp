@@ -0,0 +1,116 @@
+#include <utils/http/client/curl_multi/curl_multi_http_client.h>
+#include <utils/http/server/test/test_http_server.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cxx;
+
+namespace {
+
+    class CurlMultiHttpClientTest: public ::testing::Test {
+    protected:
+        void SetUp() override {
+            testServer_ = std::make_unique< TestHttpServer >(8081);
+            testServer_->setResponse(
+             200,
+             "Test Response",
+             {
+              { "Content-Type", "text/plain" }
+            });
+
+            CurlMultiHttpClient::Settings settings;
+            settings.verifySSL = false;
+            settings.connectTimeout = 2;
+            settings.timeout = 5;
+            settings.maxTransfers = 4;
+
+            client_ = std::make_unique< CurlMultiHttpClient >(settings, IHttpClient::Headers{ { "User-Agent", "TestAgent/1.0" } });
+        }
+
+        void TearDown() override {
+            client_.reset();
+            testServer_.reset();
+        }
+
+    protected:
+        std::unique_ptr< TestHttpServer > testServer_;
+        std::unique_ptr< CurlMultiHttpClient > client_;
+    };
+
+} // unnamed namespace
+
+TEST_F(CurlMultiHttpClientTest, BlockingGetRequest) {
+    auto response = client_->get(testServer_->getBaseUrl() + "/test", { { "X-Custom-Header", "custom-value" } });
+
+    EXPECT_EQ(200, response.statusCode);
+    EXPECT_EQ("Test Response", response.body);
+    EXPECT_EQ("text/plain", response.headers["Content-Type"]);
+
+    EXPECT_EQ("GET", testServer_->getLastRequestMethod());
+    EXPECT_EQ("/test", testServer_->getLastRequestPath());
+    EXPECT_EQ("custom-value", testServer_->getLastRequestHeaders().at("X-Custom-Header"));
+    EXPECT_EQ("TestAgent/1.0", testServer_->getLastRequestHeaders().at("User-Agent"));
+}
+
+TEST_F(CurlMultiHttpClientTest, FuturePostRequest) {
+    testServer_->setResponse(201, "{\"id\": 123}", { { "Content-Type", "application/json" } });
+
+    auto future = client_->async({ .method = "POST", .url = testServer_->getBaseUrl() + "/resource", .body = "{\"name\": \"test\"}", .headers = {} });
+    const auto response = future.get();
+
+    EXPECT_EQ(201, response.statusCode);
+    EXPECT_EQ("{\"id\": 123}", response.body);
+    EXPECT_EQ("POST", testServer_->getLastRequestMethod());
+    EXPECT_EQ("{\"name\": \"test\"}", testServer_->getLastRequestBody());
+}
+
+TEST_F(CurlMultiHttpClientTest, ManyConcurrentRequests) {
+    constexpr int REQUESTS = 16;
+
+    std::vector< std::future< IHttpClient::Response > > futures;
+    for (int i = 0; i < REQUESTS; ++i) {
+        futures.push_back(client_->async({ .method = "GET", .url = testServer_->getBaseUrl() + "/item/" + std::to_string(i), .body = {}, .headers = {} }));
+    }
+
+    for (auto & future: futures) {
+        const auto response = future.get();
+        EXPECT_EQ(200, response.statusCode);
+        EXPECT_EQ("Test Response", response.body);
+    }
+    EXPECT_EQ(client_->activeTransfers(), 0);
+}
+
+TEST_F(CurlMultiHttpClientTest, BlockingCallsFromSeveralThreads) {
+    std::atomic< int > succeeded = 0;
+    std::vector< std::thread > threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([this, &succeeded]() {
+            for (int j = 0; j < 4; ++j) {
+                if (client_->get(testServer_->getBaseUrl() + "/test").statusCode == 200) {
+                    ++succeeded;
+                }
+            }
+        });
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(succeeded, 16);
+}
+
+TEST_F(CurlMultiHttpClientTest, CallbackReceivesTransferError) {
+    std::promise< bool > failed;
+    client_->async({ .method = "GET", .url = "http://127.0.0.1:1/unreachable", .body = {}, .headers = {} }, [&failed](std::exception_ptr error, IHttpClient::Response) {
+        failed.set_value(error != nullptr);
+    });
+
+    EXPECT_TRUE(failed.get_future().get());
+    EXPECT_THROW(client_->get("http://127.0.0.1:1/unreachable"), std::runtime_error);
+}
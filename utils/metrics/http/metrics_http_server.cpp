@@ -0,0 +1,128 @@
+#include "metrics_http_server.h"
+
+#include <spdlog/spdlog.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    constexpr std::size_t MAX_REQUEST_SIZE = 8192;
+    constexpr int POLL_TIMEOUT_MS = 100;
+
+    std::string makeResponse(const std::string & status, const std::string & contentType, const std::string & body) {
+        std::string response = "HTTP/1.1 " + status + "\r\n";
+        response += "Content-Type: " + contentType + "\r\n";
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        response += body;
+        return response;
+    }
+
+    void sendAll(int fd, const std::string & data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const auto bytes = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (bytes <= 0) {
+                return;
+            }
+            sent += static_cast< std::size_t >(bytes);
+        }
+    }
+
+} // unnamed namespace
+
+MetricsHttpServer::MetricsHttpServer(const MetricsRegistry & registry, int port, const std::string & address)
+  : registry_(registry) {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        throw std::runtime_error("Failed to create metrics socket");
+    }
+
+    int opt = 1;
+    setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast< uint16_t >(port));
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1
+        || bind(listenFd_, reinterpret_cast< sockaddr * >(&addr), sizeof(addr)) < 0
+        || listen(listenFd_, 16) < 0) {
+        const std::string error = std::strerror(errno);
+        close(listenFd_);
+        throw std::runtime_error("Failed to listen for metrics on " + address + ":" + std::to_string(port) + ": " + error);
+    }
+
+    socklen_t length = sizeof(addr);
+    getsockname(listenFd_, reinterpret_cast< sockaddr * >(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+
+    thread_ = std::thread(&MetricsHttpServer::run, this);
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close(listenFd_);
+}
+
+int MetricsHttpServer::port() const noexcept {
+    return port_;
+}
+
+void MetricsHttpServer::run() {
+    while (running_) {
+        pollfd pfd{ .fd = listenFd_, .events = POLLIN, .revents = 0 };
+        if (poll(&pfd, 1, POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+
+        const int clientFd = accept(listenFd_, nullptr, nullptr);
+        if (clientFd < 0) {
+            continue;
+        }
+        handleConnection(clientFd);
+        close(clientFd);
+    }
+}
+
+void MetricsHttpServer::handleConnection(int clientFd) {
+    // A slow client must not block the scrape loop forever
+    timeval timeout{ .tv_sec = 1, .tv_usec = 0 };
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        const auto bytes = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (bytes <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast< std::size_t >(bytes));
+    }
+
+    const auto lineEnd = request.find("\r\n");
+    const auto requestLine = request.substr(0, lineEnd);
+    const auto methodEnd = requestLine.find(' ');
+    const auto pathEnd = requestLine.find(' ', methodEnd + 1);
+    const auto method = requestLine.substr(0, methodEnd);
+    const auto path = methodEnd == std::string::npos ? std::string() : requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+
+    if (method == "GET" && (path == "/metrics" || path.starts_with("/metrics?"))) {
+        sendAll(clientFd, makeResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", registry_.renderPrometheus()));
+    } else {
+        SPDLOG_DEBUG("Metrics server: unexpected request {}", requestLine);
+        sendAll(clientFd, makeResponse("404 Not Found", "text/plain", "Not Found\n"));
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <utils/metrics/registry/metrics_registry.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace cxx {
+
+    /**
+     * @brief Minimal HTTP server exposing a MetricsRegistry for Prometheus scraping
+     *
+     * Answers GET /metrics with the registry rendered in the text exposition format and
+     * 404 to everything else. Requests are served one by one on a background thread,
+     * which is enough for a scraper polling every few seconds.
+     */
+    class MetricsHttpServer final {
+    public:
+        /**
+         * @brief Binds the socket and starts serving
+         *
+         * @param registry Registry to expose, must outlive the server
+         * @param port TCP port, zero picks a free one
+         * @param address IPv4 address to bind, loopback by default
+         * @throws std::runtime_error if the socket cannot be bound
+         */
+        MetricsHttpServer(const MetricsRegistry & registry, int port, const std::string & address = "127.0.0.1");
+
+        /**
+         * @brief Stops serving and closes the socket
+         */
+        ~MetricsHttpServer();
+
+        MetricsHttpServer(const MetricsHttpServer &) = delete;
+        MetricsHttpServer & operator=(const MetricsHttpServer &) = delete;
+
+        /**
+         * @brief Port the server listens on
+         */
+        int port() const noexcept;
+
+    private:
+        void run();
+
+        /**
+         * @brief Reads one request from the client and sends the response
+         */
+        void handleConnection(int clientFd);
+
+    private:
+        const MetricsRegistry & registry_;
+        int listenFd_ = -1;
+        int port_ = 0;
+        std::atomic< bool > running_{ true };
+        std::thread thread_;
+    };
+
+} // namespace cxx
@@ -0,0 +1,45 @@
+#include <utils/http/client/curl/curl_http_client.h>
+#include <utils/metrics/http/metrics_http_server.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    class MetricsHttpServerTest: public ::testing::Test {
+    protected:
+        std::string url(const std::string & path) const {
+            return "http://127.0.0.1:" + std::to_string(server_.port()) + path;
+        }
+
+    protected:
+        MetricsRegistry registry_;
+        MetricsHttpServer server_{ registry_, 0 };
+        CurlHttpClient client_{ CurlHttpClient::Settings{} };
+    };
+
+} // unnamed namespace
+
+TEST_F(MetricsHttpServerTest, ServesRegistry) {
+    registry_.counter("requests_total", "Requests").inc(3);
+
+    const auto response = client_.get(url("/metrics"));
+    EXPECT_EQ(response.statusCode, 200);
+    EXPECT_EQ(response.headers.at("Content-Type"), "text/plain; version=0.0.4; charset=utf-8");
+    EXPECT_NE(response.body.find("requests_total 3\n"), std::string::npos);
+
+    registry_.counter("requests_total", "Requests").inc();
+    EXPECT_NE(client_.get(url("/metrics")).body.find("requests_total 4\n"), std::string::npos);
+}
+
+TEST_F(MetricsHttpServerTest, UnknownPathIsNotFound) {
+    EXPECT_EQ(client_.get(url("/")).statusCode, 404);
+    EXPECT_EQ(client_.post(url("/metrics"), "").statusCode, 404);
+}
+
+TEST_F(MetricsHttpServerTest, BusyPortIsReported) {
+    EXPECT_THROW(MetricsHttpServer(registry_, server_.port()), std::runtime_error);
+}
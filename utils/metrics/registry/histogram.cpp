@@ -0,0 +1,133 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace cxx;
+
+namespace {
+
+    constexpr uint64_t MAX_VALUE = (uint64_t{ 1 } << Histogram::MAX_VALUE_BITS) - 1;
+
+    std::atomic< std::size_t > nextShard{ 0 };
+
+} // unnamed namespace
+
+uint64_t Histogram::Snapshot::count() const noexcept {
+    return count_;
+}
+
+uint64_t Histogram::Snapshot::sum() const noexcept {
+    return sum_;
+}
+
+uint64_t Histogram::Snapshot::max() const noexcept {
+    return max_;
+}
+
+double Histogram::Snapshot::mean() const noexcept {
+    return count_ == 0 ? 0.0 : static_cast< double >(sum_) / static_cast< double >(count_);
+}
+
+uint64_t Histogram::Snapshot::quantile(double quantile) const noexcept {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max< uint64_t >(1, static_cast< uint64_t >(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast< double >(count_))));
+    uint64_t seen = 0;
+    for (std::size_t index = 0; index < BUCKETS; ++index) {
+        seen += counts_[index];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(index), max_);
+        }
+    }
+    return max_;
+}
+
+uint64_t Histogram::Snapshot::countAtOrBelow(uint64_t value) const noexcept {
+    uint64_t result = 0;
+    for (std::size_t index = 0; index < BUCKETS && bucketUpperBound(index) <= value; ++index) {
+        result += counts_[index];
+    }
+    return result;
+}
+
+void Histogram::Snapshot::merge(const Snapshot & other) {
+    for (std::size_t index = 0; index < BUCKETS; ++index) {
+        counts_[index] += other.counts_[index];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+void Histogram::record(uint64_t value) noexcept {
+    record(value, 1);
+}
+
+void Histogram::record(uint64_t value, uint64_t count) noexcept {
+    value = std::min(value, MAX_VALUE);
+
+    auto & target = shard();
+    target.counts[bucketIndex(value)].fetch_add(count, std::memory_order_relaxed);
+    target.count.fetch_add(count, std::memory_order_relaxed);
+    target.sum.fetch_add(value * count, std::memory_order_relaxed);
+
+    auto max = target.max.load(std::memory_order_relaxed);
+    while (value > max && !target.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::record(std::chrono::nanoseconds duration) noexcept {
+    record(static_cast< uint64_t >(std::max< int64_t >(std::chrono::duration_cast< std::chrono::microseconds >(duration).count(), 0)));
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot result;
+    for (const auto & shard: shards_) {
+        for (std::size_t index = 0; index < BUCKETS; ++index) {
+            result.counts_[index] += shard.counts[index].load(std::memory_order_relaxed);
+        }
+        result.count_ += shard.count.load(std::memory_order_relaxed);
+        result.sum_ += shard.sum.load(std::memory_order_relaxed);
+        result.max_ = std::max(result.max_, shard.max.load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+std::size_t Histogram::bucketIndex(uint64_t value) noexcept {
+    value = std::min(value, MAX_VALUE);
+    if (value < SUB_BUCKETS) {
+        return static_cast< std::size_t >(value);
+    }
+
+    // Values in [2^e, 2^(e+1)) are split into SUB_BUCKETS buckets of width 2^(e - SUB_BUCKET_BITS)
+    const auto exponent = static_cast< std::size_t >(std::bit_width(value)) - 1;
+    const auto shift = exponent - SUB_BUCKET_BITS;
+    const auto subBucket = static_cast< std::size_t >(value >> shift) - SUB_BUCKETS;
+    return (shift + 1) * SUB_BUCKETS + subBucket;
+}
+
+uint64_t Histogram::bucketLowerBound(std::size_t index) noexcept {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const auto shift = index / SUB_BUCKETS - 1;
+    return static_cast< uint64_t >(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+}
+
+uint64_t Histogram::bucketUpperBound(std::size_t index) noexcept {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const auto shift = index / SUB_BUCKETS - 1;
+    return bucketLowerBound(index) + (uint64_t{ 1 } << shift) - 1;
+}
+
+Histogram::Shard & Histogram::shard() noexcept {
+    // Threads are spread over the stripes round-robin in the order they first record
+    thread_local const std::size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shards_[index];
+}
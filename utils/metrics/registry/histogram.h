@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Lock-free log-linear histogram in the spirit of HdrHistogram
+     *
+     * Every power of two is split into SUB_BUCKETS linear buckets, so a quantile is reported
+     * with a relative error of at most 1 / SUB_BUCKETS at a fixed memory cost. Durations are
+     * recorded in microseconds.
+     *
+     * Writers only do relaxed atomic increments. Each thread writes to one of SHARDS
+     * cache line aligned stripes, so threads recording the same histogram do not contend
+     * on the same cache lines; snapshot() merges the stripes.
+     */
+    class Histogram final {
+    public:
+        static constexpr std::size_t SUB_BUCKET_BITS = 4;
+        static constexpr std::size_t SUB_BUCKETS = std::size_t{ 1 } << SUB_BUCKET_BITS;
+        static constexpr std::size_t MAX_VALUE_BITS = 36; /**< Larger values are clamped, ~19 hours in microseconds */
+        static constexpr std::size_t BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+        static constexpr std::size_t SHARDS = 4;
+
+        /**
+         * @brief Merged state of a histogram at some moment
+         */
+        class Snapshot final {
+        public:
+            /**
+             * @brief Number of recorded values
+             */
+            uint64_t count() const noexcept;
+
+            /**
+             * @brief Sum of recorded values
+             */
+            uint64_t sum() const noexcept;
+
+            /**
+             * @brief Largest recorded value
+             */
+            uint64_t max() const noexcept;
+
+            /**
+             * @brief Mean of recorded values, zero if the histogram is empty
+             */
+            double mean() const noexcept;
+
+            /**
+             * @brief Value at the quantile, rounded up to the upper bound of its bucket
+             *
+             * @param quantile Quantile in [0, 1]
+             * @return Value or zero if the histogram is empty
+             */
+            uint64_t quantile(double quantile) const noexcept;
+
+            /**
+             * @brief Number of recorded values whose bucket lies entirely at or below the value
+             */
+            uint64_t countAtOrBelow(uint64_t value) const noexcept;
+
+            /**
+             * @brief Adds the values of other snapshot
+             */
+            void merge(const Snapshot & other);
+
+        private:
+            friend class Histogram;
+
+            std::vector< uint64_t > counts_ = std::vector< uint64_t >(BUCKETS);
+            uint64_t count_ = 0;
+            uint64_t sum_ = 0;
+            uint64_t max_ = 0;
+        };
+
+    public:
+        Histogram() = default;
+        Histogram(const Histogram &) = delete;
+        Histogram & operator=(const Histogram &) = delete;
+
+        /**
+         * @brief Records a value
+         */
+        void record(uint64_t value) noexcept;
+
+        /**
+         * @brief Records a value as if it was observed count times
+         */
+        void record(uint64_t value, uint64_t count) noexcept;
+
+        /**
+         * @brief Records a duration in microseconds
+         */
+        void record(std::chrono::nanoseconds duration) noexcept;
+
+        /**
+         * @brief Merges all stripes into a snapshot
+         *
+         * Concurrent writes may be partially visible in the snapshot.
+         */
+        Snapshot snapshot() const;
+
+        /**
+         * @brief Index of the bucket the value falls into
+         */
+        static std::size_t bucketIndex(uint64_t value) noexcept;
+
+        /**
+         * @brief Smallest value of the bucket
+         */
+        static uint64_t bucketLowerBound(std::size_t index) noexcept;
+
+        /**
+         * @brief Largest value of the bucket
+         */
+        static uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    private:
+        struct alignas(64) Shard {
+            std::array< std::atomic< uint64_t >, BUCKETS > counts{};
+            std::atomic< uint64_t > count{ 0 };
+            std::atomic< uint64_t > sum{ 0 };
+            std::atomic< uint64_t > max{ 0 };
+        };
+
+        /**
+         * @brief Stripe of the calling thread
+         */
+        Shard & shard() noexcept;
+
+    private:
+        std::array< Shard, SHARDS > shards_;
+    };
+
+} // namespace cxx
@@ -0,0 +1,181 @@
+#include "metrics_registry.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+using namespace cxx;
+
+namespace {
+
+    // Prometheus type of every MetricsRegistry::Series alternative, callbacks are gauges
+    constexpr std::array< const char *, 4 > TYPE_NAMES = { "counter", "gauge", "histogram", "gauge" };
+
+    /**
+     * @brief Upper bounds of the exported histogram buckets in microseconds
+     */
+    constexpr std::array< uint64_t, 16 > HISTOGRAM_BOUNDS = {
+        100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000,
+        100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000, 10'000'000
+    };
+
+    std::string formatNumber(double value) {
+        if (std::isnan(value)) {
+            return "NaN";
+        }
+        if (std::isinf(value)) {
+            return value > 0 ? "+Inf" : "-Inf";
+        }
+        // Plain notation reads better for the usual magnitudes, huge values fall back to exponent
+        std::array< char, 64 > buffer{};
+        auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed);
+        if (ec != std::errc()) {
+            end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr;
+        }
+        return std::string(buffer.data(), end);
+    }
+
+    std::string escape(const std::string & value, bool quotes) {
+        std::string result;
+        result.reserve(value.size());
+        for (const char c: value) {
+            if (c == '\\') {
+                result += "\\\\";
+            } else if (c == '\n') {
+                result += "\\n";
+            } else if (c == '"' && quotes) {
+                result += "\\\"";
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Renders labels as name="value" pairs without braces, it is the key of a series
+     */
+    std::string renderLabels(const MetricsRegistry::Labels & labels) {
+        std::string result;
+        for (const auto & [name, value]: labels) {
+            if (!result.empty()) {
+                result += ',';
+            }
+            result += name;
+            result += "=\"";
+            result += escape(value, true);
+            result += '"';
+        }
+        return result;
+    }
+
+    void appendSample(std::string & out, const std::string & name, const std::string & labels, const std::string & value) {
+        out += name;
+        if (!labels.empty()) {
+            out += '{';
+            out += labels;
+            out += '}';
+        }
+        out += ' ';
+        out += value;
+        out += '\n';
+    }
+
+    void appendHistogram(std::string & out, const std::string & name, const std::string & labels, const Histogram & histogram) {
+        const auto snapshot = histogram.snapshot();
+        const auto bucketLabels = labels.empty() ? std::string() : labels + ",";
+
+        for (const auto bound: HISTOGRAM_BOUNDS) {
+            appendSample(out, name + "_bucket", bucketLabels + "le=\"" + formatNumber(static_cast< double >(bound) / 1e6) + "\"", std::to_string(snapshot.countAtOrBelow(bound)));
+        }
+        appendSample(out, name + "_bucket", bucketLabels + "le=\"+Inf\"", std::to_string(snapshot.count()));
+        appendSample(out, name + "_sum", labels, formatNumber(static_cast< double >(snapshot.sum()) / 1e6));
+        appendSample(out, name + "_count", labels, std::to_string(snapshot.count()));
+    }
+
+} // unnamed namespace
+
+MetricsRegistry & MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+Counter & MetricsRegistry::counter(const std::string & name, const std::string & help, const Labels & labels) {
+    return get< Counter >(name, help, labels);
+}
+
+Gauge & MetricsRegistry::gauge(const std::string & name, const std::string & help, const Labels & labels) {
+    return get< Gauge >(name, help, labels);
+}
+
+Histogram & MetricsRegistry::histogram(const std::string & name, const std::string & help, const Labels & labels) {
+    return get< Histogram >(name, help, labels);
+}
+
+void MetricsRegistry::callback(const std::string & name, const std::string & help, const Labels & labels, Callback callback) {
+    std::unique_lock lock(mutex_);
+    family(name, help, Series(Callback()).index()).series[renderLabels(labels)] = std::move(callback);
+}
+
+template < typename Metric >
+Metric & MetricsRegistry::get(const std::string & name, const std::string & help, const Labels & labels) {
+    using Pointer = std::unique_ptr< Metric >;
+    const auto key = renderLabels(labels);
+
+    {
+        std::shared_lock lock(mutex_);
+        const auto familyIt = families_.find(name);
+        if (familyIt != families_.end()) {
+            const auto seriesIt = familyIt->second.series.find(key);
+            if (seriesIt != familyIt->second.series.end() && std::holds_alternative< Pointer >(seriesIt->second)) {
+                return *std::get< Pointer >(seriesIt->second);
+            }
+        }
+    }
+
+    std::unique_lock lock(mutex_);
+    auto & series = family(name, help, Series(Pointer()).index()).series;
+    auto it = series.find(key);
+    if (it == series.end()) {
+        it = series.emplace(key, std::make_unique< Metric >()).first;
+    }
+    return *std::get< Pointer >(it->second);
+}
+
+MetricsRegistry::Family & MetricsRegistry::family(const std::string & name, const std::string & help, std::size_t type) {
+    auto [it, inserted] = families_.try_emplace(name, Family{ .help = help, .type = type, .series = {} });
+    if (!inserted && it->second.type != type) {
+        throw std::logic_error("Metric " + name + " is already registered as " + TYPE_NAMES[it->second.type]);
+    }
+    return it->second;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::shared_lock lock(mutex_);
+
+    std::string out;
+    for (const auto & [name, family]: families_) {
+        out += "# HELP " + name + " " + escape(family.help, false) + "\n";
+        out += "# TYPE " + name + " " + TYPE_NAMES[family.type] + "\n";
+
+        for (const auto & [labels, series]: family.series) {
+            std::visit(
+             [&out, &name, &labels](const auto & metric) {
+                 using Type = std::decay_t< decltype(metric) >;
+                 if constexpr (std::is_same_v< Type, std::unique_ptr< Counter > >) {
+                     appendSample(out, name, labels, std::to_string(metric->value()));
+                 } else if constexpr (std::is_same_v< Type, std::unique_ptr< Gauge > >) {
+                     appendSample(out, name, labels, std::to_string(metric->value()));
+                 } else if constexpr (std::is_same_v< Type, std::unique_ptr< Histogram > >) {
+                     appendHistogram(out, name, labels, *metric);
+                 } else {
+                     appendSample(out, name, labels, formatNumber(metric()));
+                 }
+             },
+             series);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <utils/metrics/registry/histogram.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cxx {
+
+    /**
+     * @brief Monotonically increasing counter
+     */
+    class Counter final {
+    public:
+        void inc(uint64_t value = 1) noexcept {
+            value_.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        uint64_t value() const noexcept {
+            return value_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic< uint64_t > value_{ 0 };
+    };
+
+    /**
+     * @brief Value that can go up and down
+     */
+    class Gauge final {
+    public:
+        void set(int64_t value) noexcept {
+            value_.store(value, std::memory_order_relaxed);
+        }
+
+        void add(int64_t value) noexcept {
+            value_.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        int64_t value() const noexcept {
+            return value_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic< int64_t > value_{ 0 };
+    };
+
+    /**
+     * @brief Named metrics with labels, rendered in the Prometheus text format
+     *
+     * Metrics are created on first access and live as long as the registry, so the returned
+     * references may be cached by the caller to skip the lookup. Lookups of existing metrics
+     * take a shared lock only. Histograms record microseconds and are exported in seconds,
+     * so their names should end with _seconds.
+     */
+    class MetricsRegistry final {
+    public:
+        using Labels = std::vector< std::pair< std::string, std::string > >;
+        using Callback = std::function< double() >;
+
+    public:
+        MetricsRegistry() = default;
+        MetricsRegistry(const MetricsRegistry &) = delete;
+        MetricsRegistry & operator=(const MetricsRegistry &) = delete;
+
+        /**
+         * @brief Registry used by the instrumented libraries
+         */
+        static MetricsRegistry & global();
+
+        /**
+         * @brief Returns the counter, creating it on first access
+         *
+         * @throws std::logic_error if the name is registered with other metric type
+         */
+        Counter & counter(const std::string & name, const std::string & help, const Labels & labels = {});
+
+        /**
+         * @brief Returns the gauge, creating it on first access
+         *
+         * @throws std::logic_error if the name is registered with other metric type
+         */
+        Gauge & gauge(const std::string & name, const std::string & help, const Labels & labels = {});
+
+        /**
+         * @brief Returns the histogram, creating it on first access
+         *
+         * @throws std::logic_error if the name is registered with other metric type
+         */
+        Histogram & histogram(const std::string & name, const std::string & help, const Labels & labels = {});
+
+        /**
+         * @brief Registers a gauge whose value is sampled on every render
+         *
+         * The callback is called under the registry lock and must not access the registry.
+         * A callback registered again with the same name and labels replaces the old one.
+         *
+         * @throws std::logic_error if the name is registered with other metric type
+         */
+        void callback(const std::string & name, const std::string & help, const Labels & labels, Callback callback);
+
+        /**
+         * @brief Renders all metrics in the Prometheus text exposition format 0.0.4
+         */
+        std::string renderPrometheus() const;
+
+    private:
+        using Series = std::variant< std::unique_ptr< Counter >, std::unique_ptr< Gauge >, std::unique_ptr< Histogram >, Callback >;
+
+        struct Family {
+            std::string help;
+            std::size_t type; /**< Index of the alternative in Series */
+            std::map< std::string, Series > series;
+        };
+
+        /**
+         * @brief Finds or creates the series
+         */
+        template < typename Metric >
+        Metric & get(const std::string & name, const std::string & help, const Labels & labels);
+
+        /**
+         * @brief Returns the family, creating it on first access, the lock must be held exclusively
+         */
+        Family & family(const std::string & name, const std::string & help, std::size_t type);
+
+    private:
+        mutable std::shared_mutex mutex_;
+        std::map< std::string, Family > families_;
+    };
+
+} // namespace cxx
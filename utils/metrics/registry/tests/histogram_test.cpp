@@ -0,0 +1,74 @@
+#include <utils/metrics/registry/histogram.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace cxx;
+
+TEST(HistogramTest, BucketsCoverValuesContinuously) {
+    for (std::size_t index = 1; index < Histogram::BUCKETS; ++index) {
+        ASSERT_EQ(Histogram::bucketLowerBound(index), Histogram::bucketUpperBound(index - 1) + 1) << index;
+    }
+    for (uint64_t value: { 0, 1, 15, 16, 17, 1000, 123456, 99999999 }) {
+        const auto index = Histogram::bucketIndex(value);
+        EXPECT_LE(Histogram::bucketLowerBound(index), value);
+        EXPECT_GE(Histogram::bucketUpperBound(index), value);
+    }
+    EXPECT_EQ(Histogram::bucketIndex(UINT64_MAX), Histogram::BUCKETS - 1);
+}
+
+TEST(HistogramTest, QuantilesAreWithinRelativeError) {
+    Histogram histogram;
+    for (uint64_t value = 1; value <= 10000; ++value) {
+        histogram.record(value);
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 10000);
+    EXPECT_EQ(snapshot.max(), 10000);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 5000.5);
+
+    for (const auto & [quantile, expected]: { std::pair{ 0.5, 5000.0 }, std::pair{ 0.99, 9900.0 }, std::pair{ 0.999, 9990.0 } }) {
+        const auto value = static_cast< double >(snapshot.quantile(quantile));
+        EXPECT_GE(value, expected);
+        EXPECT_LE(value, expected * (1.0 + 1.0 / Histogram::SUB_BUCKETS));
+    }
+    EXPECT_EQ(snapshot.quantile(1.0), 10000);
+    EXPECT_EQ(Histogram().snapshot().quantile(0.5), 0);
+}
+
+TEST(HistogramTest, RecordsDurationsInMicroseconds) {
+    Histogram histogram;
+    histogram.record(std::chrono::milliseconds(3));
+    histogram.record(std::chrono::nanoseconds(-5));
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.sum(), 3000);
+    EXPECT_EQ(snapshot.countAtOrBelow(0), 1);
+    EXPECT_EQ(snapshot.countAtOrBelow(5000), 2);
+}
+
+TEST(HistogramTest, ConcurrentWritersAreMerged) {
+    Histogram histogram;
+
+    constexpr int THREADS = 8;
+    constexpr int VALUES = 100000;
+    std::vector< std::thread > threads;
+    for (int i = 0; i < THREADS; ++i) {
+        threads.emplace_back([&histogram, i]() {
+            for (int j = 0; j < VALUES; ++j) {
+                histogram.record(static_cast< uint64_t >(i + 1));
+            }
+        });
+    }
+    for (auto & thread: threads) {
+        thread.join();
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), THREADS * VALUES);
+    EXPECT_EQ(snapshot.sum(), uint64_t{ VALUES } * THREADS * (THREADS + 1) / 2);
+    EXPECT_EQ(snapshot.max(), THREADS);
+}
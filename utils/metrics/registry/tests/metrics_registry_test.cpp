@@ -0,0 +1,59 @@
+#include <utils/metrics/registry/metrics_registry.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace cxx;
+using namespace testing;
+
+TEST(MetricsRegistryTest, SameNameAndLabelsReturnSameMetric) {
+    MetricsRegistry registry;
+
+    auto & first = registry.counter("requests_total", "Requests", { { "method", "Get" } });
+    auto & second = registry.counter("requests_total", "Requests", { { "method", "Get" } });
+    auto & other = registry.counter("requests_total", "Requests", { { "method", "Put" } });
+
+    first.inc();
+    second.inc(2);
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+    EXPECT_EQ(first.value(), 3);
+    EXPECT_EQ(other.value(), 0);
+}
+
+TEST(MetricsRegistryTest, TypeMismatchIsRejected) {
+    MetricsRegistry registry;
+    registry.gauge("in_flight", "In flight");
+
+    EXPECT_THROW(registry.counter("in_flight", "In flight"), std::logic_error);
+    EXPECT_THROW(registry.callback("in_flight", "In flight", {}, []() {
+        return 1.0;
+    }),
+                 std::logic_error);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText) {
+    MetricsRegistry registry;
+    registry.counter("errors_total", "Errors", { { "code", "NOT_FOUND" } }).inc(2);
+    registry.gauge("in_flight", "Requests in \"flight\"").set(-1);
+    registry.callback("pool_size", "Pool size", { { "state", "idle" } }, []() {
+        return 2.5;
+    });
+    auto & latency = registry.histogram("latency_seconds", "Latency", { { "method", "a\"b" } });
+    latency.record(std::chrono::microseconds(200));
+    latency.record(std::chrono::milliseconds(20));
+
+    const auto text = registry.renderPrometheus();
+    EXPECT_THAT(text, HasSubstr("# TYPE errors_total counter\nerrors_total{code=\"NOT_FOUND\"} 2\n"));
+    EXPECT_THAT(text, HasSubstr("# HELP in_flight Requests in \"flight\"\n# TYPE in_flight gauge\nin_flight -1\n"));
+    EXPECT_THAT(text, HasSubstr("# TYPE pool_size gauge\npool_size{state=\"idle\"} 2.5\n"));
+    EXPECT_THAT(text, HasSubstr("# TYPE latency_seconds histogram\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_bucket{method=\"a\\\"b\",le=\"0.0001\"} 0\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_bucket{method=\"a\\\"b\",le=\"0.00025\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_bucket{method=\"a\\\"b\",le=\"0.025\"} 2\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_bucket{method=\"a\\\"b\",le=\"+Inf\"} 2\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_sum{method=\"a\\\"b\"} 0.0202\n"));
+    EXPECT_THAT(text, HasSubstr("latency_seconds_count{method=\"a\\\"b\"} 2\n"));
+}
@@ -0,0 +1,50 @@
+#include <utils/string/doublespaces/doublespaces.h>
+#include <utils/string/trim.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+namespace {
+
+    // Item name as it comes from OFD: padded and with runs of spaces between the words
+    std::string makePaddedName(std::size_t words) {
+        std::string result = " \t ";
+        for (std::size_t i = 0; i < words; ++i) {
+            result += "Сок   яблочный  ";
+        }
+        return result + " \r\n";
+    }
+
+    void BM_Trim(benchmark::State & state) {
+        const auto source = makePaddedName(static_cast< std::size_t >(state.range(0)));
+        for (auto _: state) {
+            auto str = source;
+            cxx::trim(str);
+            benchmark::DoNotOptimize(str);
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * source.size()));
+    }
+    BENCHMARK(BM_Trim)->Arg(1)->Arg(16);
+
+    void BM_TrimCopy(benchmark::State & state) {
+        const auto source = makePaddedName(static_cast< std::size_t >(state.range(0)));
+        for (auto _: state) {
+            benchmark::DoNotOptimize(cxx::trimCopy(source));
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * source.size()));
+    }
+    BENCHMARK(BM_TrimCopy)->Arg(1)->Arg(16);
+
+    void BM_RemoveDoubleSpaces(benchmark::State & state) {
+        const auto source = makePaddedName(static_cast< std::size_t >(state.range(0)));
+        for (auto _: state) {
+            auto str = source;
+            cxx::removeDoubleSpaces(str);
+            benchmark::DoNotOptimize(str);
+        }
+        state.SetBytesProcessed(static_cast< int64_t >(state.iterations() * source.size()));
+    }
+    BENCHMARK(BM_RemoveDoubleSpaces)->Arg(1)->Arg(16)->Arg(256);
+
+} // unnamed namespace